@@ -14,3 +14,14 @@ def enumerate_files(env, directory, extensions):
 			results += env.Glob("{}/*.{}".format(build_dirpath, extension))
 
 	return results
+
+# Returns the compiler flags for a source file compiled for a specific SIMD tier, or None if the source file should use
+# the build-wide flags. The build-wide instruction set flag is removed since only one may be specified.
+def get_simd_tier_cc_flags(env, source, simd_tier_cc_flags):
+	basename = os.path.splitext(os.path.basename(str(source)))[0]
+	for simd_tier, tier_cc_flags in simd_tier_cc_flags.items():
+		if basename.endswith("_" + simd_tier):
+			cc_flags = [flag for flag in env["CCFLAGS"] if not str(flag).startswith("/arch:")]
+			return cc_flags + tier_cc_flags
+
+	return None
@@ -0,0 +1,227 @@
+#include "benchmarks/benchmark.h"
+
+#include "common/math/simd.h"
+
+#include "instrument/native_modules/json/json_file.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct s_registered_benchmark {
+	const char *name;
+	f_benchmark benchmark;
+};
+
+struct s_benchmark_result {
+	std::string benchmark;
+	std::string configuration;
+	std::string result_name;
+	real64 value;
+	std::string units;
+	bool higher_is_better;
+};
+
+// Function-local static so that registration works regardless of static initialization order
+static std::vector<s_registered_benchmark> &get_registered_benchmarks() {
+	static std::vector<s_registered_benchmark> s_registered_benchmarks;
+	return s_registered_benchmarks;
+}
+
+static const char *g_running_benchmark_name = nullptr;
+static std::vector<s_benchmark_result> g_benchmark_results;
+static const char *g_benchmark_instrument_path = nullptr;
+
+static std::string get_benchmark_result_key(
+	const std::string &benchmark,
+	const std::string &configuration,
+	const std::string &result_name) {
+	return benchmark + "/" + configuration + "/" + result_name;
+}
+
+static void write_json_string(std::ofstream &file, const std::string &str) {
+	file << '"';
+	for (char c : str) {
+		if (c == '"' || c == '\\') {
+			file << '\\';
+		}
+
+		file << c;
+	}
+
+	file << '"';
+}
+
+static const char *get_json_string_element(const c_json_node_object &object, const char *name) {
+	const c_json_node *node = object.get_element(name);
+	const c_json_node_string *string_node = node ? node->try_get_as<c_json_node_string>() : nullptr;
+	return string_node ? string_node->get_value() : nullptr;
+}
+
+c_benchmark_registrar::c_benchmark_registrar(const char *name, f_benchmark benchmark) {
+	wl_assert(name);
+	wl_assert(benchmark);
+	get_registered_benchmarks().push_back({ name, benchmark });
+}
+
+uint32 run_benchmarks(const char *filter) {
+	uint32 benchmarks_run = 0;
+	for (const s_registered_benchmark &registered_benchmark : get_registered_benchmarks()) {
+		if (filter && !strstr(registered_benchmark.name, filter)) {
+			continue;
+		}
+
+		std::cout << registered_benchmark.name << "\n";
+		g_running_benchmark_name = registered_benchmark.name;
+		registered_benchmark.benchmark();
+		g_running_benchmark_name = nullptr;
+		benchmarks_run++;
+	}
+
+	return benchmarks_run;
+}
+
+void report_benchmark_result(
+	const char *configuration,
+	const char *result_name,
+	real64 value,
+	const char *units,
+	bool higher_is_better) {
+	wl_assert(g_running_benchmark_name);
+	std::cout << "  " << configuration << ": " << result_name << " = " << value << " " << units << "\n";
+	g_benchmark_results.push_back(
+		{ g_running_benchmark_name, configuration, result_name, value, units, higher_is_better });
+}
+
+bool write_benchmark_results(const char *filename) {
+	std::ofstream file(filename);
+	if (file.fail()) {
+		return false;
+	}
+
+	// The SIMD width is fixed at build time and hot kernels are selected by CPU so both are recorded to avoid comparing
+	// results which used different instruction sets
+	file << std::setprecision(17);
+	file << "{\n";
+	file << "  \"simd_lanes\": " << k_simd_32_lanes << ",\n";
+	file << "  \"simd_tier\": \"" << get_simd_tier_name(get_simd_tier()) << "\",\n";
+	file << "  \"results\": [";
+	for (size_t index = 0; index < g_benchmark_results.size(); index++) {
+		const s_benchmark_result &result = g_benchmark_results[index];
+		file << ((index == 0) ? "\n" : ",\n") << "    { \"benchmark\": ";
+		write_json_string(file, result.benchmark);
+		file << ", \"configuration\": ";
+		write_json_string(file, result.configuration);
+		file << ", \"name\": ";
+		write_json_string(file, result.result_name);
+		file << ", \"value\": " << result.value << ", \"units\": ";
+		write_json_string(file, result.units);
+		file << ", \"higher_is_better\": " << (result.higher_is_better ? "true" : "false") << " }";
+	}
+
+	file << "\n  ]\n";
+	file << "}\n";
+
+	return !file.fail();
+}
+
+bool compare_benchmark_results(const char *baseline_filename, real64 regression_threshold) {
+	c_json_file baseline_file;
+	s_json_result load_result = baseline_file.load(baseline_filename);
+	if (load_result.result != e_json_result::k_success) {
+		std::cout << "Failed to read baseline '" << baseline_filename << "'";
+		if (load_result.result == e_json_result::k_parse_error) {
+			std::cout << " (" << load_result.parse_error_line << ":" << load_result.parse_error_character << ")";
+		}
+
+		std::cout << "\n";
+		return false;
+	}
+
+	const c_json_node_object *root = baseline_file.get_root()->try_get_as<c_json_node_object>();
+	const c_json_node *results_node = root ? root->get_element("results") : nullptr;
+	const c_json_node_array *results = results_node ? results_node->try_get_as<c_json_node_array>() : nullptr;
+	if (!results) {
+		std::cout << "Baseline '" << baseline_filename << "' contains no results\n";
+		return false;
+	}
+
+	const c_json_node *simd_lanes_node = root->get_element("simd_lanes");
+	const c_json_node_number *simd_lanes =
+		simd_lanes_node ? simd_lanes_node->try_get_as<c_json_node_number>() : nullptr;
+	if (simd_lanes && static_cast<size_t>(simd_lanes->get_value()) != k_simd_32_lanes) {
+		std::cout << "Warning: baseline was built with " << simd_lanes->get_value() << " SIMD lanes but this build has "
+			<< k_simd_32_lanes << "\n";
+	}
+
+	const char *simd_tier = get_json_string_element(*root, "simd_tier");
+	if (simd_tier && strcmp(simd_tier, get_simd_tier_name(get_simd_tier())) != 0) {
+		std::cout << "Warning: baseline used " << simd_tier << " SIMD kernels but this run uses "
+			<< get_simd_tier_name(get_simd_tier()) << "\n";
+	}
+
+	std::unordered_map<std::string, real64> baseline_values;
+	for (const c_json_node *result_node : results->get_value()) {
+		const c_json_node_object *result = result_node->try_get_as<c_json_node_object>();
+		if (!result) {
+			continue;
+		}
+
+		const char *benchmark = get_json_string_element(*result, "benchmark");
+		const char *configuration = get_json_string_element(*result, "configuration");
+		const char *result_name = get_json_string_element(*result, "name");
+		const c_json_node *value_node = result->get_element("value");
+		const c_json_node_number *value = value_node ? value_node->try_get_as<c_json_node_number>() : nullptr;
+		if (benchmark && configuration && result_name && value) {
+			baseline_values[get_benchmark_result_key(benchmark, configuration, result_name)] = value->get_value();
+		}
+	}
+
+	std::cout << "Comparison against '" << baseline_filename << "':\n";
+	uint32 regression_count = 0;
+	uint32 missing_count = 0;
+	for (const s_benchmark_result &result : g_benchmark_results) {
+		std::string key = get_benchmark_result_key(result.benchmark, result.configuration, result.result_name);
+		auto baseline_value = baseline_values.find(key);
+		if (baseline_value == baseline_values.end()) {
+			missing_count++;
+			continue;
+		}
+
+		if (baseline_value->second == 0.0) {
+			continue;
+		}
+
+		// Positive changes are always worse regardless of whether the measured value should go up or down
+		real64 ratio = result.value / baseline_value->second;
+		real64 change = result.higher_is_better ? (1.0 / ratio - 1.0) : (ratio - 1.0);
+		bool regressed = change > regression_threshold;
+		if (regressed) {
+			regression_count++;
+		}
+
+		std::cout << "  " << key << ": " << baseline_value->second << " -> " << result.value << " " << result.units
+			<< " (" << std::showpos << std::fixed << std::setprecision(1) << change * 100.0 << "%"
+			<< std::noshowpos << std::defaultfloat << std::setprecision(6) << ")"
+			<< (regressed ? " REGRESSION" : "") << "\n";
+	}
+
+	if (missing_count > 0) {
+		std::cout << missing_count << " results were not found in the baseline\n";
+	}
+
+	std::cout << regression_count << " regressions beyond " << regression_threshold * 100.0 << "%\n";
+	return regression_count == 0;
+}
+
+void set_benchmark_instrument_path(const char *path) {
+	g_benchmark_instrument_path = path;
+}
+
+const char *get_benchmark_instrument_path() {
+	return g_benchmark_instrument_path;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "common/common.h"
+
+using f_benchmark = void (*)();
+
+// Buffer sizes that per-sample kernels are measured with, covering the range of driver buffer sizes we expect
+static constexpr size_t k_benchmark_buffer_sizes[] = { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+
+// Number of samples each per-sample kernel configuration processes, rounded up to a whole number of buffers. This is
+// large enough that timer resolution is irrelevant but small enough that the whole suite runs quickly.
+static constexpr size_t k_benchmark_sample_count = 1 << 18;
+
+// Registers a benchmark to be run by the benchmarks executable. Use the BENCHMARK() macro rather than using this class
+// directly.
+class c_benchmark_registrar {
+public:
+	c_benchmark_registrar(const char *name, f_benchmark benchmark);
+};
+
+#define BENCHMARK(name)												\
+	static void name();												\
+	static c_benchmark_registrar name##_registrar(#name, name);		\
+	static void name()
+
+// Runs all registered benchmarks whose names contain the filter string, or all benchmarks if the filter is null.
+// Returns the number of benchmarks run.
+uint32 run_benchmarks(const char *filter);
+
+// Reports a single measured value for the currently running benchmark. The configuration string describes the
+// parameters the value was measured with (e.g. thread and voice counts). When comparing against a baseline, an increase
+// in value is treated as a regression unless higher_is_better is set.
+void report_benchmark_result(
+	const char *configuration,
+	const char *result_name,
+	real64 value,
+	const char *units,
+	bool higher_is_better = false);
+
+// Writes every result reported so far to a JSON file which can later be used as a baseline
+bool write_benchmark_results(const char *filename);
+
+// Prints the change of every reported result relative to the matching result in the baseline file. Returns false if
+// the baseline couldn't be read or if any result regressed by more than regression_threshold, which is a ratio of the
+// baseline value (e.g. 0.1 means 10% worse).
+bool compare_benchmark_results(const char *baseline_filename, real64 regression_threshold);
+
+// Benchmarks which run a whole instrument use the compiled instrument at this path and are skipped if it is null
+void set_benchmark_instrument_path(const char *path);
+const char *get_benchmark_instrument_path();
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/utility/aligned_allocator.h"
+
+#include "engine/buffer.h"
+
+#include <vector>
+
+// A set of real buffers which own their memory so that kernels operating on buffers can be benchmarked outside of the
+// executor
+class c_benchmark_real_buffers {
+public:
+	c_benchmark_real_buffers() = default;
+	UNCOPYABLE(c_benchmark_real_buffers);
+
+	void initialize(size_t buffer_count, size_t sample_count) {
+		m_padded_sample_count = align_size(sample_count, k_simd_32_lanes);
+		m_memory.allocate(buffer_count * m_padded_sample_count);
+		zero_type(m_memory.get_array().get_pointer(), m_memory.get_array().get_count());
+
+		m_buffers.reserve(buffer_count);
+		for (size_t index = 0; index < buffer_count; index++) {
+			m_buffers.push_back(c_buffer::construct(c_task_data_type(e_task_primitive_type::k_real, false, 1)));
+			m_buffers.back().set_memory(get_memory(index));
+		}
+	}
+
+	// Fills a buffer with a deterministic signal that never looks constant, varying by up to half the range around the
+	// center value
+	void fill_dynamic(size_t index, real32 center = 0.0f, real32 range = 1.0f) {
+		real32 *data = get_memory(index);
+		for (size_t sample_index = 0; sample_index < m_padded_sample_count; sample_index++) {
+			real32 offset = static_cast<real32>((sample_index + index) % 17) / 17.0f - 0.5f;
+			data[sample_index] = center + offset * range;
+		}
+
+		m_buffers[index].set_is_constant(false);
+	}
+
+	void fill_constant(size_t index, real32 value) {
+		get(index)->assign_constant(value);
+	}
+
+	c_real_buffer *get(size_t index) {
+		return &m_buffers[index].get_as<c_real_buffer>();
+	}
+
+	c_wrapped_array<c_buffer> get_buffers() {
+		return c_wrapped_array<c_buffer>(m_buffers.data(), m_buffers.size());
+	}
+
+private:
+	real32 *get_memory(size_t index) {
+		return m_memory.get_array().get_pointer() + index * m_padded_sample_count;
+	}
+
+	size_t m_padded_sample_count = 0;
+	c_aligned_allocator<real32, k_simd_alignment> m_memory;
+	std::vector<c_buffer> m_buffers;
+};
@@ -0,0 +1,58 @@
+#include "benchmarks/benchmark.h"
+
+#include "common/common.h"
+#include "common/math/floating_point.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static constexpr real64 k_default_regression_threshold = 0.1;
+
+static void print_usage() {
+	std::cout << "Usage: benchmarks [filter] [--json <results file>] [--compare <baseline file>] "
+		"[--threshold <percent>] [--instrument <compiled instrument>]\n";
+}
+
+int main(int argc, char **argv) {
+	initialize_floating_point_behavior();
+
+	// An optional positional argument filters which benchmarks are run
+	const char *filter = nullptr;
+	const char *json_filename = nullptr;
+	const char *baseline_filename = nullptr;
+	real64 regression_threshold = k_default_regression_threshold;
+	for (int32 index = 1; index < argc; index++) {
+		bool has_value = index + 1 < argc;
+		if (strcmp(argv[index], "--json") == 0 && has_value) {
+			json_filename = argv[++index];
+		} else if (strcmp(argv[index], "--compare") == 0 && has_value) {
+			baseline_filename = argv[++index];
+		} else if (strcmp(argv[index], "--threshold") == 0 && has_value) {
+			regression_threshold = std::atof(argv[++index]) * 0.01;
+		} else if (strcmp(argv[index], "--instrument") == 0 && has_value) {
+			set_benchmark_instrument_path(argv[++index]);
+		} else if (argv[index][0] != '-' && !filter) {
+			filter = argv[index];
+		} else {
+			print_usage();
+			return 1;
+		}
+	}
+
+	if (run_benchmarks(filter) == 0) {
+		std::cout << "No benchmarks were run\n";
+		return 1;
+	}
+
+	if (json_filename && !write_benchmark_results(json_filename)) {
+		std::cout << "Failed to write '" << json_filename << "'\n";
+		return 1;
+	}
+
+	if (baseline_filename && !compare_benchmark_results(baseline_filename, regression_threshold)) {
+		return 1;
+	}
+
+	return 0;
+}
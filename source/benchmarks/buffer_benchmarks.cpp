@@ -0,0 +1,188 @@
+#include "benchmarks/benchmark.h"
+#include "benchmarks/benchmark_buffer.h"
+
+#include "common/math/simd.h"
+#include "common/utility/stopwatch.h"
+
+#include "engine/buffer_operations/buffer_iterator.h"
+#include "engine/executor/channel_mixer.h"
+
+#include <string>
+#include <vector>
+
+// These benchmarks measure the per-sample cost of buffer iteration and of moving channels in and out of the executor
+
+enum class e_buffer_input_mode {
+	k_dynamic,
+	k_constant,
+
+	k_count
+};
+
+static constexpr const char *k_buffer_input_mode_names[] = { "dynamic", "constant" };
+STATIC_ASSERT(array_count(k_buffer_input_mode_names) == enum_count<e_buffer_input_mode>());
+
+static void fill_input(c_benchmark_real_buffers &buffers, size_t index, e_buffer_input_mode input_mode) {
+	if (input_mode == e_buffer_input_mode::k_dynamic) {
+		buffers.fill_dynamic(index);
+	} else {
+		buffers.fill_constant(index, 0.5f);
+	}
+}
+
+template<size_t k_stride>
+static real64 run_iterate_buffers(
+	size_t buffer_size,
+	e_buffer_input_mode input_mode_a,
+	e_buffer_input_mode input_mode_b) {
+	c_benchmark_real_buffers buffers;
+	buffers.initialize(3, buffer_size);
+	fill_input(buffers, 0, input_mode_a);
+	fill_input(buffers, 1, input_mode_b);
+
+	const c_real_buffer *input_a = buffers.get(0);
+	const c_real_buffer *input_b = buffers.get(1);
+	c_real_buffer *output = buffers.get(2);
+
+	size_t buffer_count = (k_benchmark_sample_count + buffer_size - 1) / buffer_size;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t buffer_index = 0; buffer_index < buffer_count; buffer_index++) {
+		if constexpr (k_stride == 1) {
+			iterate_buffers<1, true>(buffer_size, input_a, input_b, output,
+				[](size_t i, real32 a, real32 b, real32 &c) {
+					c = a * b + a;
+				});
+		} else {
+			iterate_buffers<k_stride, true>(buffer_size, input_a, input_b, output,
+				[](size_t i, const real32xN &a, const real32xN &b, real32xN &c) {
+					c = a * b + a;
+				});
+		}
+	}
+
+	int64 total_time = stopwatch.query();
+	return static_cast<real64>(total_time) / static_cast<real64>(buffer_count * buffer_size);
+}
+
+BENCHMARK(iterate_buffers) {
+	static constexpr e_buffer_input_mode k_input_modes[][2] = {
+		{ e_buffer_input_mode::k_dynamic, e_buffer_input_mode::k_dynamic },
+		{ e_buffer_input_mode::k_dynamic, e_buffer_input_mode::k_constant },
+		{ e_buffer_input_mode::k_constant, e_buffer_input_mode::k_constant }
+	};
+
+	for (const auto &input_modes : k_input_modes) {
+		for (size_t buffer_size : k_benchmark_buffer_sizes) {
+			std::string configuration = std::string("inputs=") + k_buffer_input_mode_names[enum_index(input_modes[0])]
+				+ "," + k_buffer_input_mode_names[enum_index(input_modes[1])]
+				+ " buffer=" + std::to_string(buffer_size);
+
+			real64 scalar_time = run_iterate_buffers<1>(buffer_size, input_modes[0], input_modes[1]);
+			report_benchmark_result(configuration.c_str(), "scalar", scalar_time, "ns/sample");
+
+			real64 simd_time = run_iterate_buffers<k_simd_32_lanes>(buffer_size, input_modes[0], input_modes[1]);
+			report_benchmark_result(configuration.c_str(), "simd", simd_time, "ns/sample");
+		}
+	}
+}
+
+static real64 run_mix_channel_buffers(
+	size_t buffer_size,
+	uint32 input_channel_count,
+	uint32 output_channel_count,
+	e_buffer_input_mode input_mode) {
+	c_benchmark_real_buffers input_buffers;
+	input_buffers.initialize(input_channel_count, buffer_size);
+	for (uint32 channel = 0; channel < input_channel_count; channel++) {
+		fill_input(input_buffers, channel, input_mode);
+	}
+
+	c_benchmark_real_buffers output_buffers;
+	output_buffers.initialize(output_channel_count, buffer_size);
+
+	size_t buffer_count = (k_benchmark_sample_count + buffer_size - 1) / buffer_size;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t buffer_index = 0; buffer_index < buffer_count; buffer_index++) {
+		mix_channel_buffers(
+			static_cast<uint32>(buffer_size),
+			input_buffers.get_buffers(),
+			output_buffers.get_buffers());
+	}
+
+	int64 total_time = stopwatch.query();
+	return static_cast<real64>(total_time) / static_cast<real64>(buffer_count * buffer_size);
+}
+
+BENCHMARK(mix_channel_buffers) {
+	// Channel copies, mono to stereo, and stereo to mono cover every mixing path the executor takes
+	static constexpr uint32 k_channel_counts[][2] = { { 2, 2 }, { 1, 2 }, { 2, 1 } };
+
+	for (const auto &channel_counts : k_channel_counts) {
+		for (e_buffer_input_mode input_mode : iterate_enum<e_buffer_input_mode>()) {
+			for (size_t buffer_size : k_benchmark_buffer_sizes) {
+				std::string configuration = "channels=" + std::to_string(channel_counts[0])
+					+ "->" + std::to_string(channel_counts[1])
+					+ " input=" + k_buffer_input_mode_names[enum_index(input_mode)]
+					+ " buffer=" + std::to_string(buffer_size);
+
+				real64 time = run_mix_channel_buffers(buffer_size, channel_counts[0], channel_counts[1], input_mode);
+				report_benchmark_result(configuration.c_str(), "mix", time, "ns/sample");
+			}
+		}
+	}
+}
+
+static real64 run_convert_and_interleave(size_t buffer_size, uint32 channel_count, e_buffer_input_mode input_mode) {
+	c_benchmark_real_buffers channel_buffers;
+	channel_buffers.initialize(channel_count, buffer_size);
+	for (uint32 channel = 0; channel < channel_count; channel++) {
+		fill_input(channel_buffers, channel, input_mode);
+	}
+
+	std::vector<uint8> stream_output_buffer(buffer_size * channel_count * sizeof(real32));
+	c_wrapped_array<uint8> stream_output(stream_output_buffer.data(), stream_output_buffer.size());
+
+	size_t buffer_count = (k_benchmark_sample_count + buffer_size - 1) / buffer_size;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t buffer_index = 0; buffer_index < buffer_count; buffer_index++) {
+		convert_and_interleave_to_stream_output_buffer(
+			static_cast<uint32>(buffer_size),
+			channel_buffers.get_buffers(),
+			e_sample_format::k_float32,
+			stream_output);
+	}
+
+	int64 total_time = stopwatch.query();
+
+	// Normalize by frames rather than by channel samples so that this is comparable to the executor's cost per frame
+	return static_cast<real64>(total_time) / static_cast<real64>(buffer_count * buffer_size);
+}
+
+BENCHMARK(convert_and_interleave_to_stream_output_buffer) {
+	static constexpr uint32 k_channel_counts[] = { 1, 2, 8 };
+
+	for (uint32 channel_count : k_channel_counts) {
+		for (e_buffer_input_mode input_mode : iterate_enum<e_buffer_input_mode>()) {
+			for (size_t buffer_size : k_benchmark_buffer_sizes) {
+				std::string configuration = "channels=" + std::to_string(channel_count)
+					+ " input=" + k_buffer_input_mode_names[enum_index(input_mode)]
+					+ " buffer=" + std::to_string(buffer_size);
+
+				real64 time = run_convert_and_interleave(buffer_size, channel_count, input_mode);
+				report_benchmark_result(configuration.c_str(), "float32", time, "ns/frame");
+			}
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#include "benchmarks/benchmark.h"
+
+#include "common/math/math.h"
+#include "common/utility/aligned_allocator.h"
+#include "common/utility/stopwatch.h"
+
+#include "engine/task_functions/filter/comb_feedback.h"
+
+#include <string>
+#include <vector>
+
+// These benchmarks measure the cost of activating a comb feedback voice, which should not depend on the delay length
+
+static constexpr size_t k_comb_feedback_activation_count = 1024;
+static constexpr size_t k_comb_feedback_buffer_size = 256;
+static constexpr real32 k_comb_feedback_feedback = 0.5f;
+
+// Resets the comb filter and processes a single buffer, which is what happens when a note is triggered
+static real64 run_comb_feedback_activation(uint32 delay) {
+	c_stack_allocator::c_memory_calculator memory_calculator;
+	memory_calculator.add<c_comb_feedback>();
+	c_comb_feedback::calculate_memory(delay, memory_calculator);
+
+	c_aligned_allocator<uint8, k_simd_alignment> memory;
+	memory.allocate(memory_calculator.get_size_alignment().size);
+
+	c_stack_allocator allocator(memory.get_array());
+	c_comb_feedback *comb_feedback;
+	allocator.allocate(comb_feedback);
+	comb_feedback->initialize(delay, allocator);
+
+	std::vector<real32> input(k_comb_feedback_buffer_size);
+	std::vector<real32> history(k_comb_feedback_buffer_size);
+	std::vector<real32> output(k_comb_feedback_buffer_size);
+	for (size_t index = 0; index < k_comb_feedback_buffer_size; index++) {
+		input[index] = static_cast<real32>(index % 17) / 17.0f - 0.5f;
+	}
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t activation_index = 0; activation_index < k_comb_feedback_activation_count; activation_index++) {
+		comb_feedback->reset();
+		comb_feedback->read_history(delay, history.data(), k_comb_feedback_buffer_size);
+		for (real32 &value : history) {
+			value *= k_comb_feedback_feedback;
+		}
+
+		comb_feedback->write_history(input.data(), history.data(), output.data(), k_comb_feedback_buffer_size);
+	}
+
+	int64 total_time = stopwatch.query();
+
+	allocator.release_no_destructors();
+
+	return static_cast<real64>(total_time) / static_cast<real64>(k_comb_feedback_activation_count);
+}
+
+BENCHMARK(comb_feedback_activation) {
+	static constexpr uint32 k_delays[] = { 256, 4096, 65536, 1048576 };
+	for (uint32 delay : k_delays) {
+		std::string configuration = "delay=" + std::to_string(delay);
+		real64 activation_time = run_comb_feedback_activation(delay);
+		report_benchmark_result(configuration.c_str(), "activation", activation_time, "ns/activation");
+	}
+}
@@ -0,0 +1,201 @@
+#include "benchmarks/benchmark.h"
+
+#include "common/utility/stopwatch.h"
+
+#include "engine/controller.h"
+#include "engine/events/event_data_types.h"
+#include "engine/executor/executor.h"
+#include "engine/runtime_instrument.h"
+#include "engine/task_function_registration.h"
+#include "engine/task_function_registry.h"
+#include "engine/task_functions/scrape_task_functions.h"
+
+#include "instrument/instrument.h"
+#include "instrument/native_module_registration.h"
+#include "instrument/native_module_registry.h"
+#include "instrument/native_modules/scrape_native_modules.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// These benchmarks measure the cost of processing whole chunks through the executor using a compiled instrument. This
+// covers task scheduling, voice allocation, and channel mixing in addition to the task functions themselves.
+
+static constexpr uint32 k_executor_sample_rate = 44100;
+static constexpr uint32 k_executor_output_channel_count = 2;
+static constexpr uint32 k_executor_voice_count = 8;
+static constexpr int32 k_executor_first_note_id = 60;
+static constexpr uint32 k_executor_thread_counts[] = { 0, 1, 2, 4 };
+
+// Presses a chord at the start of the run and holds it so that every chunk processes the same number of voices
+static size_t process_controller_events(
+	void *context,
+	c_wrapped_array<s_timestamped_controller_event> controller_events,
+	real64 buffer_time_sec,
+	real64 buffer_duration_sec) {
+	if (buffer_time_sec > 0.0) {
+		return 0;
+	}
+
+	size_t controller_event_count = std::min<size_t>(k_executor_voice_count, controller_events.get_count());
+	for (size_t index = 0; index < controller_event_count; index++) {
+		s_timestamped_controller_event &event = controller_events[index];
+		event.timestamp_sec = 0.0;
+		event.controller_event.event_type = e_controller_event_type::k_note_on;
+		s_controller_event_data_note_on *event_data =
+			event.controller_event.get_data<s_controller_event_data_note_on>();
+		event_data->note_id = k_executor_first_note_id + static_cast<int32>(index);
+		event_data->velocity = 1.0f;
+	}
+
+	return controller_event_count;
+}
+
+static bool load_runtime_instrument(const char *fname, c_runtime_instrument &runtime_instrument) {
+	c_instrument instrument;
+	e_instrument_result load_result = instrument.load(fname);
+	if (load_result != e_instrument_result::k_success) {
+		std::cout << "  Failed to load '" << fname << "' (result code " << enum_index(load_result) << ")\n";
+		return false;
+	}
+
+	s_instrument_variant_requirements requirements;
+	requirements.sample_rate = k_executor_sample_rate;
+
+	uint32 instrument_variant_index;
+	e_instrument_variant_for_requirements_result instrument_variant_result =
+		instrument.get_instrument_variant_for_requirements(requirements, instrument_variant_index);
+	if (instrument_variant_result != e_instrument_variant_for_requirements_result::k_success) {
+		std::cout << "  Failed to find a single instrument variant for a " << k_executor_sample_rate
+			<< "Hz sample rate\n";
+		return false;
+	}
+
+	if (!runtime_instrument.build(instrument.get_instrument_variant(instrument_variant_index))) {
+		std::cout << "  Failed to build runtime instrument\n";
+		return false;
+	}
+
+	return true;
+}
+
+static real64 run_executor(
+	const c_runtime_instrument &runtime_instrument,
+	c_wrapped_array<void *> task_function_library_contexts,
+	uint32 thread_count,
+	uint32 buffer_size) {
+	s_executor_settings settings;
+	settings.runtime_instrument = &runtime_instrument;
+	settings.thread_count = thread_count;
+	settings.process_voices_concurrently = thread_count > 0;
+	settings.voice_batch_size = 1;
+	settings.deadline_policy = e_deadline_policy::k_none;
+	settings.deadline_threshold = 1.0f;
+	settings.sample_rate = k_executor_sample_rate;
+	settings.sample_format = e_sample_format::k_float32;
+	settings.max_buffer_size = buffer_size;
+	settings.fixed_buffer_size = true;
+	settings.input_channel_count = 0;
+	settings.output_channel_count = k_executor_output_channel_count;
+	settings.processing_chunk_size = 0;
+	settings.controller_event_queue_size = k_executor_voice_count;
+	settings.max_controller_parameters = 1024;
+	settings.process_controller_events = process_controller_events;
+	settings.process_controller_events_context = nullptr;
+	settings.event_console_enabled = false;
+	settings.profiling_enabled = false;
+	settings.profiling_threshold = 0.0f;
+	settings.profiling_trace_chunk_count = 0;
+
+	c_executor executor;
+	executor.initialize(settings, task_function_library_contexts);
+
+	std::vector<uint8> output_buffer(buffer_size * k_executor_output_channel_count * sizeof(real32));
+
+	s_executor_chunk_context chunk_context;
+	chunk_context.sample_rate = k_executor_sample_rate;
+	chunk_context.frames = buffer_size;
+	chunk_context.input_channel_count = 0;
+	chunk_context.input_sample_format = e_sample_format::k_float32;
+	chunk_context.input_buffer = c_wrapped_array<const uint8>();
+	chunk_context.output_channel_count = k_executor_output_channel_count;
+	chunk_context.output_sample_format = e_sample_format::k_float32;
+	chunk_context.output_buffer = c_wrapped_array<uint8>(output_buffer.data(), output_buffer.size());
+
+	size_t buffer_count = (k_benchmark_sample_count + buffer_size - 1) / buffer_size;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t buffer_index = 0; buffer_index < buffer_count; buffer_index++) {
+		chunk_context.buffer_time_sec =
+			static_cast<real64>(buffer_index * buffer_size) / static_cast<real64>(k_executor_sample_rate);
+		executor.execute(chunk_context);
+	}
+
+	int64 total_time = stopwatch.query();
+	executor.shutdown();
+
+	return static_cast<real64>(total_time) / static_cast<real64>(buffer_count * buffer_size);
+}
+
+BENCHMARK(executor) {
+	const char *instrument_path = get_benchmark_instrument_path();
+	if (!instrument_path) {
+		std::cout << "  Skipped, no instrument was provided\n";
+		return;
+	}
+
+	scrape_native_modules();
+	scrape_task_functions();
+
+	c_native_module_registry::initialize();
+	c_task_function_registry::initialize();
+
+	if (register_native_modules() && register_task_functions()) {
+		std::vector<void *> library_contexts(c_task_function_registry::get_task_function_library_count(), nullptr);
+		for (h_task_function_library library_handle : c_task_function_registry::iterate_task_function_libraries()) {
+			const s_task_function_library &library =
+				c_task_function_registry::get_task_function_library(library_handle);
+			if (library.engine_initializer) {
+				library_contexts[library_handle.get_data()] = library.engine_initializer();
+			}
+		}
+
+		initialize_event_data_types();
+
+		c_runtime_instrument runtime_instrument;
+		if (load_runtime_instrument(instrument_path, runtime_instrument)) {
+			for (uint32 thread_count : k_executor_thread_counts) {
+				for (size_t buffer_size : k_benchmark_buffer_sizes) {
+					std::string configuration = "threads=" + std::to_string(thread_count)
+						+ " voices=" + std::to_string(k_executor_voice_count)
+						+ " buffer=" + std::to_string(buffer_size);
+
+					real64 time = run_executor(
+						runtime_instrument,
+						c_wrapped_array<void *>(library_contexts.data(), library_contexts.size()),
+						thread_count,
+						static_cast<uint32>(buffer_size));
+					report_benchmark_result(configuration.c_str(), "chunk", time, "ns/frame");
+				}
+			}
+		}
+
+		for (h_task_function_library library_handle : c_task_function_registry::iterate_task_function_libraries()) {
+			const s_task_function_library &library =
+				c_task_function_registry::get_task_function_library(library_handle);
+			if (library.engine_deinitializer) {
+				library.engine_deinitializer(library_contexts[library_handle.get_data()]);
+			}
+		}
+	} else {
+		std::cout << "  Failed to register native modules and task functions\n";
+	}
+
+	c_task_function_registry::shutdown();
+	c_native_module_registry::shutdown();
+}
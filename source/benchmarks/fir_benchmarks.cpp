@@ -0,0 +1,155 @@
+#include "benchmarks/benchmark.h"
+
+#include "common/math/math.h"
+#include "common/utility/aligned_allocator.h"
+#include "common/utility/stopwatch.h"
+
+#include "engine/task_functions/filter/fir.h"
+#include "engine/task_functions/filter/fir_kernels.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+// These benchmarks measure FIR processing cost per sample for direct convolution and for partitioned FFT convolution
+
+// Total number of samples processed for each configuration, rounded up to a whole number of buffers
+static constexpr size_t k_fir_sample_count = 1 << 18;
+
+// Direct convolution is skipped above this coefficient count because it takes too long to be useful
+static constexpr size_t k_max_direct_coefficient_count = 65536;
+
+struct s_fir_benchmark_memory {
+	c_aligned_allocator<uint8, k_simd_alignment> coefficients_memory;
+	c_aligned_allocator<uint8, k_simd_alignment> fir_memory;
+};
+
+static real64 run_fir(
+	c_wrapped_array<const real32> coefficients,
+	size_t buffer_size,
+	bool partitioning_enabled) {
+	s_fir_benchmark_memory memory;
+
+	c_stack_allocator::c_memory_calculator coefficients_calculator;
+	coefficients_calculator.add<c_fir_coefficients>();
+	c_fir_coefficients::calculate_memory(coefficients.get_count(), coefficients_calculator, partitioning_enabled);
+	memory.coefficients_memory.allocate(coefficients_calculator.get_size_alignment().size);
+
+	c_stack_allocator::c_memory_calculator fir_calculator;
+	fir_calculator.add<c_fir>();
+	c_fir::calculate_memory(coefficients.get_count(), fir_calculator, partitioning_enabled);
+	memory.fir_memory.allocate(fir_calculator.get_size_alignment().size);
+
+	c_stack_allocator coefficients_allocator(memory.coefficients_memory.get_array());
+	c_fir_coefficients *fir_coefficients;
+	coefficients_allocator.allocate(fir_coefficients);
+	fir_coefficients->initialize(coefficients, coefficients_allocator, partitioning_enabled);
+
+	c_stack_allocator fir_allocator(memory.fir_memory.get_array());
+	c_fir *fir;
+	fir_allocator.allocate(fir);
+	fir->initialize(coefficients.get_count(), fir_allocator, partitioning_enabled);
+
+	std::vector<real32> input(buffer_size);
+	std::vector<real32> output(buffer_size);
+	for (size_t index = 0; index < buffer_size; index++) {
+		input[index] = static_cast<real32>(index % 17) / 17.0f - 0.5f;
+	}
+
+	size_t buffer_count = (k_fir_sample_count + buffer_size - 1) / buffer_size;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t buffer_index = 0; buffer_index < buffer_count; buffer_index++) {
+		fir->process(*fir_coefficients, input.data(), output.data(), buffer_size);
+	}
+
+	int64 total_time = stopwatch.query();
+
+	coefficients_allocator.release_no_destructors();
+	fir_allocator.release_no_destructors();
+
+	return static_cast<real64>(total_time) / static_cast<real64>(buffer_count * buffer_size);
+}
+
+BENCHMARK(fir_convolution) {
+	static constexpr size_t k_coefficient_counts[] = { 64, 512, 4096, 16384, 65536, 200000 };
+	static constexpr size_t k_buffer_sizes[] = { 64, 256, 441 };
+
+	for (size_t coefficient_count : k_coefficient_counts) {
+		// An exponentially decaying noise-like response, similar to a reverb tail
+		std::vector<real32> coefficients(coefficient_count);
+		uint32 seed = 1;
+		for (size_t index = 0; index < coefficient_count; index++) {
+			seed = seed * 1664525u + 1013904223u;
+			real32 noise = static_cast<real32>(seed >> 8) / static_cast<real32>(1 << 24) - 0.5f;
+			coefficients[index] =
+				noise * std::exp(-6.0f * static_cast<real32>(index) / static_cast<real32>(coefficient_count));
+		}
+
+		for (size_t buffer_size : k_buffer_sizes) {
+			std::string configuration = "taps=" + std::to_string(coefficient_count)
+				+ " buffer=" + std::to_string(buffer_size);
+
+			if (coefficient_count <= k_max_direct_coefficient_count) {
+				real64 direct_time = run_fir(coefficients, buffer_size, false);
+				report_benchmark_result(configuration.c_str(), "direct", direct_time, "ns/sample");
+			}
+
+			real64 partitioned_time = run_fir(coefficients, buffer_size, true);
+			report_benchmark_result(configuration.c_str(), "partitioned", partitioned_time, "ns/sample");
+		}
+	}
+}
+
+static real64 run_fir_convolve_kernel(const s_fir_kernels &fir_kernels, size_t coefficient_count) {
+	c_aligned_allocator<real32, k_simd_alignment> coefficients;
+	c_aligned_allocator<real32, k_simd_alignment> history;
+	coefficients.allocate(coefficient_count);
+	history.allocate(coefficient_count * 2);
+	for (size_t index = 0; index < coefficient_count * 2; index++) {
+		real32 value = static_cast<real32>(index % 17) / 17.0f - 0.5f;
+		history.get_array()[index] = value;
+		if (index < coefficient_count) {
+			coefficients.get_array()[index] = value;
+		}
+	}
+
+	// Step through the history buffer the same way c_fir does so that most history loads are unaligned
+	real32 sum = 0.0f;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t sample_index = 0; sample_index < k_fir_sample_count; sample_index++) {
+		sum += fir_kernels.convolve(
+			coefficients.get_array().get_pointer(),
+			&history.get_array()[1 + sample_index % coefficient_count],
+			coefficient_count);
+	}
+
+	int64 total_time = stopwatch.query();
+	volatile real32 result = sum;
+	return static_cast<real64>(total_time) / static_cast<real64>(k_fir_sample_count);
+}
+
+BENCHMARK(fir_kernels) {
+	// Compares each SIMD tier compiled into this build which the CPU supports
+	static constexpr size_t k_coefficient_counts[] = { 64, 512, 4096 };
+
+	for (e_simd_tier simd_tier : iterate_enum<e_simd_tier>()) {
+		const s_fir_kernels *fir_kernels = get_fir_kernels(simd_tier);
+		if (!fir_kernels || enum_index(simd_tier) > enum_index(get_simd_tier())) {
+			continue;
+		}
+
+		for (size_t coefficient_count : k_coefficient_counts) {
+			std::string configuration = "taps=" + std::to_string(coefficient_count);
+			real64 time = run_fir_convolve_kernel(*fir_kernels, coefficient_count);
+			report_benchmark_result(configuration.c_str(), get_simd_tier_name(simd_tier), time, "ns/sample");
+		}
+	}
+}
@@ -0,0 +1,156 @@
+#include "benchmarks/benchmark.h"
+#include "benchmarks/benchmark_buffer.h"
+
+#include "common/utility/stopwatch.h"
+
+#include "engine/task_functions/filter/iir_sos.h"
+
+#include <string>
+
+// These benchmarks measure the per-sample cost of second-order section IIR filters with fixed and animated coefficients
+
+// A stable low-pass section. Animated coefficients wobble slightly around these values.
+static constexpr real32 k_b0 = 0.2f;
+static constexpr real32 k_b1 = 0.4f;
+static constexpr real32 k_b2 = 0.2f;
+static constexpr real32 k_a1 = -0.5f;
+static constexpr real32 k_a2 = 0.1f;
+static constexpr real32 k_coefficient_animation_range = 0.01f;
+
+enum class e_iir_order {
+	k_first,
+	k_second,
+
+	k_count
+};
+
+static constexpr const char *k_iir_order_names[] = { "first", "second" };
+STATIC_ASSERT(array_count(k_iir_order_names) == enum_count<e_iir_order>());
+
+enum class e_iir_coefficient_mode {
+	k_constant,
+	k_animated,
+
+	k_count
+};
+
+static constexpr const char *k_iir_coefficient_mode_names[] = { "constant", "animated" };
+STATIC_ASSERT(array_count(k_iir_coefficient_mode_names) == enum_count<e_iir_coefficient_mode>());
+
+// Buffers 0-4 hold b0, b1, b2, a1, and a2 for each voice, followed by each voice's input and output
+static void initialize_iir_buffers(
+	c_benchmark_real_buffers &buffers,
+	size_t voice_count,
+	size_t buffer_size,
+	e_iir_coefficient_mode coefficient_mode) {
+	static constexpr real32 k_coefficients[] = { k_b0, k_b1, k_b2, k_a1, k_a2 };
+
+	buffers.initialize(array_count(k_coefficients) + voice_count * 2, buffer_size);
+	for (size_t index = 0; index < array_count(k_coefficients); index++) {
+		if (coefficient_mode == e_iir_coefficient_mode::k_constant) {
+			buffers.fill_constant(index, k_coefficients[index]);
+		} else {
+			buffers.fill_dynamic(index, k_coefficients[index], k_coefficient_animation_range);
+		}
+	}
+
+	for (size_t voice = 0; voice < voice_count; voice++) {
+		buffers.fill_dynamic(array_count(k_coefficients) + voice * 2);
+	}
+}
+
+static void initialize_iir(c_reentrant_iir_sos &iir, c_benchmark_real_buffers &buffers, e_iir_order order) {
+	if (order == e_iir_order::k_first) {
+		iir.initialize_first_order(buffers.get(0), buffers.get(1), buffers.get(3));
+	} else {
+		iir.initialize(buffers.get(0), buffers.get(1), buffers.get(2), buffers.get(3), buffers.get(4));
+	}
+}
+
+static real64 run_iir(size_t buffer_size, e_iir_order order, e_iir_coefficient_mode coefficient_mode) {
+	c_benchmark_real_buffers buffers;
+	initialize_iir_buffers(buffers, 1, buffer_size, coefficient_mode);
+
+	c_reentrant_iir_sos iir;
+	initialize_iir(iir, buffers, order);
+
+	s_iir_sos_state state;
+	state.reset();
+
+	const real32 *input = buffers.get(5)->get_data();
+	real32 *output = buffers.get(6)->get_data();
+	size_t buffer_count = (k_benchmark_sample_count + buffer_size - 1) / buffer_size;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t buffer_index = 0; buffer_index < buffer_count; buffer_index++) {
+		if (order == e_iir_order::k_first) {
+			iir.process_first_order(state, input, output, buffer_size);
+		} else {
+			iir.process(state, input, output, buffer_size);
+		}
+	}
+
+	int64 total_time = stopwatch.query();
+	return static_cast<real64>(total_time) / static_cast<real64>(buffer_count * buffer_size);
+}
+
+static real64 run_iir_voices(size_t buffer_size, e_iir_order order, e_iir_coefficient_mode coefficient_mode) {
+	static constexpr size_t k_voice_count = c_reentrant_iir_sos::k_max_voices;
+
+	c_benchmark_real_buffers buffers;
+	initialize_iir_buffers(buffers, k_voice_count, buffer_size, coefficient_mode);
+
+	s_static_array<c_reentrant_iir_sos, k_voice_count> iirs;
+	s_static_array<s_iir_sos_state, k_voice_count> states;
+	s_static_array<s_iir_sos_state *, k_voice_count> state_pointers;
+	s_static_array<const c_real_buffer *, k_voice_count> inputs;
+	s_static_array<real32 *, k_voice_count> outputs;
+	for (size_t voice = 0; voice < k_voice_count; voice++) {
+		initialize_iir(iirs[voice], buffers, order);
+		states[voice].reset();
+		state_pointers[voice] = &states[voice];
+		inputs[voice] = buffers.get(5 + voice * 2);
+		outputs[voice] = buffers.get(6 + voice * 2)->get_data();
+	}
+
+	size_t buffer_count = (k_benchmark_sample_count + buffer_size - 1) / buffer_size;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t buffer_index = 0; buffer_index < buffer_count; buffer_index++) {
+		c_reentrant_iir_sos::process_voices(
+			c_wrapped_array<c_reentrant_iir_sos>(iirs.get_elements(), k_voice_count),
+			c_wrapped_array<s_iir_sos_state *const>(state_pointers.get_elements(), k_voice_count),
+			c_wrapped_array<const c_real_buffer *const>(inputs.get_elements(), k_voice_count),
+			c_wrapped_array<real32 *const>(outputs.get_elements(), k_voice_count),
+			buffer_size);
+	}
+
+	int64 total_time = stopwatch.query();
+
+	// Report the cost per voice sample so this is directly comparable with processing a single voice
+	return static_cast<real64>(total_time) / static_cast<real64>(buffer_count * buffer_size * k_voice_count);
+}
+
+BENCHMARK(iir_sos) {
+	for (e_iir_order order : iterate_enum<e_iir_order>()) {
+		for (e_iir_coefficient_mode coefficient_mode : iterate_enum<e_iir_coefficient_mode>()) {
+			for (size_t buffer_size : k_benchmark_buffer_sizes) {
+				std::string configuration = std::string("order=") + k_iir_order_names[enum_index(order)]
+					+ " coefficients=" + k_iir_coefficient_mode_names[enum_index(coefficient_mode)]
+					+ " buffer=" + std::to_string(buffer_size);
+
+				real64 single_time = run_iir(buffer_size, order, coefficient_mode);
+				report_benchmark_result(configuration.c_str(), "single_voice", single_time, "ns/sample");
+
+				real64 voices_time = run_iir_voices(buffer_size, order, coefficient_mode);
+				report_benchmark_result(configuration.c_str(), "voice_batch", voices_time, "ns/sample");
+			}
+		}
+	}
+}
@@ -0,0 +1,346 @@
+#include "benchmarks/benchmark.h"
+
+#include "common/math/math.h"
+#include "common/utility/stopwatch.h"
+
+#include "engine/resampler/resampler.h"
+#include "engine/task_functions/sampler/fetch_sample.h"
+#include "engine/task_functions/sampler/sample.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// These benchmarks measure the per-sample cost of sample interpolation and of the polyphase resampling filters. These
+// kernels are called once per output sample, so they are measured across playback speeds rather than buffer sizes.
+
+static constexpr const char *k_benchmark_sample_filename = "benchmark_sample.wav";
+static constexpr uint32 k_benchmark_sample_rate = 44100;
+static constexpr uint32 k_benchmark_sample_frame_count = 44100;
+static constexpr uint32 k_wavetable_harmonic_count = 32;
+static constexpr real32 k_stream_sample_rate = 48000.0f;
+static constexpr real32 k_speeds[] = { 1.0f, 0.73f, 2.41f };
+
+// Writes a mono 16-bit PCM sine wave so that fetch_sample() can be measured without depending on any data files
+static bool write_benchmark_sample(const char *filename) {
+	std::ofstream file(filename, std::ios::binary);
+	if (file.fail()) {
+		return false;
+	}
+
+	auto write_uint32 = [&file](uint32 value) {
+		uint32 raw_value = native_to_little_endian(value);
+		file.write(reinterpret_cast<const char *>(&raw_value), sizeof(raw_value));
+	};
+
+	auto write_uint16 = [&file](uint16 value) {
+		uint16 raw_value = native_to_little_endian(value);
+		file.write(reinterpret_cast<const char *>(&raw_value), sizeof(raw_value));
+	};
+
+	auto write_fourcc = [&file](const char *fourcc) {
+		file.write(fourcc, 4);
+	};
+
+	uint32 data_size = k_benchmark_sample_frame_count * sizeof(int16);
+	write_fourcc("RIFF");
+	write_uint32(20 + 16 + data_size);
+	write_fourcc("WAVE");
+	write_fourcc("fmt ");
+	write_uint32(16);
+	write_uint16(1);
+	write_uint16(1);
+	write_uint32(k_benchmark_sample_rate);
+	write_uint32(k_benchmark_sample_rate * sizeof(int16));
+	write_uint16(sizeof(int16));
+	write_uint16(16);
+	write_fourcc("data");
+	write_uint32(data_size);
+
+	for (uint32 frame = 0; frame < k_benchmark_sample_frame_count; frame++) {
+		real64 phase = 2.0 * k_pi<real64> * 440.0 * static_cast<real64>(frame) / k_benchmark_sample_rate;
+		write_uint16(static_cast<uint16>(static_cast<int16>(std::sin(phase) * 16384.0)));
+	}
+
+	return !file.fail();
+}
+
+static real64 run_fetch_sample(const c_sample *sample, real32 speed) {
+	real64 loop_start = static_cast<real64>(sample->get_loop_start());
+	real64 loop_end = static_cast<real64>(sample->get_loop_end());
+	real64 advance = static_cast<real64>(speed * static_cast<real32>(sample->get_sample_rate()) / k_stream_sample_rate);
+
+	// Accumulate the results so the compiler can't skip the fetches
+	real32 sum = 0.0f;
+	real64 sample_index = loop_start;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t index = 0; index < k_benchmark_sample_count; index++) {
+		sum += fetch_sample(sample, sample_index);
+		sample_index += advance;
+		if (sample_index >= loop_end) {
+			sample_index -= loop_end - loop_start;
+		}
+	}
+
+	int64 total_time = stopwatch.query();
+	volatile real32 result = sum;
+	return static_cast<real64>(total_time) / static_cast<real64>(k_benchmark_sample_count);
+}
+
+static real64 run_fetch_wavetable_sample(const c_sample *sample, real32 speed) {
+	real64 loop_end = static_cast<real64>(sample->get_loop_end());
+	real64 advance = static_cast<real64>(speed * static_cast<real32>(sample->get_sample_rate()) / k_stream_sample_rate);
+
+	real32 sum = 0.0f;
+	real64 sample_index = 0.0;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t index = 0; index < k_benchmark_sample_count; index++) {
+		sum += fetch_wavetable_sample(
+			sample,
+			k_stream_sample_rate,
+			static_cast<real32>(sample->get_sample_rate()),
+			speed,
+			sample_index);
+		sample_index += advance;
+		if (sample_index >= loop_end) {
+			sample_index -= loop_end;
+		}
+	}
+
+	int64 total_time = stopwatch.query();
+	volatile real32 result = sum;
+	return static_cast<real64>(total_time) / static_cast<real64>(k_benchmark_sample_count);
+}
+
+// Measures the block versions of the fetch functions, which is how samplers call them
+static real64 run_fetch_sample_blocks(const c_sample *sample, bool is_wavetable, real32 speed) {
+	real64 loop_start = is_wavetable ? 0.0 : static_cast<real64>(sample->get_loop_start());
+	real64 loop_end = static_cast<real64>(sample->get_loop_end());
+	real64 advance = static_cast<real64>(speed * static_cast<real32>(sample->get_sample_rate()) / k_stream_sample_rate);
+
+	real32 sum = 0.0f;
+	real64 sample_index = loop_start;
+	real64 sample_indices[k_fetch_sample_block_size];
+	real32 results[k_fetch_sample_block_size];
+	size_t block_count = k_benchmark_sample_count / k_fetch_sample_block_size;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t block_index = 0; block_index < block_count; block_index++) {
+		for (size_t index = 0; index < k_fetch_sample_block_size; index++) {
+			sample_indices[index] = sample_index;
+			sample_index += advance;
+			if (sample_index >= loop_end) {
+				sample_index -= loop_end - loop_start;
+			}
+		}
+
+		if (is_wavetable) {
+			fetch_wavetable_samples(
+				sample,
+				k_stream_sample_rate,
+				static_cast<real32>(sample->get_sample_rate()),
+				speed,
+				sample_indices,
+				k_fetch_sample_block_size,
+				results);
+		} else {
+			fetch_samples(sample, sample_indices, k_fetch_sample_block_size, results);
+		}
+
+		sum += results[0];
+	}
+
+	int64 total_time = stopwatch.query();
+	volatile real32 result = sum;
+	return static_cast<real64>(total_time) / static_cast<real64>(block_count * k_fetch_sample_block_size);
+}
+
+BENCHMARK(fetch_sample) {
+	// Compact storage formats trade interpolation quality for less memory and bandwidth per fetched sample
+	static constexpr e_sample_storage_format k_storage_formats[] = {
+		e_sample_storage_format::k_interpolation_coefficients,
+		e_sample_storage_format::k_real32,
+		e_sample_storage_format::k_int16
+	};
+
+	static constexpr const char *k_storage_format_names[] = {
+		"single",
+		"single_real32",
+		"single_int16"
+	};
+
+	STATIC_ASSERT(array_count(k_storage_formats) == array_count(k_storage_format_names));
+
+	if (!write_benchmark_sample(k_benchmark_sample_filename)) {
+		std::cout << "  Failed to generate benchmark sample\n";
+		return;
+	}
+
+	for (size_t format_index = 0; format_index < array_count(k_storage_formats); format_index++) {
+		std::vector<c_sample *> channel_samples;
+		if (!c_sample::load_file(
+			k_benchmark_sample_filename,
+			e_sample_loop_mode::k_loop,
+			false,
+			k_storage_formats[format_index],
+			false,
+			channel_samples)) {
+			std::cout << "  Failed to load benchmark sample\n";
+			continue;
+		}
+
+		std::unique_ptr<c_sample> sample(channel_samples[0]);
+		for (real32 speed : k_speeds) {
+			std::string configuration = "speed=" + std::to_string(speed);
+			real64 time = run_fetch_sample(sample.get(), speed);
+			report_benchmark_result(configuration.c_str(), k_storage_format_names[format_index], time, "ns/sample");
+
+			std::string block_result_name = std::string(k_storage_format_names[format_index]) + "_block";
+			real64 block_time = run_fetch_sample_blocks(sample.get(), false, speed);
+			report_benchmark_result(configuration.c_str(), block_result_name.c_str(), block_time, "ns/sample");
+		}
+	}
+
+	std::remove(k_benchmark_sample_filename);
+
+	// A sawtooth wavetable, which exercises blending between wavetable levels
+	std::vector<real32> harmonic_weights(k_wavetable_harmonic_count);
+	for (uint32 harmonic = 0; harmonic < k_wavetable_harmonic_count; harmonic++) {
+		harmonic_weights[harmonic] = 1.0f / static_cast<real32>(harmonic + 1);
+	}
+
+	std::unique_ptr<c_sample> wavetable(c_sample::generate_wavetable(
+		c_wrapped_array<const real32>(harmonic_weights.data(), harmonic_weights.size()),
+		false));
+	for (real32 speed : k_speeds) {
+		std::string configuration = "speed=" + std::to_string(speed);
+		real64 time = run_fetch_wavetable_sample(wavetable.get(), speed);
+		report_benchmark_result(configuration.c_str(), "wavetable", time, "ns/sample");
+
+		real64 block_time = run_fetch_sample_blocks(wavetable.get(), true, speed);
+		report_benchmark_result(configuration.c_str(), "wavetable_block", block_time, "ns/sample");
+	}
+}
+
+static real64 run_resampler(e_resampler_filter resampler_filter, real32 fractional_sample_index) {
+	const s_resampler_parameters &parameters = get_resampler_parameters(resampler_filter);
+	c_resampler resampler(parameters, get_resampler_phases(resampler_filter));
+
+	// The resampler reads taps_per_phase history samples ending at the sample index
+	static constexpr size_t k_history_length = 1024;
+	size_t history_extension = c_resampler::get_required_history_samples(parameters);
+	std::vector<real32> history(history_extension + k_history_length);
+	for (size_t index = 0; index < history.size(); index++) {
+		history[index] = static_cast<real32>(index % 17) / 17.0f - 0.5f;
+	}
+
+	c_wrapped_array<const real32> samples(history.data(), history.size());
+	real32 sum = 0.0f;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t index = 0; index < k_benchmark_sample_count; index++) {
+		sum += resampler.resample(samples, history_extension + (index % k_history_length), fractional_sample_index);
+	}
+
+	int64 total_time = stopwatch.query();
+	volatile real32 result = sum;
+	return static_cast<real64>(total_time) / static_cast<real64>(k_benchmark_sample_count);
+}
+
+static real64 run_resampler_block_kernel(
+	e_resampler_filter resampler_filter,
+	real32 fractional_sample_index,
+	uint32 sample_stride) {
+	const s_resampler_parameters &parameters = get_resampler_parameters(resampler_filter);
+	c_resampler_block_kernel kernel;
+	kernel.initialize(
+		parameters,
+		get_resampler_phases(resampler_filter),
+		c_wrapped_array<const real32>(&fractional_sample_index, 1),
+		sample_stride);
+
+	// Each block computes consecutive outputs from the same history buffer as run_resampler()
+	static constexpr size_t k_block_size = c_resampler_block_kernel::k_max_strided_output_count;
+	static constexpr size_t k_history_length = 1024;
+	std::vector<real32> history(kernel.get_required_sample_count(k_history_length));
+	for (size_t index = 0; index < history.size(); index++) {
+		history[index] = static_cast<real32>(index % 17) / 17.0f - 0.5f;
+	}
+
+	std::vector<real32> outputs(k_block_size);
+	real32 sum = 0.0f;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (size_t index = 0; index < k_benchmark_sample_count; index += k_block_size) {
+		size_t block_start = index % k_history_length;
+		kernel.process(&history[block_start * sample_stride], k_block_size, outputs.data());
+		sum += outputs[0];
+	}
+
+	int64 total_time = stopwatch.query();
+	volatile real32 result = sum;
+	return static_cast<real64>(total_time) / static_cast<real64>(k_benchmark_sample_count);
+}
+
+BENCHMARK(resampler) {
+	static constexpr e_resampler_filter k_resampler_filters[] = {
+		e_resampler_filter::k_upsample_low_quality,
+		e_resampler_filter::k_upsample_high_quality,
+		e_resampler_filter::k_downsample_2x_low_quality,
+		e_resampler_filter::k_downsample_2x_high_quality
+	};
+
+	static constexpr const char *k_resampler_filter_names[] = {
+		"upsample_low_quality",
+		"upsample_high_quality",
+		"downsample_2x_low_quality",
+		"downsample_2x_high_quality"
+	};
+
+	// Downsampling filters are evaluated once every downsample_factor input samples
+	static constexpr uint32 k_resampler_sample_strides[] = { 1, 1, 2, 2 };
+
+	STATIC_ASSERT(array_count(k_resampler_filters) == array_count(k_resampler_filter_names));
+	STATIC_ASSERT(array_count(k_resampler_filters) == array_count(k_resampler_sample_strides));
+
+	for (size_t filter_index = 0; filter_index < array_count(k_resampler_filters); filter_index++) {
+		std::string configuration = std::string("filter=") + k_resampler_filter_names[filter_index];
+
+		// Integer sample positions only evaluate a single phase while fractional positions blend two phases
+		real64 aligned_time = run_resampler(k_resampler_filters[filter_index], 0.0f);
+		report_benchmark_result(configuration.c_str(), "aligned", aligned_time, "ns/sample");
+
+		real64 fractional_time = run_resampler(k_resampler_filters[filter_index], 0.37f);
+		report_benchmark_result(configuration.c_str(), "fractional", fractional_time, "ns/sample");
+
+		// The block kernel computes a SIMD vector of consecutive outputs per pass with pre-blended coefficients
+		uint32 sample_stride = k_resampler_sample_strides[filter_index];
+		real64 block_aligned_time = run_resampler_block_kernel(k_resampler_filters[filter_index], 0.0f, sample_stride);
+		report_benchmark_result(configuration.c_str(), "block_aligned", block_aligned_time, "ns/sample");
+
+		real64 block_fractional_time =
+			run_resampler_block_kernel(k_resampler_filters[filter_index], 0.37f, sample_stride);
+		report_benchmark_result(configuration.c_str(), "block_fractional", block_fractional_time, "ns/sample");
+	}
+}
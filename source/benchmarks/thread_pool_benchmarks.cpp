@@ -0,0 +1,377 @@
+#include "benchmarks/benchmark.h"
+
+#include "common/threading/semaphore.h"
+#include "common/utility/stopwatch.h"
+
+#include "engine/thread_pool.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+// These benchmarks simulate the executor's voice scheduling using empty tasks so that the measured time is entirely
+// scheduling overhead
+
+static constexpr uint32 k_chunk_count = 2000;
+static constexpr uint32 k_tasks_per_voice = 4;
+
+// The task graph benchmarks run tiny tasks with dependencies between them to measure task throughput
+static constexpr uint32 k_task_graph_iterations = 1000;
+static constexpr uint32 k_task_work_iterations = 64;
+static constexpr uint32 k_wide_task_graph_width = 254;
+static constexpr uint32 k_deep_task_graph_chain_count = 4;
+static constexpr uint32 k_deep_task_graph_chain_length = 64;
+static constexpr uint32 k_invalid_synthetic_task = static_cast<uint32>(-1);
+
+enum class e_voice_scheduling_mode {
+	// Worker threads are resumed and paused around each voice and the calling thread blocks on a semaphore
+	k_per_voice,
+
+	// Worker threads are resumed and paused once per chunk and the calling thread executes tasks while it waits
+	k_per_chunk,
+
+	k_count
+};
+
+struct s_voice_context {
+	ALIGNAS_LOCK_FREE std::atomic<int32> tasks_remaining;
+	c_semaphore all_tasks_complete_signal;
+	bool notify_on_completion;
+};
+
+struct s_voice_task_parameters {
+	s_voice_context *voice_context;
+};
+
+struct s_voice_scheduling_result {
+	real64 nanoseconds_per_chunk;
+	real64 resumes_per_chunk;
+	real64 worker_wakeups_per_chunk;
+	real64 blocking_waits_per_chunk;
+};
+
+static void voice_task(uint32 thread_index, const s_thread_parameter_block *params) {
+	s_voice_context *voice_context = params->get_memory_typed<s_voice_task_parameters>()->voice_context;
+	bool notify = voice_context->notify_on_completion;
+	if (voice_context->tasks_remaining-- == 1 && notify) {
+		voice_context->all_tasks_complete_signal.notify();
+	}
+}
+
+static void add_voice_tasks(c_thread_pool &thread_pool, s_voice_context &voice_context) {
+	voice_context.tasks_remaining = k_tasks_per_voice;
+	for (uint32 task_index = 0; task_index < k_tasks_per_voice; task_index++) {
+		s_thread_pool_task task;
+		task.task_entry_point = voice_task;
+		task.parameter_block.get_memory_typed<s_voice_task_parameters>()->voice_context = &voice_context;
+		IF_ASSERTS_ENABLED(bool result = ) thread_pool.add_task(task);
+		wl_assert(result);
+	}
+}
+
+static s_voice_scheduling_result run_voice_scheduling(
+	e_voice_scheduling_mode mode,
+	uint32 thread_count,
+	uint32 voice_count) {
+	s_thread_pool_settings thread_pool_settings;
+	thread_pool_settings.thread_count = thread_count;
+	thread_pool_settings.max_tasks = k_tasks_per_voice;
+	thread_pool_settings.start_paused = true;
+
+	c_thread_pool thread_pool;
+	thread_pool.start(thread_pool_settings);
+
+	s_voice_context voice_context;
+	voice_context.tasks_remaining = 0;
+	voice_context.notify_on_completion = (mode == e_voice_scheduling_mode::k_per_voice);
+
+	uint32 resumes = 0;
+	uint32 blocking_waits = 0;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	for (uint32 chunk = 0; chunk < k_chunk_count; chunk++) {
+		if (mode == e_voice_scheduling_mode::k_per_voice) {
+			for (uint32 voice = 0; voice < voice_count; voice++) {
+				add_voice_tasks(thread_pool, voice_context);
+				thread_pool.resume();
+				resumes++;
+				voice_context.all_tasks_complete_signal.wait();
+				blocking_waits++;
+				thread_pool.pause();
+			}
+		} else {
+			wl_assert(mode == e_voice_scheduling_mode::k_per_chunk);
+			thread_pool.resume();
+			resumes++;
+			for (uint32 voice = 0; voice < voice_count; voice++) {
+				add_voice_tasks(thread_pool, voice_context);
+				while (voice_context.tasks_remaining > 0) {
+					if (!thread_pool.execute_task(thread_count)) {
+						c_thread::spin_wait_hint();
+					}
+				}
+			}
+			thread_pool.pause();
+		}
+	}
+
+	int64 total_time = stopwatch.query();
+	uint32 wakeup_count = thread_pool.get_wakeup_count();
+
+	IF_ASSERTS_ENABLED(uint32 unexecuted_tasks = ) thread_pool.stop();
+	wl_assert(unexecuted_tasks == 0);
+
+	s_voice_scheduling_result result;
+	result.nanoseconds_per_chunk = static_cast<real64>(total_time) / static_cast<real64>(k_chunk_count);
+	result.resumes_per_chunk = static_cast<real64>(resumes) / static_cast<real64>(k_chunk_count);
+	result.worker_wakeups_per_chunk = static_cast<real64>(wakeup_count) / static_cast<real64>(k_chunk_count);
+	result.blocking_waits_per_chunk = static_cast<real64>(blocking_waits) / static_cast<real64>(k_chunk_count);
+	return result;
+}
+
+BENCHMARK(voice_scheduling_overhead) {
+	static constexpr const char *k_mode_names[] = { "per_voice", "per_chunk" };
+	STATIC_ASSERT(is_enum_fully_mapped<e_voice_scheduling_mode>(k_mode_names));
+
+	static constexpr uint32 k_thread_counts[] = { 1, 2, 4 };
+	static constexpr uint32 k_voice_counts[] = { 8, 64 };
+
+	for (uint32 thread_count : k_thread_counts) {
+		for (uint32 voice_count : k_voice_counts) {
+			for (e_voice_scheduling_mode mode : iterate_enum<e_voice_scheduling_mode>()) {
+				s_voice_scheduling_result result = run_voice_scheduling(mode, thread_count, voice_count);
+
+				std::string configuration = std::string(k_mode_names[enum_index(mode)])
+					+ " threads=" + std::to_string(thread_count)
+					+ " voices=" + std::to_string(voice_count);
+				report_benchmark_result(configuration.c_str(), "chunk_time", result.nanoseconds_per_chunk, "ns");
+				report_benchmark_result(configuration.c_str(), "resumes", result.resumes_per_chunk, "per chunk");
+				report_benchmark_result(
+					configuration.c_str(),
+					"worker_wakeups",
+					result.worker_wakeups_per_chunk,
+					"per chunk");
+				report_benchmark_result(
+					configuration.c_str(),
+					"blocking_waits",
+					result.blocking_waits_per_chunk,
+					"per chunk");
+			}
+		}
+	}
+}
+
+enum class e_task_graph_shape {
+	// A single task fans out to many independent tasks which all join into a single final task
+	k_wide,
+
+	// A few independent long chains of tasks
+	k_deep,
+
+	k_count
+};
+
+enum class e_task_scheduling_mode {
+	// Every ready task is pushed onto the thread pool's shared queue
+	k_shared_queue,
+
+	// Ready tasks are pushed onto the executing thread's deque and the first ready successor runs inline
+	k_work_stealing,
+
+	k_count
+};
+
+struct s_synthetic_task_graph {
+	std::vector<std::vector<uint32>> task_successors;
+	std::vector<int32> task_predecessor_counts;
+	std::vector<uint32> initial_tasks;
+};
+
+struct s_synthetic_task_graph_context {
+	c_thread_pool *thread_pool;
+	e_task_scheduling_mode mode;
+	const s_synthetic_task_graph *task_graph;
+	std::unique_ptr<std::atomic<int32>[]> task_predecessors_remaining;
+	std::vector<uint32> task_results;
+	ALIGNAS_LOCK_FREE std::atomic<int32> tasks_remaining;
+};
+
+struct s_synthetic_task_parameters {
+	s_synthetic_task_graph_context *context;
+	uint32 task_index;
+};
+
+static void synthetic_task(uint32 thread_index, const s_thread_parameter_block *params);
+
+static s_synthetic_task_graph build_synthetic_task_graph(e_task_graph_shape shape) {
+	s_synthetic_task_graph task_graph;
+	auto add_task = [&]() {
+		task_graph.task_successors.emplace_back();
+		task_graph.task_predecessor_counts.push_back(0);
+		return cast_integer_verify<uint32>(task_graph.task_successors.size() - 1);
+	};
+
+	auto add_edge = [&](uint32 predecessor, uint32 successor) {
+		task_graph.task_successors[predecessor].push_back(successor);
+		task_graph.task_predecessor_counts[successor]++;
+	};
+
+	if (shape == e_task_graph_shape::k_wide) {
+		uint32 root_task = add_task();
+		uint32 final_task = add_task();
+		for (uint32 index = 0; index < k_wide_task_graph_width; index++) {
+			uint32 task = add_task();
+			add_edge(root_task, task);
+			add_edge(task, final_task);
+		}
+
+		task_graph.initial_tasks.push_back(root_task);
+	} else {
+		wl_assert(shape == e_task_graph_shape::k_deep);
+		for (uint32 chain = 0; chain < k_deep_task_graph_chain_count; chain++) {
+			uint32 previous_task = add_task();
+			task_graph.initial_tasks.push_back(previous_task);
+			for (uint32 index = 1; index < k_deep_task_graph_chain_length; index++) {
+				uint32 task = add_task();
+				add_edge(previous_task, task);
+				previous_task = task;
+			}
+		}
+	}
+
+	return task_graph;
+}
+
+static void add_synthetic_task(
+	s_synthetic_task_graph_context *context,
+	uint32 thread_index,
+	uint32 task_index) {
+	s_thread_pool_task task;
+	task.task_entry_point = synthetic_task;
+	s_synthetic_task_parameters *task_parameters = task.parameter_block.get_memory_typed<s_synthetic_task_parameters>();
+	task_parameters->context = context;
+	task_parameters->task_index = task_index;
+
+	IF_ASSERTS_ENABLED(bool result = ) (context->mode == e_task_scheduling_mode::k_shared_queue)
+		? context->thread_pool->add_task(task)
+		: context->thread_pool->add_task(thread_index, task);
+	wl_assert(result);
+}
+
+static void synthetic_task(uint32 thread_index, const s_thread_parameter_block *params) {
+	const s_synthetic_task_parameters *task_parameters = params->get_memory_typed<s_synthetic_task_parameters>();
+	s_synthetic_task_graph_context *context = task_parameters->context;
+
+	uint32 task_index = task_parameters->task_index;
+	while (task_index != k_invalid_synthetic_task) {
+		// Perform a small amount of work so that tasks aren't completely empty
+		uint32 value = task_index + 1;
+		for (uint32 iteration = 0; iteration < k_task_work_iterations; iteration++) {
+			value ^= value << 13;
+			value ^= value >> 17;
+			value ^= value << 5;
+		}
+
+		context->task_results[task_index] = value;
+
+		uint32 next_task_index = k_invalid_synthetic_task;
+		for (uint32 successor : context->task_graph->task_successors[task_index]) {
+			if (context->task_predecessors_remaining[successor]-- == 1) {
+				if (context->mode == e_task_scheduling_mode::k_work_stealing
+					&& next_task_index == k_invalid_synthetic_task) {
+					next_task_index = successor;
+				} else {
+					add_synthetic_task(context, thread_index, successor);
+				}
+			}
+		}
+
+		context->tasks_remaining--;
+		task_index = next_task_index;
+	}
+}
+
+static real64 run_synthetic_task_graph(
+	e_task_graph_shape shape,
+	e_task_scheduling_mode mode,
+	uint32 thread_count) {
+	s_synthetic_task_graph task_graph = build_synthetic_task_graph(shape);
+	uint32 task_count = cast_integer_verify<uint32>(task_graph.task_successors.size());
+
+	s_thread_pool_settings thread_pool_settings;
+	thread_pool_settings.thread_count = thread_count;
+	thread_pool_settings.max_tasks = task_count;
+	thread_pool_settings.start_paused = true;
+
+	c_thread_pool thread_pool;
+	thread_pool.start(thread_pool_settings);
+
+	s_synthetic_task_graph_context context;
+	context.thread_pool = &thread_pool;
+	context.mode = mode;
+	context.task_graph = &task_graph;
+	context.task_predecessors_remaining = std::make_unique<std::atomic<int32>[]>(task_count);
+	context.task_results.resize(task_count);
+	context.tasks_remaining = 0;
+
+	// The calling thread uses the thread index reserved for the external thread
+	uint32 calling_thread_index = thread_count;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	stopwatch.reset();
+
+	thread_pool.resume();
+	for (uint32 iteration = 0; iteration < k_task_graph_iterations; iteration++) {
+		for (uint32 task_index = 0; task_index < task_count; task_index++) {
+			context.task_predecessors_remaining[task_index] = task_graph.task_predecessor_counts[task_index];
+		}
+
+		context.tasks_remaining = cast_integer_verify<int32>(task_count);
+		for (uint32 task_index : task_graph.initial_tasks) {
+			add_synthetic_task(&context, calling_thread_index, task_index);
+		}
+
+		while (context.tasks_remaining > 0) {
+			if (!thread_pool.execute_task(calling_thread_index)) {
+				c_thread::spin_wait_hint();
+			}
+		}
+	}
+	thread_pool.pause();
+
+	int64 total_time = stopwatch.query();
+
+	IF_ASSERTS_ENABLED(uint32 unexecuted_tasks = ) thread_pool.stop();
+	wl_assert(unexecuted_tasks == 0);
+
+	real64 total_tasks = static_cast<real64>(task_count) * static_cast<real64>(k_task_graph_iterations);
+	return total_tasks * static_cast<real64>(k_nanoseconds_per_second) / static_cast<real64>(total_time);
+}
+
+BENCHMARK(task_graph_throughput) {
+	static constexpr const char *k_shape_names[] = { "wide", "deep" };
+	STATIC_ASSERT(is_enum_fully_mapped<e_task_graph_shape>(k_shape_names));
+
+	static constexpr const char *k_mode_names[] = { "shared_queue", "work_stealing" };
+	STATIC_ASSERT(is_enum_fully_mapped<e_task_scheduling_mode>(k_mode_names));
+
+	static constexpr uint32 k_thread_counts[] = { 1, 2, 4, 8, 16 };
+
+	for (e_task_graph_shape shape : iterate_enum<e_task_graph_shape>()) {
+		for (uint32 thread_count : k_thread_counts) {
+			for (e_task_scheduling_mode mode : iterate_enum<e_task_scheduling_mode>()) {
+				real64 tasks_per_second = run_synthetic_task_graph(shape, mode, thread_count);
+
+				std::string configuration = std::string(k_mode_names[enum_index(mode)])
+					+ " graph=" + k_shape_names[enum_index(shape)]
+					+ " threads=" + std::to_string(thread_count);
+				report_benchmark_result(configuration.c_str(), "throughput", tasks_per_second, "tasks/s", true);
+			}
+		}
+	}
+}
@@ -0,0 +1,231 @@
+#include "common/math/fft.h"
+#include "common/math/math.h"
+
+#include <cmath>
+
+// The real FFT packs the even samples into the real parts and the odd samples into the imaginary parts of a half-size
+// complex signal, transforms it, and then separates the even and odd spectra to combine them into the real spectrum.
+// The inverse performs the same steps in reverse. Inverting the complex FFT is done by conjugating its input and
+// output.
+
+static bool is_power_of_two(size_t value) {
+	return value > 0 && (value & (value - 1)) == 0;
+}
+
+void c_real_fft::calculate_memory(size_t fft_size, c_stack_allocator::c_memory_calculator &memory_calculator) {
+	wl_assert(is_power_of_two(fft_size));
+	wl_assert(fft_size >= k_min_fft_size);
+
+	memory_calculator.add_array<real32>(fft_size / 4);
+	memory_calculator.add_array<real32>(fft_size / 4);
+	memory_calculator.add_array<real32>(fft_size / 4 + 1);
+	memory_calculator.add_array<real32>(fft_size / 4 + 1);
+}
+
+void c_real_fft::initialize(size_t fft_size, c_stack_allocator &allocator) {
+	wl_assert(is_power_of_two(fft_size));
+	wl_assert(fft_size >= k_min_fft_size);
+
+	m_fft_size = fft_size;
+
+	size_t complex_fft_size = fft_size / 2;
+	m_stage_count = 0;
+	for (size_t size = complex_fft_size; size > 1; size /= 2) {
+		m_stage_count++;
+	}
+
+	allocator.allocate_array(m_complex_twiddle_real, fft_size / 4);
+	allocator.allocate_array(m_complex_twiddle_imaginary, fft_size / 4);
+	for (size_t index = 0; index < m_complex_twiddle_real.get_count(); index++) {
+		real64 angle = -2.0 * k_pi<real64> * static_cast<real64>(index) / static_cast<real64>(complex_fft_size);
+		m_complex_twiddle_real[index] = static_cast<real32>(std::cos(angle));
+		m_complex_twiddle_imaginary[index] = static_cast<real32>(std::sin(angle));
+	}
+
+	allocator.allocate_array(m_real_twiddle_real, fft_size / 4 + 1);
+	allocator.allocate_array(m_real_twiddle_imaginary, fft_size / 4 + 1);
+	for (size_t index = 0; index < m_real_twiddle_real.get_count(); index++) {
+		real64 angle = -2.0 * k_pi<real64> * static_cast<real64>(index) / static_cast<real64>(fft_size);
+		m_real_twiddle_real[index] = static_cast<real32>(std::cos(angle));
+		m_real_twiddle_imaginary[index] = static_cast<real32>(std::sin(angle));
+	}
+}
+
+size_t c_real_fft::get_fft_size() const {
+	return m_fft_size;
+}
+
+void c_real_fft::forward(const real32 *input, real32 *real_out, real32 *imaginary_out, real32 *scratch) const {
+	size_t complex_fft_size = m_fft_size / 2;
+
+	// Even samples become the real parts and odd samples become the imaginary parts
+	for (size_t index = 0; index < complex_fft_size; index++) {
+		real_out[index] = input[index * 2];
+		imaginary_out[index] = input[index * 2 + 1];
+	}
+
+	real32 *z_real = real_out;
+	real32 *z_imaginary = imaginary_out;
+	if (complex_fft(real_out, imaginary_out, scratch, scratch + complex_fft_size)) {
+		z_real = scratch;
+		z_imaginary = scratch + complex_fft_size;
+	}
+
+	// The DC bin and the Nyquist bin are both real so they are packed together
+	real32 z_0_real = z_real[0];
+	real32 z_0_imaginary = z_imaginary[0];
+	real_out[0] = z_0_real + z_0_imaginary;
+	imaginary_out[0] = z_0_real - z_0_imaginary;
+
+	// Each pair of bins k and N/2 - k is computed together so this can be done in place
+	for (size_t index = 1; index <= complex_fft_size / 2; index++) {
+		size_t mirror_index = complex_fft_size - index;
+		real32 z_real_a = z_real[index];
+		real32 z_imaginary_a = z_imaginary[index];
+		real32 z_real_b = z_real[mirror_index];
+		real32 z_imaginary_b = z_imaginary[mirror_index];
+
+		// Even spectrum: (Z[k] + conj(Z[N/2 - k])) / 2
+		real32 even_real = (z_real_a + z_real_b) * 0.5f;
+		real32 even_imaginary = (z_imaginary_a - z_imaginary_b) * 0.5f;
+
+		// Odd spectrum: (Z[k] - conj(Z[N/2 - k])) / 2i
+		real32 odd_real = (z_imaginary_a + z_imaginary_b) * 0.5f;
+		real32 odd_imaginary = (z_real_b - z_real_a) * 0.5f;
+
+		real32 twiddle_real = m_real_twiddle_real[index];
+		real32 twiddle_imaginary = m_real_twiddle_imaginary[index];
+		real32 twiddled_odd_real = odd_real * twiddle_real - odd_imaginary * twiddle_imaginary;
+		real32 twiddled_odd_imaginary = odd_real * twiddle_imaginary + odd_imaginary * twiddle_real;
+
+		// X[k] = E[k] + W^k O[k] and X[N/2 - k] = conj(E[k] - W^k O[k])
+		real_out[index] = even_real + twiddled_odd_real;
+		imaginary_out[index] = even_imaginary + twiddled_odd_imaginary;
+		real_out[mirror_index] = even_real - twiddled_odd_real;
+		imaginary_out[mirror_index] = twiddled_odd_imaginary - even_imaginary;
+	}
+}
+
+void c_real_fft::inverse(const real32 *real, const real32 *imaginary, real32 *output, real32 *scratch) const {
+	size_t complex_fft_size = m_fft_size / 2;
+
+	// Choose the starting arrays so that the complex FFT finishes in the scratch buffer, which frees up the output
+	// buffer for the final interleave
+	bool start_in_output = (m_stage_count % 2) == 1;
+	real32 *z_real = start_in_output ? output : scratch;
+	real32 *z_imaginary = z_real + complex_fft_size;
+	real32 *work_real = start_in_output ? scratch : output;
+	real32 *work_imaginary = work_real + complex_fft_size;
+
+	// Recombine the even and odd spectra into Z[k] = E[k] + i O[k], conjugated so that the forward complex FFT performs
+	// an inverse transform. The factors of 1/2 are dropped which scales the output by fft_size.
+	real32 dc = real[0];
+	real32 nyquist = imaginary[0];
+	z_real[0] = dc + nyquist;
+	z_imaginary[0] = -(dc - nyquist);
+
+	for (size_t index = 1; index <= complex_fft_size / 2; index++) {
+		size_t mirror_index = complex_fft_size - index;
+		real32 x_real_a = real[index];
+		real32 x_imaginary_a = imaginary[index];
+		real32 x_real_b = real[mirror_index];
+		real32 x_imaginary_b = imaginary[mirror_index];
+
+		// E[k] = X[k] + conj(X[N/2 - k])
+		real32 even_real = x_real_a + x_real_b;
+		real32 even_imaginary = x_imaginary_a - x_imaginary_b;
+
+		// O[k] = (X[k] - conj(X[N/2 - k])) W^-k
+		real32 difference_real = x_real_a - x_real_b;
+		real32 difference_imaginary = x_imaginary_a + x_imaginary_b;
+		real32 twiddle_real = m_real_twiddle_real[index];
+		real32 twiddle_imaginary = m_real_twiddle_imaginary[index];
+		real32 odd_real = difference_real * twiddle_real + difference_imaginary * twiddle_imaginary;
+		real32 odd_imaginary = difference_imaginary * twiddle_real - difference_real * twiddle_imaginary;
+
+		// Z[k] = E[k] + i O[k] and Z[N/2 - k] = conj(E[k]) + i conj(O[k]), both conjugated
+		z_real[index] = even_real - odd_imaginary;
+		z_imaginary[index] = -(even_imaginary + odd_real);
+		z_real[mirror_index] = even_real + odd_imaginary;
+		z_imaginary[mirror_index] = even_imaginary - odd_real;
+	}
+
+	IF_ASSERTS_ENABLED(bool result_in_work = ) complex_fft(z_real, z_imaginary, work_real, work_imaginary);
+	wl_assert(result_in_work == start_in_output);
+
+	// Conjugate the result and interleave the even and odd samples
+	for (size_t index = 0; index < complex_fft_size; index++) {
+		output[index * 2] = scratch[index];
+		output[index * 2 + 1] = -scratch[complex_fft_size + index];
+	}
+}
+
+bool c_real_fft::complex_fft(real32 *real, real32 *imaginary, real32 *work_real, real32 *work_imaginary) const {
+	size_t complex_fft_size = m_fft_size / 2;
+
+	real32 *source_real = real;
+	real32 *source_imaginary = imaginary;
+	real32 *destination_real = work_real;
+	real32 *destination_imaginary = work_imaginary;
+
+	// Each stage splits sub-transforms of the current size into two half-size sub-transforms, interleaved by the stride
+	size_t stride = 1;
+	for (size_t size = complex_fft_size; size > 1; size /= 2) {
+		size_t half_size = size / 2;
+
+		for (size_t butterfly_index = 0; butterfly_index < half_size; butterfly_index++) {
+			real32 twiddle_real = m_complex_twiddle_real[butterfly_index * stride];
+			real32 twiddle_imaginary = m_complex_twiddle_imaginary[butterfly_index * stride];
+
+			size_t a_offset = stride * butterfly_index;
+			size_t b_offset = stride * (butterfly_index + half_size);
+			size_t sum_offset = stride * (butterfly_index * 2);
+			size_t difference_offset = stride * (butterfly_index * 2 + 1);
+
+			if (stride >= k_simd_32_lanes) {
+				// The stride is a multiple of the lane count so all accesses are aligned
+				real32xN twiddle_real_n(twiddle_real);
+				real32xN twiddle_imaginary_n(twiddle_imaginary);
+				for (size_t offset = 0; offset < stride; offset += k_simd_32_lanes) {
+					real32xN a_real(&source_real[a_offset + offset]);
+					real32xN a_imaginary(&source_imaginary[a_offset + offset]);
+					real32xN b_real(&source_real[b_offset + offset]);
+					real32xN b_imaginary(&source_imaginary[b_offset + offset]);
+
+					(a_real + b_real).store(&destination_real[sum_offset + offset]);
+					(a_imaginary + b_imaginary).store(&destination_imaginary[sum_offset + offset]);
+
+					real32xN difference_real = a_real - b_real;
+					real32xN difference_imaginary = a_imaginary - b_imaginary;
+					(difference_real * twiddle_real_n - difference_imaginary * twiddle_imaginary_n)
+						.store(&destination_real[difference_offset + offset]);
+					(difference_real * twiddle_imaginary_n + difference_imaginary * twiddle_real_n)
+						.store(&destination_imaginary[difference_offset + offset]);
+				}
+			} else {
+				for (size_t offset = 0; offset < stride; offset++) {
+					real32 a_real = source_real[a_offset + offset];
+					real32 a_imaginary = source_imaginary[a_offset + offset];
+					real32 b_real = source_real[b_offset + offset];
+					real32 b_imaginary = source_imaginary[b_offset + offset];
+
+					destination_real[sum_offset + offset] = a_real + b_real;
+					destination_imaginary[sum_offset + offset] = a_imaginary + b_imaginary;
+
+					real32 difference_real = a_real - b_real;
+					real32 difference_imaginary = a_imaginary - b_imaginary;
+					destination_real[difference_offset + offset] =
+						difference_real * twiddle_real - difference_imaginary * twiddle_imaginary;
+					destination_imaginary[difference_offset + offset] =
+						difference_real * twiddle_imaginary + difference_imaginary * twiddle_real;
+				}
+			}
+		}
+
+		std::swap(source_real, destination_real);
+		std::swap(source_imaginary, destination_imaginary);
+		stride *= 2;
+	}
+
+	return source_real == work_real;
+}
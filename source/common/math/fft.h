@@ -0,0 +1,47 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/math/simd.h"
+#include "common/utility/stack_allocator.h"
+
+// FFT of a power-of-two number of real samples. An N-point spectrum is stored as N/2 complex bins in separate real and
+// imaginary arrays. The DC and Nyquist bins are both purely real, so the Nyquist bin is stored in imaginary[0]. All
+// buffers passed in must be SIMD-aligned. Tables are read-only after initialization so a single instance can be shared
+// between threads as long as each thread provides its own scratch buffer.
+class c_real_fft {
+public:
+	// The smallest FFT size supported. This guarantees that each spectrum array is at least one SIMD vector long.
+	static constexpr size_t k_min_fft_size = k_simd_32_lanes * 2;
+
+	c_real_fft() = default;
+
+	static void calculate_memory(size_t fft_size, c_stack_allocator::c_memory_calculator &memory_calculator);
+	void initialize(size_t fft_size, c_stack_allocator &allocator);
+
+	size_t get_fft_size() const;
+
+	// Transforms fft_size real samples into fft_size / 2 complex bins. The scratch buffer must hold fft_size samples.
+	void forward(const real32 *input, real32 *real_out, real32 *imaginary_out, real32 *scratch) const;
+
+	// Transforms fft_size / 2 complex bins back into fft_size real samples. The output is scaled by fft_size. The
+	// scratch buffer must hold fft_size samples.
+	void inverse(const real32 *real, const real32 *imaginary, real32 *output, real32 *scratch) const;
+
+private:
+	// Performs an unnormalized forward complex FFT of size fft_size / 2 using the Stockham algorithm, which alternates
+	// between the input and work arrays each stage. Returns whether the result ended up in the work arrays.
+	bool complex_fft(real32 *real, real32 *imaginary, real32 *work_real, real32 *work_imaginary) const;
+
+	size_t m_fft_size = 0;
+
+	// Number of radix-2 stages in the complex FFT
+	size_t m_stage_count = 0;
+
+	// e^(-2 pi i k / (fft_size / 2)) for k in [0, fft_size / 4), used by the complex FFT
+	c_wrapped_array<real32> m_complex_twiddle_real;
+	c_wrapped_array<real32> m_complex_twiddle_imaginary;
+
+	// e^(-2 pi i k / fft_size) for k in [0, fft_size / 4], used to split the complex FFT into the real spectrum
+	c_wrapped_array<real32> m_real_twiddle_real;
+	c_wrapped_array<real32> m_real_twiddle_imaginary;
+};
@@ -8,6 +8,7 @@
 // Math type declaration includes
 #include "common/math/int32x4.h"
 #include "common/math/real32x4.h"
+#include "common/math/real32x16.h"
 
 // Math type definition includes - each implementation has the appropriate ifdefs so only one will be compiled
 #include "common/math/neon/int32x4_neon.h"
@@ -16,6 +17,7 @@
 #include "common/math/sse/int32x8_sse.h"
 #include "common/math/sse/real32x4_sse.h"
 #include "common/math/sse/real32x8_sse.h"
+#include "common/math/sse/real32x16_sse.h"
 
 // These typedefs are for when the maximum size SIMD type should be used
 #if IS_TRUE(SIMD_256_ENABLED)
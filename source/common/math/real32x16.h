@@ -0,0 +1,68 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/math/simd.h"
+
+#if IS_TRUE(SIMD_512_ENABLED)
+
+// This type is only available to kernels which are compiled for the AVX-512 tier and selected at runtime. There is no
+// int32x16 counterpart yet so comparisons, integer conversions, and transcendental functions are not provided.
+class ALIGNAS_SIMD_512 real32x16 {
+public:
+	using t_element = real32;
+	static constexpr size_t k_element_count = 16;
+	static constexpr size_t k_element_size = sizeof(t_element);
+	static constexpr size_t k_element_size_bits = sizeof(t_element) * 8;
+
+	inline real32x16();
+	inline real32x16(real32 v);
+	inline real32x16(const real32 *ptr);
+	inline real32x16(const t_simd_real32x16 &v);
+	inline real32x16(const real32x16 &v);
+
+	inline void load(const real32 *ptr);
+	inline void load_unaligned(const real32 *ptr);
+	inline void store(real32 *ptr) const;
+	inline void store_unaligned(real32 *ptr) const;
+
+	inline real32x16 &operator=(const t_simd_real32x16 &v);
+	inline real32x16 &operator=(const real32x16 &v);
+
+	inline real32x16 &operator+=(const real32x16 &rhs);
+	inline real32x16 &operator-=(const real32x16 &rhs);
+	inline real32x16 &operator*=(const real32x16 &rhs);
+	inline real32x16 &operator/=(const real32x16 &rhs);
+
+	inline operator t_simd_real32x16() const;
+	inline real32x16 sum_elements() const;
+	inline real32 first_element() const;
+
+private:
+	t_simd_real32x16 m_value;
+};
+
+// Unary operators
+inline real32x16 operator+(const real32x16 &v);
+inline real32x16 operator-(const real32x16 &v);
+
+// Binary operators
+inline real32x16 operator+(const real32x16 &lhs, const real32x16 &rhs);
+inline real32x16 operator-(const real32x16 &lhs, const real32x16 &rhs);
+inline real32x16 operator*(const real32x16 &lhs, const real32x16 &rhs);
+inline real32x16 operator/(const real32x16 &lhs, const real32x16 &rhs);
+
+inline real32x16 &real32x16::operator+=(const real32x16 &rhs) { *this = *this + rhs; return *this; }
+inline real32x16 &real32x16::operator-=(const real32x16 &rhs) { *this = *this - rhs; return *this; }
+inline real32x16 &real32x16::operator*=(const real32x16 &rhs) { *this = *this * rhs; return *this; }
+inline real32x16 &real32x16::operator/=(const real32x16 &rhs) { *this = *this / rhs; return *this; }
+
+// Arithmetic/utility
+inline real32x16 abs(const real32x16 &v);
+inline real32x16 floor(const real32x16 &v);
+inline real32x16 ceil(const real32x16 &v);
+inline real32x16 round(const real32x16 &v);
+inline real32x16 min(const real32x16 &a, const real32x16 &b);
+inline real32x16 max(const real32x16 &a, const real32x16 &b);
+inline real32x16 sqrt(const real32x16 &v);
+
+#endif // IS_TRUE(SIMD_512_ENABLED)
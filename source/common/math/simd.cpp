@@ -6,11 +6,14 @@
 
 #if IS_TRUE(ARCHITECTURE_X86_64)
 
+// Fills cpu_info with EAX, EBX, ECX, and EDX in that order
 static void cpuid(int32 cpu_info[4], int function) {
 #if IS_TRUE(COMPILER_MSVC)
 	__cpuidex(cpu_info, function, 0);
 #elif IS_TRUE(COMPILER_GCC) || IS_TRUE(COMPILER_CLANG)
-	__get_cpuid(function, &cpu_info[3], &cpu_info[2], &cpu_info[1], &cpu_info[0]);
+	uint32 registers[4] = {};
+	__get_cpuid_count(function, 0, &registers[0], &registers[1], &registers[2], &registers[3]);
+	copy_type(cpu_info, reinterpret_cast<const int32 *>(registers), 4);
 #else // COMPILER
 #error Unknown compiler
 #endif // COMPILER
@@ -28,6 +31,7 @@ uint32 get_simd_requirements() {
 		| (SIMD_IMPLEMENTATION_SSE4_2_ENABLED << enum_index(e_simd_instruction_set::k_sse4_2))
 		| (SIMD_IMPLEMENTATION_AVX_ENABLED << enum_index(e_simd_instruction_set::k_avx))
 		| (SIMD_IMPLEMENTATION_AVX2_ENABLED << enum_index(e_simd_instruction_set::k_avx2))
+		| (SIMD_IMPLEMENTATION_AVX512F_ENABLED << enum_index(e_simd_instruction_set::k_avx512))
 		| (SIMD_IMPLEMENTATION_NEON_ENABLED << enum_index(e_simd_instruction_set::k_neon));
 
 	return simd_requirements;
@@ -39,54 +43,95 @@ uint32 get_simd_availability() {
 #if IS_TRUE(ARCHITECTURE_X86_64)
 	int32 cpu_info_0[4];
 	cpuid(cpu_info_0, 0);
+	int32 max_function = cpu_info_0[0];
 
-	int32 cpu_info_7[4];
-	cpuid(cpu_info_7, 7);
+	int32 cpu_info_1[4];
+	cpuid(cpu_info_1, 1);
 
-	bool os_xsave_supported = (cpu_info_0[2] & (1 << 27)) != 0;
+	int32 cpu_info_7[4] = {};
+	if (max_function >= 7) {
+		cpuid(cpu_info_7, 7);
+	}
+
+	// The OS must save the extended register state for AVX (XMM and YMM) and AVX-512 (opmask, ZMM0-15, and ZMM16-31)
+	bool os_xsave_supported = (cpu_info_1[2] & (1 << 27)) != 0;
 	uint64 xcr_feature_mask = 0;
 	if (os_xsave_supported) {
 		xcr_feature_mask = _xgetbv(0);
 	}
 
-	if (cpu_info_0[3] & (1 << 25)) {
+	bool avx_state_supported = (xcr_feature_mask & 0x6) == 0x6;
+	bool avx512_state_supported = (xcr_feature_mask & 0xe6) == 0xe6;
+
+	if (cpu_info_1[3] & (1 << 25)) {
 		simd_availability |= 1 << enum_index(e_simd_instruction_set::k_sse);
 	}
 
-	if (cpu_info_0[3] & (1 << 26)) {
+	if (cpu_info_1[3] & (1 << 26)) {
 		simd_availability |= 1 << enum_index(e_simd_instruction_set::k_sse2);
 	}
 
-	if (cpu_info_0[2] & (1 << 0)) {
+	if (cpu_info_1[2] & (1 << 0)) {
 		simd_availability |= 1 << enum_index(e_simd_instruction_set::k_sse3);
 	}
 
-	if (cpu_info_0[2] & (1 << 9)) {
+	if (cpu_info_1[2] & (1 << 9)) {
 		simd_availability |= 1 << enum_index(e_simd_instruction_set::k_ssse3);
 	}
 
-	if (cpu_info_0[2] & (1 << 19)) {
+	if (cpu_info_1[2] & (1 << 19)) {
 		simd_availability |= 1 << enum_index(e_simd_instruction_set::k_sse4_1);
 	}
 
-	if (cpu_info_0[2] & (1 << 20)) {
+	if (cpu_info_1[2] & (1 << 20)) {
 		simd_availability |= 1 << enum_index(e_simd_instruction_set::k_sse4_2);
 	}
 
-	if ((xcr_feature_mask & 0x6) == 0x6) {
-		if (cpu_info_0[2] & (1 << 28)) {
+	if (avx_state_supported) {
+		if (cpu_info_1[2] & (1 << 28)) {
 			simd_availability |= 1 << enum_index(e_simd_instruction_set::k_avx);
 		}
 
-		if (cpu_info_7[1] & (1 << 5)) {
+		// /arch:AVX2 also allows FMA instructions to be generated so we require both
+		bool fma_supported = (cpu_info_1[2] & (1 << 12)) != 0;
+		if ((cpu_info_7[1] & (1 << 5)) && fma_supported) {
 			simd_availability |= 1 << enum_index(e_simd_instruction_set::k_avx2);
 		}
+
+		// Foundation, DQ, CD, BW, and VL
+		static constexpr uint32 k_avx512_mask = (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31);
+		if ((static_cast<uint32>(cpu_info_7[1]) & k_avx512_mask) == k_avx512_mask && avx512_state_supported) {
+			simd_availability |= 1 << enum_index(e_simd_instruction_set::k_avx512);
+		}
 	}
 #elif IS_TRUE(ARCHITECTURE_ARM)
-#error Not yet implemented // $TODO $NEON
+	// NEON is mandatory on 64-bit ARM so there is nothing to query
+	simd_availability |= SIMD_IMPLEMENTATION_NEON_ENABLED << enum_index(e_simd_instruction_set::k_neon);
 #else // ARCHITECTURE
 #error Unknown architecture
 #endif // ARCHITECTURE
 
 	return simd_availability;
 }
+
+static e_simd_tier determine_simd_tier() {
+	uint32 simd_availability = get_simd_availability();
+	if (simd_availability & (1 << enum_index(e_simd_instruction_set::k_avx512))) {
+		return e_simd_tier::k_avx512;
+	} else if (simd_availability & (1 << enum_index(e_simd_instruction_set::k_avx2))) {
+		return e_simd_tier::k_avx2;
+	} else {
+		return e_simd_tier::k_baseline;
+	}
+}
+
+e_simd_tier get_simd_tier() {
+	static const e_simd_tier k_simd_tier = determine_simd_tier();
+	return k_simd_tier;
+}
+
+const char *get_simd_tier_name(e_simd_tier simd_tier) {
+	static constexpr const char *k_simd_tier_names[] = { "baseline", "avx2", "avx512" };
+	STATIC_ASSERT(array_count(k_simd_tier_names) == enum_count<e_simd_tier>());
+	return k_simd_tier_names[enum_index(simd_tier)];
+}
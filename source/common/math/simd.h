@@ -11,6 +11,7 @@
 #define SIMD_IMPLEMENTATION_SSE4_2_ENABLED 0
 #define SIMD_IMPLEMENTATION_AVX_ENABLED 0
 #define SIMD_IMPLEMENTATION_AVX2_ENABLED 0
+#define SIMD_IMPLEMENTATION_AVX512F_ENABLED 0
 
 // NEON availability: $TODO $NEON break this down further
 #define SIMD_IMPLEMENTATION_NEON_ENABLED 0
@@ -22,12 +23,12 @@
 		#ifndef SCRAPER_ENABLED
 			#define __SSE__
 			#define __SSE2__
-			#if defined(__AVX__) || defined(__AVX2__)
+			#if defined(__AVX__) || defined(__AVX2__) || defined(__AVX512F__)
 				#define __SSE3__
 				#define __SSSE3__
 				#define __SSE4_1__
 				#define __SSE4_2__
-			#endif // defined(__AVX__) || defined(__AVX2__)
+			#endif // defined(__AVX__) || defined(__AVX2__) || defined(__AVX512F__)
 		#endif // SCRAPER_ENABLED
 	#elif IS_TRUE(COMPILER_GCC) || IS_TRUE(COMPILER_CLANG)
 		#include <x86intrin.h>
@@ -72,6 +73,10 @@
 	#undef SIMD_IMPLEMENTATION_AVX2_ENABLED
 	#define SIMD_IMPLEMENTATION_AVX2_ENABLED 1
 #endif // __AVX2__
+#ifdef __AVX512F__
+	#undef SIMD_IMPLEMENTATION_AVX512F_ENABLED
+	#define SIMD_IMPLEMENTATION_AVX512F_ENABLED 1
+#endif // __AVX512F__
 
 #ifdef __ARM_NEON // $TODO $NEON not sure if this is correct
 	#undef SIMD_IMPLEMENTATION_NEON_ENABLED
@@ -80,6 +85,7 @@
 
 #define SIMD_128_ENABLED (SIMD_IMPLEMENTATION_AVX_ENABLED || SIMD_IMPLEMENTATION_NEON_ENABLED)
 #define SIMD_256_ENABLED SIMD_IMPLEMENTATION_AVX2_ENABLED
+#define SIMD_512_ENABLED SIMD_IMPLEMENTATION_AVX512F_ENABLED
 
 static constexpr size_t k_simd_128_size = 16;
 static constexpr size_t k_simd_128_size_bits = 128;
@@ -89,7 +95,12 @@ static constexpr size_t k_simd_256_size = 32;
 static constexpr size_t k_simd_256_size_bits = 256;
 static constexpr size_t k_simd_256_alignment = 32;
 
-// Generic SIMD sizes/alignments default to the largest type
+static constexpr size_t k_simd_512_size = 64;
+static constexpr size_t k_simd_512_size_bits = 512;
+static constexpr size_t k_simd_512_alignment = 64;
+
+// Generic SIMD sizes/alignments default to the largest type. 512-bit types are only used by kernels which are selected
+// at runtime (see e_simd_tier) so they don't affect buffer layouts.
 #if IS_TRUE(SIMD_256_ENABLED)
 static constexpr size_t k_simd_size = k_simd_256_size;
 static constexpr size_t k_simd_size_bits = k_simd_256_size_bits;
@@ -105,6 +116,7 @@ static constexpr size_t k_simd_32_lanes = k_simd_size_bits / 32;
 
 #define ALIGNAS_SIMD_128 alignas(k_simd_128_alignment)
 #define ALIGNAS_SIMD_256 alignas(k_simd_256_alignment)
+#define ALIGNAS_SIMD_512 alignas(k_simd_512_alignment)
 #define ALIGNAS_SIMD alignas(k_simd_alignment)
 
 #if IS_TRUE(SIMD_128_ENABLED)
@@ -159,6 +171,10 @@ static constexpr size_t k_simd_32_lanes = k_simd_size_bits / 32;
 	#endif // SIMD_IMPLEMENTATION
 #endif // IS_TRUE(SIMD_256_ENABLED)
 
+#if IS_TRUE(SIMD_512_ENABLED)
+	using t_simd_real32x16 = __m512;
+#endif // IS_TRUE(SIMD_512_ENABLED)
+
 // $TODO use enum flags
 enum class e_simd_instruction_set {
 	k_sse,
@@ -169,11 +185,32 @@ enum class e_simd_instruction_set {
 	k_sse4_2,
 	k_avx,
 	k_avx2,
+	k_avx512, // F, CD, BW, DQ, and VL, which is the set that compilers target for AVX-512
 	k_neon,
 
 	k_count
 };
 
-// $TODO call these
+// Returns a mask of the instruction sets this build was compiled for
 uint32 get_simd_requirements();
+
+// Returns a mask of the instruction sets supported by the CPU and OS
 uint32 get_simd_availability();
+
+// Hot kernels are compiled once per tier and the highest tier supported by the CPU is selected at runtime. The
+// baseline tier is whatever the build's simd_support option targets. Source files named *_avx2.cpp and *_avx512.cpp
+// are compiled with that instruction set enabled, so nothing they call may have external linkage: the linker could
+// pick their out-of-line copy of an inline function for code running at a lower tier. This rules out the shared SIMD
+// types in common/math/math.h, whose inline functions have external linkage. Instead, tier files wrap the intrinsics
+// they need in static functions and keep their kernels file-local.
+enum class e_simd_tier {
+	k_baseline,
+	k_avx2,
+	k_avx512,
+
+	k_count
+};
+
+// Returns the highest tier the CPU supports. This is only queried once.
+e_simd_tier get_simd_tier();
+const char *get_simd_tier_name(e_simd_tier simd_tier);
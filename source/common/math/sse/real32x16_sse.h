@@ -0,0 +1,119 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/math/real32x16.h"
+#include "common/math/simd.h"
+
+#if IS_TRUE(SIMD_512_ENABLED) && IS_TRUE(SIMD_IMPLEMENTATION_AVX512F_ENABLED)
+
+inline real32x16::real32x16() {}
+
+inline real32x16::real32x16(real32 v)
+	: m_value(_mm512_set1_ps(v)) {}
+
+inline real32x16::real32x16(const real32 *ptr) {
+	load(ptr);
+}
+
+inline real32x16::real32x16(const t_simd_real32x16 &v)
+	: m_value(v) {
+}
+
+inline real32x16::real32x16(const real32x16 &v)
+	: m_value(v.m_value) {}
+
+inline void real32x16::load(const real32 *ptr) {
+	wl_assert(is_pointer_aligned(ptr, k_simd_512_alignment));
+	m_value = _mm512_load_ps(ptr);
+}
+
+inline void real32x16::load_unaligned(const real32 *ptr) {
+	m_value = _mm512_loadu_ps(ptr);
+}
+
+inline void real32x16::store(real32 *ptr) const {
+	wl_assert(is_pointer_aligned(ptr, k_simd_512_alignment));
+	_mm512_store_ps(ptr, m_value);
+}
+
+inline void real32x16::store_unaligned(real32 *ptr) const {
+	_mm512_storeu_ps(ptr, m_value);
+}
+
+inline real32x16 &real32x16::operator=(const t_simd_real32x16 &v) {
+	m_value = v;
+	return *this;
+}
+
+inline real32x16 &real32x16::operator=(const real32x16 &v) {
+	m_value = v.m_value;
+	return *this;
+}
+
+inline real32x16::operator t_simd_real32x16() const {
+	return m_value;
+}
+
+inline real32x16 real32x16::sum_elements() const {
+	return _mm512_reduce_add_ps(m_value);
+}
+
+inline real32 real32x16::first_element() const {
+	return _mm512_cvtss_f32(m_value);
+}
+
+inline real32x16 operator+(const real32x16 &v) {
+	return v;
+}
+
+inline real32x16 operator-(const real32x16 &v) {
+	return _mm512_sub_ps(_mm512_set1_ps(0.0f), v);
+}
+
+inline real32x16 operator+(const real32x16 &lhs, const real32x16 &rhs) {
+	return _mm512_add_ps(lhs, rhs);
+}
+
+inline real32x16 operator-(const real32x16 &lhs, const real32x16 &rhs) {
+	return _mm512_sub_ps(lhs, rhs);
+}
+
+inline real32x16 operator*(const real32x16 &lhs, const real32x16 &rhs) {
+	return _mm512_mul_ps(lhs, rhs);
+}
+
+inline real32x16 operator/(const real32x16 &lhs, const real32x16 &rhs) {
+	return _mm512_div_ps(lhs, rhs);
+}
+
+inline real32x16 abs(const real32x16 &v) {
+	// Mask off the sign bit for fast abs. AVX-512F has no floating point logical operations so use integer ones.
+	const __m512i k_sign_mask = _mm512_set1_epi32(0x7fffffff);
+	return _mm512_castsi512_ps(_mm512_and_epi32(_mm512_castps_si512(v), k_sign_mask));
+}
+
+inline real32x16 floor(const real32x16 &v) {
+	return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+}
+
+inline real32x16 ceil(const real32x16 &v) {
+	return _mm512_roundscale_ps(v, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC);
+}
+
+inline real32x16 round(const real32x16 &v) {
+	return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+
+inline real32x16 min(const real32x16 &a, const real32x16 &b) {
+	return _mm512_min_ps(a, b);
+}
+
+inline real32x16 max(const real32x16 &a, const real32x16 &b) {
+	return _mm512_max_ps(a, b);
+}
+
+inline real32x16 sqrt(const real32x16 &v) {
+	return _mm512_sqrt_ps(v);
+}
+
+#endif // IS_TRUE(SIMD_512_ENABLED) && IS_TRUE(SIMD_IMPLEMENTATION_AVX512F_ENABLED)
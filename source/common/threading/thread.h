@@ -98,6 +98,12 @@ public:
 	// Returns the ID of the current thread
 	static t_thread_id get_current_thread_id();
 
+	// Gives up the remainder of the current thread's time slice
+	static void yield();
+
+	// Hints to the processor that the current thread is in a spin-wait loop
+	static void spin_wait_hint();
+
 private:
 	// Thread function and parameter block
 	f_thread_entry_point m_thread_entry_point;
@@ -6,6 +6,16 @@
 #include <pthread.h>
 #endif // IS_TRUE(PLATFORM_LINUX)
 
+#if IS_TRUE(ARCHITECTURE_X86_64)
+	#if IS_TRUE(COMPILER_MSVC)
+		#include <intrin.h>
+	#else // COMPILER
+		#include <immintrin.h>
+	#endif // COMPILER
+#elif IS_TRUE(ARCHITECTURE_ARM) && IS_TRUE(COMPILER_MSVC)
+	#include <intrin.h>
+#endif // ARCHITECTURE
+
 #if !IS_TRUE(USE_THREAD_IMPLEMENTATION_WINDOWS)
 
 c_thread::c_thread() {}
@@ -72,6 +82,24 @@ c_thread::t_thread_id c_thread::get_current_thread_id() {
 	return std::this_thread::get_id();
 }
 
+void c_thread::yield() {
+	std::this_thread::yield();
+}
+
+void c_thread::spin_wait_hint() {
+#if IS_TRUE(ARCHITECTURE_X86_64)
+	_mm_pause();
+#elif IS_TRUE(ARCHITECTURE_ARM)
+	#if IS_TRUE(COMPILER_MSVC)
+		__yield();
+	#else // COMPILER
+		__asm__ __volatile__("yield");
+	#endif // COMPILER
+#else // ARCHITECTURE
+	// No processor hint is available so just let the spinning thread continue
+#endif // ARCHITECTURE
+}
+
 void c_thread::thread_entry_point(const c_thread *this_ptr) {
 	initialize_memory_debugger();
 	initialize_floating_point_behavior();
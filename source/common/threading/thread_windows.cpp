@@ -89,6 +89,14 @@ c_thread::t_thread_id c_thread::get_current_thread_id() {
 	return static_cast<uint32>(GetCurrentThreadId());
 }
 
+void c_thread::yield() {
+	SwitchToThread();
+}
+
+void c_thread::spin_wait_hint() {
+	YieldProcessor();
+}
+
 DWORD WINAPI c_thread::thread_entry_point(LPVOID param) {
 	initialize_memory_debugger();
 	initialize_floating_point_behavior();
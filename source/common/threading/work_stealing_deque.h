@@ -0,0 +1,50 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/threading/lock_free.h"
+
+#include <atomic>
+
+// Chase-Lev work-stealing deque with a fixed capacity. A single owner thread pushes and pops elements at the bottom in
+// LIFO order while any number of other threads steal elements from the top in FIFO order. The owner only contends with
+// thieves when a single element remains.
+// See https://www.di.ens.fr/~zappa/readings/ppopp13.pdf for the memory ordering used here.
+template<typename t_element>
+class c_work_stealing_deque {
+public:
+	using c_element_array = c_wrapped_array<t_element>;
+
+	// Non-thread-safe functions:
+
+	c_work_stealing_deque();
+
+	// Initializes the deque with element backing memory. The element count must be a power of two.
+	void initialize(c_element_array element_memory);
+
+	// Owner thread functions:
+
+	// Push onto the bottom, returns false if the deque is full
+	bool push(const t_element &element);
+
+	// Pop from the bottom, returns false if the deque is empty
+	bool pop(t_element &element_out);
+
+	// Thread-safe functions:
+
+	// Steal from the top, returns false if the deque is empty or if another thread took the top element first
+	bool steal(t_element &element_out);
+
+	// Returns the number of elements in the deque. Not thread safe!
+	size_t get_count_unsafe() const;
+
+private:
+	c_element_array m_elements;
+	int64 m_mask;
+
+	// Thieves take from the top and the owner pushes and pops at the bottom, so these are kept on separate cache lines
+	ALIGNAS_LOCK_FREE std::atomic<int64> m_top;
+	ALIGNAS_LOCK_FREE std::atomic<int64> m_bottom;
+};
+
+#include "common/threading/work_stealing_deque.inl"
+
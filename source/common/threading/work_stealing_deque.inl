@@ -0,0 +1,90 @@
+template<typename t_element>
+c_work_stealing_deque<t_element>::c_work_stealing_deque()
+	: m_elements(nullptr, 0)
+	, m_mask(0)
+	, m_top(0)
+	, m_bottom(0) {}
+
+template<typename t_element>
+void c_work_stealing_deque<t_element>::initialize(c_element_array element_memory) {
+	size_t count = element_memory.get_count();
+	wl_assertf(count > 0 && (count & (count - 1)) == 0, "Work-stealing deque size must be a power of two");
+
+	m_elements = element_memory;
+	m_mask = static_cast<int64>(count - 1);
+	m_top = 0;
+	m_bottom = 0;
+}
+
+template<typename t_element>
+bool c_work_stealing_deque<t_element>::push(const t_element &element) {
+	int64 bottom = m_bottom.load(std::memory_order_relaxed);
+	int64 top = m_top.load(std::memory_order_acquire);
+	if (bottom - top > m_mask) {
+		// Deque is full
+		return false;
+	}
+
+	copy_type(&m_elements[static_cast<size_t>(bottom & m_mask)], &element);
+
+	// Make sure the element is visible before thieves can see the new bottom
+	std::atomic_thread_fence(std::memory_order_release);
+	m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	return true;
+}
+
+template<typename t_element>
+bool c_work_stealing_deque<t_element>::pop(t_element &element_out) {
+	// Reserve the bottom element before looking at the top so that thieves can't also take it
+	int64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+	m_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 top = m_top.load(std::memory_order_relaxed);
+
+	if (top > bottom) {
+		// Deque is empty, restore the bottom
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	copy_type(&element_out, &m_elements[static_cast<size_t>(bottom & m_mask)]);
+	if (top < bottom) {
+		// More than one element remains so no thief can reach this one
+		return true;
+	}
+
+	// This is the last element so we race with thieves by advancing the top
+	bool success = m_top.compare_exchange_strong(
+		top,
+		top + 1,
+		std::memory_order_seq_cst,
+		std::memory_order_relaxed);
+	m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	return success;
+}
+
+template<typename t_element>
+bool c_work_stealing_deque<t_element>::steal(t_element &element_out) {
+	int64 top = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 bottom = m_bottom.load(std::memory_order_acquire);
+
+	if (top >= bottom) {
+		return false;
+	}
+
+	// Copy the value into our output BEFORE we compare_exchange. If the compare_exchange fails, the element may have
+	// been overwritten in the meantime, so the copy is discarded.
+	copy_type(&element_out, &m_elements[static_cast<size_t>(top & m_mask)]);
+	return m_top.compare_exchange_strong(
+		top,
+		top + 1,
+		std::memory_order_seq_cst,
+		std::memory_order_relaxed);
+}
+
+template<typename t_element>
+size_t c_work_stealing_deque<t_element>::get_count_unsafe() const {
+	int64 count = m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed);
+	return count > 0 ? static_cast<size_t>(count) : 0;
+}
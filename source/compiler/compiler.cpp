@@ -1,6 +1,7 @@
 #include "common/utility/file_utility.h"
 
 #include "compiler/compiler.h"
+#include "compiler/compiler_task_runner.h"
 #include "compiler/components/ast_builder.h"
 #include "compiler/components/entry_point_extractor.h"
 #include "compiler/components/importer.h"
@@ -9,15 +10,38 @@
 #include "compiler/components/instrument_variant_optimizer.h"
 #include "compiler/components/lexer.h"
 #include "compiler/components/parser.h"
+#include "compiler/source_file_cache.h"
 
 #include "instrument/instrument.h"
 
 #include <memory>
 #include <vector>
 
+// State for reading, lexing, and parsing a single source file on a worker thread
+struct s_source_file_task {
+	explicit s_source_file_task(c_compiler_context *parent_context)
+		: context(parent_context) {}
+
+	c_compiler_context context;
+	bool parsed = false;
+	bool from_cache = false;
+};
+
+// State for building and optimizing a single instrument variant on a worker thread
+struct s_instrument_variant_task {
+	explicit s_instrument_variant_task(c_compiler_context *parent_context)
+		: context(parent_context) {}
+
+	c_compiler_context context;
+	std::unique_ptr<c_instrument_variant> instrument_variant;
+};
+
 static bool read_source_file(c_compiler_context &context, h_compiler_source_file source_file_handle);
 
-c_instrument *c_compiler::compile(c_compiler_context &context, const char *source_filename) {
+c_instrument *c_compiler::compile(
+	c_compiler_context &context,
+	const char *source_filename,
+	const s_compiler_settings &settings) {
 	wl_assert(source_filename);
 	wl_assert(context.get_source_file_count() == 0);
 
@@ -37,23 +61,64 @@ c_instrument *c_compiler::compile(c_compiler_context &context, const char *sourc
 
 	s_instrument_globals_context instrument_globals_context;
 
-	// Iterate and process imports for each source file. This will continue looping until no new imports are discovered.
-	for (size_t source_file_index = 0; source_file_index < context.get_source_file_count(); source_file_index++) {
-		h_compiler_source_file source_file_handle = h_compiler_source_file::construct(source_file_index);
-		s_compiler_source_file &source_file = context.get_source_file(source_file_handle);
-
-		if (read_source_file(context, source_file_handle)) {
-			if (c_lexer::process(context, source_file_handle)) {
-				if (c_parser::process(context, source_file_handle)) {
-					c_importer::resolve_imports(context, source_file_handle);
-					c_instrument_globals_parser::parse_instrument_globals(
-						context,
-						source_file_handle,
-						source_file_index == 0,
-						instrument_globals_context);
+	// Process imports for each source file. This will continue looping until no new imports are discovered. Source
+	// files are processed in waves: all files discovered by the previous wave are read, lexed, and parsed in parallel,
+	// and then their imports are resolved one file at a time in order. This assigns source file handles and reports
+	// diagnostics in exactly the same order as processing each file individually would.
+	size_t wave_start_index = 0;
+	while (wave_start_index < context.get_source_file_count()) {
+		size_t wave_end_index = context.get_source_file_count();
+
+		std::vector<s_source_file_task> source_file_tasks;
+		source_file_tasks.reserve(wave_end_index - wave_start_index);
+		for (size_t source_file_index = wave_start_index; source_file_index < wave_end_index; source_file_index++) {
+			source_file_tasks.emplace_back(&context);
+		}
+
+		c_compiler_task_runner::run(
+			settings.thread_count,
+			source_file_tasks.size(),
+			[&](size_t task_index) {
+				s_source_file_task &task = source_file_tasks[task_index];
+				h_compiler_source_file source_file_handle =
+					h_compiler_source_file::construct(wave_start_index + task_index);
+				s_compiler_source_file &source_file = task.context.get_source_file(source_file_handle);
+
+				if (settings.source_file_cache
+					&& settings.source_file_cache->try_copy_source_file(source_file_handle, source_file)) {
+					task.parsed = true;
+					task.from_cache = true;
+				} else {
+					task.parsed = read_source_file(task.context, source_file_handle)
+						&& c_lexer::process(task.context, source_file_handle)
+						&& c_parser::process(task.context, source_file_handle);
 				}
+			});
+
+		for (size_t task_index = 0; task_index < source_file_tasks.size(); task_index++) {
+			s_source_file_task &task = source_file_tasks[task_index];
+			size_t source_file_index = wave_start_index + task_index;
+			h_compiler_source_file source_file_handle = h_compiler_source_file::construct(source_file_index);
+
+			bool had_errors = task.context.get_error_count() > 0;
+			context.merge_deferred_context(task.context);
+			if (!task.parsed) {
+				continue;
 			}
+
+			if (settings.source_file_cache && !task.from_cache && !had_errors) {
+				settings.source_file_cache->add_source_file(context.get_source_file(source_file_handle));
+			}
+
+			c_importer::resolve_imports(context, source_file_handle);
+			c_instrument_globals_parser::parse_instrument_globals(
+				context,
+				source_file_handle,
+				source_file_index == 0,
+				instrument_globals_context);
 		}
+
+		wave_start_index = wave_end_index;
 	}
 
 	instrument_globals_context.assign_defaults();
@@ -100,25 +165,43 @@ c_instrument *c_compiler::compile(c_compiler_context &context, const char *sourc
 
 	std::unique_ptr<c_instrument> instrument(new c_instrument());
 
+	// Each variant only reads from the AST so they can all be built and optimized in parallel. Failures and diagnostics
+	// are processed in variant order afterwards, which matches building the variants one at a time.
 	std::vector<s_instrument_globals> instrument_globals_set =
 		instrument_globals_context.build_instrument_globals_set();
-	for (const s_instrument_globals &instrument_globals : instrument_globals_set) {
-		std::unique_ptr<c_instrument_variant> instrument_variant(
-			c_instrument_variant_builder::build_instrument_variant(
-				context,
-				instrument_globals,
-				voice_entry_point,
-				fx_entry_point));
+	std::vector<s_instrument_variant_task> instrument_variant_tasks;
+	instrument_variant_tasks.reserve(instrument_globals_set.size());
+	for (size_t variant_index = 0; variant_index < instrument_globals_set.size(); variant_index++) {
+		instrument_variant_tasks.emplace_back(&context);
+	}
 
-		if (!instrument_variant) {
-			return nullptr;
-		}
+	c_compiler_task_runner::run(
+		settings.thread_count,
+		instrument_variant_tasks.size(),
+		[&](size_t task_index) {
+			s_instrument_variant_task &task = instrument_variant_tasks[task_index];
+			task.instrument_variant.reset(
+				c_instrument_variant_builder::build_instrument_variant(
+					task.context,
+					instrument_globals_set[task_index],
+					voice_entry_point,
+					fx_entry_point));
+
+			if (task.instrument_variant
+				&& !c_instrument_variant_optimizer::optimize_instrument_variant(
+					task.context,
+					*task.instrument_variant.get())) {
+				task.instrument_variant.reset();
+			}
+		});
 
-		if (!c_instrument_variant_optimizer::optimize_instrument_variant(context, *instrument_variant.get())) {
+	for (s_instrument_variant_task &task : instrument_variant_tasks) {
+		context.merge_deferred_context(task.context);
+		if (!task.instrument_variant) {
 			return nullptr;
 		}
 
-		instrument->add_instrument_variant(instrument_variant.release());
+		instrument->add_instrument_variant(task.instrument_variant.release());
 	}
 
 	wl_assert(instrument->validate());
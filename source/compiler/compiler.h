@@ -6,11 +6,23 @@
 
 // The entry point to the wavelang compiler
 
+class c_compiler_source_file_cache;
 class c_instrument;
 
+struct s_compiler_settings {
+	// Number of threads used to lex and parse independent source files and to build instrument variants. If this is 0
+	// or 1, everything runs on the calling thread. Diagnostics are reported in the same order regardless.
+	uint32 thread_count = 1;
+
+	// If provided, source files are looked up in this cache before being lexed and parsed, and newly parsed source
+	// files are added to it. This is used to share imports between compilations of multiple source files.
+	c_compiler_source_file_cache *source_file_cache = nullptr;
+};
+
 class c_compiler {
 public:
 	static c_instrument *compile(
 		c_compiler_context &context,
-		const char *source_filename);
+		const char *source_filename,
+		const s_compiler_settings &settings = s_compiler_settings());
 };
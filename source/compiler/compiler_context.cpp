@@ -8,6 +8,39 @@ c_compiler_context::c_compiler_context(c_wrapped_array<void *> native_module_lib
 	m_native_module_library_contexts = native_module_library_contexts;
 }
 
+c_compiler_context::c_compiler_context(c_compiler_context *parent_context) {
+	wl_assert(parent_context);
+	m_native_module_library_contexts = parent_context->m_native_module_library_contexts;
+	m_parent_context = parent_context;
+}
+
+void c_compiler_context::merge_deferred_context(c_compiler_context &deferred_context) {
+	wl_assert(deferred_context.m_parent_context == this);
+	for (const s_deferred_diagnostic &diagnostic : deferred_context.m_deferred_diagnostics) {
+		switch (diagnostic.diagnostic_type) {
+		case e_diagnostic_type::k_message:
+			add_message(deferred_context.m_messages[diagnostic.index], diagnostic.location);
+			break;
+
+		case e_diagnostic_type::k_warning:
+			add_warning(deferred_context.m_warnings[diagnostic.index], diagnostic.location);
+			break;
+
+		case e_diagnostic_type::k_error:
+			add_error(deferred_context.m_errors[diagnostic.index], diagnostic.location);
+			break;
+
+		default:
+			wl_unreachable();
+		}
+	}
+
+	deferred_context.m_messages.clear();
+	deferred_context.m_warnings.clear();
+	deferred_context.m_errors.clear();
+	deferred_context.m_deferred_diagnostics.clear();
+}
+
 void c_compiler_context::message(
 	const s_compiler_source_location &location,
 	const char *format,
@@ -26,8 +59,7 @@ void c_compiler_context::vmessage(
 		str_vformat(format, args)
 	};
 
-	output_to_stream(std::cout, "Message", -1, location, message_entry.message.c_str());
-	m_messages.emplace_back(message_entry);
+	add_message(message_entry, location);
 }
 
 void c_compiler_context::message(
@@ -66,8 +98,7 @@ void c_compiler_context::vwarning(
 		str_vformat(format, args)
 	};
 
-	output_to_stream(std::cerr, "Warning", enum_index(warning), location, warning_entry.message.c_str());
-	m_warnings.emplace_back(warning_entry);
+	add_warning(warning_entry, location);
 }
 
 void c_compiler_context::warning(
@@ -108,8 +139,7 @@ void c_compiler_context::verror(
 		str_vformat(format, args)
 	};
 
-	output_to_stream(std::cerr, "Error", enum_index(error), location, error_entry.message.c_str());
-	m_errors.emplace_back(error_entry);
+	add_error(error_entry, location);
 }
 
 void c_compiler_context::error(
@@ -154,18 +184,32 @@ const s_compiler_error &c_compiler_context::get_error(size_t index) const {
 }
 
 size_t c_compiler_context::get_source_file_count() const {
+	if (m_parent_context) {
+		return m_parent_context->get_source_file_count();
+	}
+
 	return m_source_files.size();
 }
 
 s_compiler_source_file &c_compiler_context::get_source_file(h_compiler_source_file handle) {
+	if (m_parent_context) {
+		return m_parent_context->get_source_file(handle);
+	}
+
 	return *m_source_files[handle.get_data()].get();
 }
 
 const s_compiler_source_file &c_compiler_context::get_source_file(h_compiler_source_file handle) const {
+	if (m_parent_context) {
+		return m_parent_context->get_source_file(handle);
+	}
+
 	return *m_source_files[handle.get_data()].get();
 }
 
 h_compiler_source_file c_compiler_context::get_or_add_source_file(const char *path, bool &was_added_out) {
+	// Deferred contexts may be used from multiple threads at once so they can't add source files
+	wl_assert(!m_parent_context);
 	was_added_out = false;
 
 	std::string canonical_path = canonicalize_path(path);
@@ -192,6 +236,45 @@ void *c_compiler_context::get_native_module_library_context(h_native_module_libr
 	return m_native_module_library_contexts[native_module_library_handle.get_data()];
 }
 
+void c_compiler_context::add_message(
+	const s_compiler_message &message_entry,
+	const s_compiler_source_location &location) {
+	if (m_parent_context) {
+		m_deferred_diagnostics.push_back({ e_diagnostic_type::k_message, m_messages.size(), location });
+	} else {
+		output_to_stream(std::cout, "Message", -1, location, message_entry.message.c_str());
+	}
+
+	m_messages.emplace_back(message_entry);
+}
+
+void c_compiler_context::add_warning(
+	const s_compiler_warning &warning_entry,
+	const s_compiler_source_location &location) {
+	if (m_parent_context) {
+		m_deferred_diagnostics.push_back({ e_diagnostic_type::k_warning, m_warnings.size(), location });
+	} else {
+		output_to_stream(
+			std::cerr,
+			"Warning",
+			enum_index(warning_entry.warning),
+			location,
+			warning_entry.message.c_str());
+	}
+
+	m_warnings.emplace_back(warning_entry);
+}
+
+void c_compiler_context::add_error(const s_compiler_error &error_entry, const s_compiler_source_location &location) {
+	if (m_parent_context) {
+		m_deferred_diagnostics.push_back({ e_diagnostic_type::k_error, m_errors.size(), location });
+	} else {
+		output_to_stream(std::cerr, "Error", enum_index(error_entry.error), location, error_entry.message.c_str());
+	}
+
+	m_errors.emplace_back(error_entry);
+}
+
 void c_compiler_context::output_to_stream(
 	std::ostream &stream,
 	const char *prefix,
@@ -209,13 +292,13 @@ std::string c_compiler_context::get_source_location_string(const s_compiler_sour
 	std::ostringstream stream;
 
 	if (location.source_file_handle.is_valid()) {
-		std::cout << " in file '" << m_source_files[location.source_file_handle.get_data()]->path << "'";
+		stream << " in file '" << get_source_file(location.source_file_handle).path << "'";
 		if (location.line >= 0) {
-			std::cout << " (" << location.line;
+			stream << " (" << location.line;
 			if (location.character >= 0) {
-				std::cout << ", " << location.character;
+				stream << ", " << location.character;
 			}
-			std::cout << ")";
+			stream << ")";
 		}
 	}
 
@@ -114,6 +114,15 @@ class c_compiler_context {
 public:
 	c_compiler_context(c_wrapped_array<void *> native_module_library_contexts);
 
+	// Creates a deferred context which shares the parent's source files and native module library contexts but holds
+	// onto its diagnostics rather than outputting them. This allows independent compilation work to be performed on
+	// worker threads. Source files must not be added while deferred contexts are in use.
+	explicit c_compiler_context(c_compiler_context *parent_context);
+
+	// Outputs and takes ownership of all diagnostics recorded by the given deferred context, in the order they were
+	// reported. Deferred contexts should be merged in a fixed order so that compiler output is deterministic.
+	void merge_deferred_context(c_compiler_context &deferred_context);
+
 	void message(
 		const s_compiler_source_location &location,
 		const char *format,
@@ -181,6 +190,24 @@ public:
 	void *get_native_module_library_context(h_native_module_library native_module_library_handle);
 
 private:
+	enum class e_diagnostic_type {
+		k_message,
+		k_warning,
+		k_error,
+
+		k_count
+	};
+
+	struct s_deferred_diagnostic {
+		e_diagnostic_type diagnostic_type;
+		size_t index;
+		s_compiler_source_location location;
+	};
+
+	void add_message(const s_compiler_message &message_entry, const s_compiler_source_location &location);
+	void add_warning(const s_compiler_warning &warning_entry, const s_compiler_source_location &location);
+	void add_error(const s_compiler_error &error_entry, const s_compiler_source_location &location);
+
 	void output_to_stream(
 		std::ostream &stream,
 		const char *prefix,
@@ -191,10 +218,16 @@ private:
 
 	c_wrapped_array<void *> m_native_module_library_contexts;
 
+	// If set, this is a deferred context and source files are owned by the parent
+	c_compiler_context *m_parent_context = nullptr;
+
 	// We use unique_ptr to make sure that existing source file references remain valid when a new source file is added
 	std::vector<std::unique_ptr<s_compiler_source_file>> m_source_files;
 
 	std::vector<s_compiler_message> m_messages;
 	std::vector<s_compiler_warning> m_warnings;
 	std::vector<s_compiler_error> m_errors;
+
+	// Diagnostics in the order they were reported, only used by deferred contexts
+	std::vector<s_deferred_diagnostic> m_deferred_diagnostics;
 };
\ No newline at end of file
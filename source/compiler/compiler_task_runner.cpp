@@ -0,0 +1,68 @@
+#include "common/threading/thread.h"
+
+#include "compiler/compiler_task_runner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+struct s_compiler_task_runner_state {
+	void (*task_function)(const void *task_context, size_t task_index);
+	const void *task_context;
+	size_t task_count;
+	std::atomic<size_t> next_task_index;
+};
+
+static void execute_compiler_tasks(s_compiler_task_runner_state *state);
+static void compiler_worker_thread_entry_point(const s_thread_parameter_block *parameter_block);
+
+void c_compiler_task_runner::run_internal(
+	uint32 thread_count,
+	size_t task_count,
+	f_task task_function,
+	const void *task_context) {
+	s_compiler_task_runner_state state;
+	state.task_function = task_function;
+	state.task_context = task_context;
+	state.task_count = task_count;
+	state.next_task_index = 0;
+
+	// The calling thread also executes tasks so we never need more workers than there are remaining tasks
+	size_t worker_thread_count = std::min<size_t>(std::max(thread_count, 1u), task_count);
+	worker_thread_count = (worker_thread_count > 0) ? worker_thread_count - 1 : 0;
+
+	std::vector<c_thread> worker_threads(worker_thread_count);
+	for (c_thread &worker_thread : worker_threads) {
+		s_thread_definition thread_definition;
+		thread_definition.thread_name = "compiler_worker";
+		thread_definition.stack_size = 0;
+		thread_definition.thread_priority = e_thread_priority::k_normal;
+		thread_definition.processor = -1;
+		thread_definition.thread_entry_point = compiler_worker_thread_entry_point;
+
+		zero_type(&thread_definition.parameter_block);
+		*thread_definition.parameter_block.get_memory_typed<s_compiler_task_runner_state *>() = &state;
+		worker_thread.start(thread_definition);
+	}
+
+	execute_compiler_tasks(&state);
+
+	for (c_thread &worker_thread : worker_threads) {
+		worker_thread.join();
+	}
+}
+
+static void execute_compiler_tasks(s_compiler_task_runner_state *state) {
+	while (true) {
+		size_t task_index = state->next_task_index.fetch_add(1, std::memory_order_relaxed);
+		if (task_index >= state->task_count) {
+			break;
+		}
+
+		state->task_function(state->task_context, task_index);
+	}
+}
+
+static void compiler_worker_thread_entry_point(const s_thread_parameter_block *parameter_block) {
+	execute_compiler_tasks(*parameter_block->get_memory_typed<s_compiler_task_runner_state *>());
+}
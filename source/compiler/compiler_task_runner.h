@@ -0,0 +1,26 @@
+#pragma once
+
+#include "common/common.h"
+
+// Runs independent compiler tasks across worker threads. Each task is identified by its index and should only write to
+// state owned by that index so that the caller can consume the results in a deterministic order once run() returns.
+class c_compiler_task_runner {
+public:
+	// If thread_count is 0 or 1, all tasks are run on the calling thread. Otherwise, the calling thread executes tasks
+	// alongside thread_count - 1 worker threads.
+	template<typename t_task>
+	static void run(uint32 thread_count, size_t task_count, const t_task &task) {
+		run_internal(
+			thread_count,
+			task_count,
+			[](const void *task_context, size_t task_index) {
+				(*static_cast<const t_task *>(task_context))(task_index);
+			},
+			&task);
+	}
+
+private:
+	using f_task = void (*)(const void *task_context, size_t task_index);
+
+	static void run_internal(uint32 thread_count, size_t task_count, f_task task_function, const void *task_context);
+};
@@ -185,7 +185,7 @@ c_import_resolver_visitor::c_import_resolver_visitor(
 	, m_source_file_handle(source_file_handle) {
 	m_native_import = false;
 	m_import_path_prefix_dot_count = 0;
-	bool m_import_as_local = false;
+	m_import_as_local = false;
 }
 
 void c_import_resolver_visitor::exit_import() {
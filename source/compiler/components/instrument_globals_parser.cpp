@@ -30,6 +30,11 @@ static bool get_unsigned_nonzero_integer(
 	const s_token &command_token,
 	const s_token &value_token,
 	uint32 &value_out);
+static bool get_nonnegative_real(
+	c_compiler_context &context,
+	const s_token &command_token,
+	const s_token &value_token,
+	real32 &value_out);
 static bool get_bool(
 	c_compiler_context &context,
 	const s_token &command_token,
@@ -56,6 +61,16 @@ static void instrument_global_parser_activate_fx_immediately(
 	s_instrument_globals_context &instrument_globals_context,
 	const s_token &command_token,
 	c_wrapped_array<const s_token> tokens);
+static void instrument_global_parser_inaudible_voice_timeout(
+	c_compiler_context &context,
+	s_instrument_globals_context &instrument_globals_context,
+	const s_token &command_token,
+	c_wrapped_array<const s_token> tokens);
+static void instrument_global_parser_inaudible_voice_threshold(
+	c_compiler_context &context,
+	s_instrument_globals_context &instrument_globals_context,
+	const s_token &command_token,
+	c_wrapped_array<const s_token> tokens);
 
 struct s_instrument_global_parser {
 	const char *name;
@@ -67,7 +82,9 @@ static constexpr const s_instrument_global_parser k_instrument_global_parsers[]
 	{ "max_voices", instrument_global_parser_max_voices },
 	{ "sample_rate", instrument_global_parser_sample_rate },
 	{ "chunk_size", instrument_global_parser_chunk_size },
-	{ "activate_fx_immediately", instrument_global_parser_activate_fx_immediately }
+	{ "activate_fx_immediately", instrument_global_parser_activate_fx_immediately },
+	{ "inaudible_voice_timeout", instrument_global_parser_inaudible_voice_timeout },
+	{ "inaudible_voice_threshold", instrument_global_parser_inaudible_voice_threshold }
 };
 
 class c_instrument_globals_visitor : public c_wavelang_lr_parse_tree_visitor {
@@ -121,6 +138,14 @@ void s_instrument_globals_context::assign_defaults() {
 	if (!activate_fx_immediately_command_executed) {
 		activate_fx_immediately = false;
 	}
+
+	if (!inaudible_voice_timeout_command_executed) {
+		inaudible_voice_timeout = 0;
+	}
+
+	if (!inaudible_voice_threshold_command_executed) {
+		inaudible_voice_threshold = 0.0f;
+	}
 }
 
 std::vector<s_instrument_globals> s_instrument_globals_context::build_instrument_globals_set() const {
@@ -137,6 +162,8 @@ std::vector<s_instrument_globals> s_instrument_globals_context::build_instrument
 		globals.sample_rate = sample_rate;
 		globals.chunk_size = chunk_size;
 		globals.activate_fx_immediately = activate_fx_immediately;
+		globals.inaudible_voice_timeout = inaudible_voice_timeout;
+		globals.inaudible_voice_threshold = inaudible_voice_threshold;
 
 		result.push_back(globals);
 	}
@@ -248,6 +275,26 @@ static bool get_unsigned_nonzero_integer(
 	return true;
 }
 
+static bool get_nonnegative_real(
+	c_compiler_context &context,
+	const s_token &command_token,
+	const s_token &value_token,
+	real32 &value_out) {
+	if (value_token.token_type != e_token_type::k_literal_real
+		|| !(value_token.value.real_value >= 0.0f)) {
+		context.error(
+			e_compiler_error::k_invalid_instrument_global_parameters,
+			value_token.source_location,
+			"Instrument global '%s' value '%s' is not a non-negative real value",
+			escape_token_string_for_output(command_token.token_string).c_str(),
+			escape_token_string_for_output(value_token.token_string).c_str());
+		return false;
+	}
+
+	value_out = value_token.value.real_value;
+	return true;
+}
+
 static bool get_bool(
 	c_compiler_context &context,
 	const s_token &command_token,
@@ -404,6 +451,70 @@ static void instrument_global_parser_activate_fx_immediately(
 	instrument_globals_context.activate_fx_immediately_command_executed = true;
 }
 
+static void instrument_global_parser_inaudible_voice_timeout(
+	c_compiler_context &context,
+	s_instrument_globals_context &instrument_globals_context,
+	const s_token &command_token,
+	c_wrapped_array<const s_token> tokens) {
+	if (instrument_globals_context.inaudible_voice_timeout_command_executed) {
+		context.error(
+			e_compiler_error::k_duplicate_instrument_global,
+			command_token.source_location,
+			"Instrument global '%s' specified multiple times",
+			escape_token_string_for_output(command_token.token_string).c_str());
+		return;
+	}
+
+	if (tokens.get_count() != 1) {
+		context.error(
+			e_compiler_error::k_invalid_instrument_global_parameters,
+			command_token.source_location,
+			"Incorrect number of values specified for instrument global '%s'",
+			escape_token_string_for_output(command_token.token_string).c_str());
+		return;
+	}
+
+	if (!get_unsigned_integer(context, command_token, tokens[0], instrument_globals_context.inaudible_voice_timeout)) {
+		return;
+	}
+
+	instrument_globals_context.inaudible_voice_timeout_command_executed = true;
+}
+
+static void instrument_global_parser_inaudible_voice_threshold(
+	c_compiler_context &context,
+	s_instrument_globals_context &instrument_globals_context,
+	const s_token &command_token,
+	c_wrapped_array<const s_token> tokens) {
+	if (instrument_globals_context.inaudible_voice_threshold_command_executed) {
+		context.error(
+			e_compiler_error::k_duplicate_instrument_global,
+			command_token.source_location,
+			"Instrument global '%s' specified multiple times",
+			escape_token_string_for_output(command_token.token_string).c_str());
+		return;
+	}
+
+	if (tokens.get_count() != 1) {
+		context.error(
+			e_compiler_error::k_invalid_instrument_global_parameters,
+			command_token.source_location,
+			"Incorrect number of values specified for instrument global '%s'",
+			escape_token_string_for_output(command_token.token_string).c_str());
+		return;
+	}
+
+	if (!get_nonnegative_real(
+		context,
+		command_token,
+		tokens[0],
+		instrument_globals_context.inaudible_voice_threshold)) {
+		return;
+	}
+
+	instrument_globals_context.inaudible_voice_threshold_command_executed = true;
+}
+
 c_instrument_globals_visitor::c_instrument_globals_visitor(
 	c_compiler_context &context,
 	h_compiler_source_file source_file_handle,
@@ -24,6 +24,12 @@ struct s_instrument_globals_context {
 	bool activate_fx_immediately_command_executed = false;
 	bool activate_fx_immediately = false;
 
+	bool inaudible_voice_timeout_command_executed = false;
+	uint32 inaudible_voice_timeout = 0;
+
+	bool inaudible_voice_threshold_command_executed = false;
+	real32 inaudible_voice_threshold = 0.0f;
+
 	// Fills in defaults for values which weren't specified
 	void assign_defaults();
 
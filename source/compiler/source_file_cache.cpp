@@ -0,0 +1,63 @@
+#include "compiler/source_file_cache.h"
+
+static void copy_tokens(
+	const std::vector<char> &source_from,
+	const std::vector<s_token> &tokens_from,
+	const std::vector<char> &source_to,
+	h_compiler_source_file source_file_handle_to,
+	std::vector<s_token> &tokens_to);
+
+bool c_compiler_source_file_cache::try_copy_source_file(
+	h_compiler_source_file source_file_handle,
+	s_compiler_source_file &source_file) const {
+	auto iter = m_source_files.find(source_file.path);
+	if (iter == m_source_files.end()) {
+		return false;
+	}
+
+	const s_cached_source_file &cached_source_file = *iter->second.get();
+	source_file.source = cached_source_file.source;
+	copy_tokens(
+		cached_source_file.source,
+		cached_source_file.tokens,
+		source_file.source,
+		source_file_handle,
+		source_file.tokens);
+	source_file.parse_tree = cached_source_file.parse_tree;
+	return true;
+}
+
+void c_compiler_source_file_cache::add_source_file(const s_compiler_source_file &source_file) {
+	if (m_source_files.find(source_file.path) != m_source_files.end()) {
+		return;
+	}
+
+	std::unique_ptr<s_cached_source_file> cached_source_file = std::make_unique<s_cached_source_file>();
+	cached_source_file->source = source_file.source;
+	copy_tokens(
+		source_file.source,
+		source_file.tokens,
+		cached_source_file->source,
+		h_compiler_source_file::invalid(),
+		cached_source_file->tokens);
+	cached_source_file->parse_tree = source_file.parse_tree;
+
+	m_source_files.insert(std::make_pair(source_file.path, std::move(cached_source_file)));
+}
+
+static void copy_tokens(
+	const std::vector<char> &source_from,
+	const std::vector<s_token> &tokens_from,
+	const std::vector<char> &source_to,
+	h_compiler_source_file source_file_handle_to,
+	std::vector<s_token> &tokens_to) {
+	wl_assert(source_from.size() == source_to.size());
+
+	// Token strings point into the source, so rebase them onto the new copy of the source
+	tokens_to = tokens_from;
+	for (s_token &token : tokens_to) {
+		size_t offset = static_cast<size_t>(token.token_string.data() - source_from.data());
+		token.token_string = std::string_view(source_to.data() + offset, token.token_string.length());
+		token.source_location.source_file_handle = source_file_handle_to;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "common/common.h"
+
+#include "compiler/source_file.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Holds the lexed and parsed results of source files so that a batch of compilations only processes each shared import
+// once. Tokens refer to the handle of their source file, which is specific to each compiler context, so cached files
+// are copied into each context rather than shared. Lookups may run concurrently with each other but not with add().
+class c_compiler_source_file_cache {
+public:
+	// If the file at the given resolved path has been cached, copies its source, tokens, and parse tree into the
+	// provided source file and returns true
+	bool try_copy_source_file(h_compiler_source_file source_file_handle, s_compiler_source_file &source_file) const;
+
+	// Caches a source file which was lexed and parsed without errors
+	void add_source_file(const s_compiler_source_file &source_file);
+
+private:
+	struct s_cached_source_file {
+		std::vector<char> source;
+		std::vector<s_token> tokens;
+		c_lr_parse_tree parse_tree;
+	};
+
+	// Keyed by resolved source file path
+	std::unordered_map<std::string, std::unique_ptr<s_cached_source_file>> m_source_files;
+};
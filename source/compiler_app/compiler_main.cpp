@@ -4,6 +4,7 @@
 #include "common/utility/memory_debugger.h"
 
 #include "compiler/compiler.h"
+#include "compiler/source_file_cache.h"
 
 #include "compiler_app/getopt/getopt.h"
 
@@ -13,7 +14,10 @@
 #include "instrument/native_module_registry.h"
 #include "instrument/native_modules/scrape_native_modules.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <thread>
 
 static constexpr const char *k_wavelang_instrument_extension = "wli";
 static constexpr const char *k_documentation_filename = "registered_native_modules.txt";
@@ -35,6 +39,8 @@ int main(int argc, char **argv) {
 	bool output_documentation = false;
 	bool output_native_module_graph = false;
 	bool condense_large_arrays = false;
+	bool batch_mode = false;
+	uint32 thread_count = std::max(std::thread::hardware_concurrency(), 1u);
 	bool command_line_option_error = false;
 	int32 first_file_argument_index;
 
@@ -42,7 +48,8 @@ int main(int argc, char **argv) {
 		// Read the command line options
 		int32 getopt_result;
 		extern int optind;
-		while ((getopt_result = getopt(argc, argv, const_cast<char *>("dgG"))) != -1) {
+		extern char *optarg;
+		while ((getopt_result = getopt(argc, argv, const_cast<char *>("dgGbj:"))) != -1) {
 			switch (getopt_result) {
 			case 'd':
 				output_documentation = true;
@@ -57,6 +64,21 @@ int main(int argc, char **argv) {
 				condense_large_arrays = true;
 				break;
 
+			case 'b':
+				batch_mode = true;
+				break;
+
+			case 'j':
+			{
+				int32 thread_count_argument = std::atoi(optarg);
+				if (thread_count_argument <= 0) {
+					command_line_option_error = true;
+				} else {
+					thread_count = cast_integer_verify<uint32>(thread_count_argument);
+				}
+				break;
+			}
+
 			case '?':
 				command_line_option_error = true;
 				break;
@@ -76,7 +98,7 @@ int main(int argc, char **argv) {
 	}
 
 	if (command_line_option_error) {
-		std::cerr << "usage: " << argv[0] << " [-d] [-g] [-G] fname1 [fname2 ...]\n";
+		std::cerr << "usage: " << argv[0] << " [-d] [-g] [-G] [-b] [-j threads] fname1 [fname2 ...]\n";
 		return 1;
 	}
 
@@ -92,11 +114,17 @@ int main(int argc, char **argv) {
 		}
 	}
 
+	// In batch mode, source files imported by multiple input files are only lexed and parsed once
+	c_compiler_source_file_cache source_file_cache;
+	s_compiler_settings compiler_settings;
+	compiler_settings.thread_count = thread_count;
+	compiler_settings.source_file_cache = batch_mode ? &source_file_cache : nullptr;
+
 	// Compile each input file
 	for (int32 arg = first_file_argument_index; arg < argc; arg++) {
 		std::cout << "Compiling '" << argv[arg] << "'\n";
 		c_compiler_context context = c_compiler_context(c_wrapped_array<void *>(library_contexts));
-		std::unique_ptr<c_instrument> instrument(c_compiler::compile(context, argv[arg]));
+		std::unique_ptr<c_instrument> instrument(c_compiler::compile(context, argv[arg], compiler_settings));
 
 		if (instrument) {
 			std::string fname_no_ext = argv[arg];
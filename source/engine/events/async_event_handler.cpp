@@ -53,6 +53,10 @@ void c_async_event_handler::initialize(const s_async_event_handler_settings &set
 	wl_assert(m_settings.buffer_size > sizeof(uint32) + m_settings.max_event_size);
 	// We store offsets as uint32, so the buffer size can't exceed this capacity
 	wl_assert(m_settings.buffer_size <= std::numeric_limits<uint32>::max());
+	m_settings.real_time_channel_buffer_size =
+		align_size(m_settings.real_time_channel_buffer_size, k_buffer_alignment);
+	wl_assert(m_settings.real_time_channel_buffer_size > sizeof(uint32) + m_settings.max_event_size);
+	wl_assert(m_settings.real_time_channel_buffer_size <= std::numeric_limits<uint32>::max());
 	wl_assert(m_settings.flush_period_ms > 0);
 
 	// Allocate the buffer with extra padding to avoid wrapping events
@@ -68,10 +72,22 @@ bool c_async_event_handler::is_initialized() const {
 	return m_initialized;
 }
 
-void c_async_event_handler::begin_event_handling() {
+void c_async_event_handler::begin_event_handling(uint32 real_time_channel_count) {
 	wl_assert(m_initialized);
 	wl_assert(!m_event_handling_thread.is_running());
 
+	wl_assert(m_real_time_channels.empty());
+	m_real_time_channels.resize(real_time_channel_count);
+	for (std::unique_ptr<s_real_time_channel> &channel : m_real_time_channels) {
+		channel = std::make_unique<s_real_time_channel>();
+		channel->buffer.allocate(m_settings.real_time_channel_buffer_size + m_settings.max_event_size);
+		channel->read_position = 0;
+		channel->write_position = 0;
+		channel->dropped_event_count = 0;
+	}
+
+	m_reported_dropped_event_count = 0;
+
 	m_flush_required = false;
 	m_read_write_position = 0;
 	m_stopwatch.initialize();
@@ -102,6 +118,7 @@ void c_async_event_handler::end_event_handling() {
 	}
 
 	m_event_handling_thread.join();
+	m_real_time_channels.clear();
 }
 
 void c_async_event_handler::submit_event(size_t event_size, const void *event_data) {
@@ -201,6 +218,82 @@ void c_async_event_handler::submit_event(size_t event_size, const void *event_da
 	} while (!wrote_to_buffer);
 }
 
+void c_async_event_handler::submit_real_time_event(uint32 channel_index, size_t event_size, const void *event_data) {
+	wl_assert(valid_index(channel_index, m_real_time_channels.size()));
+	wl_assert(event_size <= m_settings.max_event_size);
+	if (event_size == 0) {
+		return;
+	}
+
+	wl_assert(event_data);
+
+	s_real_time_channel &channel = *m_real_time_channels[channel_index];
+	size_t total_size = align_size(sizeof(uint32) + event_size, k_buffer_alignment);
+
+	// This is the only thread which writes the write position, so only the read position can change underneath us
+	uint32 write_position = channel.write_position.load(std::memory_order_relaxed);
+	uint32 read_position = channel.read_position.load(std::memory_order_acquire);
+	uint32 channel_buffer_size = static_cast<uint32>(m_settings.real_time_channel_buffer_size);
+	uint32 new_write_position = (write_position + static_cast<uint32>(total_size)) % channel_buffer_size;
+
+	// As with the main buffer, don't allow the write position to reach the read position. Rather than waiting for a
+	// flush, drop the event and count it so it can be reported later.
+	if (does_a_to_b_pass_c(write_position, new_write_position, read_position)) {
+		// This is the only thread which writes the count, so a read-modify-write isn't required
+		uint64 dropped_event_count = channel.dropped_event_count.load(std::memory_order_relaxed);
+		channel.dropped_event_count.store(dropped_event_count + 1, std::memory_order_relaxed);
+		return;
+	}
+
+	// Since the buffer has a tail, don't worry about wrapping
+	uint8 *event_pointer = channel.buffer.get_array().get_pointer() + write_position;
+	*reinterpret_cast<uint32 *>(event_pointer) = cast_integer_verify<uint32>(event_size);
+	memcpy(event_pointer + sizeof(uint32), event_data, event_size);
+
+	// Publish the event
+	channel.write_position.store(new_write_position, std::memory_order_release);
+}
+
+void c_async_event_handler::flush_real_time_channels() {
+	uint32 channel_buffer_size = static_cast<uint32>(m_settings.real_time_channel_buffer_size);
+	uint64 dropped_event_count = 0;
+	for (std::unique_ptr<s_real_time_channel> &channel : m_real_time_channels) {
+		const uint8 *buffer = channel->buffer.get_array().get_pointer();
+
+		// Only events published before this point are read, any others are picked up by the next flush
+		uint32 read_position = channel->read_position.load(std::memory_order_relaxed);
+		uint32 write_position = channel->write_position.load(std::memory_order_acquire);
+		while (read_position != write_position) {
+			wl_assert(is_size_aligned(read_position, k_buffer_alignment));
+			uint32 event_size = *reinterpret_cast<const uint32 *>(buffer + read_position);
+			wl_assert(event_size > 0 && event_size <= m_settings.max_event_size);
+
+			m_settings.event_handler(
+				m_settings.event_handler_context,
+				event_size,
+				buffer + read_position + sizeof(uint32));
+
+			// Release the space as we go so the producer can reuse it as soon as possible
+			uint32 read_advance = static_cast<uint32>(align_size(sizeof(uint32) + event_size, k_buffer_alignment));
+			read_position = (read_position + read_advance) % channel_buffer_size;
+			channel->read_position.store(read_position, std::memory_order_release);
+		}
+
+		dropped_event_count += channel->dropped_event_count.load(std::memory_order_relaxed);
+	}
+
+	wl_assert(dropped_event_count >= m_reported_dropped_event_count);
+	if (dropped_event_count > m_reported_dropped_event_count) {
+		if (m_settings.dropped_event_handler) {
+			m_settings.dropped_event_handler(
+				m_settings.event_handler_context,
+				dropped_event_count - m_reported_dropped_event_count);
+		}
+
+		m_reported_dropped_event_count = dropped_event_count;
+	}
+}
+
 void c_async_event_handler::flush() {
 	// Obtain the initial read position
 	s_read_write_position current_position;
@@ -258,6 +351,9 @@ void c_async_event_handler::flush() {
 			current_position.read = read_advancer.new_position;
 		}
 	} while (!done);
+
+	// Real-time producers never signal a flush, so their channels are drained whenever any flush occurs
+	flush_real_time_channels();
 }
 
 void c_async_event_handler::signal_flush() {
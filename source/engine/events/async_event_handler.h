@@ -2,32 +2,50 @@
 
 #include "common/common.h"
 #include "common/threading/condition_variable.h"
+#include "common/threading/lock_free.h"
 #include "common/threading/mutex.h"
 #include "common/threading/thread.h"
 #include "common/utility/aligned_allocator.h"
 #include "common/utility/stopwatch.h"
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 using f_event_handler = void (*)(void *context, size_t event_size, const void *event_data);
+using f_dropped_event_handler = void (*)(void *context, uint64 dropped_event_count);
 
 struct s_async_event_handler_settings {
 	f_event_handler event_handler;
+
+	// Optional, called on the event handling thread with the number of real-time events dropped since the last call
+	f_dropped_event_handler dropped_event_handler;
+
 	void *event_handler_context;
 	size_t max_event_size;
 	size_t buffer_size;
+
+	// Size of each real-time channel's buffer. Real-time producers never wake the event handling thread, so this should
+	// be large enough to hold the events submitted by one thread during a flush period.
+	size_t real_time_channel_buffer_size;
+
 	uint32 flush_period_ms;
 
 	void set_default() {
 		event_handler = nullptr;
+		dropped_event_handler = nullptr;
 		event_handler_context = nullptr;
 		max_event_size = 1024;
 		buffer_size = 4 * 1024 * 1024; // 4mb
+		real_time_channel_buffer_size = 64 * 1024; // 64kb
 		flush_period_ms = 250;
 	}
 };
 
 class c_async_event_handler {
+private:
+	static constexpr size_t k_buffer_alignment = sizeof(uint32);
+
 public:
 	c_async_event_handler();
 
@@ -35,15 +53,39 @@ public:
 
 	void initialize(const s_async_event_handler_settings &settings);
 	bool is_initialized() const;
-	void begin_event_handling();
+
+	// Real-time channels are created for the duration of event handling
+	void begin_event_handling(uint32 real_time_channel_count = 0);
 	void end_event_handling();
 
 	// Functions called from any thread:
 
-	// Queues an event to be processed by all registered event handlers
+	// Queues an event to be processed by all registered event handlers. If the buffer is full, this blocks until the
+	// event handling thread has flushed.
 	void submit_event(size_t event_size, const void *event_data);
 
+	// Queues an event on a real-time channel. This is wait-free: it never locks, allocates, or waits, and if the
+	// channel is full, the event is dropped and counted instead. Each channel must only be used by one thread at a
+	// time. Events are not ordered with respect to events submitted through other channels or through submit_event().
+	void submit_real_time_event(uint32 channel_index, size_t event_size, const void *event_data);
+
 private:
+	// A single-producer, single-consumer queue using the same event layout as the main buffer
+	struct ALIGNAS_LOCK_FREE s_real_time_channel {
+		// Padded by max_event_size to avoid wrapping events, like the main buffer
+		c_aligned_allocator<uint8, k_buffer_alignment> buffer;
+
+		// Only written by the event handling thread
+		ALIGNAS_LOCK_FREE std::atomic<uint32> read_position;
+
+		// Only written by the producer thread
+		ALIGNAS_LOCK_FREE std::atomic<uint32> write_position;
+		std::atomic<uint64> dropped_event_count;
+	};
+
+	// Called from the event handling thread to flush all real-time channels and report dropped events
+	void flush_real_time_channels();
+
 	// Called from the event handling thread to flush all queued events
 	void flush();
 
@@ -57,8 +99,6 @@ private:
 	static void event_handling_thread_function_entry_point(const s_thread_parameter_block *params);
 	void event_handling_thread_function();
 
-	static constexpr size_t k_buffer_alignment = sizeof(uint32);
-
 	// Whether settings have been initialized
 	bool m_initialized;
 
@@ -95,5 +135,11 @@ private:
 
 	// Flag indicating that the event handling thread should terminate
 	bool m_event_handling_thread_terminate_flag;
+
+	// Real-time channels, which are only allocated while event handling is active
+	std::vector<std::unique_ptr<s_real_time_channel>> m_real_time_channels;
+
+	// Total number of dropped real-time events which have been reported so far
+	uint64 m_reported_dropped_event_count;
 };
 
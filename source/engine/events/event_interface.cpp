@@ -25,14 +25,22 @@ uint8 register_event_data_type_internal(f_build_event_string build_event_string)
 	return id;
 }
 
-void c_event_interface::initialize(c_async_event_handler *event_handler) {
+void c_event_interface::initialize(c_async_event_handler *event_handler, uint32 real_time_channel_index) {
 	m_event_handler = event_handler;
+	m_real_time_channel_index = real_time_channel_index;
 }
 
 void c_event_interface::submit(const c_event &e) {
 	if (m_event_handler) {
 		c_wrapped_array<const uint8> event_data = e.get_event_data();
-		m_event_handler->submit_event(event_data.get_count(), event_data.get_pointer());
+		if (m_real_time_channel_index == k_invalid_real_time_channel_index) {
+			m_event_handler->submit_event(event_data.get_count(), event_data.get_pointer());
+		} else {
+			m_event_handler->submit_real_time_event(
+				m_real_time_channel_index,
+				event_data.get_count(),
+				event_data.get_pointer());
+		}
 	}
 }
 
@@ -113,8 +113,13 @@ template<typename t_value> void register_event_data_type() {
 // $TODO remove all this complexity and just change it to use a format string
 class c_event_interface {
 public:
-	// Pass null to disable events
-	void initialize(c_async_event_handler *event_handler);
+	static constexpr uint32 k_invalid_real_time_channel_index = static_cast<uint32>(-1);
+
+	// Pass null to disable events. If a real-time channel is provided, submission never blocks and events are dropped
+	// when the channel is full. The interface must then only be used by one thread at a time.
+	void initialize(
+		c_async_event_handler *event_handler,
+		uint32 real_time_channel_index = k_invalid_real_time_channel_index);
 	void submit(const c_event &e);
 
 	// Constructs an event string from event data
@@ -125,6 +130,7 @@ public:
 
 private:
 	c_async_event_handler *m_event_handler;
+	uint32 m_real_time_channel_index;
 };
 
 // Macros for convenience. Example usage:
@@ -3,6 +3,7 @@
 #include "engine/executor/channel_mixer.h"
 
 #include <algorithm>
+#include <cmath>
 
 static constexpr uint32 k_invalid_buffer_pool_index = -1;
 
@@ -10,12 +11,30 @@ void c_buffer_manager::initialize(
 	const c_runtime_instrument *runtime_instrument,
 	uint32 max_buffer_size,
 	uint32 input_channel_count,
-	uint32 output_channel_count) {
+	uint32 output_channel_count,
+	uint32 voice_graph_instance_count,
+	const s_static_array<e_task_graph_schedule, enum_count<e_instrument_stage>()> &task_graph_schedules) {
 	wl_assert(runtime_instrument);
 	wl_assert(max_buffer_size > 0);
 	wl_assert(output_channel_count > 0);
+	wl_assert(voice_graph_instance_count > 0);
 
 	m_runtime_instrument = runtime_instrument;
+	m_task_graph_schedules = task_graph_schedules;
+
+	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
+		const c_task_graph *task_graph = runtime_instrument->get_task_graph(instrument_stage);
+		if (!task_graph) {
+			continue;
+		}
+
+		uint32 instance_count = (instrument_stage == e_instrument_stage::k_voice) ? voice_graph_instance_count : 1;
+		std::vector<c_task_graph_instance> &graph_instances = m_graph_instances[enum_index(instrument_stage)];
+		graph_instances.resize(instance_count);
+		for (c_task_graph_instance &graph_instance : graph_instances) {
+			graph_instance.initialize(task_graph);
+		}
+	}
 
 	uint32 instrument_input_channel_count = runtime_instrument->get_input_channel_count();
 	if (instrument_input_channel_count == 0) {
@@ -61,17 +80,12 @@ void c_buffer_manager::initialize(
 		}
 	}
 
-	if (runtime_instrument->get_voice_task_graph()) {
-		// During the voice processing phase, start with the buffers from the voice task graph
-		c_wrapped_array<const c_task_graph::s_buffer_usage_info> voice_graph_buffer_usage_info =
-			runtime_instrument->get_voice_task_graph()->get_buffer_usage_info();
-
-		voice_buffer_usage_info.assign(
-			voice_graph_buffer_usage_info.get_pointer(),
-			voice_graph_buffer_usage_info.get_pointer() + voice_graph_buffer_usage_info.get_count());
+	// Task graph buffers don't come from the pools because they're bound to buffer slots
 
+	if (runtime_instrument->get_voice_task_graph()) {
 		// Voice accumulation buffers and voice shift buffers exist in parallel with voice processing, so we need an
-		// additional two buffers for each voice output
+		// additional two buffers for each voice output. Accumulation always occurs serially so only one set of shift
+		// buffers is required regardless of the instance count.
 		c_buffer_array voice_outputs = runtime_instrument->get_voice_task_graph()->get_outputs();
 		m_voice_shift_buffers.reserve(voice_outputs.get_count());
 		m_voice_accumulation_buffers.reserve(voice_outputs.get_count());
@@ -94,14 +108,6 @@ void c_buffer_manager::initialize(
 	}
 
 	if (runtime_instrument->get_fx_task_graph()) {
-		// During the FX processing phase, start with the buffers from the FX task graph
-		c_wrapped_array<const c_task_graph::s_buffer_usage_info> fx_graph_buffer_usage_info =
-			runtime_instrument->get_fx_task_graph()->get_buffer_usage_info();
-
-		fx_buffer_usage_info.assign(
-			fx_graph_buffer_usage_info.get_pointer(),
-			fx_graph_buffer_usage_info.get_pointer() + fx_graph_buffer_usage_info.get_count());
-
 		// Reserve a buffer for each FX output
 		c_buffer_array fx_outputs = runtime_instrument->get_fx_task_graph()->get_outputs();
 		m_fx_output_buffers.reserve(fx_outputs.get_count());
@@ -181,8 +187,11 @@ void c_buffer_manager::initialize(
 		m_real_buffer_pool_index = channel_mix_buffer_pool_index;
 	}
 
-	initialize_task_buffer_contexts(buffer_usage_info);
-	initialize_buffer_allocator(max_buffer_size, buffer_usage_info);
+	std::vector<c_task_graph::s_buffer_usage_info> slot_usage_info = build_buffer_slot_usage_info();
+	initialize_buffer_usage_counts();
+	initialize_buffer_allocator(m_buffer_allocator, max_buffer_size, buffer_usage_info);
+	initialize_buffer_allocator(m_buffer_slot_allocator, max_buffer_size, slot_usage_info);
+	bind_buffer_slots(slot_usage_info);
 
 	m_chunk_size = 0;
 	m_voices_processed = 0;
@@ -191,13 +200,12 @@ void c_buffer_manager::initialize(
 
 void c_buffer_manager::shutdown() {
 	m_buffer_allocator.shutdown();
+	m_buffer_slot_allocator.shutdown();
 
 	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
-		m_task_buffer_contexts[enum_index(instrument_stage)].clear();
+		m_graph_instances[enum_index(instrument_stage)].clear();
+		m_buffer_usage_counts[enum_index(instrument_stage)].clear();
 		m_dynamic_buffers[enum_index(instrument_stage)].clear();
-		m_task_buffers_to_decrement[enum_index(instrument_stage)].clear();
-		m_task_buffers_to_allocate[enum_index(instrument_stage)].clear();
-		m_output_buffers_to_decrement[enum_index(instrument_stage)].clear();
 	}
 
 	m_voice_output_pool_indices.clear();
@@ -210,6 +218,16 @@ void c_buffer_manager::shutdown() {
 	m_output_channel_mix_buffers.clear();
 }
 
+uint32 c_buffer_manager::get_graph_instance_count(e_instrument_stage instrument_stage) const {
+	return cast_integer_verify<uint32>(m_graph_instances[enum_index(instrument_stage)].size());
+}
+
+const c_task_graph_instance &c_buffer_manager::get_graph_instance(
+	e_instrument_stage instrument_stage,
+	uint32 instance_index) const {
+	return m_graph_instances[enum_index(instrument_stage)][instance_index];
+}
+
 void c_buffer_manager::begin_chunk(uint32 chunk_size) {
 	wl_assert(chunk_size <= m_buffer_allocator.get_buffer_pool_description(m_real_buffer_pool_index).size);
 	m_chunk_size = chunk_size;
@@ -258,21 +276,21 @@ void c_buffer_manager::allocate_voice_accumulation_buffers() {
 	}
 }
 
-void c_buffer_manager::allocate_and_initialize_voice_input_buffers(uint32 voice_sample_offset) {
-	const c_task_graph *task_graph = m_runtime_instrument->get_voice_task_graph();
-	wl_assert(task_graph);
-
-	for (size_t index = 0; index < task_graph->get_inputs().get_count(); index++) {
-		c_real_buffer *voice_input_buffer = &task_graph->get_inputs()[index]->get_as<c_real_buffer>();
-		// If any input is completely unused, the buffer should not be allocated
-		size_t buffer_index = task_graph->get_buffer_index(voice_input_buffer);
-		s_task_buffer_context &context = m_task_buffer_contexts[enum_index(e_instrument_stage::k_fx)][buffer_index];
-		if (context.initial_usages == 0) {
+void c_buffer_manager::allocate_and_initialize_voice_input_buffers(
+	uint32 instance_index,
+	uint32 voice_sample_offset) {
+	const c_task_graph_instance &graph_instance = get_graph_instance(e_instrument_stage::k_voice, instance_index);
+	const std::vector<uint32> &buffer_usage_counts = m_buffer_usage_counts[enum_index(e_instrument_stage::k_voice)];
+
+	c_buffer_array inputs = graph_instance.get_inputs();
+	for (size_t index = 0; index < inputs.get_count(); index++) {
+		c_real_buffer *voice_input_buffer = &inputs[index]->get_as<c_real_buffer>();
+		// If any input is completely unused, the buffer doesn't need to be initialized
+		size_t buffer_index = graph_instance.get_buffer_index(voice_input_buffer);
+		if (buffer_usage_counts[buffer_index] == 0) {
 			continue;
 		}
 
-		voice_input_buffer->set_memory(m_buffer_allocator.allocate_buffer_memory(m_real_buffer_pool_index));
-
 		// Shift the input data over by the voice sample offset
 		const c_real_buffer &input_buffer = m_input_buffers[index].get_as<c_real_buffer>();
 		if (input_buffer.is_constant()) {
@@ -296,11 +314,10 @@ void c_buffer_manager::allocate_voice_shift_buffers() {
 	}
 }
 
-void c_buffer_manager::accumulate_voice_output(uint32 voice_sample_offset) {
-	const c_task_graph *task_graph = m_runtime_instrument->get_voice_task_graph();
-	wl_assert(task_graph);
+void c_buffer_manager::accumulate_voice_output(uint32 instance_index, uint32 voice_sample_offset) {
+	const c_task_graph_instance &graph_instance = get_graph_instance(e_instrument_stage::k_voice, instance_index);
 
-	c_buffer_array outputs = task_graph->get_outputs();
+	c_buffer_array outputs = graph_instance.get_outputs();
 	for (size_t output_index = 0; output_index < outputs.get_count(); output_index++) {
 		c_real_buffer *output_buffer = &outputs[output_index]->get_as<c_real_buffer>();
 		c_real_buffer *voice_shift_buffer = &m_voice_shift_buffers[output_index].get_as<c_real_buffer>();
@@ -350,12 +367,6 @@ void c_buffer_manager::accumulate_voice_output(uint32 voice_sample_offset) {
 		buffer.set_memory(nullptr);
 	}
 
-	// Free the output buffers
-	decrement_buffer_usages(
-		e_instrument_stage::k_voice,
-		m_output_buffers_to_decrement[enum_index(e_instrument_stage::k_voice)]);
-
-	assert_all_task_buffers_free(e_instrument_stage::k_voice);
 	m_voices_processed++;
 }
 
@@ -369,43 +380,29 @@ void c_buffer_manager::allocate_fx_output_buffers() {
 }
 
 void c_buffer_manager::transfer_input_buffers_and_voice_accumulation_buffers_to_fx_inputs() {
-	const c_task_graph *task_graph = m_runtime_instrument->get_task_graph(e_instrument_stage::k_fx);
-	c_buffer_array inputs = task_graph->get_inputs();
+	const c_task_graph_instance &graph_instance = get_graph_instance(e_instrument_stage::k_fx, 0);
+	c_buffer_array inputs = graph_instance.get_inputs();
 
 	// FX inputs are divided into channel inputs and voice graph outputs. Channel inputs come first.
 	wl_assert(inputs.get_count() >= m_voice_accumulation_buffers.size());
 	size_t channel_input_count = inputs.get_count() - m_voice_accumulation_buffers.size();
-	c_buffer_array channel_inputs = inputs.get_range(0, channel_input_count);
-	c_buffer_array voice_inputs = inputs.get_range(channel_input_count, inputs.get_count() - channel_input_count);
-
-	for (size_t index = 0; index < channel_inputs.get_count(); index++) {
-		c_buffer *input_buffer = channel_inputs[index];
-		c_buffer *channel_input_buffer = &m_input_buffers[index];
-
-		wl_assert(!input_buffer->is_compile_time_constant());
-		input_buffer->set_memory(channel_input_buffer->get_data_untyped());
-		input_buffer->set_is_constant(channel_input_buffer->is_constant());
-		channel_input_buffer->set_memory(nullptr);
-	}
-
-	for (size_t index = 0; index < voice_inputs.get_count(); index++) {
-		c_buffer *input_buffer = voice_inputs[index];
-		c_buffer *voice_accumulation_buffer = &m_voice_accumulation_buffers[index];
 
-		wl_assert(!input_buffer->is_compile_time_constant());
-		input_buffer->set_memory(voice_accumulation_buffer->get_data_untyped());
-		input_buffer->set_is_constant(voice_accumulation_buffer->is_constant());
-		voice_accumulation_buffer->set_memory(nullptr);
-	}
+	// The FX inputs are bound to buffer slots so we must copy rather than transfer ownership
+	for (size_t index = 0; index < inputs.get_count(); index++) {
+		c_real_buffer *input_buffer = &inputs[index]->get_as<c_real_buffer>();
+		c_real_buffer *source_buffer = (index < channel_input_count)
+			? &m_input_buffers[index].get_as<c_real_buffer>()
+			: &m_voice_accumulation_buffers[index - channel_input_count].get_as<c_real_buffer>();
 
-	for (c_buffer *input_buffer : inputs) {
-		// If any input is completely unused, it should be deallocated immediately
-		size_t buffer_index = task_graph->get_buffer_index(input_buffer);
-		s_task_buffer_context &context = m_task_buffer_contexts[enum_index(e_instrument_stage::k_fx)][buffer_index];
-		if (context.initial_usages == 0) {
-			m_buffer_allocator.free_buffer_memory(input_buffer->get_data_untyped());
-			input_buffer->set_memory(nullptr);
+		if (source_buffer->is_constant()) {
+			input_buffer->assign_constant(source_buffer->get_constant());
+		} else {
+			copy_type(input_buffer->get_data(), source_buffer->get_data(), m_chunk_size);
+			input_buffer->set_is_constant(false);
 		}
+
+		m_buffer_allocator.free_buffer_memory(source_buffer->get_data_untyped());
+		source_buffer->set_memory(nullptr);
 	}
 }
 
@@ -418,10 +415,9 @@ void c_buffer_manager::free_voice_accumulation_buffers() {
 }
 
 void c_buffer_manager::store_fx_output() {
-	const c_task_graph *task_graph = m_runtime_instrument->get_fx_task_graph();
-	wl_assert(task_graph);
+	const c_task_graph_instance &graph_instance = get_graph_instance(e_instrument_stage::k_fx, 0);
 
-	c_buffer_array outputs = task_graph->get_outputs();
+	c_buffer_array outputs = graph_instance.get_outputs();
 	for (uint32 output_index = 0; output_index < outputs.get_count(); output_index++) {
 		c_real_buffer *output_buffer = &outputs[output_index]->get_as<c_real_buffer>();
 		c_real_buffer *fx_output_buffer = &m_fx_output_buffers[output_index].get_as<c_real_buffer>();
@@ -436,33 +432,16 @@ void c_buffer_manager::store_fx_output() {
 		}
 	}
 
-	// Free the output buffers
-	decrement_buffer_usages(
-		e_instrument_stage::k_fx,
-		m_output_buffers_to_decrement[enum_index(e_instrument_stage::k_fx)]);
-
-	assert_all_task_buffers_free(e_instrument_stage::k_fx);
 	m_fx_processed = true;
 }
 
-void c_buffer_manager::initialize_buffers_for_graph_processing(e_instrument_stage instrument_stage) {
-	const c_task_graph *task_graph = m_runtime_instrument->get_task_graph(instrument_stage);
-	wl_assert(task_graph);
-
-	for (size_t buffer_index : m_dynamic_buffers[enum_index(instrument_stage)]) {
-		s_task_buffer_context &context = m_task_buffer_contexts[enum_index(instrument_stage)][buffer_index];
-		wl_assert(context.pool_index >= 0);
-		wl_assert(context.buffer);
-		context.usages_remaining = context.initial_usages;
-	}
-}
-
 bool c_buffer_manager::process_remain_active_output(
 	e_instrument_stage instrument_stage,
+	uint32 instance_index,
 	uint64 voice_sample_index,
 	uint32 voice_sample_offset) {
-	const c_task_graph *task_graph = m_runtime_instrument->get_task_graph(instrument_stage);
-	wl_assert(task_graph);
+	const c_task_graph_instance &graph_instance = get_graph_instance(instrument_stage, instance_index);
+	const c_task_graph *task_graph = graph_instance.get_task_graph();
 
 	wl_assert(voice_sample_offset < m_chunk_size);
 	uint32 voice_chunk_size = m_chunk_size - voice_sample_offset;
@@ -470,7 +449,7 @@ bool c_buffer_manager::process_remain_active_output(
 	uint64 remaining_output_latency = (output_latency > voice_sample_index) ? (output_latency - voice_sample_index) : 0;
 
 	bool remain_active;
-	const c_bool_buffer *remain_active_buffer = &task_graph->get_remain_active_output()->get_as<c_bool_buffer>();
+	const c_bool_buffer *remain_active_buffer = &graph_instance.get_remain_active_output()->get_as<c_bool_buffer>();
 	if (remaining_output_latency >= voice_chunk_size) {
 		// Latency takes up this entire chunk, so ignore all remain_active values (if they were automatically latency-
 		// compensated, the initial values will be false, which is likely not what the user intended)
@@ -557,6 +536,23 @@ bool c_buffer_manager::process_remain_active_output(
 	return remain_active;
 }
 
+bool c_buffer_manager::are_outputs_inaudible(
+	e_instrument_stage instrument_stage,
+	uint32 instance_index,
+	real32 threshold) const {
+	const c_task_graph_instance &graph_instance = get_graph_instance(instrument_stage, instance_index);
+
+	c_buffer_array outputs = graph_instance.get_outputs();
+	for (uint32 output_index = 0; output_index < outputs.get_count(); output_index++) {
+		const c_real_buffer *output_buffer = &outputs[output_index]->get_as<c_real_buffer>();
+		if (!output_buffer->is_constant() || !(std::abs(output_buffer->get_constant()) <= threshold)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void c_buffer_manager::mix_voice_accumulation_buffers_to_channel_buffers() {
 	mix_to_channel_buffers(m_voice_accumulation_buffers);
 }
@@ -578,31 +574,6 @@ void c_buffer_manager::mix_output_channel_buffers_to_output_buffer(
 	assert_all_buffers_free();
 }
 
-void c_buffer_manager::allocate_output_buffers(e_instrument_stage instrument_stage, uint32 task_index) {
-	const std::vector<size_t> &buffer_indices = m_task_buffers_to_allocate[enum_index(instrument_stage)][task_index];
-	for (size_t buffer_index : buffer_indices) {
-		s_task_buffer_context &context = m_task_buffer_contexts[enum_index(instrument_stage)][buffer_index];
-
-		// Make sure the buffer isn't already allocated
-		wl_assert(!context.buffer->is_constant() && !context.buffer->get_data_untyped());
-		context.buffer->set_memory(m_buffer_allocator.allocate_buffer_memory(context.pool_index));
-	}
-
-#if IS_TRUE(ASSERTS_ENABLED)
-	// Make sure all buffers are allocated
-	const c_task_graph *task_graph = m_runtime_instrument->get_task_graph(instrument_stage);
-	wl_assert(task_graph);
-	for (c_task_buffer_iterator iter(task_graph->get_task_arguments(task_index)); iter.is_valid(); iter.next()) {
-		wl_assert(iter.get_buffer()->get_data_untyped());
-	}
-#endif // IS_TRUE(ASSERTS_ENABLED)
-}
-
-void c_buffer_manager::decrement_buffer_usages(e_instrument_stage instrument_stage, uint32 task_index) {
-	const std::vector<size_t> &buffer_indices = m_task_buffers_to_decrement[enum_index(instrument_stage)][task_index];
-	decrement_buffer_usages(instrument_stage, buffer_indices);
-}
-
 uint32 c_buffer_manager::get_buffer_pool(
 	c_task_data_type buffer_type,
 	const std::vector<c_task_graph::s_buffer_usage_info> &buffer_pools) const {
@@ -649,23 +620,29 @@ std::vector<c_task_graph::s_buffer_usage_info> c_buffer_manager::combine_buffer_
 	return result;
 }
 
-void c_buffer_manager::decrement_buffer_usages(
-	e_instrument_stage instrument_stage,
-	const std::vector<size_t> &buffer_indices) {
-	for (size_t buffer_index : buffer_indices) {
-		s_task_buffer_context &context = m_task_buffer_contexts[enum_index(instrument_stage)][buffer_index];
-
-		// Free the buffer if usage reaches 0
-		uint32 prev_usage = context.usages_remaining--;
-		wl_assert(prev_usage > 0);
-		if (prev_usage == 1) {
-			m_buffer_allocator.free_buffer_memory(context.buffer->get_data_untyped());
-			context.buffer->set_memory(nullptr);
+std::vector<c_task_graph::s_buffer_usage_info> c_buffer_manager::build_buffer_slot_usage_info() const {
+	std::vector<c_task_graph::s_buffer_usage_info> result;
+	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
+		const c_task_graph *task_graph = m_runtime_instrument->get_task_graph(instrument_stage);
+		if (!task_graph) {
+			continue;
+		}
+
+		e_task_graph_schedule schedule = m_task_graph_schedules[enum_index(instrument_stage)];
+		uint32 instance_count = get_graph_instance_count(instrument_stage);
+		for (uint32 slot_index = 0; slot_index < task_graph->get_buffer_slot_count(schedule); slot_index++) {
+			uint32 buffer_pool_index = get_or_add_buffer_pool(
+				task_graph->get_buffer_slot_type(schedule, slot_index),
+				result);
+			result[buffer_pool_index].max_concurrency += instance_count;
 		}
 	}
+
+	return result;
 }
 
 void c_buffer_manager::initialize_buffer_allocator(
+	c_buffer_allocator &buffer_allocator,
 	size_t max_buffer_size,
 	const std::vector<c_task_graph::s_buffer_usage_info> &buffer_usage_info) {
 	std::vector<s_buffer_pool_description> buffer_pool_descriptions;
@@ -703,103 +680,46 @@ void c_buffer_manager::initialize_buffer_allocator(
 	buffer_allocator_settings.buffer_pool_descriptions =
 		c_wrapped_array<const s_buffer_pool_description>(buffer_pool_descriptions);
 
-	m_buffer_allocator.initialize(buffer_allocator_settings);
+	buffer_allocator.initialize(buffer_allocator_settings);
 }
 
-void c_buffer_manager::initialize_task_buffer_contexts(
-	const std::vector<c_task_graph::s_buffer_usage_info> &buffer_usage_info) {
-	const c_task_graph *voice_task_graph = m_runtime_instrument->get_voice_task_graph();
-	const c_task_graph *fx_task_graph = m_runtime_instrument->get_fx_task_graph();
-
-	size_t task_buffer_context_count = 0;
-	const c_task_graph *task_graphs[] = { voice_task_graph, fx_task_graph };
+void c_buffer_manager::initialize_buffer_usage_counts() {
 	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
-		const c_task_graph *task_graph = task_graphs[enum_index(instrument_stage)];
+		const c_task_graph *task_graph = m_runtime_instrument->get_task_graph(instrument_stage);
 		if (!task_graph) {
 			continue;
 		}
 
-		m_task_buffer_contexts[enum_index(instrument_stage)].resize(task_graph->get_buffer_count());
+		std::vector<uint32> &buffer_usage_counts = m_buffer_usage_counts[enum_index(instrument_stage)];
+		buffer_usage_counts.resize(task_graph->get_buffer_count(), 0);
 		for (size_t buffer_index = 0; buffer_index < task_graph->get_buffer_count(); buffer_index++) {
-			c_buffer *buffer = task_graph->get_buffer_by_index(buffer_index);
-			if (buffer->is_compile_time_constant()) {
-				// Don't bother initializing contexts for compile-time constant buffers
-				continue;
+			if (!task_graph->get_buffer_by_index(buffer_index)->is_compile_time_constant()) {
+				m_dynamic_buffers[enum_index(instrument_stage)].push_back(buffer_index);
 			}
-
-			s_task_buffer_context &context = m_task_buffer_contexts[enum_index(instrument_stage)][buffer_index];
-
-			context.pool_index = get_buffer_pool(buffer->get_data_type(), buffer_usage_info);
-			wl_assert(valid_index(context.pool_index, buffer_usage_info.size()));
-
-			context.initial_usages = 0;
-			context.usages_remaining = 0;
-			context.buffer = buffer;
-
-			m_dynamic_buffers[enum_index(instrument_stage)].push_back(buffer_index);
 		}
 
-		m_task_buffers_to_decrement[enum_index(instrument_stage)].resize(task_graph->get_task_count());
-		m_task_buffers_to_allocate[enum_index(instrument_stage)].resize(task_graph->get_task_count());
-
 		for (uint32 task_index = 0; task_index < task_graph->get_task_count(); task_index++) {
-			c_task_function_runtime_arguments arguments = task_graph->get_task_arguments(task_index);
-
-			for (c_task_buffer_iterator it(arguments); it.is_valid(); it.next()) {
+			for (c_task_buffer_iterator it(task_graph->get_task_arguments(task_index)); it.is_valid(); it.next()) {
 				wl_assert(!it.get_buffer()->is_compile_time_constant());
-				size_t buffer_index = task_graph->get_buffer_index(it.get_buffer());
-
-				// Each time a buffer is used in a task, increment its usage count
-				m_task_buffer_contexts[enum_index(instrument_stage)][buffer_index].initial_usages++;
-				m_task_buffers_to_decrement[enum_index(instrument_stage)][task_index].push_back(buffer_index);
-
-				if (it.get_argument_direction() == e_task_argument_direction::k_out) {
-					std::vector<size_t> &buffers_to_allocate =
-						m_task_buffers_to_allocate[enum_index(instrument_stage)][task_index];
-
-					// Don't allocate if the output buffer is shared with an input
-					bool is_shared = false;
-					for (c_task_buffer_iterator it_inner(arguments); it_inner.is_valid(); it_inner.next()) {
-						if (it_inner.get_buffer() == it.get_buffer()
-							&& it_inner.get_argument_direction() == e_task_argument_direction::k_in) {
-							is_shared = true;
-							break;
-						}
-					}
-
-					if (!is_shared) {
-						buffers_to_allocate.push_back(buffer_index);
-					}
-				}
+				buffer_usage_counts[task_graph->get_buffer_index(it.get_buffer())]++;
 			}
 		}
 
-		// Each output buffer contributes to usage to prevent the buffer from deallocating at the end of the last task
 		for (c_buffer *output_buffer : task_graph->get_outputs()) {
 			if (!output_buffer->is_compile_time_constant()) {
-				size_t buffer_index = task_graph->get_buffer_index(output_buffer);
-				m_task_buffer_contexts[enum_index(instrument_stage)][buffer_index].initial_usages++;
-				m_output_buffers_to_decrement[enum_index(instrument_stage)].push_back(buffer_index);
+				buffer_usage_counts[task_graph->get_buffer_index(output_buffer)]++;
 			}
 		}
 
-		// Remain-active buffer contributes as well
 		if (!task_graph->get_remain_active_output()->is_compile_time_constant()) {
-			size_t buffer_index = task_graph->get_buffer_index(task_graph->get_remain_active_output());
-			m_task_buffer_contexts[enum_index(instrument_stage)][buffer_index].initial_usages++;
-			m_output_buffers_to_decrement[enum_index(instrument_stage)].push_back(buffer_index);
+			buffer_usage_counts[task_graph->get_buffer_index(task_graph->get_remain_active_output())]++;
 		}
 
 #if IS_TRUE(ASSERTS_ENABLED)
-		for (size_t buffer_index = 0; buffer_index < task_graph->get_buffer_count(); buffer_index++) {
-			c_buffer *buffer = task_graph->get_buffer_by_index(buffer_index);
-			if (buffer->is_compile_time_constant()) {
-				continue;
-			}
-
-			const s_task_buffer_context &context = m_task_buffer_contexts[enum_index(instrument_stage)][buffer_index];
-			if (context.initial_usages == 0) {
+		for (size_t buffer_index : m_dynamic_buffers[enum_index(instrument_stage)]) {
+			if (buffer_usage_counts[buffer_index] == 0) {
 				// If we have a completely unused buffer, it must be an input, since inputs aren't optimized away
+				c_buffer *buffer = task_graph->get_buffer_by_index(buffer_index);
 				bool is_input = false;
 				for (c_buffer *input_buffer : task_graph->get_inputs()) {
 					if (buffer == input_buffer) {
@@ -814,6 +734,35 @@ void c_buffer_manager::initialize_task_buffer_contexts(
 	}
 }
 
+void c_buffer_manager::bind_buffer_slots(const std::vector<c_task_graph::s_buffer_usage_info> &slot_usage_info) {
+	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
+		const c_task_graph *task_graph = m_runtime_instrument->get_task_graph(instrument_stage);
+		if (!task_graph) {
+			continue;
+		}
+
+		e_task_graph_schedule schedule = m_task_graph_schedules[enum_index(instrument_stage)];
+		std::vector<void *> slot_memory(task_graph->get_buffer_slot_count(schedule));
+		for (uint32 instance_index = 0; instance_index < get_graph_instance_count(instrument_stage); instance_index++) {
+			// Each instance's slots are allocated together so that they are adjacent in memory
+			for (uint32 slot_index = 0; slot_index < slot_memory.size(); slot_index++) {
+				uint32 buffer_pool_index = get_buffer_pool(
+					task_graph->get_buffer_slot_type(schedule, slot_index),
+					slot_usage_info);
+				slot_memory[slot_index] = m_buffer_slot_allocator.allocate_buffer_memory(buffer_pool_index);
+			}
+
+			// The slot memory is never freed explicitly, it is released all at once when the allocator shuts down
+			const c_task_graph_instance &graph_instance = get_graph_instance(instrument_stage, instance_index);
+			for (size_t buffer_index : m_dynamic_buffers[enum_index(instrument_stage)]) {
+				uint32 slot_index = task_graph->get_buffer_slot(schedule, buffer_index);
+				wl_assert(slot_index != c_task_graph::k_invalid_buffer_slot);
+				graph_instance.get_buffer_by_index(buffer_index)->set_memory(slot_memory[slot_index]);
+			}
+		}
+	}
+}
+
 void c_buffer_manager::mix_to_channel_buffers(std::vector<c_buffer> &source_buffers) {
 	// Allocate and zero channel buffers
 	for (c_buffer &buffer : m_output_channel_mix_buffers) {
@@ -847,22 +796,9 @@ void c_buffer_manager::free_channel_buffers() {
 }
 
 #if IS_TRUE(ASSERTS_ENABLED)
-void c_buffer_manager::assert_all_task_buffers_free(e_instrument_stage instrument_stage) const {
-	// All buffers should have been freed
-	for (const s_task_buffer_context &context : m_task_buffer_contexts[enum_index(instrument_stage)]) {
-		wl_assert(context.usages_remaining == 0);
-		// For constant buffers, the buffer itself won't even be allocated
-		wl_assert(!context.buffer || context.buffer->get_data_untyped() == nullptr);
-	}
-}
-
 void c_buffer_manager::assert_all_buffers_free() const {
 	m_buffer_allocator.assert_no_allocations();
 
-	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
-		assert_all_task_buffers_free(instrument_stage);
-	}
-
 	for (const c_buffer &buffer : m_input_channel_mix_buffers) {
 		wl_assert(buffer.get_data_untyped() == nullptr);
 	}
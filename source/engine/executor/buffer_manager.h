@@ -1,78 +1,63 @@
 #pragma once
 
 #include "common/common.h"
-#include "common/threading/lock_free.h"
 
 #include "engine/executor/buffer_allocator.h"
+#include "engine/executor/task_graph_instance.h"
 #include "engine/runtime_instrument.h"
 #include "engine/sample_format.h"
 #include "engine/task_graph.h"
 
-#include <atomic>
 #include <vector>
 
 class c_buffer_manager {
 public:
+	// Each dynamic task graph buffer is permanently bound to the slot assigned to it for the schedule that its stage's
+	// tasks are executed with, so buffers are never allocated, freed, or usage-counted during graph processing. Every
+	// graph instance has its own set of slots.
 	void initialize(
 		const c_runtime_instrument *runtime_instrument,
 		uint32 max_buffer_size,
 		uint32 input_channel_count,
-		uint32 output_channel_count);
+		uint32 output_channel_count,
+		uint32 voice_graph_instance_count,
+		const s_static_array<e_task_graph_schedule, enum_count<e_instrument_stage>()> &task_graph_schedules);
 	void shutdown();
 
+	// Each voice graph instance has its own set of buffers so that multiple voices can be processed concurrently. There
+	// is always exactly one FX graph instance.
+	uint32 get_graph_instance_count(e_instrument_stage instrument_stage) const;
+	const c_task_graph_instance &get_graph_instance(e_instrument_stage instrument_stage, uint32 instance_index) const;
+
 	void begin_chunk(uint32 chunk_size);
 	void mix_input_channel_buffer_to_input_buffers(
 		e_sample_format sample_format,
 		c_wrapped_array<const uint8> input_buffer);
 	void allocate_voice_accumulation_buffers();
-	void allocate_and_initialize_voice_input_buffers(uint32 voice_sample_offset);
+	void allocate_and_initialize_voice_input_buffers(uint32 instance_index, uint32 voice_sample_offset);
 	void allocate_voice_shift_buffers();
-	void accumulate_voice_output(uint32 voice_sample_offset);
+	void accumulate_voice_output(uint32 instance_index, uint32 voice_sample_offset);
 	void allocate_fx_output_buffers();
 	void transfer_input_buffers_and_voice_accumulation_buffers_to_fx_inputs();
 	void free_voice_accumulation_buffers();
 	void store_fx_output();
-	void initialize_buffers_for_graph_processing(e_instrument_stage instrument_stage);
 	bool process_remain_active_output(
 		e_instrument_stage instrument_stage,
+		uint32 instance_index,
 		uint64 voice_sample_index,
 		uint32 voice_sample_offset);
+
+	// Returns true if every output of the graph instance is a constant with a magnitude no greater than the threshold.
+	// This relies only on constant tracking so it never needs to scan buffer contents.
+	bool are_outputs_inaudible(e_instrument_stage instrument_stage, uint32 instance_index, real32 threshold) const;
+
 	void mix_voice_accumulation_buffers_to_channel_buffers();
 	void mix_fx_output_to_channel_buffers();
 	void mix_output_channel_buffers_to_output_buffer(
 		e_sample_format sample_format,
 		c_wrapped_array<uint8> output_buffer);
 
-	void allocate_output_buffers(e_instrument_stage instrument_stage, uint32 task_index);
-	void decrement_buffer_usages(e_instrument_stage instrument_stage, uint32 task_index);
-
 private:
-	// Context for a buffer used by a task. These are indexed by total buffer count for the task graph, which includes
-	// both constant and dynamic buffers, but only dynamic buffers are used, so the c_buffer instance on the constant
-	// entries will be unallocated.
-	struct ALIGNAS_LOCK_FREE s_task_buffer_context {
-		s_task_buffer_context() = default;
-		UNCOPYABLE(s_task_buffer_context);
-
-		s_task_buffer_context(s_task_buffer_context &&other)
-			: pool_index(other.pool_index)
-			, initial_usages(other.initial_usages)
-			, usages_remaining(other.usages_remaining.load())
-			, buffer(other.buffer) {}
-
-		s_task_buffer_context &operator=(s_task_buffer_context &&other) {
-			pool_index = other.pool_index;
-			initial_usages = other.initial_usages;
-			usages_remaining = other.usages_remaining.load();
-			buffer = other.buffer;
-		}
-
-		uint32 pool_index;
-		int32 initial_usages;
-		std::atomic<uint32> usages_remaining;
-		c_buffer *buffer;
-	};
-
 	uint32 get_buffer_pool(
 		c_task_data_type buffer_type,
 		const std::vector<c_task_graph::s_buffer_usage_info> &buffer_pools) const;
@@ -84,44 +69,46 @@ private:
 	std::vector<c_task_graph::s_buffer_usage_info> combine_buffer_usage_info(
 		c_wrapped_array<const std::vector<c_task_graph::s_buffer_usage_info> *const> buffer_usage_info_array) const;
 
-	void decrement_buffer_usages(e_instrument_stage instrument_stage, const std::vector<size_t> &buffer_indices);
+	// Produces a buffer usage info list containing the buffer slots for all graph instances. Slots are held for the
+	// lifetime of the buffer manager so slots from different graphs and graph instances are never shared.
+	std::vector<c_task_graph::s_buffer_usage_info> build_buffer_slot_usage_info() const;
 
 	void initialize_buffer_allocator(
+		c_buffer_allocator &buffer_allocator,
 		size_t max_buffer_size,
 		const std::vector<c_task_graph::s_buffer_usage_info> &buffer_usage_info);
-	void initialize_task_buffer_contexts(
-		const std::vector<c_task_graph::s_buffer_usage_info> &buffer_usage_info);
+	void initialize_buffer_usage_counts();
+	void bind_buffer_slots(const std::vector<c_task_graph::s_buffer_usage_info> &slot_usage_info);
 
 	void mix_to_channel_buffers(std::vector<c_buffer> &source_buffers);
 	void free_channel_buffers();
 
 #if IS_TRUE(ASSERTS_ENABLED)
-	void assert_all_task_buffers_free(e_instrument_stage instrument_stage) const;
 	void assert_all_buffers_free() const;
 #else // IS_TRUE(ASSERTS_ENABLED)
-	void assert_all_task_buffers_free(e_instrument_stage instrument_stage) const {}
 	void assert_all_buffers_free() const {}
 #endif // IS_TRUE(ASSERTS_ENABLED)
 
 	const c_runtime_instrument *m_runtime_instrument;
 
-	// Allocator for buffers used during processing
+	// Allocator for buffers used outside of graph processing
 	c_buffer_allocator m_buffer_allocator;
 
-	// Contexts for task buffers for each stage
-	s_static_array<std::vector<s_task_buffer_context>, enum_count<e_instrument_stage>()> m_task_buffer_contexts;
+	// The schedule used to execute each stage's tasks, which determines the buffer slot assignment
+	s_static_array<e_task_graph_schedule, enum_count<e_instrument_stage>()> m_task_graph_schedules;
 
-	// List of all dynamic buffers indices for each stage
-	s_static_array<std::vector<size_t>, enum_count<e_instrument_stage>()> m_dynamic_buffers;
+	// Backing memory for buffer slots. Every slot is allocated up front and remains allocated until shutdown.
+	c_buffer_allocator m_buffer_slot_allocator;
 
-	// Cached lists of dynamic input buffers for each task for each stage
-	s_static_array<std::vector<std::vector<size_t>>, enum_count<e_instrument_stage>()> m_task_buffers_to_decrement;
+	// Instances of the task graph for each stage
+	s_static_array<std::vector<c_task_graph_instance>, enum_count<e_instrument_stage>()> m_graph_instances;
 
-	// Cached lists of dynamic output buffers for each task for each stage (de-duplicated)
-	s_static_array<std::vector<std::vector<size_t>>, enum_count<e_instrument_stage>()> m_task_buffers_to_allocate;
+	// Number of times each buffer is used by tasks or as a graph output for each stage. These are identical across all
+	// graph instances. An unused input buffer never needs to be initialized.
+	s_static_array<std::vector<uint32>, enum_count<e_instrument_stage>()> m_buffer_usage_counts;
 
-	// Cached list of dynamic output buffers for each stage
-	s_static_array<std::vector<size_t>, enum_count<e_instrument_stage>()> m_output_buffers_to_decrement;
+	// List of all dynamic buffers indices for each stage
+	s_static_array<std::vector<size_t>, enum_count<e_instrument_stage>()> m_dynamic_buffers;
 
 	// Pool index of real buffers
 	uint32 m_real_buffer_pool_index;
@@ -0,0 +1,123 @@
+#include "engine/executor/chunk_accumulator.h"
+
+#include <algorithm>
+
+void c_chunk_accumulator::initialize(
+	uint32 processing_chunk_size,
+	uint32 max_driver_frames,
+	bool fixed_driver_frames,
+	size_t input_frame_size,
+	size_t output_frame_size) {
+	wl_assert(processing_chunk_size > 0);
+	wl_assert(max_driver_frames > 0);
+
+	m_processing_chunk_size = processing_chunk_size;
+	m_max_driver_frames = max_driver_frames;
+
+	// Only a fixed driver buffer size which splits into whole processing chunks is guaranteed to never run short
+	m_latency = (fixed_driver_frames && max_driver_frames % processing_chunk_size == 0)
+		? 0
+		: processing_chunk_size;
+	m_input_frame_size = input_frame_size;
+	m_output_frame_size = output_frame_size;
+
+	// At most one partial processing chunk of input is carried between driver buffers. Output holds up to one processing
+	// chunk of delayed frames, which also covers frames left over after a short driver buffer, plus everything
+	// processed during a single driver buffer.
+	m_input_buffer.resize((processing_chunk_size - 1 + max_driver_frames) * input_frame_size);
+	m_input_frame_count = 0;
+	m_carried_input_frame_count = 0;
+	m_processed_input_frame_count = 0;
+
+	m_output_buffer.resize((processing_chunk_size + max_driver_frames) * output_frame_size);
+	zero_type(m_output_buffer.data(), m_output_buffer.size());
+	m_output_frame_count = m_latency;
+
+	m_driver_frames = 0;
+}
+
+void c_chunk_accumulator::shutdown() {
+	m_input_buffer.clear();
+	m_output_buffer.clear();
+	m_processing_chunk_size = 0;
+	m_max_driver_frames = 0;
+	m_latency = 0;
+	m_input_frame_count = 0;
+	m_output_frame_count = 0;
+}
+
+uint32 c_chunk_accumulator::get_processing_chunk_size() const {
+	return m_processing_chunk_size;
+}
+
+uint32 c_chunk_accumulator::get_latency() const {
+	return m_latency;
+}
+
+void c_chunk_accumulator::begin_driver_chunk(uint32 frames, c_wrapped_array<const uint8> input_buffer) {
+	wl_assert(input_buffer.get_count() == frames * m_input_frame_size);
+	wl_assert(frames <= m_max_driver_frames);
+	wl_assert((m_input_frame_count + frames) * m_input_frame_size <= m_input_buffer.size());
+
+	if (m_input_frame_size > 0) {
+		copy_type(
+			m_input_buffer.data() + m_input_frame_count * m_input_frame_size,
+			input_buffer.get_pointer(),
+			input_buffer.get_count());
+	}
+
+	m_carried_input_frame_count = m_input_frame_count;
+	m_input_frame_count += frames;
+	m_processed_input_frame_count = 0;
+	m_driver_frames = frames;
+}
+
+bool c_chunk_accumulator::get_next_processing_chunk(s_processing_chunk &processing_chunk_out) {
+	if (m_input_frame_count - m_processed_input_frame_count < m_processing_chunk_size) {
+		return false;
+	}
+
+	wl_assert((m_output_frame_count + m_processing_chunk_size) * m_output_frame_size <= m_output_buffer.size());
+
+	processing_chunk_out.frame_offset =
+		static_cast<int32>(m_processed_input_frame_count) - static_cast<int32>(m_carried_input_frame_count);
+	processing_chunk_out.input_buffer = c_wrapped_array<const uint8>(
+		m_input_buffer.data() + m_processed_input_frame_count * m_input_frame_size,
+		m_processing_chunk_size * m_input_frame_size);
+	processing_chunk_out.output_buffer = c_wrapped_array<uint8>(
+		m_output_buffer.data() + m_output_frame_count * m_output_frame_size,
+		m_processing_chunk_size * m_output_frame_size);
+
+	m_processed_input_frame_count += m_processing_chunk_size;
+	m_output_frame_count += m_processing_chunk_size;
+	return true;
+}
+
+void c_chunk_accumulator::end_driver_chunk(c_wrapped_array<uint8> output_buffer) {
+	wl_assert(output_buffer.get_count() == m_driver_frames * m_output_frame_size);
+
+	// Hand the oldest processed frames to the driver and shift the rest down. If the driver provided a buffer which
+	// doesn't split into whole processing chunks without having latency to cover it, there aren't enough processed
+	// frames, so the remainder is silent.
+	uint32 output_frame_count = std::min(m_output_frame_count, m_driver_frames);
+	size_t output_size = output_frame_count * m_output_frame_size;
+	copy_type(output_buffer.get_pointer(), m_output_buffer.data(), output_size);
+	zero_type(output_buffer.get_pointer() + output_size, output_buffer.get_count() - output_size);
+	m_output_frame_count -= output_frame_count;
+	copy_type_with_overlap(
+		m_output_buffer.data(),
+		m_output_buffer.data() + output_size,
+		m_output_frame_count * m_output_frame_size);
+
+	// Keep the unprocessed input around for the next driver buffer
+	m_input_frame_count -= m_processed_input_frame_count;
+	if (m_input_frame_size > 0) {
+		copy_type_with_overlap(
+			m_input_buffer.data(),
+			m_input_buffer.data() + m_processed_input_frame_count * m_input_frame_size,
+			m_input_frame_count * m_input_frame_size);
+	}
+
+	m_processed_input_frame_count = 0;
+	m_driver_frames = 0;
+}
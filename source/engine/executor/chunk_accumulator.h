@@ -0,0 +1,73 @@
+#pragma once
+
+#include "common/common.h"
+
+#include <vector>
+
+// Splits and accumulates interleaved stream buffers of arbitrary size into fixed-size processing chunks. If the driver
+// guarantees a fixed buffer size which is a multiple of the processing chunk size, each driver buffer is split into
+// whole processing chunks with no added latency. Otherwise, output is delayed by one processing chunk so that there are
+// always enough processed frames to fill the driver buffer even when the accumulated input doesn't add up to a whole
+// processing chunk yet. If the driver breaks its guarantee, the missing output frames are filled with silence.
+class c_chunk_accumulator {
+public:
+	// Describes a processing chunk within the accumulated stream buffers
+	struct s_processing_chunk {
+		// Offset in frames of the first frame of this chunk relative to the start of the current driver buffer. This
+		// is negative for chunks which begin with input accumulated during previous driver buffers.
+		int32 frame_offset;
+
+		c_wrapped_array<const uint8> input_buffer;
+		c_wrapped_array<uint8> output_buffer;
+	};
+
+	c_chunk_accumulator() = default;
+	~c_chunk_accumulator() = default;
+
+	void initialize(
+		uint32 processing_chunk_size,
+		uint32 max_driver_frames,
+		bool fixed_driver_frames,
+		size_t input_frame_size,
+		size_t output_frame_size);
+	void shutdown();
+
+	uint32 get_processing_chunk_size() const;
+
+	// Returns the number of frames by which the output is delayed
+	uint32 get_latency() const;
+
+	// Appends the driver's input frames to the accumulator. The driver may provide fewer than max_driver_frames frames.
+	void begin_driver_chunk(uint32 frames, c_wrapped_array<const uint8> input_buffer);
+
+	// Returns the next full processing chunk, or false if there isn't enough accumulated input left. The output buffer
+	// of the returned chunk must be filled before the next call.
+	bool get_next_processing_chunk(s_processing_chunk &processing_chunk_out);
+
+	// Fills the driver's output buffer with processed frames and retains any leftover input and output
+	void end_driver_chunk(c_wrapped_array<uint8> output_buffer);
+
+private:
+	uint32 m_processing_chunk_size = 0;
+	uint32 m_max_driver_frames = 0;
+	uint32 m_latency = 0;
+	size_t m_input_frame_size = 0;
+	size_t m_output_frame_size = 0;
+
+	// Interleaved input frames which haven't been processed yet
+	std::vector<uint8> m_input_buffer;
+	uint32 m_input_frame_count = 0;
+
+	// Number of input frames which were already accumulated when the current driver buffer began
+	uint32 m_carried_input_frame_count = 0;
+
+	// Number of input frames processed during the current driver buffer
+	uint32 m_processed_input_frame_count = 0;
+
+	// Interleaved output frames which haven't been consumed by the driver yet
+	std::vector<uint8> m_output_buffer;
+	uint32 m_output_frame_count = 0;
+
+	// Number of frames in the current driver buffer
+	uint32 m_driver_frames = 0;
+};
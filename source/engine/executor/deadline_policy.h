@@ -0,0 +1,27 @@
+#pragma once
+
+#include "common/common.h"
+
+// Determines what the executor does with voices which haven't started processing yet once a chunk is expected to use up
+// its processing time budget. The expected cost is the number of remaining voices times the average cost of a voice in
+// recent chunks. Eligible voices are degraded oldest first and only until the remaining voices are expected to fit in
+// the budget. Voices which were activated during the current chunk are always processed since they need to run their
+// voice activators.
+//
+// There is no policy which reduces oversampling: oversampling factors are fixed in each instrument variant's task
+// graph by the compiler, so there is no cheaper version of a voice to switch to at runtime.
+enum class e_deadline_policy {
+	// Every voice is processed, even if the deadline is missed
+	k_none,
+
+	// Released voices are skipped for the rest of this chunk but remain active
+	k_skip_released_voices,
+
+	// Released voices are deactivated
+	k_steal_released_voices,
+
+	// All voices are deactivated
+	k_steal_voices,
+
+	k_count
+};
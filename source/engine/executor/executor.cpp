@@ -5,12 +5,15 @@
 #include "engine/executor/executor.h"
 #include "engine/runtime_instrument.h"
 #include "engine/task_function_registry.h"
+#include "engine/task_fusion.h"
 #include "engine/task_graph.h"
 
 #include "instrument/instrument_globals.h"
 
 #include <algorithm>
 
+static constexpr uint32 k_invalid_task_index = static_cast<uint32>(-1);
+
 c_executor::c_executor() {
 	m_state = enum_index(e_state::k_uninitialized);
 
@@ -54,6 +57,16 @@ void c_executor::shutdown() {
 	shutdown_internal();
 }
 
+void c_executor::shutdown_detached() {
+	int32 old_state = m_state.exchange(enum_index(e_state::k_uninitialized));
+	if (old_state == enum_index(e_state::k_uninitialized)) {
+		return;
+	}
+
+	wl_assert(old_state == enum_index(e_state::k_initialized) || old_state == enum_index(e_state::k_running));
+	shutdown_internal();
+}
+
 void c_executor::execute(const s_executor_chunk_context &chunk_context) {
 	SET_MEMORY_ALLOCATIONS_ALLOWED_FOR_SCOPE(false);
 
@@ -69,7 +82,22 @@ void c_executor::execute(const s_executor_chunk_context &chunk_context) {
 	}
 
 	if (old_state == enum_index(e_state::k_running)) {
-		execute_internal(chunk_context);
+		// Wake the worker threads up once for the entire driver buffer rather than once per processing chunk or voice.
+		// While they are awake, they spin waiting for tasks and the calling thread helps execute tasks rather than
+		// blocking.
+		if (m_settings.thread_count > 0) {
+			m_thread_pool.resume();
+		}
+
+		if (m_chunk_accumulator.get_processing_chunk_size() > 0) {
+			execute_accumulated(chunk_context);
+		} else {
+			execute_internal(chunk_context);
+		}
+
+		if (m_settings.thread_count > 0) {
+			m_thread_pool.pause();
+		}
 	} else {
 		// Zero buffer if disabled
 		zero_output_buffers(
@@ -101,6 +129,7 @@ void c_executor::initialize_internal(
 	wl_assert(settings.runtime_instrument->get_voice_task_graph() || settings.runtime_instrument->get_fx_task_graph());
 
 	initialize_events();
+	initialize_chunk_accumulator();
 	initialize_thread_pool();
 	initialize_buffer_manager();
 	pre_initialize_task_function_libraries();
@@ -111,8 +140,14 @@ void c_executor::initialize_internal(
 	initialize_controller_event_manager();
 	initialize_task_contexts();
 	initialize_profiler();
+	initialize_deadline_policy();
 
 	m_event_interface.submit(EVENT_MESSAGE << "Synth started");
+	if (m_chunk_accumulator.get_processing_chunk_size() > 0) {
+		m_event_interface.submit(EVENT_MESSAGE << "Processing in chunks of "
+			<< m_chunk_accumulator.get_processing_chunk_size() << " frames with "
+			<< m_chunk_accumulator.get_latency() << " frames of added latency");
+	}
 	if (m_settings.profiling_enabled) {
 		m_event_interface.submit(EVENT_MESSAGE << "Profiling enabled");
 	}
@@ -126,14 +161,19 @@ void c_executor::initialize_events() {
 			s_async_event_handler_settings event_handler_settings;
 			event_handler_settings.set_default();
 			event_handler_settings.event_handler = handle_event_wrapper;
+			event_handler_settings.dropped_event_handler = handle_dropped_events_wrapper;
 			event_handler_settings.event_handler_context = this;
 			m_async_event_handler.initialize(event_handler_settings);
 		}
 
-		m_async_event_handler.begin_event_handling();
+		// Each worker thread and the calling thread get their own real-time channel
+		m_async_event_handler.begin_event_handling(m_settings.thread_count + 1);
 	}
 
-	m_event_interface.initialize(m_settings.event_console_enabled ? &m_async_event_handler : nullptr);
+	// The calling thread's channel is also used during initialization and shutdown since the stream isn't running then
+	m_event_interface.initialize(
+		m_settings.event_console_enabled ? &m_async_event_handler : nullptr,
+		m_settings.thread_count);
 }
 
 void c_executor::initialize_thread_pool() {
@@ -141,10 +181,15 @@ void c_executor::initialize_thread_pool() {
 	thread_pool_settings.thread_count = m_settings.thread_count;
 	thread_pool_settings.max_tasks = 1;
 	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
-		if (m_settings.runtime_instrument->get_task_graph(instrument_stage)) {
+		const c_task_graph *task_graph = m_settings.runtime_instrument->get_task_graph(instrument_stage);
+		if (task_graph) {
+			// Each graph instance can have its maximum number of tasks in flight at once
+			uint32 graph_instance_count = (instrument_stage == e_instrument_stage::k_voice)
+				? get_voice_graph_instance_count()
+				: 1;
 			thread_pool_settings.max_tasks = std::max(
 				thread_pool_settings.max_tasks,
-				m_settings.runtime_instrument->get_task_graph(instrument_stage)->get_max_task_concurrency());
+				task_graph->get_max_task_concurrency() * graph_instance_count);
 		}
 	}
 	thread_pool_settings.start_paused = true;
@@ -152,18 +197,35 @@ void c_executor::initialize_thread_pool() {
 	// We should not be allocating anything inside of tasks
 	thread_pool_settings.memory_allocations_allowed = false;
 
-	// Set up thread contexts
-	size_t thread_context_count = std::max(m_settings.thread_count, 1u); // We always need at least 1 context
+	// Set up thread contexts. The calling thread gets an additional context because it joins in executing tasks.
+	size_t thread_context_count = m_settings.thread_count + 1;
+	m_calling_thread_index = m_settings.thread_count;
 	m_thread_contexts.allocate(thread_context_count);
 	for (size_t thread_index = 0; thread_index < thread_context_count; thread_index++) {
-		s_task_function_context &task_function_context =
-			m_thread_contexts.get_array()[thread_index].task_function_context;
+		s_thread_context &thread_context = m_thread_contexts.get_array()[thread_index];
+		thread_context.event_interface.initialize(
+			m_settings.event_console_enabled ? &m_async_event_handler : nullptr,
+			cast_integer_verify<uint32>(thread_index));
+
+		s_task_function_context &task_function_context = thread_context.task_function_context;
 		zero_type(&task_function_context);
-		task_function_context.event_interface = &m_event_interface;
-		task_function_context.voice_interface = &m_voice_interface;
+		task_function_context.event_interface = &thread_context.event_interface;
 		task_function_context.controller_interface = &m_controller_interface;
 	}
 
+	// Batched task functions receive one context per voice in the batch
+	uint32 voice_batch_size = get_voice_batch_size();
+	if (voice_batch_size > 1) {
+		m_batched_task_function_contexts.resize(thread_context_count * voice_batch_size);
+		for (size_t context_index = 0; context_index < m_batched_task_function_contexts.size(); context_index++) {
+			s_task_function_context &task_function_context = m_batched_task_function_contexts[context_index];
+			zero_type(&task_function_context);
+			task_function_context.event_interface =
+				&m_thread_contexts.get_array()[context_index / voice_batch_size].event_interface;
+			task_function_context.controller_interface = &m_controller_interface;
+		}
+	}
+
 	zero_type(&m_voice_activator_task_function_context);
 	m_voice_activator_task_function_context.event_interface = &m_event_interface;
 
@@ -171,11 +233,18 @@ void c_executor::initialize_thread_pool() {
 }
 
 void c_executor::initialize_buffer_manager() {
+	s_static_array<e_task_graph_schedule, enum_count<e_instrument_stage>()> task_graph_schedules;
+	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
+		task_graph_schedules[enum_index(instrument_stage)] = get_task_graph_schedule(instrument_stage);
+	}
+
 	m_buffer_manager.initialize(
 		m_settings.runtime_instrument,
-		m_settings.max_buffer_size,
+		get_max_processing_chunk_size(),
 		m_settings.input_channel_count,
-		m_settings.output_channel_count);
+		m_settings.output_channel_count,
+		get_voice_graph_instance_count(),
+		task_graph_schedules);
 }
 
 void c_executor::pre_initialize_task_function_libraries() {
@@ -262,48 +331,149 @@ void c_executor::initialize_controller_event_manager() {
 }
 
 void c_executor::initialize_task_contexts() {
-	m_task_contexts.free_memory();
+	m_graph_instance_contexts.clear();
 	uint32 max_task_count = 0;
 
 	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
 		const c_task_graph *task_graph = m_settings.runtime_instrument->get_task_graph(instrument_stage);
 
 		if (task_graph) {
-			if (task_graph) {
-				max_task_count = std::max(max_task_count, task_graph->get_task_count());
-			}
+			max_task_count = std::max(max_task_count, task_graph->get_task_count());
 		}
 	}
 
-	m_task_contexts.allocate(max_task_count);
+	// FX processing uses the first instance
+	m_graph_instance_contexts.resize(get_voice_graph_instance_count());
+	for (std::unique_ptr<s_graph_instance_context> &graph_instance_context : m_graph_instance_contexts) {
+		graph_instance_context = std::make_unique<s_graph_instance_context>();
+		graph_instance_context->task_contexts.allocate(max_task_count);
+		graph_instance_context->tasks_remaining = 0;
+		graph_instance_context->voice_index = 0;
+		graph_instance_context->frame_count = 0;
+		graph_instance_context->batch_graph_instance_count = 0;
+	}
 }
 
 void c_executor::initialize_profiler() {
 	if (m_settings.profiling_enabled) {
 		s_profiler_settings profiler_settings;
-		profiler_settings.worker_thread_count = std::max(1u, m_settings.thread_count);
-		profiler_settings.voice_task_count = m_settings.runtime_instrument->get_voice_task_graph()
-			? m_settings.runtime_instrument->get_voice_task_graph()->get_task_count()
-			: 0;
-		profiler_settings.fx_task_count = m_settings.runtime_instrument->get_fx_task_graph()
-			? m_settings.runtime_instrument->get_fx_task_graph()->get_task_count()
-			: 0;
+		profiler_settings.worker_thread_count = cast_integer_verify<uint32>(m_thread_contexts.get_array().get_count());
+
+		// Any thread could end up executing every task in a chunk
+		uint32 max_voices = m_settings.runtime_instrument->get_instrument_globals().max_voices;
+		uint32 max_task_count_per_chunk = 0;
+		for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
+			const c_task_graph *task_graph = m_settings.runtime_instrument->get_task_graph(instrument_stage);
+			profiler_settings.task_graphs[enum_index(instrument_stage)] = task_graph;
+			if (task_graph) {
+				uint32 graph_count_per_chunk = (instrument_stage == e_instrument_stage::k_voice) ? max_voices : 1;
+				max_task_count_per_chunk += task_graph->get_task_count() * graph_count_per_chunk;
+			}
+		}
+
+		profiler_settings.trace_chunk_count = m_settings.profiling_trace_chunk_count;
+		profiler_settings.trace_task_event_count = m_settings.profiling_trace_chunk_count * max_task_count_per_chunk;
 		m_profiler.initialize(profiler_settings);
 		m_profiler.start();
 	}
 }
 
+void c_executor::initialize_deadline_policy() {
+	m_deadline_stopwatch.initialize();
+	m_deadline_budget_ns = 0;
+	m_deadline_exceeded = false;
+	m_estimated_voice_cost_ns = 0;
+	m_chunk_voices_processed = 0;
+
+	uint32 max_voices = m_voice_allocator.get_voice_count();
+	m_deadline_skipped_voices.assign(max_voices, false);
+	m_deadline_candidate_voices.clear();
+	m_deadline_candidate_voices.reserve(max_voices);
+
+	m_chunk_voices_skipped = 0;
+	m_chunk_voices_stolen = 0;
+	m_total_voices_skipped = 0;
+	m_total_voices_stolen = 0;
+	m_total_chunks_exceeding_deadline = 0;
+}
+
+void c_executor::initialize_chunk_accumulator() {
+	uint32 processing_chunk_size = m_settings.runtime_instrument->get_instrument_globals().chunk_size;
+	if (processing_chunk_size == 0) {
+		processing_chunk_size = m_settings.processing_chunk_size;
+	}
+
+	if (processing_chunk_size == 0
+		|| (m_settings.fixed_buffer_size && processing_chunk_size == m_settings.max_buffer_size)) {
+		// The driver's buffers can be processed directly
+		return;
+	}
+
+	size_t sample_format_size = get_sample_format_size(m_settings.sample_format);
+	m_chunk_accumulator.initialize(
+		processing_chunk_size,
+		m_settings.max_buffer_size,
+		m_settings.fixed_buffer_size,
+		m_settings.input_channel_count * sample_format_size,
+		m_settings.output_channel_count * sample_format_size);
+}
+
+uint32 c_executor::get_max_processing_chunk_size() const {
+	uint32 processing_chunk_size = m_chunk_accumulator.get_processing_chunk_size();
+	return processing_chunk_size > 0 ? processing_chunk_size : m_settings.max_buffer_size;
+}
+
+uint32 c_executor::get_voice_graph_instance_count() const {
+	if (!m_settings.runtime_instrument->get_voice_task_graph()) {
+		return 1;
+	}
+
+	// Each voice in a batch needs its own graph instance
+	uint32 voice_batch_size = get_voice_batch_size();
+	if (!m_settings.process_voices_concurrently || m_settings.thread_count == 0) {
+		return voice_batch_size;
+	}
+
+	// There's no benefit to having more batches in flight than worker threads since each batch (or voice, if voices
+	// aren't batched) occupies at least one thread
+	uint32 max_voices = m_settings.runtime_instrument->get_instrument_globals().max_voices;
+	uint32 max_batches = (max_voices + voice_batch_size - 1) / voice_batch_size;
+	return std::max(1u, std::min(max_batches, m_settings.thread_count)) * voice_batch_size;
+}
+
+uint32 c_executor::get_voice_batch_size() const {
+	if (!m_settings.runtime_instrument->get_voice_task_graph()) {
+		return 1;
+	}
+
+	uint32 max_voices = m_settings.runtime_instrument->get_instrument_globals().max_voices;
+	return std::max(1u, std::min(max_voices, m_settings.voice_batch_size));
+}
+
+e_task_graph_schedule c_executor::get_task_graph_schedule(e_instrument_stage instrument_stage) const {
+	// Without worker threads, every graph is processed in sequential order. Voice batches are always processed in
+	// sequential order, even when the batches themselves run on worker threads.
+	if (m_settings.thread_count == 0
+		|| (instrument_stage == e_instrument_stage::k_voice && get_voice_batch_size() > 1)) {
+		return e_task_graph_schedule::k_sequential;
+	}
+
+	return e_task_graph_schedule::k_concurrent;
+}
+
 void c_executor::shutdown_internal() {
 	IF_ASSERTS_ENABLED(uint32 unexecuted_tasks = ) m_thread_pool.stop();
 	wl_assert(unexecuted_tasks == 0);
 
 	m_thread_contexts.free_memory();
-	m_task_contexts.free_memory();
+	m_batched_task_function_contexts.clear();
+	m_graph_instance_contexts.clear();
 	m_controller_event_manager.shutdown();
 	m_voice_allocator.shutdown();
 	deinitialize_tasks();
 	m_task_memory_manager.deinitialize();
 	m_buffer_manager.shutdown();
+	m_chunk_accumulator.shutdown();
 
 	if (m_settings.event_console_enabled) {
 		m_async_event_handler.end_event_handling();
@@ -315,6 +485,12 @@ void c_executor::shutdown_internal() {
 		s_profiler_report report;
 		m_profiler.get_report(report);
 		output_profiler_report("profiler_report.csv", report);
+
+		if (m_profiler.is_tracing_enabled()) {
+			s_profiler_trace trace;
+			m_profiler.get_trace(trace);
+			output_profiler_trace("profiler_trace.json", trace);
+		}
 	}
 
 	m_task_function_library_contexts.clear();
@@ -404,12 +580,47 @@ s_task_memory_query_result c_executor::task_memory_query(
 	return memory_query_result;
 }
 
+void c_executor::execute_accumulated(const s_executor_chunk_context &chunk_context) {
+	wl_assert(chunk_context.frames <= m_settings.max_buffer_size);
+	wl_assert(chunk_context.input_sample_format == m_settings.sample_format);
+	wl_assert(chunk_context.output_sample_format == m_settings.sample_format);
+
+	m_chunk_accumulator.begin_driver_chunk(chunk_context.frames, chunk_context.input_buffer);
+
+	s_executor_chunk_context processing_chunk_context = chunk_context;
+	processing_chunk_context.frames = m_chunk_accumulator.get_processing_chunk_size();
+
+	c_chunk_accumulator::s_processing_chunk processing_chunk;
+	while (m_chunk_accumulator.get_next_processing_chunk(processing_chunk)) {
+		processing_chunk_context.buffer_time_sec = chunk_context.buffer_time_sec
+			+ static_cast<real64>(processing_chunk.frame_offset) / static_cast<real64>(chunk_context.sample_rate);
+		processing_chunk_context.input_buffer = processing_chunk.input_buffer;
+		processing_chunk_context.output_buffer = processing_chunk.output_buffer;
+		execute_internal(processing_chunk_context);
+	}
+
+	m_chunk_accumulator.end_driver_chunk(chunk_context.output_buffer);
+}
+
 void c_executor::execute_internal(const s_executor_chunk_context &chunk_context) {
 	if (m_settings.profiling_enabled) {
 		m_profiler.begin_execution();
 	}
 
-	wl_assert(chunk_context.frames <= m_settings.max_buffer_size); // $TODO we could do multiple passes to handle this
+	wl_assert(chunk_context.frames <= get_max_processing_chunk_size());
+
+	if (m_settings.deadline_policy != e_deadline_policy::k_none) {
+		m_deadline_stopwatch.reset();
+		m_deadline_budget_ns = static_cast<int64>(
+			(static_cast<real64>(chunk_context.frames) / static_cast<real64>(chunk_context.sample_rate)) *
+			m_settings.deadline_threshold *
+			static_cast<real64>(k_nanoseconds_per_second));
+		m_deadline_exceeded = false;
+		m_chunk_voices_processed = 0;
+		std::fill(m_deadline_skipped_voices.begin(), m_deadline_skipped_voices.end(), false);
+		m_chunk_voices_skipped = 0;
+		m_chunk_voices_stolen = 0;
+	}
 
 	// Clear accumulation buffers
 	m_buffer_manager.begin_chunk(chunk_context.frames);
@@ -438,33 +649,30 @@ void c_executor::execute_internal(const s_executor_chunk_context &chunk_context)
 			m_profiler.begin_voices();
 		}
 
-		// Process each active voice
-		for (uint32 voice_index = 0; voice_index < m_voice_allocator.get_voice_count(); voice_index++) {
-			const c_voice_allocator::s_voice &voice = m_voice_allocator.get_voice(voice_index);
-
-			if (!voice.active) {
-				continue;
-			}
-
-			m_buffer_manager.allocate_and_initialize_voice_input_buffers(voice.chunk_offset_samples);
-			m_buffer_manager.allocate_voice_shift_buffers();
-
-			if (m_settings.profiling_enabled) {
-				m_profiler.begin_voice();
-			}
-
-			process_instrument_stage(e_instrument_stage::k_voice, chunk_context, voice_index);
-
-			if (m_settings.profiling_enabled) {
-				m_profiler.end_voice();
-			}
+		int64 voice_processing_start_ns = 0;
+		if (m_settings.deadline_policy != e_deadline_policy::k_none) {
+			// Degrade voices up front if the voices from previous chunks are already expected to miss the deadline
+			voice_processing_start_ns = m_deadline_stopwatch.query();
+			plan_deadline_policy(0, voice_processing_start_ns);
+		}
 
-			m_buffer_manager.accumulate_voice_output(voice.chunk_offset_samples);
+		if (get_voice_batch_size() > 1) {
+			process_voice_batches(chunk_context);
+		} else if (m_graph_instance_contexts.size() > 1) {
+			process_voices_concurrently(chunk_context);
+		} else {
+			process_voices_serially(chunk_context);
 		}
 
 		if (m_settings.profiling_enabled) {
 			m_profiler.end_voices();
 		}
+
+		if (m_settings.deadline_policy != e_deadline_policy::k_none) {
+			update_estimated_voice_cost(m_deadline_stopwatch.query() - voice_processing_start_ns);
+		}
+
+		report_deadline_policy();
 	}
 
 	if (m_settings.runtime_instrument->get_fx_task_graph()) {
@@ -486,7 +694,9 @@ void c_executor::execute_internal(const s_executor_chunk_context &chunk_context)
 		} else {
 			m_buffer_manager.free_voice_accumulation_buffers();
 		}
+	}
 
+	if (m_settings.runtime_instrument->get_fx_task_graph()) {
 		m_buffer_manager.mix_fx_output_to_channel_buffers();
 	} else {
 		m_buffer_manager.mix_voice_accumulation_buffers_to_channel_buffers();
@@ -505,15 +715,351 @@ void c_executor::execute_internal(const s_executor_chunk_context &chunk_context)
 	}
 }
 
+bool c_executor::apply_deadline_policy(uint32 voice_index) {
+	if (m_settings.deadline_policy == e_deadline_policy::k_none) {
+		return true;
+	}
+
+	int64 elapsed_ns = m_deadline_stopwatch.query();
+	if (elapsed_ns >= m_deadline_budget_ns) {
+		m_deadline_exceeded = true;
+	}
+
+	// Re-plan using the actual elapsed time in case the estimate was off. This is a no-op if the remaining voices are
+	// still expected to fit in the budget.
+	plan_deadline_policy(voice_index, elapsed_ns);
+
+	if (!m_voice_allocator.get_voice(voice_index).active || m_deadline_skipped_voices[voice_index]) {
+		return false;
+	}
+
+	m_chunk_voices_processed++;
+	return true;
+}
+
+void c_executor::plan_deadline_policy(uint32 first_voice_index, int64 elapsed_ns) {
+	int64 remaining_budget_ns = m_deadline_budget_ns - elapsed_ns;
+
+	uint32 remaining_voice_count = 0;
+	for (uint32 voice_index = first_voice_index; voice_index < m_voice_allocator.get_voice_count(); voice_index++) {
+		if (m_voice_allocator.get_voice(voice_index).active && !m_deadline_skipped_voices[voice_index]) {
+			remaining_voice_count++;
+		}
+	}
+
+	int64 estimated_cost_ns = static_cast<int64>(remaining_voice_count) * m_estimated_voice_cost_ns;
+	if (estimated_cost_ns <= remaining_budget_ns) {
+		return;
+	}
+
+	m_deadline_exceeded = true;
+
+	// Voices which were activated during this chunk must run their voice activators so they are never degraded
+	m_deadline_candidate_voices.clear();
+	for (uint32 voice_index = first_voice_index; voice_index < m_voice_allocator.get_voice_count(); voice_index++) {
+		const c_voice_allocator::s_voice &voice = m_voice_allocator.get_voice(voice_index);
+		if (!voice.active || voice.activated_this_chunk || m_deadline_skipped_voices[voice_index]) {
+			continue;
+		}
+
+		if (m_settings.deadline_policy != e_deadline_policy::k_steal_voices && !voice.released) {
+			continue;
+		}
+
+		m_deadline_candidate_voices.push_back(voice_index);
+	}
+
+	std::sort(
+		m_deadline_candidate_voices.begin(),
+		m_deadline_candidate_voices.end(),
+		[this](uint32 voice_index_a, uint32 voice_index_b) {
+			return m_voice_allocator.get_voice(voice_index_a).activation_index
+				< m_voice_allocator.get_voice(voice_index_b).activation_index;
+		});
+
+	// If we don't have an estimate yet, every candidate is degraded since we can't tell when the cost would fit
+	for (uint32 voice_index : m_deadline_candidate_voices) {
+		if (estimated_cost_ns <= remaining_budget_ns) {
+			break;
+		}
+
+		switch (m_settings.deadline_policy) {
+		case e_deadline_policy::k_skip_released_voices:
+			m_deadline_skipped_voices[voice_index] = true;
+			m_chunk_voices_skipped++;
+			break;
+
+		case e_deadline_policy::k_steal_released_voices:
+		case e_deadline_policy::k_steal_voices:
+			m_voice_allocator.disable_voice(voice_index);
+			m_chunk_voices_stolen++;
+			break;
+
+		default:
+			wl_unreachable();
+		}
+
+		estimated_cost_ns -= m_estimated_voice_cost_ns;
+	}
+}
+
+void c_executor::update_estimated_voice_cost(int64 voice_processing_ns) {
+	if (m_chunk_voices_processed == 0) {
+		return;
+	}
+
+	// Smooth the estimate so that a single outlier chunk doesn't cause voices to be degraded
+	int64 voice_cost_ns = voice_processing_ns / static_cast<int64>(m_chunk_voices_processed);
+	m_estimated_voice_cost_ns = (m_estimated_voice_cost_ns == 0)
+		? voice_cost_ns
+		: (m_estimated_voice_cost_ns * 3 + voice_cost_ns) / 4;
+}
+
+void c_executor::report_deadline_policy() {
+	if (!m_deadline_exceeded) {
+		return;
+	}
+
+	m_total_chunks_exceeding_deadline++;
+	m_total_voices_skipped += m_chunk_voices_skipped;
+	m_total_voices_stolen += m_chunk_voices_stolen;
+
+	m_event_interface.submit(EVENT_WARNING << "Chunk exceeded or was expected to exceed deadline threshold, "
+		<< "voices skipped: " << m_chunk_voices_skipped << ", voices stolen: " << m_chunk_voices_stolen
+		<< " (total chunks: " << m_total_chunks_exceeding_deadline
+		<< ", voices skipped: " << m_total_voices_skipped
+		<< ", voices stolen: " << m_total_voices_stolen << ")");
+}
+
+void c_executor::process_voices_serially(const s_executor_chunk_context &chunk_context) {
+	// Process each active voice
+	for (uint32 voice_index = 0; voice_index < m_voice_allocator.get_voice_count(); voice_index++) {
+		const c_voice_allocator::s_voice &voice = m_voice_allocator.get_voice(voice_index);
+
+		if (!voice.active || !apply_deadline_policy(voice_index)) {
+			continue;
+		}
+
+		m_buffer_manager.allocate_and_initialize_voice_input_buffers(0, voice.chunk_offset_samples);
+		m_buffer_manager.allocate_voice_shift_buffers();
+
+		if (m_settings.profiling_enabled) {
+			m_profiler.begin_voice();
+		}
+
+		process_instrument_stage(e_instrument_stage::k_voice, chunk_context, voice_index);
+
+		if (m_settings.profiling_enabled) {
+			m_profiler.end_voice();
+		}
+
+		m_buffer_manager.accumulate_voice_output(0, voice.chunk_offset_samples);
+	}
+}
+
+void c_executor::process_voices_concurrently(const s_executor_chunk_context &chunk_context) {
+	// Voices are assigned to graph instances in round-robin order and retired in that same order. This means that the
+	// voice outputs are always accumulated in voice index order, so the result is bit-identical to serial processing.
+	// Single voice times are not profiled because voices overlap.
+	uint32 graph_instance_count = cast_integer_verify<uint32>(m_graph_instance_contexts.size());
+	uint32 next_voice_index = 0;
+	uint32 voices_started = 0;
+	uint32 voices_finished = 0;
+
+	while (true) {
+		// Kick off voices until all graph instances are busy
+		while (voices_started - voices_finished < graph_instance_count
+			&& next_voice_index < m_voice_allocator.get_voice_count()) {
+			uint32 voice_index = next_voice_index;
+			next_voice_index++;
+
+			const c_voice_allocator::s_voice &voice = m_voice_allocator.get_voice(voice_index);
+			if (!voice.active || !apply_deadline_policy(voice_index)) {
+				continue;
+			}
+
+			uint32 graph_instance_index = voices_started % graph_instance_count;
+			m_buffer_manager.allocate_and_initialize_voice_input_buffers(
+				graph_instance_index,
+				voice.chunk_offset_samples);
+			begin_instrument_stage(e_instrument_stage::k_voice, chunk_context, voice_index, graph_instance_index);
+			voices_started++;
+		}
+
+		if (voices_finished == voices_started) {
+			break;
+		}
+
+		// Retire the oldest voice. The accumulation buffers are only touched on this thread.
+		uint32 graph_instance_index = voices_finished % graph_instance_count;
+		uint32 voice_index = m_graph_instance_contexts[graph_instance_index]->voice_index;
+		end_instrument_stage(e_instrument_stage::k_voice, graph_instance_index);
+
+		m_buffer_manager.allocate_voice_shift_buffers();
+		m_buffer_manager.accumulate_voice_output(
+			graph_instance_index,
+			m_voice_allocator.get_voice(voice_index).chunk_offset_samples);
+		voices_finished++;
+	}
+}
+
+void c_executor::process_voice_batches(const s_executor_chunk_context &chunk_context) {
+	// Batches are kicked off and retired in order and voices within a batch are retired in voice index order, so voice
+	// outputs are accumulated in the same order as serial processing. Without worker threads, each batch is processed
+	// on the calling thread as soon as it is kicked off. Single voice times are not profiled because voices overlap.
+	uint32 voice_batch_size = get_voice_batch_size();
+	uint32 graph_instance_count = cast_integer_verify<uint32>(m_graph_instance_contexts.size());
+	wl_assert(graph_instance_count % voice_batch_size == 0);
+	uint32 batch_slot_count = graph_instance_count / voice_batch_size;
+	uint32 next_voice_index = 0;
+	uint32 batches_started = 0;
+	uint32 batches_finished = 0;
+
+	while (true) {
+		// Kick off batches until all batch slots are busy
+		while (batches_started - batches_finished < batch_slot_count
+			&& next_voice_index < m_voice_allocator.get_voice_count()) {
+			uint32 first_graph_instance_index = (batches_started % batch_slot_count) * voice_batch_size;
+			uint32 batch_graph_instance_count = 0;
+			while (batch_graph_instance_count < voice_batch_size
+				&& next_voice_index < m_voice_allocator.get_voice_count()) {
+				uint32 voice_index = next_voice_index;
+				next_voice_index++;
+
+				const c_voice_allocator::s_voice &voice = m_voice_allocator.get_voice(voice_index);
+				if (!voice.active || !apply_deadline_policy(voice_index)) {
+					continue;
+				}
+
+				uint32 graph_instance_index = first_graph_instance_index + batch_graph_instance_count;
+				m_buffer_manager.allocate_and_initialize_voice_input_buffers(
+					graph_instance_index,
+					voice.chunk_offset_samples);
+				prepare_graph_instance(e_instrument_stage::k_voice, chunk_context, voice_index, graph_instance_index);
+				batch_graph_instance_count++;
+			}
+
+			if (batch_graph_instance_count == 0) {
+				// There were no remaining active voices
+				break;
+			}
+
+			s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[first_graph_instance_index];
+			graph_instance_context.batch_graph_instance_count = batch_graph_instance_count;
+
+			if (m_settings.thread_count == 0) {
+				process_tasks_sequentially(
+					m_calling_thread_index,
+					e_instrument_stage::k_voice,
+					first_graph_instance_index,
+					batch_graph_instance_count,
+					m_settings.profiling_enabled);
+			} else {
+				// The entire batch is a single thread pool task which the first graph instance waits on
+				graph_instance_context.tasks_remaining = 1;
+
+				s_thread_pool_task task;
+				task.task_entry_point = process_voice_batch_wrapper;
+				s_voice_batch_parameters *batch_params =
+					task.parameter_block.get_memory_typed<s_voice_batch_parameters>();
+				batch_params->this_ptr = this;
+				batch_params->first_graph_instance_index = first_graph_instance_index;
+				batch_params->graph_instance_count = batch_graph_instance_count;
+
+				IF_ASSERTS_ENABLED(bool result = ) m_thread_pool.add_task(m_calling_thread_index, task);
+				wl_assert(result);
+			}
+
+			batches_started++;
+		}
+
+		if (batches_finished == batches_started) {
+			break;
+		}
+
+		// Retire the oldest batch. The accumulation buffers are only touched on this thread.
+		uint32 first_graph_instance_index = (batches_finished % batch_slot_count) * voice_batch_size;
+		s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[first_graph_instance_index];
+		wait_for_graph_instance(first_graph_instance_index);
+
+		for (uint32 batch_index = 0; batch_index < graph_instance_context.batch_graph_instance_count; batch_index++) {
+			uint32 graph_instance_index = first_graph_instance_index + batch_index;
+			uint32 voice_index = m_graph_instance_contexts[graph_instance_index]->voice_index;
+			end_instrument_stage(e_instrument_stage::k_voice, graph_instance_index);
+
+			m_buffer_manager.allocate_voice_shift_buffers();
+			m_buffer_manager.accumulate_voice_output(
+				graph_instance_index,
+				m_voice_allocator.get_voice(voice_index).chunk_offset_samples);
+		}
+
+		graph_instance_context.batch_graph_instance_count = 0;
+		batches_finished++;
+	}
+}
+
 void c_executor::process_instrument_stage(
 	e_instrument_stage instrument_stage,
 	const s_executor_chunk_context &chunk_context,
 	uint32 voice_index) {
+	if (m_settings.thread_count == 0) {
+		prepare_graph_instance(instrument_stage, chunk_context, voice_index, 0);
+		process_tasks_sequentially(m_calling_thread_index, instrument_stage, 0, 1, m_settings.profiling_enabled);
+	} else {
+		begin_instrument_stage(instrument_stage, chunk_context, voice_index, 0);
+	}
+
+	end_instrument_stage(instrument_stage, 0);
+}
+
+void c_executor::begin_instrument_stage(
+	e_instrument_stage instrument_stage,
+	const s_executor_chunk_context &chunk_context,
+	uint32 voice_index,
+	uint32 graph_instance_index) {
+	prepare_graph_instance(instrument_stage, chunk_context, voice_index, graph_instance_index);
+
+	const c_task_graph *task_graph = m_settings.runtime_instrument->get_task_graph(instrument_stage);
+	s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[graph_instance_index];
+
+	// Setup each initial task predecessor count
+	c_wrapped_array<s_task_context> task_contexts = graph_instance_context.task_contexts.get_array();
+	for (uint32 task = 0; task < task_graph->get_task_count(); task++) {
+		task_contexts[task].predecessors_remaining =
+			cast_integer_verify<int32>(task_graph->get_task_predecessor_count(task));
+	}
+
+	graph_instance_context.tasks_remaining = cast_integer_verify<int32>(task_graph->get_task_count());
+
+	// Add the initial tasks. They're sorted by decreasing priority and the calling thread pops its own tasks in LIFO
+	// order, so they're pushed in reverse to start the critical path first.
+	c_task_graph_task_array initial_tasks = task_graph->get_initial_tasks();
+	for (size_t initial_task = initial_tasks.get_count(); initial_task > 0; initial_task--) {
+		add_task(
+			m_calling_thread_index,
+			instrument_stage,
+			voice_index,
+			graph_instance_index,
+			initial_tasks[initial_task - 1],
+			chunk_context.sample_rate,
+			graph_instance_context.frame_count);
+	}
+}
+
+void c_executor::prepare_graph_instance(
+	e_instrument_stage instrument_stage,
+	const s_executor_chunk_context &chunk_context,
+	uint32 voice_index,
+	uint32 graph_instance_index) {
 	const c_task_graph *task_graph = m_settings.runtime_instrument->get_task_graph(instrument_stage);
+	const c_task_graph_instance &graph_instance =
+		m_buffer_manager.get_graph_instance(instrument_stage, graph_instance_index);
+	s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[graph_instance_index];
 	const c_voice_allocator::s_voice &voice = (instrument_stage == e_instrument_stage::k_voice)
 		? m_voice_allocator.get_voice(voice_index)
 		: m_voice_allocator.get_fx_voice();
 	wl_assert(voice.active);
+	wl_assert(graph_instance_context.tasks_remaining == 0);
 
 	// Voice index should be 0 if we're performing FX proessing
 	wl_assert(instrument_stage == e_instrument_stage::k_voice || voice_index == 0);
@@ -524,62 +1070,56 @@ void c_executor::process_instrument_stage(
 				c_task_function_registry::get_task_function(task_graph->get_task_function_handle(task));
 
 			if (task_function.voice_activator) {
+				m_voice_activator_task_function_context.library_context =
+					m_task_memory_manager.get_task_library_context(instrument_stage, task);
 				m_voice_activator_task_function_context.shared_memory =
 					m_task_memory_manager.get_task_shared_memory(instrument_stage, task);
 				m_voice_activator_task_function_context.voice_memory =
 					m_task_memory_manager.get_task_voice_memory(instrument_stage, task, voice_index);
 				m_voice_activator_task_function_context.scratch_memory =
-					m_task_memory_manager.get_scratch_memory(0);
-				m_voice_activator_task_function_context.arguments = task_graph->get_task_arguments(task);
+					m_task_memory_manager.get_scratch_memory(m_calling_thread_index);
+				m_voice_activator_task_function_context.arguments = graph_instance.get_task_arguments(task);
 
 				task_function.voice_activator(m_voice_activator_task_function_context);
 			}
 		}
 	}
 
-	// Setup each initial task predecessor count
-	for (uint32 task = 0; task < task_graph->get_task_count(); task++) {
-		m_task_contexts.get_array()[task].predecessors_remaining =
-			cast_integer_verify<int32>(task_graph->get_task_predecessor_count(task));
-	}
-
-	m_buffer_manager.initialize_buffers_for_graph_processing(instrument_stage);
-
-	m_tasks_remaining = cast_integer_verify<int32>(task_graph->get_task_count());
-
 	wl_assert(chunk_context.frames > voice.chunk_offset_samples);
 	uint32 frame_count = chunk_context.frames - voice.chunk_offset_samples;
 
-	m_voice_interface = c_voice_interface(
+	graph_instance_context.voice_interface = c_voice_interface(
 		voice.note_id,
 		voice.note_velocity,
 		voice.note_release_sample - voice.chunk_offset_samples);
+	graph_instance_context.voice_index = voice_index;
+	graph_instance_context.frame_count = frame_count;
+}
 
-	// Add the initial tasks
-	c_task_graph_task_array initial_tasks = task_graph->get_initial_tasks();
-	if (initial_tasks.get_count() > 0) {
-		for (size_t initial_task = 0; initial_task < initial_tasks.get_count(); initial_task++) {
-			add_task(
-				instrument_stage,
-				voice_index,
-				initial_tasks[initial_task],
-				chunk_context.sample_rate,
-				frame_count);
-		}
+void c_executor::end_instrument_stage(e_instrument_stage instrument_stage, uint32 graph_instance_index) {
+	wait_for_graph_instance(graph_instance_index);
 
-		// Start the threads processing
-		m_thread_pool.resume();
-		m_all_tasks_complete_signal.wait();
-		m_thread_pool.pause();
-	}
+	const s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[graph_instance_index];
+
+	uint32 voice_index = graph_instance_context.voice_index;
+	uint32 frame_count = graph_instance_context.frame_count;
+	const c_voice_allocator::s_voice &voice = (instrument_stage == e_instrument_stage::k_voice)
+		? m_voice_allocator.get_voice(voice_index)
+		: m_voice_allocator.get_fx_voice();
 
 	bool remain_active = m_buffer_manager.process_remain_active_output(
 		instrument_stage,
+		graph_instance_index,
 		voice.sample_index,
 		voice.chunk_offset_samples);
 
 	if (instrument_stage == e_instrument_stage::k_voice) {
 		m_voice_allocator.voice_samples_processed(voice_index, frame_count);
+
+		if (remain_active && is_voice_inaudible(graph_instance_index, frame_count)) {
+			m_event_interface.submit(EVENT_VERBOSE << "Deactivating inaudible voice " << voice_index);
+			remain_active = false;
+		}
 	} else {
 		m_voice_allocator.fx_samples_processed(frame_count);
 	}
@@ -593,13 +1133,123 @@ void c_executor::process_instrument_stage(
 	}
 }
 
+bool c_executor::is_voice_inaudible(uint32 graph_instance_index, uint32 frame_count) {
+	const s_instrument_globals &globals = m_settings.runtime_instrument->get_instrument_globals();
+	if (globals.inaudible_voice_timeout == 0) {
+		return false;
+	}
+
+	// Only released voices are culled. A held note may be silent on purpose, e.g. while waiting on a delay line.
+	uint32 voice_index = m_graph_instance_contexts[graph_instance_index]->voice_index;
+	const c_voice_allocator::s_voice &voice = m_voice_allocator.get_voice(voice_index);
+	bool inaudible = voice.released
+		&& m_buffer_manager.are_outputs_inaudible(
+			e_instrument_stage::k_voice,
+			graph_instance_index,
+			globals.inaudible_voice_threshold);
+	m_voice_allocator.voice_inaudible_samples_processed(voice_index, inaudible, frame_count);
+
+	// Anything still in flight inside of the graph shows up at the outputs after the output latency, so the voice must
+	// stay silent for at least that long
+	uint64 required_inaudible_samples = std::max<uint64>(
+		globals.inaudible_voice_timeout,
+		m_settings.runtime_instrument->get_voice_task_graph()->get_output_latency());
+	return voice.inaudible_sample_count >= required_inaudible_samples;
+}
+
+void c_executor::wait_for_graph_instance(uint32 graph_instance_index) {
+	const s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[graph_instance_index];
+	while (graph_instance_context.tasks_remaining > 0) {
+		// Rather than sleeping, help the worker threads out. Any task we pick up may belong to a different graph
+		// instance, but that's fine because that work needs to happen anyway.
+		if (!m_thread_pool.execute_task(m_calling_thread_index)) {
+			c_thread::spin_wait_hint();
+		}
+	}
+}
+
+void c_executor::process_tasks_sequentially(
+	uint32 thread_index,
+	e_instrument_stage instrument_stage,
+	uint32 first_graph_instance_index,
+	uint32 graph_instance_count,
+	bool profiling_enabled) {
+	const c_task_graph *task_graph = m_settings.runtime_instrument->get_task_graph(instrument_stage);
+	wl_assert(graph_instance_count > 0);
+	wl_assert(get_task_graph_schedule(instrument_stage) == e_task_graph_schedule::k_sequential);
+
+	// Unlike the aggregate task records, every voice is traced
+	bool tracing_enabled = m_settings.profiling_enabled && m_profiler.is_tracing_enabled();
+
+	uint32 graph_instance_end_index = first_graph_instance_index + graph_instance_count;
+	for (uint32 task_index : task_graph->get_sequential_task_order()) {
+		if (profiling_enabled) {
+			m_profiler.begin_task(
+				instrument_stage,
+				thread_index,
+				task_index,
+				task_graph->get_task_function_handle(task_index));
+		}
+
+		if (tracing_enabled) {
+			m_profiler.begin_trace_task(thread_index);
+		}
+
+		// Fused tasks don't execute their task function so they can't be batched
+		const s_task_function &task_function =
+			c_task_function_registry::get_task_function(task_graph->get_task_function_handle(task_index));
+		if (graph_instance_count > 1
+			&& task_function.batched_function
+			&& task_graph->get_task_fused_instructions(task_index).get_count() == 0) {
+			call_batched_task_function(
+				thread_index,
+				instrument_stage,
+				first_graph_instance_index,
+				graph_instance_count,
+				task_index,
+				profiling_enabled);
+		} else {
+			for (uint32 index = first_graph_instance_index; index < graph_instance_end_index; index++) {
+				// Only the first voice of a batch is profiled to avoid recording the same task multiple times
+				const s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[index];
+				call_task_function(
+					thread_index,
+					instrument_stage,
+					graph_instance_context.voice_index,
+					index,
+					task_index,
+					graph_instance_context.frame_count,
+					profiling_enabled && index == first_graph_instance_index);
+			}
+		}
+
+		if (tracing_enabled) {
+			m_profiler.end_trace_task(
+				instrument_stage,
+				thread_index,
+				task_index,
+				task_graph->get_task_function_handle(task_index),
+				m_graph_instance_contexts[first_graph_instance_index]->voice_index,
+				graph_instance_count);
+		}
+
+		if (profiling_enabled) {
+			m_profiler.end_task(instrument_stage, thread_index, task_index);
+		}
+	}
+}
+
 void c_executor::add_task(
+	uint32 thread_index,
 	e_instrument_stage instrument_stage,
 	uint32 voice_index,
+	uint32 graph_instance_index,
 	uint32 task_index,
 	uint32 sample_rate,
 	uint32 frames) {
-	wl_assert(m_task_contexts.get_array()[task_index].predecessors_remaining == 0);
+	wl_assert(
+		m_graph_instance_contexts[graph_instance_index]->task_contexts.get_array()[task_index].predecessors_remaining
+		== 0);
 
 	s_thread_pool_task task;
 	task.task_entry_point = process_task_wrapper;
@@ -607,11 +1257,13 @@ void c_executor::add_task(
 	task_params->this_ptr = this;
 	task_params->instrument_stage = instrument_stage;
 	task_params->voice_index = voice_index;
+	task_params->graph_instance_index = graph_instance_index;
 	task_params->task_index = task_index;
 	task_params->sample_rate = sample_rate;
 	task_params->frames = frames;
 
-	m_thread_pool.add_task(task);
+	IF_ASSERTS_ENABLED(bool result = ) m_thread_pool.add_task(thread_index, task);
+	wl_assert(result);
 }
 
 void c_executor::process_task_wrapper(uint32 thread_index, const s_thread_parameter_block *params) {
@@ -621,82 +1273,220 @@ void c_executor::process_task_wrapper(uint32 thread_index, const s_thread_parame
 
 void c_executor::process_task(uint32 thread_index, const s_task_parameters *params) {
 	const c_task_graph *task_graph = m_settings.runtime_instrument->get_task_graph(params->instrument_stage);
+	s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[params->graph_instance_index];
+
+	// Per-task profiling records are shared between graph instances, so when voices are processed concurrently only
+	// the first instance is profiled to avoid multiple threads writing to the same record
+	bool profiling_enabled = m_settings.profiling_enabled && params->graph_instance_index == 0;
+	bool tracing_enabled = m_settings.profiling_enabled && m_profiler.is_tracing_enabled();
+
+	// The highest priority successor which becomes ready is executed directly on this thread rather than being pushed,
+	// since it likely reads the buffers that were just written and it is the most likely to be on the critical path
+	uint32 task_index = params->task_index;
+	while (task_index != k_invalid_task_index) {
+		if (profiling_enabled) {
+			m_profiler.begin_task(
+				params->instrument_stage,
+				thread_index,
+				task_index,
+				task_graph->get_task_function_handle(task_index));
+		}
 
-	if (m_settings.profiling_enabled) {
-		m_profiler.begin_task(
-			params->instrument_stage,
+		if (tracing_enabled) {
+			m_profiler.begin_trace_task(thread_index);
+		}
+
+		call_task_function(
 			thread_index,
-			params->task_index,
-			task_graph->get_task_function_handle(params->task_index));
+			params->instrument_stage,
+			params->voice_index,
+			params->graph_instance_index,
+			task_index,
+			params->frames,
+			profiling_enabled);
+
+		// Decrement remaining predecessor counts for all successors to this task. Successors are sorted by decreasing
+		// priority and are visited in reverse so that each ready successor displaces the previous one as the next task.
+		// The displaced successors are pushed in increasing priority order, so this thread pops the highest first.
+		uint32 next_task_index = k_invalid_task_index;
+		c_task_graph_task_array successors = task_graph->get_task_successors(task_index);
+		for (size_t successor = successors.get_count(); successor > 0; successor--) {
+			uint32 successor_index = successors[successor - 1];
+
+			int32 prev_predecessors_remaining =
+				graph_instance_context.task_contexts.get_array()[successor_index].predecessors_remaining--;
+			wl_assert(prev_predecessors_remaining > 0);
+			if (prev_predecessors_remaining == 1) {
+				if (next_task_index != k_invalid_task_index) {
+					add_task(
+						thread_index,
+						params->instrument_stage,
+						params->voice_index,
+						params->graph_instance_index,
+						next_task_index,
+						params->sample_rate,
+						params->frames);
+				}
+
+				next_task_index = successor_index;
+			}
+		}
+
+		if (tracing_enabled) {
+			m_profiler.end_trace_task(
+				params->instrument_stage,
+				thread_index,
+				task_index,
+				task_graph->get_task_function_handle(task_index),
+				params->voice_index,
+				1);
+		}
+
+		if (profiling_enabled) {
+			m_profiler.end_task(params->instrument_stage, thread_index, task_index);
+		}
+
+		// This must be the last thing we do with this task because the calling thread may proceed as soon as this
+		// reaches 0. It can't reach 0 if we're about to execute another task.
+		IF_ASSERTS_ENABLED(int32 prev_tasks_remaining = ) graph_instance_context.tasks_remaining--;
+		wl_assert(prev_tasks_remaining > 0);
+
+		task_index = next_task_index;
 	}
+}
 
-	const s_task_function &task_function =
-		c_task_function_registry::get_task_function(task_graph->get_task_function_handle(params->task_index));
+void c_executor::process_voice_batch_wrapper(uint32 thread_index, const s_thread_parameter_block *params) {
+	const s_voice_batch_parameters *batch_params = params->get_memory_typed<s_voice_batch_parameters>();
+	batch_params->this_ptr->process_voice_batch(thread_index, batch_params);
+}
 
-	m_buffer_manager.allocate_output_buffers(params->instrument_stage, params->task_index);
+void c_executor::process_voice_batch(uint32 thread_index, const s_voice_batch_parameters *params) {
+	// Per-task profiling records are shared between graph instances, so only the batch on the first instance is
+	// profiled
+	bool profiling_enabled = m_settings.profiling_enabled && params->first_graph_instance_index == 0;
+	process_tasks_sequentially(
+		thread_index,
+		e_instrument_stage::k_voice,
+		params->first_graph_instance_index,
+		params->graph_instance_count,
+		profiling_enabled);
+
+	// This must be the last thing we do with this batch because the calling thread may proceed as soon as this
+	// reaches 0
+	s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[params->first_graph_instance_index];
+	IF_ASSERTS_ENABLED(int32 prev_tasks_remaining = ) graph_instance_context.tasks_remaining--;
+	wl_assert(prev_tasks_remaining == 1);
+}
 
-	{
-		s_task_function_context &task_function_context =
-			m_thread_contexts.get_array()[thread_index].task_function_context;
-		task_function_context.upsample_factor = task_graph->get_task_upsample_factor(params->task_index);
-		task_function_context.sample_rate = m_settings.sample_rate * task_function_context.upsample_factor;
-		task_function_context.buffer_size = params->frames * task_function_context.upsample_factor;
-		task_function_context.library_context =
-			m_task_memory_manager.get_task_library_context(params->instrument_stage, params->task_index);
-		task_function_context.shared_memory = m_task_memory_manager.get_task_shared_memory(
-			params->instrument_stage,
-			params->task_index);
-		task_function_context.voice_memory = m_task_memory_manager.get_task_voice_memory(
-			params->instrument_stage,
-			params->task_index,
-			params->voice_index);
-		task_function_context.scratch_memory = m_task_memory_manager.get_scratch_memory(thread_index);
-		task_function_context.arguments = task_graph->get_task_arguments(params->task_index);
+void c_executor::setup_task_function_context(
+	s_task_function_context &task_function_context,
+	uint32 thread_index,
+	e_instrument_stage instrument_stage,
+	uint32 voice_index,
+	uint32 graph_instance_index,
+	uint32 task_index,
+	uint32 frames) {
+	const c_task_graph *task_graph = m_settings.runtime_instrument->get_task_graph(instrument_stage);
+	const c_task_graph_instance &graph_instance =
+		m_buffer_manager.get_graph_instance(instrument_stage, graph_instance_index);
+	s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[graph_instance_index];
+
+	task_function_context.upsample_factor = task_graph->get_task_upsample_factor(task_index);
+	task_function_context.sample_rate = m_settings.sample_rate * task_function_context.upsample_factor;
+	task_function_context.buffer_size = frames * task_function_context.upsample_factor;
+	task_function_context.library_context =
+		m_task_memory_manager.get_task_library_context(instrument_stage, task_index);
+	task_function_context.shared_memory = m_task_memory_manager.get_task_shared_memory(instrument_stage, task_index);
+	task_function_context.voice_memory = m_task_memory_manager.get_task_voice_memory(
+		instrument_stage,
+		task_index,
+		voice_index);
+	task_function_context.scratch_memory = m_task_memory_manager.get_scratch_memory(thread_index);
+	task_function_context.voice_interface = &graph_instance_context.voice_interface;
+	task_function_context.arguments = graph_instance.get_task_arguments(task_index);
+}
 
-		// Call the task function
-		wl_assert(task_function.function);
+void c_executor::call_task_function(
+	uint32 thread_index,
+	e_instrument_stage instrument_stage,
+	uint32 voice_index,
+	uint32 graph_instance_index,
+	uint32 task_index,
+	uint32 frames,
+	bool profiling_enabled) {
+	const c_task_graph *task_graph = m_settings.runtime_instrument->get_task_graph(instrument_stage);
+	const s_task_function &task_function =
+		c_task_function_registry::get_task_function(task_graph->get_task_function_handle(task_index));
 
-		if (m_settings.profiling_enabled) {
-			m_profiler.begin_task_function(params->instrument_stage, thread_index, params->task_index);
-		}
+	s_task_function_context &task_function_context =
+		m_thread_contexts.get_array()[thread_index].task_function_context;
+	setup_task_function_context(
+		task_function_context,
+		thread_index,
+		instrument_stage,
+		voice_index,
+		graph_instance_index,
+		task_index,
+		frames);
 
-		task_function.function(task_function_context);
+	// Call the task function
+	wl_assert(task_function.function);
 
-		if (m_settings.profiling_enabled) {
-			m_profiler.end_task_function(params->instrument_stage, thread_index, params->task_index);
-		}
+	if (profiling_enabled) {
+		m_profiler.begin_task_function(instrument_stage, thread_index, task_index);
 	}
 
-	m_buffer_manager.decrement_buffer_usages(params->instrument_stage, params->task_index);
+	c_fused_task_instruction_array fused_instructions = task_graph->get_task_fused_instructions(task_index);
+	if (fused_instructions.get_count() > 0) {
+		execute_fused_task(task_function_context, fused_instructions);
+	} else {
+		task_function.function(task_function_context);
+	}
 
-	// Decrement remaining predecessor counts for all successors to this task
-	c_task_graph_task_array successors = task_graph->get_task_successors(params->task_index);
-	for (size_t successor = 0; successor < successors.get_count(); successor++) {
-		uint32 successor_index = successors[successor];
+	if (profiling_enabled) {
+		m_profiler.end_task_function(instrument_stage, thread_index, task_index);
+	}
+}
 
-		int32 prev_predecessors_remaining =
-			m_task_contexts.get_array()[successor_index].predecessors_remaining--;
-		wl_assert(prev_predecessors_remaining > 0);
-		if (prev_predecessors_remaining == 1) {
-			add_task(
-				params->instrument_stage,
-				params->voice_index,
-				successor_index,
-				params->sample_rate,
-				params->frames);
-		}
+void c_executor::call_batched_task_function(
+	uint32 thread_index,
+	e_instrument_stage instrument_stage,
+	uint32 first_graph_instance_index,
+	uint32 graph_instance_count,
+	uint32 task_index,
+	bool profiling_enabled) {
+	const c_task_graph *task_graph = m_settings.runtime_instrument->get_task_graph(instrument_stage);
+	const s_task_function &task_function =
+		c_task_function_registry::get_task_function(task_graph->get_task_function_handle(task_index));
+
+	uint32 voice_batch_size = get_voice_batch_size();
+	wl_assert(graph_instance_count <= voice_batch_size);
+	s_task_function_context *task_function_contexts =
+		&m_batched_task_function_contexts[thread_index * voice_batch_size];
+	for (uint32 batch_index = 0; batch_index < graph_instance_count; batch_index++) {
+		uint32 graph_instance_index = first_graph_instance_index + batch_index;
+		const s_graph_instance_context &graph_instance_context = *m_graph_instance_contexts[graph_instance_index];
+		setup_task_function_context(
+			task_function_contexts[batch_index],
+			thread_index,
+			instrument_stage,
+			graph_instance_context.voice_index,
+			graph_instance_index,
+			task_index,
+			graph_instance_context.frame_count);
 	}
 
-	int32 prev_tasks_remaining = m_tasks_remaining--;
-	wl_assert(prev_tasks_remaining > 0);
+	// Call the batched task function
+	wl_assert(task_function.batched_function);
 
-	if (m_settings.profiling_enabled) {
-		m_profiler.end_task(params->instrument_stage, thread_index, params->task_index);
+	if (profiling_enabled) {
+		m_profiler.begin_task_function(instrument_stage, thread_index, task_index);
 	}
 
-	if (prev_tasks_remaining == 1) {
-		// Notify the calling thread that we are done
-		m_all_tasks_complete_signal.notify();
+	task_function.batched_function(c_task_function_context_array(task_function_contexts, graph_instance_count));
+
+	if (profiling_enabled) {
+		m_profiler.end_task_function(instrument_stage, thread_index, task_index);
 	}
 }
 
@@ -704,6 +1494,18 @@ void c_executor::handle_event_wrapper(void *context, size_t event_size, const vo
 	static_cast<c_executor *>(context)->handle_event(event_size, event_data);
 }
 
+void c_executor::handle_dropped_events_wrapper(void *context, uint64 dropped_event_count) {
+	static_cast<c_executor *>(context)->handle_dropped_events(dropped_event_count);
+}
+
+void c_executor::handle_dropped_events(uint64 dropped_event_count) {
+	// This is called on the event handling thread, so the event can be handled directly rather than submitted
+	c_event event = EVENT_WARNING << "Dropped " << dropped_event_count
+		<< " events submitted during processing because the event buffer was full";
+	c_wrapped_array<const uint8> event_data = event.get_event_data();
+	handle_event(event_data.get_count(), event_data.get_pointer());
+}
+
 void c_executor::handle_event(size_t event_size, const void *event_data) {
 	if (m_event_console.is_running()) {
 		c_event_string event_string;
@@ -3,13 +3,16 @@
 #include "common/common.h"
 #include "common/threading/lock_free.h"
 #include "common/threading/semaphore.h"
+#include "common/utility/stopwatch.h"
 
 #include "engine/controller_interface/controller_interface.h"
 #include "engine/events/async_event_handler.h"
 #include "engine/events/event_console.h"
 #include "engine/events/event_interface.h"
 #include "engine/executor/buffer_manager.h"
+#include "engine/executor/chunk_accumulator.h"
 #include "engine/executor/controller_event_manager.h"
+#include "engine/executor/deadline_policy.h"
 #include "engine/executor/task_memory_manager.h"
 #include "engine/executor/voice_allocator.h"
 #include "engine/profiler/profiler.h"
@@ -22,6 +25,8 @@
 #include "task_function/task_function.h"
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 class c_runtime_instrument;
 class c_task_graph;
@@ -33,11 +38,25 @@ using f_process_controller_events = size_t (*)(
 struct s_executor_settings {
 	const c_runtime_instrument *runtime_instrument;
 	uint32 thread_count;
+	bool process_voices_concurrently; // Only applies if thread_count is non-zero
+	uint32 voice_batch_size; // Max number of voices processed in lockstep, 0 or 1 disables batching
+
+	// What to do with unprocessed voices once the time spent on a chunk exceeds deadline_threshold, which is a ratio of
+	// the chunk's duration
+	e_deadline_policy deadline_policy;
+	real32 deadline_threshold;
+
 	uint32 sample_rate;
+	e_sample_format sample_format;
 	uint32 max_buffer_size;
+	bool fixed_buffer_size; // Whether the driver always provides exactly max_buffer_size frames
 	uint32 input_channel_count;
 	uint32 output_channel_count;
 
+	// Size of the chunks the instrument is processed in. If 0, the driver's buffer size is used. This is overridden by
+	// the instrument's chunk size if it specifies one.
+	uint32 processing_chunk_size;
+
 	size_t controller_event_queue_size;
 	size_t max_controller_parameters;
 	f_process_controller_events process_controller_events;
@@ -46,6 +65,7 @@ struct s_executor_settings {
 	bool event_console_enabled; // $TODO move this into the runtime - executor should be passed an event callback
 	bool profiling_enabled;
 	real32 profiling_threshold;
+	uint32 profiling_trace_chunk_count; // Number of most recent profiled chunks to trace, 0 disables tracing
 };
 
 // $TODO we probably don't need these settings to be both in settings and chunk context. We should instead store off the
@@ -71,6 +91,10 @@ public:
 	void initialize(const s_executor_settings &settings, c_wrapped_array<void *> task_function_library_contexts);
 	void shutdown();
 
+	// Shuts down an executor which the stream no longer calls into, e.g. after it has been swapped out for another
+	// executor. Unlike shutdown(), this doesn't wait for the stream to flush.
+	void shutdown_detached();
+
 	void execute(const s_executor_chunk_context &chunk_context);
 
 private:
@@ -93,21 +117,52 @@ private:
 	struct alignas(CACHE_LINE_SIZE) s_thread_context {
 		// Each thread has a pre-initialized context to avoid setting it up for each task
 		s_task_function_context task_function_context;
+
+		// Submits events through this thread's real-time channel so task functions never block
+		c_event_interface event_interface;
 	};
 
 	struct ALIGNAS_LOCK_FREE s_task_context {
 		std::atomic<int32> predecessors_remaining;
 	};
 
+	// Each task graph instance can be processing a different voice at the same time, so it needs its own context
+	struct alignas(CACHE_LINE_SIZE) s_graph_instance_context {
+		// Context for each task for the voice being processed on this instance
+		c_lock_free_aligned_allocator<s_task_context> task_contexts;
+
+		// Total number of tasks remaining for the voice being processed on this instance. The calling thread polls
+		// this while it helps process tasks rather than blocking on a signal.
+		ALIGNAS_LOCK_FREE std::atomic<int32> tasks_remaining;
+
+		// Interface for accessing voice data, e.g. which note ID is pressed
+		c_voice_interface voice_interface;
+
+		// The voice being processed
+		uint32 voice_index;
+		uint32 frame_count;
+
+		// When voices are batched, the number of graph instances starting with this one which are processed in
+		// lockstep. Only the first instance of each batch holds a non-zero count.
+		uint32 batch_graph_instance_count;
+	};
+
 	struct s_task_parameters {
 		c_executor *this_ptr;
 		e_instrument_stage instrument_stage;
 		uint32 voice_index;
+		uint32 graph_instance_index;
 		uint32 task_index;
 		uint32 sample_rate;
 		uint32 frames;
 	};
 
+	struct s_voice_batch_parameters {
+		c_executor *this_ptr;
+		uint32 first_graph_instance_index;
+		uint32 graph_instance_count;
+	};
+
 	void initialize_internal(
 		const s_executor_settings &settings,
 		c_wrapped_array<void *> task_function_library_contexts);
@@ -122,6 +177,21 @@ private:
 	void initialize_controller_event_manager();
 	void initialize_task_contexts();
 	void initialize_profiler();
+	void initialize_deadline_policy();
+	void initialize_chunk_accumulator();
+
+	// Returns the maximum number of frames processed by a single call to execute_internal()
+	uint32 get_max_processing_chunk_size() const;
+
+	// Returns the number of voice task graph instances, which is the maximum number of voices which can be processed
+	// at the same time
+	uint32 get_voice_graph_instance_count() const;
+
+	// Returns the maximum number of voices which are processed in lockstep, or 1 if voices are not batched
+	uint32 get_voice_batch_size() const;
+
+	// Returns how the tasks of a single graph instance of the given stage are scheduled
+	e_task_graph_schedule get_task_graph_schedule(e_instrument_stage instrument_stage) const;
 
 	void shutdown_internal();
 	void deinitialize_tasks();
@@ -136,15 +206,76 @@ private:
 		const c_task_graph *task_graph,
 		uint32 task_index);
 
+	// Splits and accumulates the driver's buffer into fixed-size processing chunks
+	void execute_accumulated(const s_executor_chunk_context &chunk_context);
+
 	void execute_internal(const s_executor_chunk_context &chunk_context);
+
+	// Called before a voice is kicked off. Returns false if the deadline policy skipped or deactivated the voice.
+	bool apply_deadline_policy(uint32 voice_index);
+
+	// If the estimated cost of the voices starting at first_voice_index doesn't fit in the remaining budget, degrades
+	// eligible voices oldest first until it does
+	void plan_deadline_policy(uint32 first_voice_index, int64 elapsed_ns);
+
+	// Updates the estimated cost of processing a single voice using the time spent on voices during this chunk
+	void update_estimated_voice_cost(int64 voice_processing_ns);
+
+	// Reports the voices degraded by the deadline policy during this chunk
+	void report_deadline_policy();
+	void process_voices_serially(const s_executor_chunk_context &chunk_context);
+	void process_voices_concurrently(const s_executor_chunk_context &chunk_context);
+
+	// Groups active voices into batches which each run the voice task graph in lockstep across consecutive graph
+	// instances. Each task is executed for every voice in the batch before moving on to the next task so that batched
+	// task functions can process all voices in a single call.
+	void process_voice_batches(const s_executor_chunk_context &chunk_context);
 	void process_instrument_stage(
 		e_instrument_stage instrument_stage,
 		const s_executor_chunk_context &chunk_context,
 		uint32 voice_index);
 
+	// Sets up and kicks off the tasks for a single voice on the given graph instance. The thread pool must be resumed
+	// for the tasks to make progress.
+	void begin_instrument_stage(
+		e_instrument_stage instrument_stage,
+		const s_executor_chunk_context &chunk_context,
+		uint32 voice_index,
+		uint32 graph_instance_index);
+
+	// Waits for the voice being processed on the given graph instance to complete and updates its active state
+	void end_instrument_stage(e_instrument_stage instrument_stage, uint32 graph_instance_index);
+
+	// Runs voice activators and sets up the graph instance context for the given voice
+	void prepare_graph_instance(
+		e_instrument_stage instrument_stage,
+		const s_executor_chunk_context &chunk_context,
+		uint32 voice_index,
+		uint32 graph_instance_index);
+
+	// Updates the inaudible sample count of the voice on the given graph instance and returns whether it has been
+	// inaudible for long enough to be deactivated. This is disabled unless the instrument specifies a timeout.
+	bool is_voice_inaudible(uint32 graph_instance_index, uint32 frame_count);
+
+	// Executes tasks on the calling thread until all tasks for the given graph instance have completed
+	void wait_for_graph_instance(uint32 graph_instance_index);
+
+	// Executes every task for a range of graph instances on the given thread in the task graph's precomputed
+	// sequential order. Each task is executed for all graph instances before moving on to the next task. With static
+	// buffer slots, this performs no buffer allocation or atomic operations.
+	void process_tasks_sequentially(
+		uint32 thread_index,
+		e_instrument_stage instrument_stage,
+		uint32 first_graph_instance_index,
+		uint32 graph_instance_count,
+		bool profiling_enabled);
+
+	// Adds a task to the deque owned by the given thread
 	void add_task(
+		uint32 thread_index,
 		e_instrument_stage instrument_stage,
 		uint32 voice_index,
+		uint32 graph_instance_index,
 		uint32 task_index,
 		uint32 sample_rate,
 		uint32 frames);
@@ -152,8 +283,42 @@ private:
 	static void process_task_wrapper(uint32 thread_index, const s_thread_parameter_block *params);
 	void process_task(uint32 thread_index, const s_task_parameters *params);
 
+	static void process_voice_batch_wrapper(uint32 thread_index, const s_thread_parameter_block *params);
+	void process_voice_batch(uint32 thread_index, const s_voice_batch_parameters *params);
+
+	// Fills in a task function context for the given task and graph instance
+	void setup_task_function_context(
+		s_task_function_context &task_function_context,
+		uint32 thread_index,
+		e_instrument_stage instrument_stage,
+		uint32 voice_index,
+		uint32 graph_instance_index,
+		uint32 task_index,
+		uint32 frames);
+
+	// Sets up the thread's task function context and calls the task function. Buffers must already be allocated.
+	void call_task_function(
+		uint32 thread_index,
+		e_instrument_stage instrument_stage,
+		uint32 voice_index,
+		uint32 graph_instance_index,
+		uint32 task_index,
+		uint32 frames,
+		bool profiling_enabled);
+
+	// Calls the task's batched function once for a range of graph instances. Buffers must already be allocated.
+	void call_batched_task_function(
+		uint32 thread_index,
+		e_instrument_stage instrument_stage,
+		uint32 first_graph_instance_index,
+		uint32 graph_instance_count,
+		uint32 task_index,
+		bool profiling_enabled);
+
 	static void handle_event_wrapper(void *context, size_t event_size, const void *event_data);
 	void handle_event(size_t event_size, const void *event_data);
+	static void handle_dropped_events_wrapper(void *context, uint64 dropped_event_count);
+	void handle_dropped_events(uint64 dropped_event_count);
 
 	// Used to enable/disable the executor in a thread-safe manner
 	std::atomic<int32> m_state;
@@ -168,12 +333,20 @@ private:
 	// Pool of worker threads
 	c_thread_pool m_thread_pool;
 
-	// Context for each thread
+	// Context for each thread. The calling thread executes tasks while waiting on the worker threads so it gets the
+	// last context.
 	c_aligned_allocator<s_thread_context, CACHE_LINE_SIZE> m_thread_contexts;
+	uint32 m_calling_thread_index;
+
+	// Contexts passed to batched task functions. Each thread owns a range of get_voice_batch_size() contexts.
+	std::vector<s_task_function_context> m_batched_task_function_contexts;
 
 	// Voice activators don't run in the thread pool so they get their own context
 	alignas(CACHE_LINE_SIZE) s_task_function_context m_voice_activator_task_function_context;
 
+	// Decouples the processing chunk size from the driver's buffer size when a processing chunk size is specified
+	c_chunk_accumulator m_chunk_accumulator;
+
 	// Manages lifetime of various buffers used during processing
 	c_buffer_manager m_buffer_manager;
 
@@ -183,23 +356,15 @@ private:
 	// Manages which voices are active
 	c_voice_allocator m_voice_allocator;
 
-	// Interface for accessing voice data, e.g. which note ID is pressed
-	c_voice_interface m_voice_interface;
-
 	// Processes controller events and generates buffers for parameters
 	c_controller_event_manager m_controller_event_manager;
 
 	// Interface to access controller events
 	c_controller_interface m_controller_interface;
 
-	// Context for each task for the currently processing voice
-	c_lock_free_aligned_allocator<s_task_context> m_task_contexts;
-
-	// Total number of tasks remaining for the currently processing voice
-	ALIGNAS_LOCK_FREE std::atomic<int32> m_tasks_remaining;
-
-	// Signaled when all tasks are complete
-	c_semaphore m_all_tasks_complete_signal;
+	// Context for each task graph instance. There is more than one instance only when voices are processed
+	// concurrently. FX processing always uses the first instance.
+	std::vector<std::unique_ptr<s_graph_instance_context>> m_graph_instance_contexts;
 
 	// Sends events from the stream threads to the event handling thread
 	c_async_event_handler m_async_event_handler;
@@ -212,5 +377,28 @@ private:
 
 	// Used to measure execution time
 	c_profiler m_profiler;
+
+	// Tracks time spent on the current chunk for the deadline policy. The deadline is considered exceeded if the chunk
+	// ran over budget or if voices had to be degraded to keep it from doing so.
+	c_stopwatch m_deadline_stopwatch;
+	int64 m_deadline_budget_ns;
+	bool m_deadline_exceeded;
+
+	// Wall-clock time per voice, averaged over recent chunks. This accounts for voices overlapping on worker threads.
+	int64 m_estimated_voice_cost_ns;
+	uint32 m_chunk_voices_processed;
+
+	// Voices skipped for the rest of the current chunk, indexed by voice
+	std::vector<bool> m_deadline_skipped_voices;
+
+	// Scratch list of voices which may be degraded, preallocated to avoid allocating while processing
+	std::vector<uint32> m_deadline_candidate_voices;
+
+	// Voices degraded by the deadline policy during the current chunk and in total
+	uint32 m_chunk_voices_skipped;
+	uint32 m_chunk_voices_stolen;
+	uint64 m_total_voices_skipped;
+	uint64 m_total_voices_stolen;
+	uint64 m_total_chunks_exceeding_deadline;
 };
 
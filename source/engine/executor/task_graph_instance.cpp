@@ -0,0 +1,143 @@
+#include "engine/executor/task_graph_instance.h"
+
+void c_task_graph_instance::initialize(const c_task_graph *task_graph) {
+	wl_assert(task_graph);
+	deinitialize();
+
+	m_task_graph = task_graph;
+
+	// Create a buffer for each task graph buffer. Compile-time constants are read-only so we point directly at the
+	// task graph's copy.
+	size_t buffer_count = task_graph->get_buffer_count();
+	m_buffers.reserve(buffer_count);
+	m_buffer_pointers.resize(buffer_count);
+	for (size_t buffer_index = 0; buffer_index < buffer_count; buffer_index++) {
+		c_buffer *task_graph_buffer = task_graph->get_buffer_by_index(buffer_index);
+		m_buffers.push_back(c_buffer::construct(task_graph_buffer->get_data_type()));
+	}
+
+	for (size_t buffer_index = 0; buffer_index < buffer_count; buffer_index++) {
+		c_buffer *task_graph_buffer = task_graph->get_buffer_by_index(buffer_index);
+		m_buffer_pointers[buffer_index] = task_graph_buffer->is_compile_time_constant()
+			? task_graph_buffer
+			: &m_buffers[buffer_index];
+	}
+
+	// Count up the total number of arguments and buffer array elements up front so that the storage is never
+	// reallocated after we start taking pointers into it
+	size_t argument_count = 0;
+	size_t buffer_array_element_count = 0;
+	for (uint32 task_index = 0; task_index < task_graph->get_task_count(); task_index++) {
+		c_task_function_runtime_arguments arguments = task_graph->get_task_arguments(task_index);
+		argument_count += arguments.get_count();
+		for (const s_task_function_runtime_argument &argument : arguments) {
+			if (argument.type.is_array() && argument.type.get_data_mutability() != e_task_data_mutability::k_constant) {
+				buffer_array_element_count += std::get<c_buffer_array>(argument.value).get_count();
+			}
+		}
+	}
+
+	m_task_function_arguments.reserve(argument_count);
+	m_task_arguments_start.resize(task_graph->get_task_count());
+	m_buffer_arrays.reserve(buffer_array_element_count);
+
+	for (uint32 task_index = 0; task_index < task_graph->get_task_count(); task_index++) {
+		m_task_arguments_start[task_index] = m_task_function_arguments.size();
+
+		c_task_function_runtime_arguments arguments = task_graph->get_task_arguments(task_index);
+		for (const s_task_function_runtime_argument &argument : arguments) {
+			m_task_function_arguments.push_back(argument);
+			s_task_function_runtime_argument &instance_argument = m_task_function_arguments.back();
+
+			if (argument.type.get_data_mutability() == e_task_data_mutability::k_constant) {
+				// Constants (including constant arrays and strings) are read-only and can be shared with the task graph
+				continue;
+			}
+
+			if (argument.type.is_array()) {
+				c_buffer_array buffer_array = std::get<c_buffer_array>(argument.value);
+				size_t start_index = m_buffer_arrays.size();
+				for (c_buffer *buffer : buffer_array) {
+					m_buffer_arrays.push_back(remap_buffer(buffer));
+				}
+
+				instance_argument.value.emplace<c_buffer_array>(
+					buffer_array.get_count() == 0 ? nullptr : &m_buffer_arrays[start_index],
+					buffer_array.get_count());
+			} else {
+				instance_argument.value.emplace<c_buffer *>(remap_buffer(std::get<c_buffer *>(argument.value)));
+			}
+		}
+	}
+
+	wl_assert(m_task_function_arguments.size() == argument_count);
+	wl_assert(m_buffer_arrays.size() == buffer_array_element_count);
+
+	for (c_buffer *input_buffer : task_graph->get_inputs()) {
+		m_input_buffers.push_back(remap_buffer(input_buffer));
+	}
+
+	for (c_buffer *output_buffer : task_graph->get_outputs()) {
+		m_output_buffers.push_back(remap_buffer(output_buffer));
+	}
+
+	if (task_graph->get_remain_active_output()) {
+		m_remain_active_output_buffer = remap_buffer(task_graph->get_remain_active_output());
+	}
+}
+
+void c_task_graph_instance::deinitialize() {
+	m_task_graph = nullptr;
+	m_buffers.clear();
+	m_buffer_pointers.clear();
+	m_task_function_arguments.clear();
+	m_task_arguments_start.clear();
+	m_buffer_arrays.clear();
+	m_input_buffers.clear();
+	m_output_buffers.clear();
+	m_remain_active_output_buffer = nullptr;
+}
+
+const c_task_graph *c_task_graph_instance::get_task_graph() const {
+	return m_task_graph;
+}
+
+c_task_function_runtime_arguments c_task_graph_instance::get_task_arguments(uint32 task_index) const {
+	size_t argument_count = m_task_graph->get_task_arguments(task_index).get_count();
+	return c_task_function_runtime_arguments(
+		argument_count == 0 ? nullptr : &m_task_function_arguments[m_task_arguments_start[task_index]],
+		argument_count);
+}
+
+c_buffer_array c_task_graph_instance::get_inputs() const {
+	return c_buffer_array(m_input_buffers);
+}
+
+c_buffer_array c_task_graph_instance::get_outputs() const {
+	return c_buffer_array(m_output_buffers);
+}
+
+c_buffer *c_task_graph_instance::get_remain_active_output() const {
+	return m_remain_active_output_buffer;
+}
+
+size_t c_task_graph_instance::get_buffer_count() const {
+	return m_buffer_pointers.size();
+}
+
+c_buffer *c_task_graph_instance::get_buffer_by_index(size_t buffer_index) const {
+	return m_buffer_pointers[buffer_index];
+}
+
+size_t c_task_graph_instance::get_buffer_index(const c_buffer *buffer) const {
+	if (!m_buffers.empty() && buffer >= m_buffers.data() && buffer < m_buffers.data() + m_buffers.size()) {
+		return buffer - m_buffers.data();
+	}
+
+	// Compile-time constants point back into the task graph
+	return m_task_graph->get_buffer_index(buffer);
+}
+
+c_buffer *c_task_graph_instance::remap_buffer(const c_buffer *task_graph_buffer) const {
+	return m_buffer_pointers[m_task_graph->get_buffer_index(task_graph_buffer)];
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common/common.h"
+
+#include "engine/task_graph.h"
+
+#include "task_function/task_function.h"
+
+#include <vector>
+
+// A task graph instance holds a private copy of each dynamic buffer in a task graph, along with a copy of the task
+// arguments which have been remapped to point at those buffers. The task graph itself is never modified during
+// processing, so multiple instances of the same graph (e.g. one for each concurrently processing voice) can be run in
+// parallel without stomping on each other's buffers.
+class c_task_graph_instance {
+public:
+	c_task_graph_instance() = default;
+	// Moving is safe because all internal pointers point into vector storage, which is retained
+	UNCOPYABLE_MOVABLE(c_task_graph_instance);
+
+	void initialize(const c_task_graph *task_graph);
+	void deinitialize();
+
+	const c_task_graph *get_task_graph() const;
+	c_task_function_runtime_arguments get_task_arguments(uint32 task_index) const;
+
+	c_buffer_array get_inputs() const;
+	c_buffer_array get_outputs() const;
+	c_buffer *get_remain_active_output() const;
+
+	// Buffer indices match the indices of the task graph. Compile-time constant buffers are not duplicated, the buffer
+	// owned by the task graph is returned directly.
+	size_t get_buffer_count() const;
+	c_buffer *get_buffer_by_index(size_t buffer_index) const;
+	size_t get_buffer_index(const c_buffer *buffer) const;
+
+private:
+	// Maps a buffer owned by the task graph to the corresponding buffer owned by this instance
+	c_buffer *remap_buffer(const c_buffer *task_graph_buffer) const;
+
+	const c_task_graph *m_task_graph = nullptr;
+
+	// Backing storage for dynamic buffers. Entries corresponding to compile-time constants are unused.
+	std::vector<c_buffer> m_buffers;
+
+	// Pointer to each buffer, indexed identically to the task graph's buffers
+	std::vector<c_buffer *> m_buffer_pointers;
+
+	// Remapped task arguments and the start index of each task's arguments
+	std::vector<s_task_function_runtime_argument> m_task_function_arguments;
+	std::vector<size_t> m_task_arguments_start;
+
+	// Remapped buffer array contents
+	std::vector<c_buffer *> m_buffer_arrays;
+
+	std::vector<c_buffer *> m_input_buffers;
+	std::vector<c_buffer *> m_output_buffers;
+	c_buffer *m_remain_active_output_buffer = nullptr;
+};
@@ -20,6 +20,8 @@ void c_voice_allocator::initialize(uint32 max_voices, bool has_fx, bool activate
 		m_voice_list_nodes.push_node_onto_list_back(m_voice_list, list_node_index);
 	}
 
+	m_next_activation_index = 0;
+
 	m_has_fx = has_fx;
 	m_fx_voice = {};
 	m_fx_needs_activation = activate_fx_immediately;
@@ -108,6 +110,8 @@ void c_voice_allocator::allocate_voices_for_chunk(
 			voice.note_id = note_on_data->note_id;
 			voice.note_velocity = note_on_data->velocity;
 			voice.note_release_sample = -1;
+			voice.inaudible_sample_count = 0;
+			voice.activation_index = m_next_activation_index++;
 
 			activate_fx = true;
 		} else if (controller_event.controller_event.event_type == e_controller_event_type::k_note_off) {
@@ -174,6 +178,11 @@ void c_voice_allocator::voice_samples_processed(uint32 voice_index, uint32 sampl
 	m_voices[voice_index].sample_index += sample_count;
 }
 
+void c_voice_allocator::voice_inaudible_samples_processed(uint32 voice_index, bool inaudible, uint32 sample_count) {
+	s_voice &voice = m_voices[voice_index];
+	voice.inaudible_sample_count = inaudible ? voice.inaudible_sample_count + sample_count : 0;
+}
+
 const c_voice_allocator::s_voice &c_voice_allocator::get_fx_voice() const {
 	return m_fx_voice;
 }
@@ -23,6 +23,8 @@ public:
 		int32 note_id = 0;					// The ID of the note being played for the voice
 		real32 note_velocity = 0.0f;		// Velocity at which the note is played
 		int32 note_release_sample = 0;		// Offset into the chunk at which this note is released, or -1
+		uint64 inaudible_sample_count = 0;	// Number of consecutive samples for which this voice has been inaudible
+		uint64 activation_index = 0;		// Increases with each activation, older voices have lower values
 	};
 
 	c_voice_allocator() = default;
@@ -46,6 +48,9 @@ public:
 	const s_voice &get_voice(uint32 voice_index) const;
 	void voice_samples_processed(uint32 voice_index, uint32 sample_count);
 
+	// Extends the voice's run of inaudible samples, or resets it if the voice was audible
+	void voice_inaudible_samples_processed(uint32 voice_index, bool inaudible, uint32 sample_count);
+
 	// We use an s_voice instance to track FX processing even though it isn't really a "voice"
 	const s_voice &get_fx_voice() const;
 	void fx_samples_processed(uint32 sample_count);
@@ -74,6 +79,9 @@ private:
 	s_linked_array_list m_voice_list;
 	c_linked_array m_voice_list_nodes;
 
+	// Assigned to the next activated voice
+	uint64 m_next_activation_index = 0;
+
 	// Whether FX processing exists
 	bool m_has_fx = false;
 
@@ -1,15 +1,29 @@
 #include "engine/profiler/profiler.h"
 #include "engine/task_function_registry.h"
+#include "engine/task_graph.h"
 
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
 
+static constexpr int64 k_microseconds_per_second = 1000000l;
+
 static real64 nanoseconds_to_milliseconds(int64 nanoseconds) {
 	return static_cast<real64>(k_milliseconds_per_second * nanoseconds) / static_cast<real64>(k_nanoseconds_per_second);
 }
 
+static real64 nanoseconds_to_microseconds(int64 nanoseconds) {
+	return static_cast<real64>(k_microseconds_per_second * nanoseconds) / static_cast<real64>(k_nanoseconds_per_second);
+}
+
+static const char *get_task_function_name(h_task_function task_function_handle) {
+	const s_task_function &task_function = c_task_function_registry::get_task_function(task_function_handle);
+	h_native_module native_module_handle =
+		c_native_module_registry::get_native_module_handle(task_function.native_module_uid);
+	return c_native_module_registry::get_native_module(native_module_handle).name.get_string();
+}
+
 void s_profiler_record::reset() {
 	sample_count = 0;
 	average_time = 0;
@@ -60,6 +74,23 @@ bool output_profiler_report(const char *filename, const s_profiler_report &repor
 
 	out << "\n";
 
+	// The makespan is the time taken to process a single voice or the FX, which can only be measured when voices are
+	// processed one at a time
+	out << "Critical path\n";
+	out << "Stage,Work avg,Critical path avg,Makespan avg,Makespan min,Makespan max\n";
+	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
+		const s_profiler_record &makespan =
+			(instrument_stage == e_instrument_stage::k_voice) ? report.voice_time : report.fx_time;
+		out << ((instrument_stage == e_instrument_stage::k_voice) ? "Voice" : "FX") << ","
+			<< nanoseconds_to_milliseconds(report.task_work_times[enum_index(instrument_stage)]) << ","
+			<< nanoseconds_to_milliseconds(report.critical_path_times[enum_index(instrument_stage)]) << ","
+			<< nanoseconds_to_milliseconds(makespan.average_time) << ","
+			<< nanoseconds_to_milliseconds(makespan.min_time) << ","
+			<< nanoseconds_to_milliseconds(makespan.max_time) << "\n";
+	}
+
+	out << "\n";
+
 	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
 		out << (instrument_stage == e_instrument_stage::k_voice) ? "Voice tasks\n" : "FX tasks\n";
 		out << "Task Index,Task UID,Task name,Total avg,Total min,Total max,Function avg,Function min,Function max,"
@@ -75,9 +106,6 @@ bool output_profiler_report(const char *filename, const s_profiler_report &repor
 
 			const s_task_function &task_function =
 				c_task_function_registry::get_task_function(task.task_function_handle);
-			h_native_module native_module_handle =
-				c_native_module_registry::get_native_module_handle(task_function.native_module_uid);
-			const s_native_module &native_module = c_native_module_registry::get_native_module(native_module_handle);
 
 			std::stringstream uid_stream;
 			uid_stream << "0x" << std::setfill('0') << std::setw(2) << std::hex;
@@ -87,7 +115,7 @@ bool output_profiler_report(const char *filename, const s_profiler_report &repor
 
 			out << task_index << ","
 				<< uid_stream.str() << ","
-				<< native_module.name.get_string() << ","
+				<< get_task_function_name(task.task_function_handle) << ","
 				<< nanoseconds_to_milliseconds(task.task_total_time.average_time) << ","
 				<< nanoseconds_to_milliseconds(task.task_total_time.min_time) << ","
 				<< nanoseconds_to_milliseconds(task.task_total_time.max_time) << ","
@@ -105,6 +133,78 @@ bool output_profiler_report(const char *filename, const s_profiler_report &repor
 	return !out.fail();
 }
 
+bool output_profiler_trace(const char *filename, const s_profiler_trace &trace) {
+	std::ofstream out(filename);
+	if (!out.is_open()) {
+		return false;
+	}
+
+	// Each event is a JSON object and events are separated by commas
+	bool first_event = true;
+	auto begin_event = [&]() -> std::ofstream & {
+		out << (first_event ? "\n" : ",\n");
+		first_event = false;
+		return out;
+	};
+
+	// Chrome trace timestamps are in microseconds
+	out << std::fixed << std::setprecision(3);
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+	// Chunks are executed by the last thread, which also helps execute tasks
+	wl_assert(trace.worker_thread_count > 0);
+	uint32 calling_thread = trace.worker_thread_count - 1;
+	for (uint32 worker_thread = 0; worker_thread < trace.worker_thread_count; worker_thread++) {
+		begin_event() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << worker_thread
+			<< ",\"args\":{\"name\":\"";
+		if (worker_thread == calling_thread) {
+			out << "Calling thread";
+		} else {
+			out << "Worker thread " << worker_thread;
+		}
+		out << "\"}}";
+	}
+
+	auto output_span = [&](const char *name, const char *category, uint32 worker_thread, int64 begin, int64 end) {
+		begin_event() << "{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+			<< worker_thread << ",\"ts\":" << nanoseconds_to_microseconds(begin)
+			<< ",\"dur\":" << nanoseconds_to_microseconds(end - begin);
+	};
+
+	for (const s_profiler_trace::s_chunk &chunk : trace.chunks) {
+		output_span("Chunk", "chunk", calling_thread, chunk.begin_time, chunk.end_time);
+		out << ",\"args\":{\"chunk\":" << chunk.chunk_index << "}}";
+
+		if (chunk.voices_end_time > chunk.voices_begin_time) {
+			output_span("Voices", "stage", calling_thread, chunk.voices_begin_time, chunk.voices_end_time);
+			out << "}";
+		}
+
+		if (chunk.fx_end_time > chunk.fx_begin_time) {
+			output_span("FX", "stage", calling_thread, chunk.fx_begin_time, chunk.fx_end_time);
+			out << "}";
+		}
+	}
+
+	for (const s_profiler_trace::s_task &task : trace.tasks) {
+		bool is_voice_task = task.instrument_stage == e_instrument_stage::k_voice;
+		output_span(
+			get_task_function_name(task.task_function_handle),
+			is_voice_task ? "voice" : "fx",
+			task.worker_thread,
+			task.begin_time,
+			task.end_time);
+		out << ",\"args\":{\"task\":" << task.task_index;
+		if (is_voice_task) {
+			out << ",\"voice\":" << task.voice_index << ",\"voice_count\":" << task.voice_count;
+		}
+		out << "}}";
+	}
+
+	out << "\n]}\n";
+	return !out.fail();
+}
+
 c_profiler::c_profiler() {}
 
 c_profiler::~c_profiler() {}
@@ -112,15 +212,32 @@ c_profiler::~c_profiler() {}
 void c_profiler::initialize(const s_profiler_settings &settings) {
 	m_thread_contexts.free_memory();
 	m_thread_contexts.allocate(settings.worker_thread_count);
-	m_tasks[enum_index(e_instrument_stage::k_voice)].free_memory();
-	m_tasks[enum_index(e_instrument_stage::k_fx)].free_memory();
-	m_tasks[enum_index(e_instrument_stage::k_voice)].allocate(settings.voice_task_count);
-	m_tasks[enum_index(e_instrument_stage::k_fx)].allocate(settings.fx_task_count);
+	m_task_graphs = settings.task_graphs;
+	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
+		const c_task_graph *task_graph = m_task_graphs[enum_index(instrument_stage)];
+		m_tasks[enum_index(instrument_stage)].free_memory();
+		m_tasks[enum_index(instrument_stage)].allocate(task_graph ? task_graph->get_task_count() : 0);
+	}
 
 	m_execution.stopwatch.initialize();
 	for (size_t thread = 0; thread < m_thread_contexts.get_array().get_count(); thread++) {
 		m_thread_contexts.get_array()[thread].stopwatch.initialize();
 	}
+
+	// The chunk being executed needs its own slot so that discarding it doesn't lose the oldest committed chunk
+	m_trace_chunks.clear();
+	m_trace_chunk_task_event_starts.clear();
+	m_trace_task_events.clear();
+	m_trace_task_event_count = 0;
+	if (settings.trace_chunk_count > 0) {
+		wl_assert(settings.trace_task_event_count > 0);
+		m_trace_chunks.resize(settings.trace_chunk_count + 1);
+		m_trace_chunk_task_event_starts.resize(m_trace_chunks.size() * settings.worker_thread_count);
+		m_trace_task_event_count = settings.trace_task_event_count;
+		m_trace_task_events.resize(settings.worker_thread_count * m_trace_task_event_count);
+	}
+
+	m_trace_stopwatch.initialize();
 }
 
 void c_profiler::start() {
@@ -139,6 +256,14 @@ void c_profiler::start() {
 			task.did_run = false;
 		}
 	}
+
+	m_trace_stopwatch.reset();
+	m_executed_chunk_count = 0;
+	m_committed_trace_chunk_count = 0;
+	for (size_t thread = 0; thread < m_thread_contexts.get_array().get_count(); thread++) {
+		m_thread_contexts.get_array()[thread].trace_task_event_count = 0;
+		m_thread_contexts.get_array()[thread].trace_task_event_high_water_count = 0;
+	}
 }
 
 void c_profiler::stop() {
@@ -177,12 +302,98 @@ void c_profiler::get_report(s_profiler_report &report_out) const {
 			report_tasks[index].task_function_time = task.function_time;
 			report_tasks[index].task_overhead_time = task.overhead_time;
 		}
+
+		// Tasks which never ran have an average time of 0
+		int64 task_work_time = 0;
+		std::vector<real64> task_costs(tasks.get_count());
+		for (size_t index = 0; index < tasks.get_count(); index++) {
+			task_work_time += tasks[index].total_time.average_time;
+			task_costs[index] = static_cast<real64>(tasks[index].total_time.average_time);
+		}
+
+		const c_task_graph *task_graph = m_task_graphs[enum_index(instrument_stage)];
+		report_out.task_work_times[enum_index(instrument_stage)] = task_work_time;
+		report_out.critical_path_times[enum_index(instrument_stage)] = task_graph
+			? static_cast<int64>(task_graph->calculate_critical_path_cost(c_wrapped_array<const real64>(task_costs)))
+			: 0;
 	}
 }
 
+void c_profiler::get_trace(s_profiler_trace &trace_out) const {
+	c_wrapped_array<const s_thread_context> thread_contexts = m_thread_contexts.get_array();
+	size_t thread_count = thread_contexts.get_count();
+	trace_out.worker_thread_count = cast_integer_verify<uint32>(thread_count);
+	trace_out.chunks.clear();
+	trace_out.tasks.clear();
+
+	if (!is_tracing_enabled()) {
+		return;
+	}
+
+	// Skip the oldest chunks if any of their events have been overwritten. Later chunks' events always start after
+	// earlier chunks' events so once a chunk is complete, all following chunks are too.
+	size_t slot_count = m_trace_chunks.size();
+	uint64 first_chunk = m_committed_trace_chunk_count
+		- std::min<uint64>(m_committed_trace_chunk_count, slot_count - 1);
+	for (; first_chunk < m_committed_trace_chunk_count; first_chunk++) {
+		size_t slot = static_cast<size_t>(first_chunk % slot_count);
+		bool complete = true;
+		for (size_t thread = 0; thread < thread_count; thread++) {
+			const s_thread_context &thread_context = thread_contexts[thread];
+			uint64 task_event_start = m_trace_chunk_task_event_starts[slot * thread_count + thread];
+			uint64 high_water_count =
+				std::max(thread_context.trace_task_event_count, thread_context.trace_task_event_high_water_count);
+			complete &= task_event_start + m_trace_task_event_count >= high_water_count;
+		}
+
+		if (complete) {
+			break;
+		}
+	}
+
+	for (uint64 chunk_index = first_chunk; chunk_index < m_committed_trace_chunk_count; chunk_index++) {
+		const s_trace_chunk &trace_chunk = m_trace_chunks[static_cast<size_t>(chunk_index % slot_count)];
+		auto query_time = [&](e_execution_query_point query_point) {
+			return trace_chunk.begin_time + trace_chunk.query_points[enum_index(query_point)];
+		};
+
+		s_profiler_trace::s_chunk chunk;
+		chunk.chunk_index = trace_chunk.chunk_index;
+		chunk.begin_time = trace_chunk.begin_time;
+		chunk.end_time = query_time(e_execution_query_point::k_end_execution);
+		chunk.voices_begin_time = query_time(e_execution_query_point::k_begin_voices);
+		chunk.voices_end_time = query_time(e_execution_query_point::k_end_voices);
+		chunk.fx_begin_time = query_time(e_execution_query_point::k_begin_fx);
+		chunk.fx_end_time = query_time(e_execution_query_point::k_end_fx);
+		trace_out.chunks.push_back(chunk);
+	}
+
+	if (first_chunk == m_committed_trace_chunk_count) {
+		return;
+	}
+
+	// Discarded chunks are rewound so each thread's events from the first chunk onward all belong to committed chunks
+	size_t first_slot = static_cast<size_t>(first_chunk % slot_count);
+	for (size_t thread = 0; thread < thread_count; thread++) {
+		uint64 task_event_start = m_trace_chunk_task_event_starts[first_slot * thread_count + thread];
+		for (uint64 index = task_event_start; index < thread_contexts[thread].trace_task_event_count; index++) {
+			trace_out.tasks.push_back(
+				m_trace_task_events[thread * m_trace_task_event_count + (index % m_trace_task_event_count)]);
+		}
+	}
+}
+
+bool c_profiler::is_tracing_enabled() const {
+	return !m_trace_chunks.empty();
+}
+
 void c_profiler::begin_execution() {
 	zero_type(&m_execution.query_points);
 	m_execution.stopwatch.reset();
+
+	if (is_tracing_enabled()) {
+		begin_trace_chunk();
+	}
 }
 
 void c_profiler::begin_voices() {
@@ -225,8 +436,14 @@ void c_profiler::end_execution(int64 min_total_time_threshold_ns) {
 	int64 total_time = m_execution.query_points[enum_index(e_execution_query_point::k_end_execution)];
 	if (total_time >= min_total_time_threshold_ns) {
 		commit();
+		if (is_tracing_enabled()) {
+			commit_trace_chunk();
+		}
 	} else {
 		discard();
+		if (is_tracing_enabled()) {
+			discard_trace_chunk();
+		}
 	}
 }
 
@@ -261,6 +478,36 @@ void c_profiler::end_task(e_instrument_stage instrument_stage, uint32 worker_thr
 	task.did_run = true;
 }
 
+void c_profiler::begin_trace_task(uint32 worker_thread) {
+	s_thread_context &thread_context = m_thread_contexts.get_array()[worker_thread];
+	thread_context.trace_task_begin_time = m_trace_stopwatch.query();
+}
+
+void c_profiler::end_trace_task(
+	e_instrument_stage instrument_stage,
+	uint32 worker_thread,
+	uint32 task_index,
+	h_task_function task_function_handle,
+	uint32 voice_index,
+	uint32 voice_count) {
+	wl_assert(is_tracing_enabled());
+	s_thread_context &thread_context = m_thread_contexts.get_array()[worker_thread];
+
+	// Overwrite the oldest event if the ring buffer is full
+	uint64 event_index = thread_context.trace_task_event_count % m_trace_task_event_count;
+	thread_context.trace_task_event_count++;
+
+	s_profiler_trace::s_task &task = m_trace_task_events[worker_thread * m_trace_task_event_count + event_index];
+	task.worker_thread = worker_thread;
+	task.instrument_stage = instrument_stage;
+	task.task_index = task_index;
+	task.task_function_handle = task_function_handle;
+	task.voice_index = voice_index;
+	task.voice_count = voice_count;
+	task.begin_time = thread_context.trace_task_begin_time;
+	task.end_time = m_trace_stopwatch.query();
+}
+
 void c_profiler::commit() {
 	// Commit each task
 	for (e_instrument_stage instrument_stage : iterate_enum<e_instrument_stage>()) {
@@ -315,3 +562,37 @@ void c_profiler::discard() {
 void c_profiler::discard_task(s_task &task) {
 	task.did_run = false;
 }
+
+void c_profiler::begin_trace_chunk() {
+	// Worker threads aren't executing tasks between chunks so their event counts can be read here
+	size_t slot = static_cast<size_t>(m_committed_trace_chunk_count % m_trace_chunks.size());
+	s_trace_chunk &trace_chunk = m_trace_chunks[slot];
+	trace_chunk.chunk_index = m_executed_chunk_count;
+	trace_chunk.begin_time = m_trace_stopwatch.query();
+	m_executed_chunk_count++;
+
+	c_wrapped_array<s_thread_context> thread_contexts = m_thread_contexts.get_array();
+	for (size_t thread = 0; thread < thread_contexts.get_count(); thread++) {
+		m_trace_chunk_task_event_starts[slot * thread_contexts.get_count() + thread] =
+			thread_contexts[thread].trace_task_event_count;
+	}
+}
+
+void c_profiler::commit_trace_chunk() {
+	size_t slot = static_cast<size_t>(m_committed_trace_chunk_count % m_trace_chunks.size());
+	m_trace_chunks[slot].query_points = m_execution.query_points;
+	m_committed_trace_chunk_count++;
+}
+
+void c_profiler::discard_trace_chunk() {
+	// Rewind each thread's ring buffer so the next chunk reuses this chunk's events
+	size_t slot = static_cast<size_t>(m_committed_trace_chunk_count % m_trace_chunks.size());
+	c_wrapped_array<s_thread_context> thread_contexts = m_thread_contexts.get_array();
+	for (size_t thread = 0; thread < thread_contexts.get_count(); thread++) {
+		s_thread_context &thread_context = thread_contexts[thread];
+		thread_context.trace_task_event_high_water_count =
+			std::max(thread_context.trace_task_event_count, thread_context.trace_task_event_high_water_count);
+		thread_context.trace_task_event_count =
+			m_trace_chunk_task_event_starts[slot * thread_contexts.get_count() + thread];
+	}
+}
@@ -10,10 +10,19 @@
 
 #include <vector>
 
+class c_task_graph;
+
 struct s_profiler_settings {
 	uint32 worker_thread_count;
-	uint32 voice_task_count;
-	uint32 fx_task_count;
+
+	// Task graph for each stage, or null if the instrument doesn't have that stage
+	s_static_array<const c_task_graph *, enum_count<e_instrument_stage>()> task_graphs;
+
+	// Number of most recent committed chunks kept in the trace, 0 disables tracing
+	uint32 trace_chunk_count;
+
+	// Capacity of each worker thread's trace event ring buffer
+	uint32 trace_task_event_count;
 };
 
 struct s_profiler_record {
@@ -43,10 +52,51 @@ struct s_profiler_report {
 	s_profiler_record fx_time;
 
 	s_static_array<std::vector<s_task>, enum_count<e_instrument_stage>()> tasks;
+
+	// Sum of each stage's average task times, and the longest chain of average task times through the stage's task
+	// graph. The critical path is the shortest possible time to process the stage with unlimited threads.
+	s_static_array<int64, enum_count<e_instrument_stage>()> task_work_times;
+	s_static_array<int64, enum_count<e_instrument_stage>()> critical_path_times;
 };
 
 bool output_profiler_report(const char *filename, const s_profiler_report &report);
 
+struct s_profiler_trace {
+	struct s_chunk {
+		uint64 chunk_index;
+		int64 begin_time;
+		int64 end_time;
+
+		// Zero-length if the stage didn't run
+		int64 voices_begin_time;
+		int64 voices_end_time;
+		int64 fx_begin_time;
+		int64 fx_end_time;
+	};
+
+	struct s_task {
+		uint32 worker_thread;
+		e_instrument_stage instrument_stage;
+		uint32 task_index;
+		h_task_function task_function_handle;
+
+		// Batched tasks process multiple voices starting at voice_index at once
+		uint32 voice_index;
+		uint32 voice_count;
+
+		int64 begin_time;
+		int64 end_time;
+	};
+
+	// All times are in nanoseconds since profiling started
+	uint32 worker_thread_count;
+	std::vector<s_chunk> chunks;
+	std::vector<s_task> tasks;
+};
+
+// Writes the trace in the Chrome trace event JSON format, which can be loaded in chrome://tracing or Perfetto
+bool output_profiler_trace(const char *filename, const s_profiler_trace &trace);
+
 // $TODO add more query points. additional data includes channel mixing time, voice/FX setup time versus task time
 
 class c_profiler {
@@ -59,6 +109,9 @@ public:
 	void start();
 	void stop();
 	void get_report(s_profiler_report &report_out) const;
+	void get_trace(s_profiler_trace &trace_out) const;
+
+	bool is_tracing_enabled() const;
 
 	void begin_execution();
 	void begin_voices();
@@ -78,6 +131,16 @@ public:
 	void end_task_function(e_instrument_stage instrument_stage, uint32 worker_thread, uint32 task_index);
 	void end_task(e_instrument_stage instrument_stage, uint32 worker_thread, uint32 task_index);
 
+	// Trace tasks are recorded for every voice, unlike the aggregate task records above
+	void begin_trace_task(uint32 worker_thread);
+	void end_trace_task(
+		e_instrument_stage instrument_stage,
+		uint32 worker_thread,
+		uint32 task_index,
+		h_task_function task_function_handle,
+		uint32 voice_index,
+		uint32 voice_count);
+
 private:
 	enum class e_execution_query_point {
 		k_begin_voices,
@@ -110,6 +173,20 @@ private:
 
 	struct ALIGNAS_LOCK_FREE s_thread_context {
 		c_stopwatch stopwatch;
+		int64 trace_task_begin_time;
+
+		// Total number of trace events written to this thread's ring buffer, discarded chunks are rewound
+		uint64 trace_task_event_count;
+
+		// Highest event count reached. Rewinding doesn't restore events which a discarded chunk overwrote, so only
+		// events within the ring buffer's capacity of this count are valid.
+		uint64 trace_task_event_high_water_count;
+	};
+
+	struct s_trace_chunk {
+		uint64 chunk_index;
+		int64 begin_time;
+		s_static_array<int64, enum_count<e_execution_query_point>()> query_points;
 	};
 
 	struct ALIGNAS_LOCK_FREE s_task {
@@ -127,8 +204,29 @@ private:
 	void discard();
 	void discard_task(s_task &task);
 
+	void begin_trace_chunk();
+	void commit_trace_chunk();
+	void discard_trace_chunk();
+
 	s_execution m_execution;
 	c_lock_free_aligned_allocator<s_thread_context> m_thread_contexts;
 	s_static_array<c_lock_free_aligned_allocator<s_task>, enum_count<e_instrument_stage>()> m_tasks;
+	s_static_array<const c_task_graph *, enum_count<e_instrument_stage>()> m_task_graphs;
+
+	// Shared by all threads so that trace events have a common time base
+	c_stopwatch m_trace_stopwatch;
+
+	// Ring buffer of the most recent committed chunks. The chunk being executed occupies the slot after the last
+	// committed chunk.
+	std::vector<s_trace_chunk> m_trace_chunks;
+	uint64 m_executed_chunk_count;
+	uint64 m_committed_trace_chunk_count;
+
+	// For each chunk slot, the trace event count of each thread when the chunk began
+	std::vector<uint64> m_trace_chunk_task_event_starts;
+
+	// Each thread owns a contiguous ring buffer of m_trace_task_event_count events
+	uint32 m_trace_task_event_count;
+	std::vector<s_profiler_trace::s_task> m_trace_task_events;
 };
 
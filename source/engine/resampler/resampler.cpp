@@ -3,6 +3,8 @@
 #include "engine/resampler/resampler.h"
 #include "engine/resampler/resampler_filters.inl"
 
+#include <algorithm>
+
 c_resampler::c_resampler(const s_resampler_parameters &parameters, c_wrapped_array<const real32> phases)
 	: m_upsample_factor(static_cast<real32>(parameters.upsample_factor))
 	, m_taps_per_phase(parameters.taps_per_phase)
@@ -74,3 +76,153 @@ real32 c_resampler::resample(
 		return interpolated_result.sum_elements().first_element();
 	}
 }
+
+void c_resampler_block_kernel::initialize(
+	const s_resampler_parameters &parameters,
+	c_wrapped_array<const real32> phases,
+	c_wrapped_array<const real32> fractional_sample_indices,
+	uint32 sample_stride) {
+	wl_assert(fractional_sample_indices.get_count() > 0);
+	wl_assert(fractional_sample_indices.get_count() <= k_max_phase_count);
+	wl_assert(sample_stride > 0 && sample_stride <= k_max_sample_stride);
+	wl_assert(parameters.taps_per_phase <= k_max_taps_per_phase);
+
+	m_phase_count = cast_integer_verify<uint32>(fractional_sample_indices.get_count());
+	m_sample_stride = sample_stride;
+	m_padded_taps_per_phase = get_padded_taps_per_phase(parameters, sample_stride);
+	m_stream_tap_count = m_padded_taps_per_phase / sample_stride;
+	m_coefficients.resize(m_padded_taps_per_phase * m_phase_count);
+
+	uint32 padding_tap_count = m_padded_taps_per_phase - parameters.taps_per_phase;
+	real32 upsample_factor = static_cast<real32>(parameters.upsample_factor);
+	for (uint32 phase_index = 0; phase_index < m_phase_count; phase_index++) {
+		// Because the filter is linear, we can interpolate between the two nearest phases' coefficients rather than
+		// between their results like c_resampler does
+		real32 fractional_sample_index = fractional_sample_indices[phase_index];
+		wl_assert(fractional_sample_index >= 0.0f && fractional_sample_index < 1.0f);
+		real32 upsampled_fractional_sample_index = fractional_sample_index * upsample_factor;
+		uint32 phase_a_index = static_cast<uint32>(upsampled_fractional_sample_index); // Rounds toward zero
+		uint32 phase_b_index = phase_a_index + 1;
+		real32 phase_fraction = upsampled_fractional_sample_index - static_cast<real32>(phase_a_index);
+		const real32 *phase_a_coefficients = &phases[phase_a_index * parameters.taps_per_phase];
+		const real32 *phase_b_coefficients = &phases[phase_b_index * parameters.taps_per_phase];
+
+		real32 phase_gain = 0.0f;
+		for (uint32 padded_tap_index = 0; padded_tap_index < m_padded_taps_per_phase; padded_tap_index++) {
+			real32 coefficient = 0.0f;
+			if (padded_tap_index >= padding_tap_count) {
+				uint32 tap_index = padded_tap_index - padding_tap_count;
+				coefficient = phase_a_coefficients[tap_index];
+				if (phase_fraction != 0.0f) {
+					coefficient += (phase_b_coefficients[tap_index] - coefficient) * phase_fraction;
+				}
+			}
+
+			// Tap t reads from stream t % sample_stride at offset t / sample_stride
+			uint32 stream_index = padded_tap_index % sample_stride;
+			uint32 stream_tap_index = padded_tap_index / sample_stride;
+			size_t coefficient_index =
+				(stream_index * m_stream_tap_count + stream_tap_index) * m_phase_count + phase_index;
+			m_coefficients[coefficient_index] = coefficient;
+			phase_gain += coefficient;
+		}
+
+		m_phase_gains[phase_index] = phase_gain;
+	}
+}
+
+size_t c_resampler_block_kernel::get_required_sample_count(size_t count) const {
+	return (align_size(count, k_simd_32_lanes) + m_stream_tap_count - 1) * m_sample_stride;
+}
+
+void c_resampler_block_kernel::process(const real32 *samples, size_t count, real32 *outputs) const {
+	switch (m_phase_count) {
+	case 1:
+		process_internal<1>(samples, count, outputs);
+		break;
+
+	case 2:
+		process_internal<2>(samples, count, outputs);
+		break;
+
+	case 3:
+		process_internal<3>(samples, count, outputs);
+		break;
+
+	case 4:
+		process_internal<4>(samples, count, outputs);
+		break;
+
+	default:
+		wl_unreachable();
+	}
+}
+
+template<uint32 k_phase_count>
+void c_resampler_block_kernel::process_internal(const real32 *samples, size_t count, real32 *outputs) const {
+	static constexpr size_t k_max_stream_length =
+		k_max_strided_output_count + k_max_taps_per_phase + k_simd_32_lanes;
+	s_static_array<const real32 *, k_max_sample_stride> streams;
+	size_t stream_length = align_size(count, k_simd_32_lanes) + m_stream_tap_count - 1;
+
+	ALIGNAS_SIMD real32 deinterleaved_samples[k_max_sample_stride][k_max_stream_length];
+	if (m_sample_stride == 1) {
+		streams[0] = samples;
+	} else {
+		// Split the samples into polyphase streams so that consecutive outputs read consecutive stream samples
+		wl_assert(count <= k_max_strided_output_count);
+		wl_assert(stream_length <= k_max_stream_length);
+		for (uint32 stream_index = 0; stream_index < m_sample_stride; stream_index++) {
+			real32 *stream = deinterleaved_samples[stream_index];
+			const real32 *stream_samples = samples + stream_index;
+			for (size_t index = 0; index < stream_length; index++) {
+				stream[index] = stream_samples[index * m_sample_stride];
+			}
+
+			streams[stream_index] = stream;
+		}
+	}
+
+	for (size_t output_index = 0; output_index < count; output_index += k_simd_32_lanes) {
+		real32xN results[k_phase_count];
+		for (uint32 phase_index = 0; phase_index < k_phase_count; phase_index++) {
+			results[phase_index] = real32xN(0.0f);
+		}
+
+		// Each lane accumulates a different output. Every sample block is shared across all phases and each
+		// coefficient is broadcast across all lanes, so no horizontal reduction is needed.
+		const real32 *coefficients = m_coefficients.data();
+		for (uint32 stream_index = 0; stream_index < m_sample_stride; stream_index++) {
+			const real32 *stream_pointer = streams[stream_index] + output_index;
+			for (uint32 stream_tap_index = 0; stream_tap_index < m_stream_tap_count; stream_tap_index++) {
+				real32xN sample_block;
+				sample_block.load_unaligned(stream_pointer + stream_tap_index);
+
+				for (uint32 phase_index = 0; phase_index < k_phase_count; phase_index++) {
+					results[phase_index] += real32xN(coefficients[phase_index]) * sample_block;
+				}
+
+				coefficients += k_phase_count;
+			}
+		}
+
+		size_t group_output_count = std::min(k_simd_32_lanes, count - output_index);
+		if (k_phase_count == 1 && group_output_count == k_simd_32_lanes) {
+			results[0].store_unaligned(outputs + output_index);
+		} else {
+			// Interleave the phases and drop any outputs past the end
+			ALIGNAS_SIMD real32 phase_results[k_phase_count][k_simd_32_lanes];
+			for (uint32 phase_index = 0; phase_index < k_phase_count; phase_index++) {
+				results[phase_index].store(phase_results[phase_index]);
+			}
+
+			real32 *group_outputs = outputs + output_index * k_phase_count;
+			for (size_t group_output_index = 0; group_output_index < group_output_count; group_output_index++) {
+				for (uint32 phase_index = 0; phase_index < k_phase_count; phase_index++) {
+					group_outputs[group_output_index * k_phase_count + phase_index] =
+						phase_results[phase_index][group_output_index];
+				}
+			}
+		}
+	}
+}
@@ -4,6 +4,8 @@
 
 #include "instrument/resampler/resampler.h"
 
+#include <vector>
+
 c_wrapped_array<const real32> get_resampler_phases(e_resampler_filter resampler_filter);
 
 class c_resampler {
@@ -21,3 +23,72 @@ private:
 	uint32 m_taps_per_phase;
 	c_wrapped_array<const real32> m_phases;
 };
+
+// Computes blocks of resampled outputs at a fixed set of fractional sample indices (phases). Rather than computing one
+// output per call and reducing it with a horizontal sum like c_resampler, this computes k_simd_32_lanes consecutive
+// outputs of every phase in a single pass by multiplying broadcast coefficients with unaligned sample blocks. Each
+// sample block load is shared by all phases and no horizontal reduction is required.
+//
+// Consecutive outputs advance by sample_stride input samples. For a stride of 1 (upsampling), the samples are read in
+// place. For larger strides (downsampling), the samples are first deinterleaved into sample_stride polyphase streams
+// so that consecutive outputs still read contiguous samples. Coefficients are stored transposed to match:
+// [stream][tap][phase], with the filter padded at the beginning with zeros to a multiple of sample_stride taps.
+class c_resampler_block_kernel {
+public:
+	static constexpr uint32 k_max_phase_count = 4;
+	static constexpr uint32 k_max_sample_stride = 4;
+	static constexpr uint32 k_max_taps_per_phase = 256;
+
+	// When sample_stride is greater than 1, at most this many outputs can be computed per call
+	static constexpr size_t k_max_strided_output_count = 128;
+
+	// Returns taps_per_phase rounded up to a multiple of sample_stride
+	static uint32 get_padded_taps_per_phase(const s_resampler_parameters &parameters, uint32 sample_stride) {
+		return ((parameters.taps_per_phase + sample_stride - 1) / sample_stride) * sample_stride;
+	}
+
+	// Interpolates the coefficients for each fractional sample index up front
+	void initialize(
+		const s_resampler_parameters &parameters,
+		c_wrapped_array<const real32> phases,
+		c_wrapped_array<const real32> fractional_sample_indices,
+		uint32 sample_stride);
+
+	uint32 get_phase_count() const {
+		return m_phase_count;
+	}
+
+	uint32 get_sample_stride() const {
+		return m_sample_stride;
+	}
+
+	// The last tap of output m lands on samples[m * sample_stride + get_history_sample_count()]
+	uint32 get_history_sample_count() const {
+		return m_padded_taps_per_phase - 1;
+	}
+
+	// Returns the number of samples which must be readable to compute count outputs. Results are computed in groups
+	// of k_simd_32_lanes, so this extends past the last output's taps.
+	size_t get_required_sample_count(size_t count) const;
+
+	// Returns the sum of a phase's coefficients, which is the output for a constant input of 1
+	real32 get_phase_gain(uint32 phase_index) const {
+		return m_phase_gains[phase_index];
+	}
+
+	// For each output m in [0, count) and each phase i, computes:
+	//   outputs[m * phase_count + i] = sum_t padded_coefficients_i[t] * samples[m * sample_stride + t]
+	void process(const real32 *samples, size_t count, real32 *outputs) const;
+
+private:
+	template<uint32 k_phase_count>
+	void process_internal(const real32 *samples, size_t count, real32 *outputs) const;
+
+	uint32 m_phase_count = 0;
+	uint32 m_sample_stride = 0;
+	uint32 m_padded_taps_per_phase = 0;	// Taps per phase rounded up to a multiple of m_sample_stride
+	uint32 m_stream_tap_count = 0;		// Taps applied to each polyphase stream
+
+	std::vector<real32> m_coefficients;
+	s_static_array<real32, k_max_phase_count> m_phase_gains;
+};
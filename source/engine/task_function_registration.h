@@ -293,6 +293,17 @@ struct s_task_function_registration_entry {
 
 			return *this;
 		}
+
+		// Sets the function to be called at runtime when the same task is executed for several voices at once. This is
+		// optional and is only used when voices are processed in batches. Arguments are not bound for batched functions
+		// and are instead read directly from each context using the same argument indices as the main function.
+		template<auto k_function>
+		c_builder &set_batched_function() {
+			wl_assert(k_entry->arguments_initialized);
+			static_assert(std::is_convertible_v<decltype(k_function), f_task_batched_function>);
+			k_entry->task_function.batched_function = k_function;
+			return *this;
+		}
 	};
 };
 
@@ -5,6 +5,7 @@
 
 #include "instrument/resampler/resampler.h"
 
+#include <algorithm>
 #include <cmath>
 
 static constexpr e_resampler_filter k_resampler_filter = e_resampler_filter::k_upsample_low_quality;
@@ -66,8 +67,8 @@ void c_comb_feedback::initialize_variable(real32 min_delay, real32 max_delay, c_
 }
 
 void c_comb_feedback::reset() {
-	zero_type(m_history_buffer.get_pointer(), m_history_buffer.get_count());
 	m_history_index = 0;
+	m_initialized_sample_count = 0;
 }
 
 void c_comb_feedback::read_history(uint32 delay, real32 *output, size_t sample_count) {
@@ -80,10 +81,12 @@ void c_comb_feedback::read_history(uint32 delay, real32 *output, size_t sample_c
 		: m_history_index + m_history_length - delay;
 	if (start_history_index + sample_count > m_history_length) {
 		// We need to divide our read up into two ranges
+		clear_uninitialized_history(m_history_length);
 		size_t pre_wrap_sample_count = m_history_length - start_history_index;
 		read_contiguous_history(start_history_index, output, pre_wrap_sample_count);
 		read_contiguous_history(0, output + pre_wrap_sample_count, sample_count - pre_wrap_sample_count);
 	} else {
+		clear_uninitialized_history(start_history_index + sample_count);
 		read_contiguous_history(start_history_index, output, sample_count);
 	}
 }
@@ -115,6 +118,11 @@ void c_comb_feedback::read_history_variable(const real32 *delay, real32 *output,
 			? history_index + history_length - delay_integer
 			: history_index - delay_integer;
 
+		// The last tap lands on history_sample_index so no later samples are read
+		if (history_sample_index >= m_initialized_sample_count) {
+			clear_uninitialized_history(history_sample_index + 1);
+		}
+
 		output[sample_index] = resampler.resample(m_history_buffer, history_sample_index, delay_fraction);
 
 		history_index++;
@@ -147,6 +155,11 @@ void c_comb_feedback::read_history_variable_constant(real32 delay, real32 *outpu
 			? history_index + history_length - delay_integer
 			: history_index - delay_integer;
 
+		// The last tap lands on history_sample_index so no later samples are read
+		if (history_sample_index >= m_initialized_sample_count) {
+			clear_uninitialized_history(history_sample_index + 1);
+		}
+
 		output[sample_index] = resampler.resample(m_history_buffer, history_sample_index, delay_fraction);
 
 		history_index++;
@@ -233,6 +246,7 @@ void c_comb_feedback::write_contiguous_history(
 		m_history_index++;
 	}
 
+	m_initialized_sample_count = std::max(m_initialized_sample_count, m_history_index);
 	m_history_index = (m_history_index == m_history_length) ? 0 : m_history_index;
 
 	// Copy to the end of the buffer if necessary
@@ -270,6 +284,7 @@ void c_comb_feedback::write_contiguous_history(real32 input, const real32 *filte
 		m_history_index++;
 	}
 
+	m_initialized_sample_count = std::max(m_initialized_sample_count, m_history_index);
 	m_history_index = (m_history_index == m_history_length) ? 0 : m_history_index;
 
 	// Copy to the end of the buffer if necessary
@@ -282,3 +297,23 @@ void c_comb_feedback::write_contiguous_history(real32 input, const real32 *filte
 			copy_sample_count);
 	}
 }
+
+void c_comb_feedback::clear_uninitialized_history(size_t end_index) {
+	// Samples past the end of the history are duplicates of the samples at the beginning
+	end_index = std::min(end_index, static_cast<size_t>(m_history_length));
+	if (end_index <= m_initialized_sample_count) {
+		return;
+	}
+
+	zero_type(&m_history_buffer[m_initialized_sample_count], end_index - m_initialized_sample_count);
+
+	size_t padding_sample_count = m_history_buffer.get_count() - m_history_length;
+	if (m_initialized_sample_count < padding_sample_count) {
+		size_t padding_end_index = std::min(end_index, padding_sample_count);
+		zero_type(
+			&m_history_buffer[m_history_length + m_initialized_sample_count],
+			padding_end_index - m_initialized_sample_count);
+	}
+
+	m_initialized_sample_count = end_index;
+}
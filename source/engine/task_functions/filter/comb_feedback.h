@@ -29,6 +29,9 @@ private:
 	void write_contiguous_history(const real32 *input, const real32 *filtered_history, size_t sample_count);
 	void write_contiguous_history(real32 input, const real32 *filtered_history, size_t sample_count);
 
+	// Zeroes any history samples before end_index which haven't been written since the last reset
+	void clear_uninitialized_history(size_t end_index);
+
 	uint32 m_history_length = 0;
 	real32 m_min_delay = 0.0f;
 	real32 m_max_delay = 0.0f;
@@ -37,4 +40,8 @@ private:
 
 	// Current write index in the history buffer
 	size_t m_history_index = 0;
+
+	// Number of samples at the start of the history buffer which have been written or zeroed since the last reset. The
+	// rest of the buffer is treated as zero and is only cleared once it is first read, which keeps reset cheap.
+	size_t m_initialized_sample_count = 0;
 };
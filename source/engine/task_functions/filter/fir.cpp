@@ -1,55 +1,184 @@
 #include "common/math/math.h"
+#include "common/utility/aligned_allocator.h"
 
 #include "engine/task_functions/filter/fir.h"
+#include "engine/task_functions/filter/fir_kernels.h"
 
 // In this FIR implementation, we pad the coefficients with zeros to be a multiple of the SIMD lane count. We store the
 // coefficients in reverse and double the length of the history buffer.
 
+// Long filters are split into a head partition which is convolved directly and tail partitions which are convolved
+// using FFTs. Each time a block of partition_size input samples has been buffered, the previous and current blocks are
+// transformed, multiplied with each tail partition's spectrum against the matching delayed input spectrum, and
+// transformed back. Because the tail starts partition_size samples into the filter, its output for the next block is
+// ready before that block begins, so partitioning adds no latency.
+
+// Filters shorter than this are always convolved directly
+static constexpr size_t k_min_partitioned_coefficient_count = 1024;
+
+static constexpr size_t k_min_partition_size = 64;
+static constexpr size_t k_max_partition_size = 1024;
+STATIC_ASSERT(k_min_partition_size * 2 >= c_real_fft::k_min_fft_size);
+
+// Returns the partition size to use for the given coefficient count, or 0 if the filter should not be partitioned
+static size_t get_partition_size(size_t coefficient_count, bool partitioning_enabled) {
+	if (!partitioning_enabled || coefficient_count < k_min_partitioned_coefficient_count) {
+		return 0;
+	}
+
+	// The direct head costs partition_size operations per sample while the tail costs roughly
+	// coefficient_count / partition_size operations per sample (plus the FFTs), so a partition size around
+	// sqrt(coefficient_count) balances the two
+	size_t partition_size = k_min_partition_size;
+	while (partition_size < k_max_partition_size && partition_size * partition_size < coefficient_count) {
+		partition_size *= 2;
+	}
+
+	return partition_size;
+}
+
+static size_t get_tail_partition_count(size_t coefficient_count, size_t partition_size) {
+	wl_assert(coefficient_count > partition_size);
+	return (coefficient_count - 1) / partition_size;
+}
+
+// Returns the number of coefficients which are convolved directly
+static size_t get_head_coefficient_count(size_t coefficient_count, bool partitioning_enabled) {
+	size_t partition_size = get_partition_size(coefficient_count, partitioning_enabled);
+	return partition_size == 0 ? coefficient_count : partition_size;
+}
+
 void c_fir_coefficients::calculate_memory(
 	size_t coefficient_count,
-	c_stack_allocator::c_memory_calculator &memory_calculator) {
+	c_stack_allocator::c_memory_calculator &memory_calculator,
+	bool partitioning_enabled) {
 	wl_assert(coefficient_count > 0);
 
-	size_t padded_coefficient_count = align_size(coefficient_count, k_simd_32_lanes);
+	size_t head_coefficient_count = get_head_coefficient_count(coefficient_count, partitioning_enabled);
+	size_t padded_coefficient_count = align_size(head_coefficient_count, k_simd_32_lanes);
 	memory_calculator.add_array<real32>(padded_coefficient_count, k_simd_alignment);
+
+	size_t partition_size = get_partition_size(coefficient_count, partitioning_enabled);
+	if (partition_size > 0) {
+		c_real_fft::calculate_memory(partition_size * 2, memory_calculator);
+
+		size_t tail_partition_count = get_tail_partition_count(coefficient_count, partition_size);
+		memory_calculator.add_array<real32>(tail_partition_count * partition_size * 2, k_simd_alignment);
+	}
 }
 
-void c_fir_coefficients::initialize(c_wrapped_array<const real32> coefficients, c_stack_allocator &allocator) {
+void c_fir_coefficients::initialize(
+	c_wrapped_array<const real32> coefficients,
+	c_stack_allocator &allocator,
+	bool partitioning_enabled) {
 	wl_assert(coefficients.get_count() > 0);
 
-	size_t padded_coefficient_count = align_size(coefficients.get_count(), k_simd_32_lanes);
+	size_t head_coefficient_count = get_head_coefficient_count(coefficients.get_count(), partitioning_enabled);
+	size_t padded_coefficient_count = align_size(head_coefficient_count, k_simd_32_lanes);
 	allocator.allocate_array(m_coefficients, padded_coefficient_count, k_simd_alignment);
 
 	// Pad the end of the coefficient array with zeros and store the coefficients in reverse
-	zero_type(m_coefficients.get_pointer(), m_coefficients.get_count() - coefficients.get_count());
-	for (size_t index = 0; index < coefficients.get_count(); index++) {
+	zero_type(m_coefficients.get_pointer(), m_coefficients.get_count() - head_coefficient_count);
+	for (size_t index = 0; index < head_coefficient_count; index++) {
 		m_coefficients[m_coefficients.get_count() - index - 1] = coefficients[index];
 	}
+
+	m_partition_size = get_partition_size(coefficients.get_count(), partitioning_enabled);
+	if (m_partition_size == 0) {
+		return;
+	}
+
+	size_t fft_size = m_partition_size * 2;
+	m_fft.initialize(fft_size, allocator);
+
+	size_t tail_partition_count = get_tail_partition_count(coefficients.get_count(), m_partition_size);
+	allocator.allocate_array(m_partition_spectra, tail_partition_count * fft_size, k_simd_alignment);
+
+	// Each partition is zero-padded to the FFT size. The scale undoes the inverse FFT's gain.
+	c_aligned_allocator<real32, k_simd_alignment> partition;
+	c_aligned_allocator<real32, k_simd_alignment> fft_scratch;
+	partition.allocate(fft_size);
+	fft_scratch.allocate(fft_size);
+
+	real32 scale = 1.0f / static_cast<real32>(fft_size);
+	for (size_t partition_index = 0; partition_index < tail_partition_count; partition_index++) {
+		size_t coefficient_offset = (partition_index + 1) * m_partition_size;
+		size_t partition_coefficient_count =
+			std::min(m_partition_size, coefficients.get_count() - coefficient_offset);
+
+		zero_type(partition.get_array().get_pointer(), fft_size);
+		for (size_t index = 0; index < partition_coefficient_count; index++) {
+			partition.get_array()[index] = coefficients[coefficient_offset + index] * scale;
+		}
+
+		real32 *spectrum = &m_partition_spectra[partition_index * fft_size];
+		m_fft.forward(
+			partition.get_array().get_pointer(),
+			spectrum,
+			spectrum + m_partition_size,
+			fft_scratch.get_array().get_pointer());
+	}
 }
 
-void c_fir::calculate_memory(size_t coefficient_count, c_stack_allocator::c_memory_calculator &memory_calculator) {
+void c_fir::calculate_memory(
+	size_t coefficient_count,
+	c_stack_allocator::c_memory_calculator &memory_calculator,
+	bool partitioning_enabled) {
 	wl_assert(coefficient_count > 0);
 
 	// No need for alignment on the history buffer
-	size_t padded_coefficient_count = align_size(coefficient_count, k_simd_32_lanes);
+	size_t head_coefficient_count = get_head_coefficient_count(coefficient_count, partitioning_enabled);
+	size_t padded_coefficient_count = align_size(head_coefficient_count, k_simd_32_lanes);
 	memory_calculator.add_array<real32>(padded_coefficient_count * 2);
+
+	size_t partition_size = get_partition_size(coefficient_count, partitioning_enabled);
+	if (partition_size > 0) {
+		size_t fft_size = partition_size * 2;
+		size_t tail_partition_count = get_tail_partition_count(coefficient_count, partition_size);
+		memory_calculator.add_array<real32>(fft_size, k_simd_alignment);
+		memory_calculator.add_array<real32>(tail_partition_count * fft_size, k_simd_alignment);
+		memory_calculator.add_array<real32>(fft_size, k_simd_alignment);
+		memory_calculator.add_array<real32>(fft_size, k_simd_alignment);
+		memory_calculator.add_array<real32>(fft_size, k_simd_alignment);
+	}
 }
 
-void c_fir::initialize(size_t coefficient_count, c_stack_allocator &allocator) {
+void c_fir::initialize(size_t coefficient_count, c_stack_allocator &allocator, bool partitioning_enabled) {
 	wl_assert(coefficient_count > 0);
 
-	size_t padded_coefficient_count = align_size(coefficient_count, k_simd_32_lanes);
+	size_t head_coefficient_count = get_head_coefficient_count(coefficient_count, partitioning_enabled);
+	size_t padded_coefficient_count = align_size(head_coefficient_count, k_simd_32_lanes);
 	allocator.allocate_array(m_history_buffer, padded_coefficient_count * 2);
-	zero_type(m_history_buffer.get_pointer(), m_history_buffer.get_count());
+	m_silent_zero_count = padded_coefficient_count;
 
-	m_history_index = 0;
-	m_zero_count = padded_coefficient_count;
+	size_t partition_size = get_partition_size(coefficient_count, partitioning_enabled);
+	if (partition_size > 0) {
+		size_t fft_size = partition_size * 2;
+		size_t tail_partition_count = get_tail_partition_count(coefficient_count, partition_size);
+		allocator.allocate_array(m_tail_input, fft_size, k_simd_alignment);
+		allocator.allocate_array(m_input_spectra, tail_partition_count * fft_size, k_simd_alignment);
+		allocator.allocate_array(m_output_spectrum, fft_size, k_simd_alignment);
+		allocator.allocate_array(m_tail_output, fft_size, k_simd_alignment);
+		allocator.allocate_array(m_fft_scratch, fft_size, k_simd_alignment);
+
+		// The tail output for a block depends on the current block and tail_partition_count blocks before it. A partial
+		// block may also be buffered.
+		m_silent_zero_count += (tail_partition_count + 2) * partition_size;
+	}
+
+	reset();
 }
 
 void c_fir::reset() {
 	zero_type(m_history_buffer.get_pointer(), m_history_buffer.get_count());
 	m_history_index = 0;
-	m_zero_count = m_history_buffer.get_count() / 2;
+	m_zero_count = m_silent_zero_count;
+
+	zero_type(m_tail_input.get_pointer(), m_tail_input.get_count());
+	m_block_sample_count = 0;
+	zero_type(m_input_spectra.get_pointer(), m_input_spectra.get_count());
+	m_input_spectrum_index = 0;
+	zero_type(m_tail_output.get_pointer(), m_tail_output.get_count());
 }
 
 void c_fir::process(
@@ -57,41 +186,8 @@ void c_fir::process(
 	const real32 *input,
 	real32 *output,
 	size_t sample_count) {
-	size_t coefficient_count = fir_coefficients.m_coefficients.get_count();
-	wl_assert(coefficient_count * 2 == m_history_buffer.get_count());
-
 	m_zero_count = 0;
-
-	for (size_t sample_index = 0; sample_index < sample_count; sample_index++) {
-		// Duplicate the sample in the history buffer
-		real32 input_value = input[sample_index];
-		m_history_buffer[m_history_index] = input_value;
-		m_history_buffer[m_history_index + coefficient_count] = input_value;
-
-		real32xN output_value(0.0f);
-
-		// The history buffer is repeated twice and each repetition is of length coefficient_count. We want our last
-		// sampled history value to be the one we just wrote which is at index m_history_index + coefficient_count.
-		// Therefore, we start sampling at index (m_history_index + coefficient_count) - (coefficient_count - 1) =
-		// m_history_count + 1. Note that the coefficients are stored in reverse so we don't have to reverse the history
-		// buffer here.
-		size_t history_index = m_history_index + 1;
-		for (size_t coefficient_index = 0;
-			coefficient_index < coefficient_count;
-			coefficient_index += k_simd_32_lanes) {
-			real32xN coefficients(&fir_coefficients.m_coefficients[coefficient_index]);
-			real32xN history;
-			history.load_unaligned(&m_history_buffer[history_index]);
-			output_value += coefficients * history;
-
-			history_index += k_simd_32_lanes;
-		}
-
-		output[sample_index] = output_value.sum_elements().first_element();
-
-		m_history_index++;
-		m_history_index = (m_history_index == coefficient_count) ? 0 : m_history_index;
-	}
+	process_internal(fir_coefficients, input, 1, output, sample_count);
 }
 
 bool c_fir::process_constant(
@@ -99,11 +195,8 @@ bool c_fir::process_constant(
 	real32 input,
 	real32 *output,
 	size_t sample_count) {
-	size_t coefficient_count = fir_coefficients.m_coefficients.get_count();
-	wl_assert(coefficient_count * 2 == m_history_buffer.get_count());
-
 	if (input == 0.0f) {
-		if (m_zero_count >= coefficient_count) {
+		if (m_zero_count >= m_silent_zero_count) {
 			// All coefficients are being multiplied by 0
 			*output = 0.0f;
 			return true;
@@ -114,35 +207,134 @@ bool c_fir::process_constant(
 		m_zero_count = 0;
 	}
 
+	process_internal(fir_coefficients, &input, 0, output, sample_count);
+	return false;
+}
+
+void c_fir::process_internal(
+	const c_fir_coefficients &fir_coefficients,
+	const real32 *input,
+	size_t input_stride,
+	real32 *output,
+	size_t sample_count) {
+	size_t partition_size = fir_coefficients.m_partition_size;
+	if (partition_size == 0) {
+		process_direct(fir_coefficients, input, input_stride, output, sample_count);
+		return;
+	}
+
+	wl_assert(m_tail_input.get_count() == partition_size * 2);
+	while (sample_count > 0) {
+		// Process up to the end of the current block
+		size_t block_sample_count = std::min(sample_count, partition_size - m_block_sample_count);
+		process_direct(fir_coefficients, input, input_stride, output, block_sample_count);
+
+		// Buffer the input for the tail and add the tail's output which was computed at the end of the previous block
+		real32 *tail_input = &m_tail_input[partition_size + m_block_sample_count];
+		const real32 *tail_output = &m_tail_output[partition_size + m_block_sample_count];
+		for (size_t sample_index = 0; sample_index < block_sample_count; sample_index++) {
+			tail_input[sample_index] = input[sample_index * input_stride];
+			output[sample_index] += tail_output[sample_index];
+		}
+
+		input += block_sample_count * input_stride;
+		output += block_sample_count;
+		sample_count -= block_sample_count;
+		m_block_sample_count += block_sample_count;
+
+		if (m_block_sample_count == partition_size) {
+			process_tail_block(fir_coefficients);
+			m_block_sample_count = 0;
+		}
+	}
+}
+
+void c_fir::process_direct(
+	const c_fir_coefficients &fir_coefficients,
+	const real32 *input,
+	size_t input_stride,
+	real32 *output,
+	size_t sample_count) {
+	size_t coefficient_count = fir_coefficients.m_coefficients.get_count();
+	wl_assert(coefficient_count * 2 == m_history_buffer.get_count());
+
+	const s_fir_kernels &fir_kernels = get_fir_kernels();
 	for (size_t sample_index = 0; sample_index < sample_count; sample_index++) {
 		// Duplicate the sample in the history buffer
-		m_history_buffer[m_history_index] = input;
-		m_history_buffer[m_history_index + coefficient_count] = input;
-
-		real32xN output_value(0.0f);
+		real32 input_value = input[sample_index * input_stride];
+		m_history_buffer[m_history_index] = input_value;
+		m_history_buffer[m_history_index + coefficient_count] = input_value;
 
 		// The history buffer is repeated twice and each repetition is of length coefficient_count. We want our last
 		// sampled history value to be the one we just wrote which is at index m_history_index + coefficient_count.
 		// Therefore, we start sampling at index (m_history_index + coefficient_count) - (coefficient_count - 1) =
 		// m_history_count + 1. Note that the coefficients are stored in reverse so we don't have to reverse the history
 		// buffer here.
-		size_t history_index = m_history_index + 1;
-		for (size_t coefficient_index = 0;
-			coefficient_index < coefficient_count;
-			coefficient_index += k_simd_32_lanes) {
-			real32xN coefficients(&fir_coefficients.m_coefficients[coefficient_index]);
-			real32xN history;
-			history.load_unaligned(&m_history_buffer[history_index]);
-			output_value += coefficients * history;
-
-			history_index += k_simd_32_lanes;
-		}
-
-		output[sample_index] = output_value.sum_elements().first_element();
+		output[sample_index] = fir_kernels.convolve(
+			fir_coefficients.m_coefficients.get_pointer(),
+			&m_history_buffer[m_history_index + 1],
+			coefficient_count);
 
 		m_history_index++;
 		m_history_index = (m_history_index == coefficient_count) ? 0 : m_history_index;
 	}
+}
 
-	return false;
+void c_fir::process_tail_block(const c_fir_coefficients &fir_coefficients) {
+	size_t partition_size = fir_coefficients.m_partition_size;
+	size_t fft_size = partition_size * 2;
+	size_t tail_partition_count = m_input_spectra.get_count() / fft_size;
+
+	// Transform the previous and current blocks, replacing the oldest input spectrum
+	m_input_spectrum_index = (m_input_spectrum_index == 0) ? tail_partition_count - 1 : m_input_spectrum_index - 1;
+	real32 *newest_input_spectrum = &m_input_spectra[m_input_spectrum_index * fft_size];
+	fir_coefficients.m_fft.forward(
+		m_tail_input.get_pointer(),
+		newest_input_spectrum,
+		newest_input_spectrum + partition_size,
+		m_fft_scratch.get_pointer());
+
+	// Partition j is applied to the input spectrum from j blocks ago. Element 0 of each spectrum holds the purely real
+	// DC and Nyquist bins so it is accumulated separately rather than as a complex product.
+	real32 *output_real = m_output_spectrum.get_pointer();
+	real32 *output_imaginary = output_real + partition_size;
+	zero_type(output_real, fft_size);
+	real32 dc = 0.0f;
+	real32 nyquist = 0.0f;
+
+	const s_fir_kernels &fir_kernels = get_fir_kernels();
+	size_t input_spectrum_index = m_input_spectrum_index;
+	for (size_t partition_index = 0; partition_index < tail_partition_count; partition_index++) {
+		const real32 *input_real = &m_input_spectra[input_spectrum_index * fft_size];
+		const real32 *input_imaginary = input_real + partition_size;
+		const real32 *partition_real = &fir_coefficients.m_partition_spectra[partition_index * fft_size];
+		const real32 *partition_imaginary = partition_real + partition_size;
+
+		dc += input_real[0] * partition_real[0];
+		nyquist += input_imaginary[0] * partition_imaginary[0];
+
+		fir_kernels.multiply_accumulate_spectrum(
+			input_real,
+			input_imaginary,
+			partition_real,
+			partition_imaginary,
+			output_real,
+			output_imaginary,
+			partition_size);
+
+		input_spectrum_index = (input_spectrum_index + 1 == tail_partition_count) ? 0 : input_spectrum_index + 1;
+	}
+
+	output_real[0] = dc;
+	output_imaginary[0] = nyquist;
+
+	// The second half of the circular convolution is the linear convolution of the current block
+	fir_coefficients.m_fft.inverse(
+		output_real,
+		output_imaginary,
+		m_tail_output.get_pointer(),
+		m_fft_scratch.get_pointer());
+
+	// The current block becomes the previous block
+	copy_type(m_tail_input.get_pointer(), m_tail_input.get_pointer() + partition_size, partition_size);
 }
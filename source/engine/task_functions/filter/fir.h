@@ -1,28 +1,52 @@
 #pragma once
 
 #include "common/common.h"
+#include "common/math/fft.h"
 #include "common/utility/stack_allocator.h"
 
 class c_fir_coefficients {
 public:
 	c_fir_coefficients() = default;
 
-	static void calculate_memory(size_t coefficient_count, c_stack_allocator::c_memory_calculator &memory_calculator);
-	void initialize(c_wrapped_array<const real32> coefficients, c_stack_allocator &allocator);
+	// If partitioning is disabled, the filter is always convolved directly. Both the coefficients and the filter must
+	// agree on this setting.
+	static void calculate_memory(
+		size_t coefficient_count,
+		c_stack_allocator::c_memory_calculator &memory_calculator,
+		bool partitioning_enabled = true);
+	void initialize(
+		c_wrapped_array<const real32> coefficients,
+		c_stack_allocator &allocator,
+		bool partitioning_enabled = true);
 
 private:
 	friend class c_fir;
 
-	// Aligned and padded coefficients
+	// Aligned and padded coefficients. For partitioned filters, these are only the head partition's coefficients.
 	c_wrapped_array<real32> m_coefficients;
+
+	// Size of each tail partition, or 0 if the filter isn't partitioned
+	size_t m_partition_size = 0;
+
+	// Transforms blocks of size m_partition_size * 2
+	c_real_fft m_fft;
+
+	// Spectrum of each tail partition, pre-scaled to undo the inverse FFT's gain. Each partition's real bins are
+	// followed by its imaginary bins.
+	c_wrapped_array<real32> m_partition_spectra;
 };
 
+// Long filters are partitioned: the first partition (the head) is convolved directly so the filter has no latency and
+// the remaining partitions (the tail) are convolved in the frequency domain using uniformly partitioned overlap-save.
 class c_fir {
 public:
 	c_fir() = default;
 
-	static void calculate_memory(size_t coefficient_count, c_stack_allocator::c_memory_calculator &memory_calculator);
-	void initialize(size_t coefficient_count, c_stack_allocator &allocator);
+	static void calculate_memory(
+		size_t coefficient_count,
+		c_stack_allocator::c_memory_calculator &memory_calculator,
+		bool partitioning_enabled = true);
+	void initialize(size_t coefficient_count, c_stack_allocator &allocator, bool partitioning_enabled = true);
 
 	void reset();
 
@@ -36,6 +60,25 @@ public:
 		size_t sample_count);
 
 private:
+	// Processes samples, switching to the tail partitions at block boundaries. An input stride of 0 reads a constant.
+	void process_internal(
+		const c_fir_coefficients &fir_coefficients,
+		const real32 *input,
+		size_t input_stride,
+		real32 *output,
+		size_t sample_count);
+
+	// Convolves the input with the directly-convolved coefficients
+	void process_direct(
+		const c_fir_coefficients &fir_coefficients,
+		const real32 *input,
+		size_t input_stride,
+		real32 *output,
+		size_t sample_count);
+
+	// Called once a full block of input has been buffered. Computes the tail's output for the next block.
+	void process_tail_block(const c_fir_coefficients &fir_coefficients);
+
 	// Padded history buffer
 	c_wrapped_array<real32> m_history_buffer;
 
@@ -44,4 +87,26 @@ private:
 
 	// Number of zeros in the history buffer
 	size_t m_zero_count = 0;
+
+	// Number of consecutive zero inputs after which the output is guaranteed to be zero
+	size_t m_silent_zero_count = 0;
+
+	// The previous and current input blocks which are transformed together for overlap-save
+	c_wrapped_array<real32> m_tail_input;
+
+	// Number of samples buffered in the current input block
+	size_t m_block_sample_count = 0;
+
+	// Spectra of the most recent input blocks, one per tail partition, used as a circular buffer
+	c_wrapped_array<real32> m_input_spectra;
+	size_t m_input_spectrum_index = 0;
+
+	// Sum of the products of the input spectra and partition spectra
+	c_wrapped_array<real32> m_output_spectrum;
+
+	// Inverse transform of the output spectrum. Only the second half is valid output.
+	c_wrapped_array<real32> m_tail_output;
+
+	// Scratch buffer for the FFT
+	c_wrapped_array<real32> m_fft_scratch;
 };
@@ -0,0 +1,73 @@
+#include "common/math/math.h"
+
+#include "engine/task_functions/filter/fir_kernels.h"
+
+// The baseline tier is compiled with the build's own instruction sets so it can use the shared SIMD types
+using t_fir_vector = real32xN;
+static constexpr size_t k_fir_lanes = real32xN::k_element_count;
+
+static t_fir_vector fir_vector_zero() {
+	return real32xN(0.0f);
+}
+
+static t_fir_vector fir_vector_load(const real32 *pointer) {
+	real32xN result;
+	result.load_unaligned(pointer);
+	return result;
+}
+
+static void fir_vector_store(real32 *pointer, const t_fir_vector &value) {
+	value.store_unaligned(pointer);
+}
+
+static t_fir_vector fir_vector_add(const t_fir_vector &lhs, const t_fir_vector &rhs) {
+	return lhs + rhs;
+}
+
+static t_fir_vector fir_vector_subtract(const t_fir_vector &lhs, const t_fir_vector &rhs) {
+	return lhs - rhs;
+}
+
+static t_fir_vector fir_vector_multiply(const t_fir_vector &lhs, const t_fir_vector &rhs) {
+	return lhs * rhs;
+}
+
+static real32 fir_vector_sum_elements(const t_fir_vector &value) {
+	return value.sum_elements().first_element();
+}
+
+#include "engine/task_functions/filter/fir_kernels.inl"
+
+static const s_fir_kernels &select_fir_kernels() {
+	// Fall back to lower tiers if the CPU's highest tier wasn't compiled into this build
+	for (int32 simd_tier = static_cast<int32>(enum_index(get_simd_tier())); simd_tier > 0; simd_tier--) {
+		const s_fir_kernels *fir_kernels = get_fir_kernels(static_cast<e_simd_tier>(simd_tier));
+		if (fir_kernels) {
+			return *fir_kernels;
+		}
+	}
+
+	return k_fir_kernels;
+}
+
+const s_fir_kernels &get_fir_kernels() {
+	static const s_fir_kernels &k_selected_fir_kernels = select_fir_kernels();
+	return k_selected_fir_kernels;
+}
+
+const s_fir_kernels *get_fir_kernels(e_simd_tier simd_tier) {
+	switch (simd_tier) {
+	case e_simd_tier::k_baseline:
+		return &k_fir_kernels;
+
+	case e_simd_tier::k_avx2:
+		return get_fir_kernels_avx2();
+
+	case e_simd_tier::k_avx512:
+		return get_fir_kernels_avx512();
+
+	default:
+		wl_unreachable();
+		return nullptr;
+	}
+}
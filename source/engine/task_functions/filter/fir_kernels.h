@@ -0,0 +1,34 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/math/simd.h"
+
+// Returns the sum of the products of count coefficients and samples
+using f_fir_convolve = real32 (*)(const real32 *coefficients, const real32 *samples, size_t count);
+
+// Adds the complex products of count bins of a and b to the output spectrum
+using f_fir_multiply_accumulate_spectrum = void (*)(
+	const real32 *a_real,
+	const real32 *a_imaginary,
+	const real32 *b_real,
+	const real32 *b_imaginary,
+	real32 *output_real,
+	real32 *output_imaginary,
+	size_t count);
+
+// The FIR's hot loops are compiled for each SIMD tier. Results may differ slightly between tiers because the products
+// are summed in a different order.
+struct s_fir_kernels {
+	f_fir_convolve convolve;
+	f_fir_multiply_accumulate_spectrum multiply_accumulate_spectrum;
+};
+
+// Returns the kernels for the highest SIMD tier supported by the CPU
+const s_fir_kernels &get_fir_kernels();
+
+// Returns the kernels for the given SIMD tier or null if this build doesn't include them
+const s_fir_kernels *get_fir_kernels(e_simd_tier simd_tier);
+
+// Implemented in the tier-specific source files, these return null if the file wasn't compiled for its tier
+const s_fir_kernels *get_fir_kernels_avx2();
+const s_fir_kernels *get_fir_kernels_avx512();
@@ -0,0 +1,60 @@
+// This file is included by each SIMD tier's source file. Everything here must be file-local (see e_simd_tier). Before
+// including it, each tier defines t_fir_vector, k_fir_lanes, and the static fir_vector_* functions used below.
+
+// Loads are unaligned because buffers are only aligned to the build's baseline SIMD alignment
+static real32 fir_convolve(const real32 *coefficients, const real32 *samples, size_t count) {
+	size_t simd_count = count - (count % k_fir_lanes);
+
+	t_fir_vector sum = fir_vector_zero();
+	size_t index = 0;
+	for (; index < simd_count; index += k_fir_lanes) {
+		t_fir_vector coefficient_values = fir_vector_load(&coefficients[index]);
+		t_fir_vector sample_values = fir_vector_load(&samples[index]);
+		sum = fir_vector_add(sum, fir_vector_multiply(coefficient_values, sample_values));
+	}
+
+	// Coefficients are only padded to the baseline lane count so wider tiers may have a remainder
+	real32 result = fir_vector_sum_elements(sum);
+	for (; index < count; index++) {
+		result += coefficients[index] * samples[index];
+	}
+
+	return result;
+}
+
+static void fir_multiply_accumulate_spectrum(
+	const real32 *a_real,
+	const real32 *a_imaginary,
+	const real32 *b_real,
+	const real32 *b_imaginary,
+	real32 *output_real,
+	real32 *output_imaginary,
+	size_t count) {
+	size_t simd_count = count - (count % k_fir_lanes);
+
+	size_t index = 0;
+	for (; index < simd_count; index += k_fir_lanes) {
+		t_fir_vector a_real_values = fir_vector_load(&a_real[index]);
+		t_fir_vector a_imaginary_values = fir_vector_load(&a_imaginary[index]);
+		t_fir_vector b_real_values = fir_vector_load(&b_real[index]);
+		t_fir_vector b_imaginary_values = fir_vector_load(&b_imaginary[index]);
+
+		t_fir_vector product_real = fir_vector_subtract(
+			fir_vector_multiply(a_real_values, b_real_values),
+			fir_vector_multiply(a_imaginary_values, b_imaginary_values));
+		t_fir_vector product_imaginary = fir_vector_add(
+			fir_vector_multiply(a_real_values, b_imaginary_values),
+			fir_vector_multiply(a_imaginary_values, b_real_values));
+		fir_vector_store(&output_real[index], fir_vector_add(fir_vector_load(&output_real[index]), product_real));
+		fir_vector_store(
+			&output_imaginary[index],
+			fir_vector_add(fir_vector_load(&output_imaginary[index]), product_imaginary));
+	}
+
+	for (; index < count; index++) {
+		output_real[index] += a_real[index] * b_real[index] - a_imaginary[index] * b_imaginary[index];
+		output_imaginary[index] += a_real[index] * b_imaginary[index] + a_imaginary[index] * b_real[index];
+	}
+}
+
+static constexpr s_fir_kernels k_fir_kernels = { fir_convolve, fir_multiply_accumulate_spectrum };
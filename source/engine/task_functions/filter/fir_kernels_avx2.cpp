@@ -0,0 +1,54 @@
+#include "engine/task_functions/filter/fir_kernels.h"
+
+#if IS_TRUE(SIMD_IMPLEMENTATION_AVX2_ENABLED)
+
+// The shared SIMD types aren't used here because their inline functions have external linkage (see e_simd_tier)
+using t_fir_vector = __m256;
+static constexpr size_t k_fir_lanes = 8;
+
+static t_fir_vector fir_vector_zero() {
+	return _mm256_setzero_ps();
+}
+
+static t_fir_vector fir_vector_load(const real32 *pointer) {
+	return _mm256_loadu_ps(pointer);
+}
+
+static void fir_vector_store(real32 *pointer, const t_fir_vector &value) {
+	_mm256_storeu_ps(pointer, value);
+}
+
+static t_fir_vector fir_vector_add(const t_fir_vector &lhs, const t_fir_vector &rhs) {
+	return _mm256_add_ps(lhs, rhs);
+}
+
+static t_fir_vector fir_vector_subtract(const t_fir_vector &lhs, const t_fir_vector &rhs) {
+	return _mm256_sub_ps(lhs, rhs);
+}
+
+static t_fir_vector fir_vector_multiply(const t_fir_vector &lhs, const t_fir_vector &rhs) {
+	return _mm256_mul_ps(lhs, rhs);
+}
+
+static real32 fir_vector_sum_elements(const t_fir_vector &value) {
+	__m128 sum = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+	__m128 shuffled = _mm_movehdup_ps(sum);
+	sum = _mm_add_ps(sum, shuffled);
+	shuffled = _mm_movehl_ps(shuffled, sum);
+	sum = _mm_add_ss(sum, shuffled);
+	return _mm_cvtss_f32(sum);
+}
+
+#include "engine/task_functions/filter/fir_kernels.inl"
+
+const s_fir_kernels *get_fir_kernels_avx2() {
+	return &k_fir_kernels;
+}
+
+#else // IS_TRUE(SIMD_IMPLEMENTATION_AVX2_ENABLED)
+
+const s_fir_kernels *get_fir_kernels_avx2() {
+	return nullptr;
+}
+
+#endif // IS_TRUE(SIMD_IMPLEMENTATION_AVX2_ENABLED)
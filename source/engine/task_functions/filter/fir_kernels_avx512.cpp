@@ -0,0 +1,49 @@
+#include "engine/task_functions/filter/fir_kernels.h"
+
+#if IS_TRUE(SIMD_IMPLEMENTATION_AVX512F_ENABLED)
+
+// The shared SIMD types aren't used here because their inline functions have external linkage (see e_simd_tier)
+using t_fir_vector = __m512;
+static constexpr size_t k_fir_lanes = 16;
+
+static t_fir_vector fir_vector_zero() {
+	return _mm512_setzero_ps();
+}
+
+static t_fir_vector fir_vector_load(const real32 *pointer) {
+	return _mm512_loadu_ps(pointer);
+}
+
+static void fir_vector_store(real32 *pointer, const t_fir_vector &value) {
+	_mm512_storeu_ps(pointer, value);
+}
+
+static t_fir_vector fir_vector_add(const t_fir_vector &lhs, const t_fir_vector &rhs) {
+	return _mm512_add_ps(lhs, rhs);
+}
+
+static t_fir_vector fir_vector_subtract(const t_fir_vector &lhs, const t_fir_vector &rhs) {
+	return _mm512_sub_ps(lhs, rhs);
+}
+
+static t_fir_vector fir_vector_multiply(const t_fir_vector &lhs, const t_fir_vector &rhs) {
+	return _mm512_mul_ps(lhs, rhs);
+}
+
+static real32 fir_vector_sum_elements(const t_fir_vector &value) {
+	return _mm512_reduce_add_ps(value);
+}
+
+#include "engine/task_functions/filter/fir_kernels.inl"
+
+const s_fir_kernels *get_fir_kernels_avx512() {
+	return &k_fir_kernels;
+}
+
+#else // IS_TRUE(SIMD_IMPLEMENTATION_AVX512F_ENABLED)
+
+const s_fir_kernels *get_fir_kernels_avx512() {
+	return nullptr;
+}
+
+#endif // IS_TRUE(SIMD_IMPLEMENTATION_AVX512F_ENABLED)
@@ -131,3 +131,131 @@ void c_reentrant_iir_sos::process_first_order(
 	// Store off the updated state
 	state = local_state;
 }
+
+void c_reentrant_iir_sos::process_voices(
+	c_wrapped_array<c_reentrant_iir_sos> filters,
+	c_wrapped_array<s_iir_sos_state *const> states,
+	c_wrapped_array<const c_real_buffer *const> inputs,
+	c_wrapped_array<real32 *const> outputs,
+	size_t sample_count) {
+	wl_assert(filters.get_count() > 0);
+	if (filters[0].m_buffer_state.b2) {
+		process_voices_internal<false>(filters, states, inputs, outputs, sample_count);
+	} else {
+		process_voices_internal<true>(filters, states, inputs, outputs, sample_count);
+	}
+}
+
+template<bool k_first_order>
+void c_reentrant_iir_sos::process_voices_internal(
+	c_wrapped_array<c_reentrant_iir_sos> filters,
+	c_wrapped_array<s_iir_sos_state *const> states,
+	c_wrapped_array<const c_real_buffer *const> inputs,
+	c_wrapped_array<real32 *const> outputs,
+	size_t sample_count) {
+	static constexpr real32 k_zero = 0.0f;
+
+	size_t voice_count = filters.get_count();
+	wl_assert(voice_count > 0 && voice_count <= k_max_voices);
+	wl_assert(states.get_count() == voice_count);
+	wl_assert(inputs.get_count() == voice_count);
+	wl_assert(outputs.get_count() == voice_count);
+
+	// Each array is indexed by lane. Unused lanes read constant zeros and write to a dummy output so that every loop
+	// over lanes has a fixed trip count.
+	real32 unused_output;
+	s_static_array<s_buffer_state, k_max_voices> buffer_states;
+	s_static_array<const real32 *, k_max_voices> input_pointers;
+	s_static_array<uint8, k_max_voices> input_increments;
+	s_static_array<real32 *, k_max_voices> output_pointers;
+	s_static_array<uint8, k_max_voices> output_increments;
+	s_static_array<real64, k_max_voices> s1;
+	s_static_array<real64, k_max_voices> s2;
+	for (size_t lane = 0; lane < k_max_voices; lane++) {
+		if (lane < voice_count) {
+			const c_reentrant_iir_sos &filter = filters[lane];
+			wl_assert((filter.m_buffer_state.b2 == nullptr) == k_first_order);
+			wl_assert((filter.m_buffer_state.a2 == nullptr) == k_first_order);
+			buffer_states[lane] = filter.m_buffer_state;
+			input_pointers[lane] = inputs[lane]->get_data();
+			input_increments[lane] = 1 - static_cast<uint8>(inputs[lane]->is_constant());
+			output_pointers[lane] = outputs[lane];
+			output_increments[lane] = 1;
+			s1[lane] = states[lane]->s1;
+			s2[lane] = states[lane]->s2;
+		} else {
+			s_buffer_state &buffer_state = buffer_states[lane];
+			buffer_state.b0 = &k_zero;
+			buffer_state.b1 = &k_zero;
+			buffer_state.b2 = &k_zero;
+			buffer_state.a1 = &k_zero;
+			buffer_state.a2 = &k_zero;
+			buffer_state.b0_increment = 0;
+			buffer_state.b1_increment = 0;
+			buffer_state.b2_increment = 0;
+			buffer_state.a1_increment = 0;
+			buffer_state.a2_increment = 0;
+			buffer_state.all_constant = true;
+			input_pointers[lane] = &k_zero;
+			input_increments[lane] = 0;
+			output_pointers[lane] = &unused_output;
+			output_increments[lane] = 0;
+			s1[lane] = 0.0;
+			s2[lane] = 0.0;
+		}
+	}
+
+	for (size_t sample_index = 0; sample_index < sample_count; sample_index++) {
+		// Gather this sample's input and coefficients for each lane, then step every lane's recursion together. The
+		// arithmetic is identical to s_iir_sos_state::process_single_sample() and process_first_order_single_sample().
+		s_static_array<real64, k_max_voices> x;
+		s_static_array<real64, k_max_voices> b0;
+		s_static_array<real64, k_max_voices> b1;
+		s_static_array<real64, k_max_voices> b2;
+		s_static_array<real64, k_max_voices> a1;
+		s_static_array<real64, k_max_voices> a2;
+		for (size_t lane = 0; lane < k_max_voices; lane++) {
+			const s_buffer_state &buffer_state = buffer_states[lane];
+			x[lane] = static_cast<real64>(*input_pointers[lane]);
+			b0[lane] = static_cast<real64>(*buffer_state.b0);
+			b1[lane] = static_cast<real64>(*buffer_state.b1);
+			a1[lane] = static_cast<real64>(*buffer_state.a1);
+			if constexpr (!k_first_order) {
+				b2[lane] = static_cast<real64>(*buffer_state.b2);
+				a2[lane] = static_cast<real64>(*buffer_state.a2);
+			}
+		}
+
+		s_static_array<real64, k_max_voices> y;
+		for (size_t lane = 0; lane < k_max_voices; lane++) {
+			y[lane] = b0[lane] * x[lane] + s1[lane];
+			if constexpr (k_first_order) {
+				s1[lane] = b1[lane] * x[lane] - a1[lane] * y[lane];
+			} else {
+				s1[lane] = b1[lane] * x[lane] - a1[lane] * y[lane] + s2[lane];
+				s2[lane] = b2[lane] * x[lane] - a2[lane] * y[lane];
+			}
+		}
+
+		for (size_t lane = 0; lane < k_max_voices; lane++) {
+			s_buffer_state &buffer_state = buffer_states[lane];
+			*output_pointers[lane] = static_cast<real32>(y[lane]);
+			input_pointers[lane] += input_increments[lane];
+			output_pointers[lane] += output_increments[lane];
+			buffer_state.b0 += buffer_state.b0_increment;
+			buffer_state.b1 += buffer_state.b1_increment;
+			buffer_state.a1 += buffer_state.a1_increment;
+			if constexpr (!k_first_order) {
+				buffer_state.b2 += buffer_state.b2_increment;
+				buffer_state.a2 += buffer_state.a2_increment;
+			}
+		}
+	}
+
+	// Store off the updated filters and states
+	for (size_t lane = 0; lane < voice_count; lane++) {
+		filters[lane].m_buffer_state = buffer_states[lane];
+		states[lane]->s1 = s1[lane];
+		states[lane]->s2 = s2[lane];
+	}
+}
@@ -42,6 +42,9 @@ struct s_iir_sos_state {
 // coefficients.
 class c_reentrant_iir_sos {
 public:
+	// Max number of voices which can be processed at once using process_voices()
+	static constexpr size_t k_max_voices = 4;
+
 	c_reentrant_iir_sos() = default;
 
 	void initialize(
@@ -58,6 +61,17 @@ public:
 	void process(s_iir_sos_state &state, const real32 *input, real32 *output, size_t sample_count);
 	void process_first_order(s_iir_sos_state &state, const real32 *input, real32 *output, size_t sample_count);
 
+	// Processes several voices in lockstep, each with its own filter, state, input, and output. The recursion within a
+	// single voice is serial, but the recursions of different voices are independent, so stepping them together keeps
+	// several samples in flight at once. Either all filters or no filters must be first-order. The results are
+	// identical to calling process() or process_first_order() for each voice.
+	static void process_voices(
+		c_wrapped_array<c_reentrant_iir_sos> filters,
+		c_wrapped_array<s_iir_sos_state *const> states,
+		c_wrapped_array<const c_real_buffer *const> inputs,
+		c_wrapped_array<real32 *const> outputs,
+		size_t sample_count);
+
 private:
 	struct s_buffer_state {
 		const real32 *b0;
@@ -73,5 +87,13 @@ private:
 		bool all_constant;
 	};
 
+	template<bool k_first_order>
+	static void process_voices_internal(
+		c_wrapped_array<c_reentrant_iir_sos> filters,
+		c_wrapped_array<s_iir_sos_state *const> states,
+		c_wrapped_array<const c_real_buffer *const> inputs,
+		c_wrapped_array<real32 *const> outputs,
+		size_t sample_count);
+
 	s_buffer_state m_buffer_state;
 };
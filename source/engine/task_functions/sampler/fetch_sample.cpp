@@ -2,10 +2,36 @@
 
 #include "engine/task_functions/sampler/fetch_sample.h"
 
+#include <algorithm>
 #include <cmath>
 
 static void split_fractional_sample_index(real64 sample_index, uint32 &int_out, real32 &fraction_out);
 static real32 interpolate_samples(const s_sample_interpolation_coefficients &coefficients, real32 fraction);
+static real32 interpolate_sample_entry(
+	const s_sample_data *sample_data,
+	e_sample_storage_format storage_format,
+	real64 sample_index);
+
+// Interpolates between frames[1] and frames[2] of a sample stored in a compact format
+static real32 interpolate_frames(const real32 *frames, real32 fraction);
+static real32 interpolate_frames(const int16 *frames, real32 fraction);
+static real32 interpolate_frames(const real32x4 &frames, real32 fraction);
+
+// Interpolates a sample entry at each of the given times, which are first scaled by the entry's base sample rate ratio.
+// Groups of k_simd_32_lanes samples are vectorized and the remaining samples are interpolated one at a time.
+static void interpolate_sample_entry_block(
+	const s_sample_data *sample_data,
+	e_sample_storage_format storage_format,
+	const real64 *sample_indices,
+	size_t count,
+	real32 *result);
+
+template<e_sample_storage_format k_storage_format>
+static size_t interpolate_sample_entry_simd(
+	const s_sample_data *sample_data,
+	const real64 *sample_indices,
+	size_t count,
+	real32 *result);
 
 // Returns the two wavetable levels to blend between for a given speed-adjusted sample rate, as well as the blend ratio.
 // If the two returned wavetable levels are the same, no blending is required.
@@ -20,12 +46,37 @@ static void choose_wavetable_level(
 
 real32 fetch_sample(const c_sample *sample, real64 sample_index) {
 	wl_assert(!sample->is_wavetable());
+	wl_assert(!sample->is_streamed());
+
+	return interpolate_sample_entry(sample->get_entry(0), sample->get_storage_format(), sample_index);
+}
+
+void fetch_samples(const c_sample *sample, const real64 *sample_indices, size_t count, real32 *result) {
+	wl_assert(!sample->is_wavetable());
+	wl_assert(!sample->is_streamed());
+
+	interpolate_sample_entry_block(sample->get_entry(0), sample->get_storage_format(), sample_indices, count, result);
+}
+
+real32 fetch_streamed_sample(
+	const c_sample *sample,
+	const c_sample_streamer *sample_streamer,
+	h_sample_stream stream_handle,
+	real64 sample_index) {
+	wl_assert(sample->is_streamed());
 
-	const s_sample_data *sample_data = sample->get_entry(0);
 	uint32 sample_index_int;
 	real32 sample_index_fraction;
 	split_fractional_sample_index(sample_index, sample_index_int, sample_index_fraction);
-	return interpolate_samples(sample_data->samples[sample_index_int], sample_index_fraction);
+
+	if (sample_index_int < sample->get_stream_start()) {
+		const s_sample_data *sample_data = sample->get_entry(0);
+		return interpolate_samples(sample_data->samples[sample_index_int], sample_index_fraction);
+	}
+
+	const s_sample_interpolation_coefficients *coefficients =
+		sample_streamer->get_stream_sample(stream_handle, sample_index_int);
+	return coefficients ? interpolate_samples(*coefficients, sample_index_fraction) : 0.0f;
 }
 
 real32 fetch_wavetable_sample(
@@ -72,6 +123,55 @@ real32 fetch_wavetable_sample(
 	}
 }
 
+void fetch_wavetable_samples(
+	const c_sample *sample,
+	real32 stream_sample_rate,
+	real32 base_sample_rate,
+	real32 speed,
+	const real64 *sample_indices,
+	size_t count,
+	real32 *result) {
+	wl_assert(sample->get_storage_format() == e_sample_storage_format::k_interpolation_coefficients);
+
+	// The speed is constant so the same wavetable levels are used for every sample
+	uint32 entry_index_a;
+	uint32 entry_index_b;
+	real32 blend_ratio;
+	choose_wavetable_level(
+		stream_sample_rate,
+		base_sample_rate,
+		speed,
+		sample->get_entry_count(),
+		entry_index_a,
+		entry_index_b,
+		blend_ratio);
+
+	interpolate_sample_entry_block(
+		sample->get_entry(entry_index_a),
+		e_sample_storage_format::k_interpolation_coefficients,
+		sample_indices,
+		count,
+		result);
+
+	if (blend_ratio != 0.0f) {
+		ALIGNAS_SIMD real32 samples_b[k_fetch_sample_block_size];
+		for (size_t block_start = 0; block_start < count; block_start += k_fetch_sample_block_size) {
+			size_t block_count = std::min(count - block_start, k_fetch_sample_block_size);
+			interpolate_sample_entry_block(
+				sample->get_entry(entry_index_b),
+				e_sample_storage_format::k_interpolation_coefficients,
+				sample_indices + block_start,
+				block_count,
+				samples_b);
+
+			real32 *block_result = result + block_start;
+			for (size_t index = 0; index < block_count; index++) {
+				block_result[index] += (samples_b[index] - block_result[index]) * blend_ratio;
+			}
+		}
+	}
+}
+
 static void split_fractional_sample_index(real64 sample_index, uint32 &int_out, real32 &fraction_out) {
 	// Not sure how fast this is. Maybe we could do better by utilizing SSE?
 	int_out = static_cast<uint32>(sample_index);
@@ -98,12 +198,228 @@ static real32 interpolate_samples(const s_sample_interpolation_coefficients &coe
 #error Not yet implemented // $TODO
 #else // SIMD_IMPLEMENTATION
 	return coefficients.coefficients[0]
-		+ (fraction * coefficients.coefficients[1]
-			+ (fraction * coefficients.coefficients[2]
+		+ fraction * (coefficients.coefficients[1]
+			+ fraction * (coefficients.coefficients[2]
 				+ fraction * coefficients.coefficients[3]));
 #endif // SIMD_IMPLEMENTATION
 }
 
+static real32 interpolate_sample_entry(
+	const s_sample_data *sample_data,
+	e_sample_storage_format storage_format,
+	real64 sample_index) {
+	uint32 sample_index_int;
+	real32 sample_index_fraction;
+	split_fractional_sample_index(sample_index, sample_index_int, sample_index_fraction);
+
+	switch (storage_format) {
+	case e_sample_storage_format::k_interpolation_coefficients:
+		return interpolate_samples(sample_data->samples[sample_index_int], sample_index_fraction);
+
+	case e_sample_storage_format::k_real32:
+		return interpolate_frames(&sample_data->real32_frames[sample_index_int], sample_index_fraction);
+
+	case e_sample_storage_format::k_int16:
+		return interpolate_frames(&sample_data->int16_frames[sample_index_int], sample_index_fraction);
+
+	default:
+		wl_unreachable();
+		return 0.0f;
+	}
+}
+
+static real32 interpolate_frames(const real32 *frames, real32 fraction) {
+	real32x4 frames_vector;
+	frames_vector.load_unaligned(frames);
+	return interpolate_frames(frames_vector, fraction);
+}
+
+static real32 interpolate_frames(const int16 *frames, real32 fraction) {
+	real32x4 frames_vector = int32x4(frames[0], frames[1], frames[2], frames[3]);
+	frames_vector = (frames_vector + real32x4(k_sample_int16_frame_offset)) * real32x4(k_sample_int16_frame_scale);
+	return interpolate_frames(frames_vector, fraction);
+}
+
+static real32 interpolate_frames(const real32x4 &frames, real32 fraction) {
+	// Rather than computing the cubic polynomial's coefficients from the frames, we compute the weight applied to each
+	// frame, which is a cubic in x. These weights form a Catmull-Rom spline, which passes through frames[1] at x = 0
+	// and frames[2] at x = 1 and matches the slopes of the neighboring segments at both ends.
+	real32x4 x(fraction);
+	real32x4 weights = real32x4(-0.5f, 1.5f, -1.5f, 0.5f);
+	weights = weights * x + real32x4(1.0f, -2.5f, 2.0f, -0.5f);
+	weights = weights * x + real32x4(-0.5f, 0.0f, 0.5f, 0.0f);
+	weights = weights * x + real32x4(0.0f, 1.0f, 0.0f, 0.0f);
+	return (weights * frames).sum_elements().first_element();
+}
+
+static void interpolate_sample_entry_block(
+	const s_sample_data *sample_data,
+	e_sample_storage_format storage_format,
+	const real64 *sample_indices,
+	size_t count,
+	real32 *result) {
+	size_t simd_count;
+	switch (storage_format) {
+	case e_sample_storage_format::k_interpolation_coefficients:
+		simd_count = interpolate_sample_entry_simd<e_sample_storage_format::k_interpolation_coefficients>(
+			sample_data,
+			sample_indices,
+			count,
+			result);
+		break;
+
+	case e_sample_storage_format::k_real32:
+		simd_count = interpolate_sample_entry_simd<e_sample_storage_format::k_real32>(
+			sample_data,
+			sample_indices,
+			count,
+			result);
+		break;
+
+	case e_sample_storage_format::k_int16:
+		simd_count = interpolate_sample_entry_simd<e_sample_storage_format::k_int16>(
+			sample_data,
+			sample_indices,
+			count,
+			result);
+		break;
+
+	default:
+		wl_unreachable();
+		simd_count = 0;
+	}
+
+	// Fall back to scalar interpolation for the samples that don't fill up a SIMD block
+	real64 base_sample_rate_ratio = sample_data->base_sample_rate_ratio;
+	for (size_t index = simd_count; index < count; index++) {
+		result[index] = interpolate_sample_entry(
+			sample_data,
+			storage_format,
+			sample_indices[index] * base_sample_rate_ratio);
+	}
+}
+
+#if IS_TRUE(SIMD_IMPLEMENTATION_AVX_ENABLED)
+// Loads the 4 values used to interpolate at the given sample index: either polynomial coefficients or frames
+template<e_sample_storage_format k_storage_format>
+static __m128 load_interpolation_values(const s_sample_data *sample_data, uint32 sample_index) {
+	if constexpr (k_storage_format == e_sample_storage_format::k_interpolation_coefficients) {
+		return _mm_load_ps(sample_data->samples[sample_index].coefficients.get_elements());
+	} else if constexpr (k_storage_format == e_sample_storage_format::k_real32) {
+		return _mm_loadu_ps(&sample_data->real32_frames[sample_index]);
+	} else {
+		STATIC_ASSERT(k_storage_format == e_sample_storage_format::k_int16);
+		__m128i frames = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&sample_data->int16_frames[sample_index]));
+		return _mm_cvtepi32_ps(_mm_cvtepi16_epi32(frames));
+	}
+}
+#endif // IS_TRUE(SIMD_IMPLEMENTATION_AVX_ENABLED)
+
+// Gathers the 4 interpolation values for each lane's sample index. The values for each sample are contiguous in memory,
+// so rather than using gather instructions, each sample's values are loaded at once and then transposed so that
+// values_out[i] holds the ith value of every lane.
+template<e_sample_storage_format k_storage_format>
+static void gather_interpolation_values(
+	const s_sample_data *sample_data,
+	const uint32 *sample_indices,
+	real32xN (&values_out)[4]) {
+#if IS_TRUE(SIMD_256_ENABLED)
+	// Lanes i and i + 4 share a register so that the transpose can operate within each 128-bit half
+	__m256 rows[4];
+	for (size_t row = 0; row < 4; row++) {
+		rows[row] = _mm256_insertf128_ps(
+			_mm256_castps128_ps256(load_interpolation_values<k_storage_format>(sample_data, sample_indices[row])),
+			load_interpolation_values<k_storage_format>(sample_data, sample_indices[row + 4]),
+			1);
+	}
+
+	__m256 low_01 = _mm256_unpacklo_ps(rows[0], rows[1]);
+	__m256 high_01 = _mm256_unpackhi_ps(rows[0], rows[1]);
+	__m256 low_23 = _mm256_unpacklo_ps(rows[2], rows[3]);
+	__m256 high_23 = _mm256_unpackhi_ps(rows[2], rows[3]);
+	values_out[0] = _mm256_shuffle_ps(low_01, low_23, _MM_SHUFFLE(1, 0, 1, 0));
+	values_out[1] = _mm256_shuffle_ps(low_01, low_23, _MM_SHUFFLE(3, 2, 3, 2));
+	values_out[2] = _mm256_shuffle_ps(high_01, high_23, _MM_SHUFFLE(1, 0, 1, 0));
+	values_out[3] = _mm256_shuffle_ps(high_01, high_23, _MM_SHUFFLE(3, 2, 3, 2));
+#elif IS_TRUE(SIMD_IMPLEMENTATION_AVX_ENABLED)
+	__m128 rows[4];
+	for (size_t row = 0; row < 4; row++) {
+		rows[row] = load_interpolation_values<k_storage_format>(sample_data, sample_indices[row]);
+	}
+
+	_MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+	for (size_t row = 0; row < 4; row++) {
+		values_out[row] = rows[row];
+	}
+#else // SIMD_IMPLEMENTATION
+	ALIGNAS_SIMD real32 value_arrays[4][k_simd_32_lanes];
+	for (size_t lane = 0; lane < k_simd_32_lanes; lane++) {
+		for (size_t value_index = 0; value_index < 4; value_index++) {
+			uint32 sample_index = sample_indices[lane];
+			if constexpr (k_storage_format == e_sample_storage_format::k_interpolation_coefficients) {
+				value_arrays[value_index][lane] = sample_data->samples[sample_index].coefficients[value_index];
+			} else if constexpr (k_storage_format == e_sample_storage_format::k_real32) {
+				value_arrays[value_index][lane] = sample_data->real32_frames[sample_index + value_index];
+			} else {
+				value_arrays[value_index][lane] =
+					static_cast<real32>(sample_data->int16_frames[sample_index + value_index]);
+			}
+		}
+	}
+
+	for (size_t value_index = 0; value_index < 4; value_index++) {
+		values_out[value_index] = real32xN(value_arrays[value_index]);
+	}
+#endif // SIMD_IMPLEMENTATION
+}
+
+template<e_sample_storage_format k_storage_format>
+static size_t interpolate_sample_entry_simd(
+	const s_sample_data *sample_data,
+	const real64 *sample_indices,
+	size_t count,
+	real32 *result) {
+	real64 base_sample_rate_ratio = sample_data->base_sample_rate_ratio;
+	size_t simd_count = align_size_down(count, k_simd_32_lanes);
+	for (size_t block_start = 0; block_start < simd_count; block_start += k_simd_32_lanes) {
+		// Splitting is done in real64 so it matches the scalar path exactly
+		uint32 index_array[k_simd_32_lanes];
+		ALIGNAS_SIMD real32 fraction_array[k_simd_32_lanes];
+		for (size_t lane = 0; lane < k_simd_32_lanes; lane++) {
+			split_fractional_sample_index(
+				sample_indices[block_start + lane] * base_sample_rate_ratio,
+				index_array[lane],
+				fraction_array[lane]);
+		}
+
+		real32xN values[4];
+		gather_interpolation_values<k_storage_format>(sample_data, index_array, values);
+
+		real32xN x(fraction_array);
+		real32xN value;
+		if constexpr (k_storage_format == e_sample_storage_format::k_interpolation_coefficients) {
+			value = values[0] + x * (values[1] + x * (values[2] + x * values[3]));
+		} else {
+			if constexpr (k_storage_format == e_sample_storage_format::k_int16) {
+				for (real32xN &frame : values) {
+					frame = (frame + real32xN(k_sample_int16_frame_offset)) * real32xN(k_sample_int16_frame_scale);
+				}
+			}
+
+			// These are the same Catmull-Rom weights used by interpolate_frames(), one lane per sample
+			real32xN weight_0 = ((real32xN(-0.5f) * x + real32xN(1.0f)) * x + real32xN(-0.5f)) * x;
+			real32xN weight_1 = (real32xN(1.5f) * x + real32xN(-2.5f)) * x * x + real32xN(1.0f);
+			real32xN weight_2 = ((real32xN(-1.5f) * x + real32xN(2.0f)) * x + real32xN(0.5f)) * x;
+			real32xN weight_3 = (real32xN(0.5f) * x + real32xN(-0.5f)) * x * x;
+			value = weight_0 * values[0] + weight_1 * values[1] + weight_2 * values[2] + weight_3 * values[3];
+		}
+
+		value.store_unaligned(result + block_start);
+	}
+
+	return simd_count;
+}
+
 static void choose_wavetable_level(
 	real32 stream_sample_rate,
 	real32 base_sample_rate,
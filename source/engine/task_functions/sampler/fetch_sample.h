@@ -3,10 +3,26 @@
 #include "common/common.h"
 
 #include "engine/task_functions/sampler/sample.h"
+#include "engine/task_functions/sampler/sample_streamer.h"
+
+// Samplers fetch blocks of at most this many samples at a time
+static constexpr size_t k_fetch_sample_block_size = 64;
 
 // Calculates the interpolated sample at the given time. The input sample should not be a mipmap.
 real32 fetch_sample(const c_sample *sample, real64 sample_index);
 
+// Calculates the interpolated samples at each of the given times. This produces the same results as calling
+// fetch_sample() for each time but interpolates several samples at once using SIMD.
+void fetch_samples(const c_sample *sample, const real64 *sample_indices, size_t count, real32 *result);
+
+// Calculates the interpolated sample at the given time for a streamed sample. Samples past the preloaded region are
+// read from the stream, and if the stream has not been filled up to the given time, 0 is returned.
+real32 fetch_streamed_sample(
+	const c_sample *sample,
+	const c_sample_streamer *sample_streamer,
+	h_sample_stream stream_handle,
+	real64 sample_index);
+
 // Calculates the interpolated bandlimited sample at the given time using the wavetable
 real32 fetch_wavetable_sample(
 	const c_sample *sample,
@@ -14,3 +30,14 @@ real32 fetch_wavetable_sample(
 	real32 base_sample_rate,
 	real32 speed,
 	real64 sample_index);
+
+// Calculates the interpolated bandlimited samples at each of the given times using the wavetable. The speed must be
+// constant across all samples because it determines which wavetable levels are used.
+void fetch_wavetable_samples(
+	const c_sample *sample,
+	real32 stream_sample_rate,
+	real32 base_sample_rate,
+	real32 speed,
+	const real64 *sample_indices,
+	size_t count,
+	real32 *result);
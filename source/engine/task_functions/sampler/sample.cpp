@@ -8,6 +8,7 @@
 #include "engine/task_functions/sampler/sample.h"
 #include "engine/task_functions/sampler/sample_loader.h"
 
+#include <cmath>
 #include <iostream>
 
 static constexpr const char *k_wavetable_cache_folder = "cache";
@@ -23,6 +24,13 @@ static constexpr real32 k_inverse_interpolation_upsample_factor =
 // Impose a minimum sample count to keep the interpolation error low
 static constexpr uint32 k_min_wavetable_sample_count = 16;
 
+// Non-looping samples longer than this are streamed from disk when streaming is enabled
+static constexpr uint32 k_min_streamed_sample_duration_ms = 2000;
+
+// The beginning of each streamed sample is kept in memory so that voices can start playing immediately. This must be
+// long enough to cover the time it takes the sample streamer to start filling a voice's stream.
+static constexpr uint32 k_streamed_sample_preload_duration_ms = 250;
+
 // To interpolate samples, we perform high quality upsampling by a factor of N (using the upsampler for loaded waves and
 // computed exactly for wavetables) and then fit those points to a cubic polynomial with equality constraints on the
 // endpoints. The worst-case error I have seen between the upsampled points and the fit curve using this method is ~1e-4
@@ -47,6 +55,19 @@ private:
 	s_static_array<real32, k_matrix_rows *k_matrix_columns> m_matrix;
 };
 
+// Calculates interpolation coefficients from padded input samples. The first coefficient is calculated from
+// padded_samples[0, required_history_samples + 1] and padded_samples must extend required_history_samples + 1 samples
+// past the last coefficient.
+static void calculate_interpolation_coefficients(
+	const c_resampler &resampler,
+	uint32 required_history_samples,
+	c_interpolation_coefficient_solver &coefficient_solver,
+	c_wrapped_array<const real32> padded_samples,
+	c_wrapped_array<s_sample_interpolation_coefficients> coefficients_out);
+
+// Converts a sample to the int16 frame format. This is lossless for samples loaded from 16-bit files.
+static int16 real32_to_int16_frame(real32 value);
+
 template<uint32 k_n>
 void solve_system_using_lu_decomposition(
 	c_wrapped_array<const real32> matrix,
@@ -78,8 +99,28 @@ bool c_sample::load_file(
 	const char *filename,
 	e_sample_loop_mode loop_mode,
 	bool phase_shift_enabled,
+	e_sample_storage_format storage_format,
+	bool streaming_enabled,
 	std::vector<c_sample *> &channel_samples_out) {
 	wl_assert(channel_samples_out.empty());
+	wl_assert(valid_enum_index(storage_format));
+
+	if (streaming_enabled
+		&& loop_mode == e_sample_loop_mode::k_none
+		&& storage_format == e_sample_storage_format::k_interpolation_coefficients) {
+		// Only read the header to determine whether this sample is long enough to stream
+		c_sample_file_reader reader;
+		if (!reader.open(filename)) {
+			return false;
+		}
+
+		uint64 min_streamed_frame_count =
+			static_cast<uint64>(reader.get_sample_rate()) * k_min_streamed_sample_duration_ms / 1000;
+		if (reader.get_frame_count() > min_streamed_frame_count) {
+			return load_streamed_file(filename, reader, channel_samples_out);
+		}
+	}
+
 	s_loaded_sample loaded_sample;
 	if (!load_sample(filename, loaded_sample)) {
 		return false;
@@ -165,6 +206,8 @@ bool c_sample::load_file(
 		sample->m_sample_rate = loaded_sample.sample_rate;
 		sample->m_looping = loop_mode != e_sample_loop_mode::k_none;
 		sample->m_phase_shift_enabled = phase_shift_enabled;
+		sample->m_storage_format = storage_format;
+		sample->m_sample_count = content_samples;
 
 		if (loop_mode == e_sample_loop_mode::k_none) {
 			// Simply copy the non-looping content - beginning and end don't need to be re-zeroed
@@ -212,33 +255,117 @@ bool c_sample::load_file(
 			sample->m_loop_end = sample->m_loop_start + loop_samples;
 		}
 
-		sample->m_samples.resize(content_samples);
-
-		// Use the resampler to upsample the signal
-		c_wrapped_array<const real32> resampler_input(padded_samples);
-		for (uint32 sample_index = 0; sample_index < content_samples; sample_index++) {
-			s_static_array<real32, k_interpolation_upsample_factor + 1> upsampled_samples;
-			for (uint32 upsample_index = 0; upsample_index <= k_interpolation_upsample_factor; upsample_index++) {
-				uint32 upsample_index_fraction = upsample_index & (k_interpolation_upsample_factor - 1);
-				uint32 sample_index_offset = upsample_index / k_interpolation_upsample_factor;
-				real32 fraction =
-					static_cast<real32>(upsample_index_fraction) * k_inverse_interpolation_upsample_factor;
-				upsampled_samples[upsample_index] = resampler.resample(
-					resampler_input,
-					sample_index + sample_index_offset + required_history_samples,
-					fraction);
+		sample->m_entries.push_back(s_sample_data());
+		s_sample_data &entry = sample->m_entries.back();
+		entry.base_sample_rate_ratio = 1.0f;
+
+		// Sample i lives at padded_samples[initial_padding + i]. For raw frames, we keep one sample of history before
+		// sample 0 and two samples after the last sample (the final padding plus the extra sample cover these).
+		wl_assert(initial_padding >= 1 && final_padding >= 1);
+		const real32 *raw_frames = &padded_samples[initial_padding - 1];
+		size_t raw_frame_count = content_samples + 3;
+
+		switch (storage_format) {
+		case e_sample_storage_format::k_interpolation_coefficients:
+			sample->m_samples.resize(content_samples);
+
+			// Use the resampler to upsample the signal
+			calculate_interpolation_coefficients(
+				resampler,
+				required_history_samples,
+				coefficient_solver,
+				c_wrapped_array<const real32>(padded_samples),
+				c_wrapped_array<s_sample_interpolation_coefficients>(sample->m_samples));
+
+			entry.samples = c_wrapped_array<const s_sample_interpolation_coefficients>(sample->m_samples);
+			break;
+
+		case e_sample_storage_format::k_real32:
+			sample->m_real32_frames.assign(raw_frames, raw_frames + raw_frame_count);
+			entry.real32_frames = c_wrapped_array<const real32>(sample->m_real32_frames);
+			break;
+
+		case e_sample_storage_format::k_int16:
+			sample->m_int16_frames.resize(raw_frame_count);
+			for (size_t index = 0; index < raw_frame_count; index++) {
+				sample->m_int16_frames[index] = real32_to_int16_frame(raw_frames[index]);
 			}
 
-			// Calculate the coefficients
-			coefficient_solver.solve(upsampled_samples.get_elements(), 1, sample->m_samples[sample_index]);
+			entry.int16_frames = c_wrapped_array<const int16>(sample->m_int16_frames);
+			break;
+
+		default:
+			wl_unreachable();
 		}
 
+		channel_samples_out.push_back(sample);
+	}
+
+	return true;
+}
+
+bool c_sample::load_streamed_file(
+	const char *filename,
+	c_sample_file_reader &reader,
+	std::vector<c_sample *> &channel_samples_out) {
+	// Streamed samples are always non-looping, so the padded signal is simply the file's samples surrounded by zeros.
+	// This means that any range of interpolation coefficients can be computed by reading the corresponding range of
+	// the file, offset by the initial padding. See load_file() for details on the padding.
+	const s_resampler_parameters &resampler_parameters =
+		get_resampler_parameters(e_resampler_filter::k_upsample_high_quality);
+	c_wrapped_array<const real32> resampler_phases =
+		get_resampler_phases(e_resampler_filter::k_upsample_high_quality);
+	c_resampler resampler(resampler_parameters, resampler_phases);
+	uint32 required_history_samples = c_resampler::get_required_history_samples(resampler_parameters);
+	uint32 initial_padding = required_history_samples - resampler_parameters.latency;
+
+	uint32 frame_count = reader.get_frame_count();
+	uint64 preload_sample_count =
+		static_cast<uint64>(reader.get_sample_rate()) * k_streamed_sample_preload_duration_ms / 1000;
+	uint32 stream_start = static_cast<uint32>(std::min<uint64>(preload_sample_count, frame_count));
+
+	// Only read the samples required to compute the preloaded coefficients
+	uint32 padded_sample_count = stream_start + required_history_samples + 1;
+	std::vector<real32> padded_samples(padded_sample_count * reader.get_channel_count());
+	if (!reader.read_frames(
+		-static_cast<int64>(initial_padding),
+		padded_sample_count,
+		c_wrapped_array<real32>(padded_samples.data(), padded_samples.size()))) {
+		return false;
+	}
+
+	c_interpolation_coefficient_solver coefficient_solver;
+
+	channel_samples_out.reserve(reader.get_channel_count());
+	for (uint32 channel_index = 0; channel_index < reader.get_channel_count(); channel_index++) {
+		c_sample *sample = new c_sample();
+		sample->m_type = e_type::k_single_sample;
+		sample->m_sample_rate = reader.get_sample_rate();
+		sample->m_looping = false;
+		sample->m_loop_start = 0;
+		sample->m_loop_end = frame_count;
+		sample->m_phase_shift_enabled = false;
+
+		sample->m_streamed = true;
+		sample->m_stream_start = stream_start;
+		sample->m_sample_count = frame_count;
+		sample->m_stream_filename = filename;
+		sample->m_stream_frame_count = frame_count;
+		sample->m_stream_channel = channel_index;
+
+		sample->m_samples.resize(stream_start);
+		calculate_interpolation_coefficients(
+			resampler,
+			required_history_samples,
+			coefficient_solver,
+			c_wrapped_array<const real32>(&padded_samples[channel_index * padded_sample_count], padded_sample_count),
+			c_wrapped_array<s_sample_interpolation_coefficients>(sample->m_samples));
+
 		sample->m_entries.push_back(s_sample_data());
 		s_sample_data &entry = sample->m_entries.back();
 		entry.base_sample_rate_ratio = 1.0f;
 		entry.samples = c_wrapped_array<const s_sample_interpolation_coefficients>(sample->m_samples);
 
-
 		channel_samples_out.push_back(sample);
 	}
 
@@ -438,6 +565,105 @@ const s_sample_data *c_sample::get_entry(uint32 index) const {
 	return &m_entries[index];
 }
 
+e_sample_storage_format c_sample::get_storage_format() const {
+	return m_storage_format;
+}
+
+uint32 c_sample::get_sample_count() const {
+	return is_wavetable() ? cast_integer_verify<uint32>(m_entries[0].samples.get_count()) : m_sample_count;
+}
+
+bool c_sample::is_streamed() const {
+	return m_streamed;
+}
+
+uint32 c_sample::get_stream_start() const {
+	return m_stream_start;
+}
+
+bool c_sample::open_stream(c_sample_file_reader &reader) const {
+	wl_assert(m_streamed);
+	if (!reader.open(m_stream_filename.c_str())) {
+		return false;
+	}
+
+	if (reader.get_frame_count() != m_stream_frame_count || m_stream_channel >= reader.get_channel_count()) {
+		// The file was modified after it was loaded. It will be reloaded when the instrument is next rebuilt.
+		reader.close();
+		return false;
+	}
+
+	return true;
+}
+
+bool c_sample::read_streamed_samples(
+	c_sample_file_reader &reader,
+	uint32 first_sample_index,
+	c_wrapped_array<s_sample_interpolation_coefficients> samples_out,
+	std::vector<real32> &scratch) const {
+	wl_assert(m_streamed);
+	wl_assert(reader.is_open());
+	wl_assert(first_sample_index >= m_stream_start);
+	wl_assert(first_sample_index + samples_out.get_count() <= m_sample_count);
+
+	const s_resampler_parameters &resampler_parameters =
+		get_resampler_parameters(e_resampler_filter::k_upsample_high_quality);
+	c_wrapped_array<const real32> resampler_phases =
+		get_resampler_phases(e_resampler_filter::k_upsample_high_quality);
+	c_resampler resampler(resampler_parameters, resampler_phases);
+	uint32 required_history_samples = c_resampler::get_required_history_samples(resampler_parameters);
+	uint32 initial_padding = required_history_samples - resampler_parameters.latency;
+
+	// Coefficient i is computed from padded samples [i, i + required_history_samples + 1], and padded sample i is
+	// frame i - initial_padding of the file
+	uint32 padded_sample_count = cast_integer_verify<uint32>(samples_out.get_count()) + required_history_samples + 1;
+	scratch.resize(padded_sample_count * reader.get_channel_count());
+	if (!reader.read_frames(
+		static_cast<int64>(first_sample_index) - static_cast<int64>(initial_padding),
+		padded_sample_count,
+		c_wrapped_array<real32>(scratch.data(), scratch.size()))) {
+		return false;
+	}
+
+	c_interpolation_coefficient_solver coefficient_solver;
+	calculate_interpolation_coefficients(
+		resampler,
+		required_history_samples,
+		coefficient_solver,
+		c_wrapped_array<const real32>(&scratch[m_stream_channel * padded_sample_count], padded_sample_count),
+		samples_out);
+	return true;
+}
+
+static void calculate_interpolation_coefficients(
+	const c_resampler &resampler,
+	uint32 required_history_samples,
+	c_interpolation_coefficient_solver &coefficient_solver,
+	c_wrapped_array<const real32> padded_samples,
+	c_wrapped_array<s_sample_interpolation_coefficients> coefficients_out) {
+	wl_assert(padded_samples.get_count() >= coefficients_out.get_count() + required_history_samples + 1);
+	for (size_t sample_index = 0; sample_index < coefficients_out.get_count(); sample_index++) {
+		s_static_array<real32, k_interpolation_upsample_factor + 1> upsampled_samples;
+		for (uint32 upsample_index = 0; upsample_index <= k_interpolation_upsample_factor; upsample_index++) {
+			uint32 upsample_index_fraction = upsample_index & (k_interpolation_upsample_factor - 1);
+			uint32 sample_index_offset = upsample_index / k_interpolation_upsample_factor;
+			real32 fraction = static_cast<real32>(upsample_index_fraction) * k_inverse_interpolation_upsample_factor;
+			upsampled_samples[upsample_index] = resampler.resample(
+				padded_samples,
+				sample_index + sample_index_offset + required_history_samples,
+				fraction);
+		}
+
+		// Calculate the coefficients
+		coefficient_solver.solve(upsampled_samples.get_elements(), 1, coefficients_out[sample_index]);
+	}
+}
+
+static int16 real32_to_int16_frame(real32 value) {
+	real32 integer_value = std::round(value * (1.0f / k_sample_int16_frame_scale) - k_sample_int16_frame_offset);
+	return static_cast<int16>(clamp(integer_value, -32768.0f, 32767.0f));
+}
+
 c_interpolation_coefficient_solver::c_interpolation_coefficient_solver() {
 	// We want to approximate n samples using a cubic polynomial of the form p0 + p1*x + p2*x^2 + p3*x^3 for x in
 	// [0, 1]. The n samples {(sx_0, sy_0), ..., (sx_{n-1}, sy_{n-1})} are linearly spread across the unit interval:
@@ -459,7 +685,9 @@ c_interpolation_coefficient_solver::c_interpolation_coefficient_solver() {
 	// add an equality constraint for sample n-1. Our vector b is then [ sy_1 sy_2 ... sy_{n-2} ]. We have only one
 	// constraint, sample n-1, so our matrix C is simply [ 1 1 1 ] and d is sy_{n-1}.
 
-	// Construct our matrix once up-front and reuse it each time solve() is called
+	// Construct our matrix once up-front and reuse it each time solve() is called. The lower right block is 0.
+	zero_type(&m_matrix);
+
 	// Start by constructing A
 	for (uint32 row = 0; row < k_sample_count - 2; row++) {
 		real32 sample_x = static_cast<real32>(row + 1) / static_cast<real32>(k_sample_count - 1);
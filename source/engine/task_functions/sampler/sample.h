@@ -4,8 +4,11 @@
 #include "common/math/simd.h"
 #include "common/utility/aligned_allocator.h"
 
+#include <string>
 #include <vector>
 
+class c_sample_file_reader;
+
 enum class e_sample_loop_mode {
 	k_none,
 	k_loop,
@@ -14,6 +17,24 @@ enum class e_sample_loop_mode {
 	k_count
 };
 
+// Determines how a sample's frames are stored in memory
+enum class e_sample_storage_format {
+	// Cubic interpolation coefficients computed from a high quality upsampled version of the signal. This gives the
+	// best interpolation quality but uses 16 bytes per frame.
+	k_interpolation_coefficients,
+
+	// Raw frames which are interpolated using a 4-point cubic when fetched. These use 4 and 2 bytes per frame.
+	k_real32,
+	k_int16,
+
+	k_count
+};
+
+// Frames stored as int16 map [-32768, 32767] to [-1, 1] the same way 16-bit sample files do:
+// real32 = (int16 + k_sample_int16_frame_offset) * k_sample_int16_frame_scale
+static constexpr real32 k_sample_int16_frame_offset = 0.5f;
+static constexpr real32 k_sample_int16_frame_scale = 1.0f / 32767.5f;
+
 struct s_sample_interpolation_coefficients {
 	// Coefficients for a cubic polynomial to be evaluated for x in range [0, 1]. This polynomial models the curve
 	// between samples i and i+1. It is constructed from a properly upsampled version of the signal. The coefficients
@@ -28,17 +49,29 @@ struct s_sample_data {
 
 	// Rather than storing raw samples, we store coefficients for interpolating between the ith and i+1th samples
 	c_wrapped_array<const s_sample_interpolation_coefficients> samples;
+
+	// Compact storage formats hold raw frames instead of coefficients. Interpolating between the ith and i+1th samples
+	// requires samples [i-1, i+2], so frames are padded by one at the beginning and two at the end: frames[i + 1]
+	// holds sample i. Only the array matching the sample's storage format is used.
+	c_wrapped_array<const real32> real32_frames;
+	c_wrapped_array<const int16> int16_frames;
 };
 
 // Contains a predefined buffer of audio sample data. This data has an associated sample rate which is independent of
 // the output sample rate. A sample can optionally consist of a wavetable of sub-samples for improved resampling
 // quality.
+//
+// Long non-looping samples can be loaded in streaming mode if streaming is enabled. Only the first few hundred
+// milliseconds of a streamed sample are held in memory and the rest is read from disk on demand using
+// read_streamed_samples(). Only samples stored as interpolation coefficients are streamed.
 class c_sample {
 public:
 	static bool load_file(
 		const char *filename,
 		e_sample_loop_mode loop_mode,
 		bool phase_shift_enabled,
+		e_sample_storage_format storage_format,
+		bool streaming_enabled,
 		std::vector<c_sample *> &channel_samples_out);
 
 	static c_sample *generate_wavetable(
@@ -59,11 +92,38 @@ public:
 	uint32 get_loop_end() const;
 	bool is_phase_shift_enabled() const;
 
+	// Wavetables are always stored as interpolation coefficients
+	e_sample_storage_format get_storage_format() const;
+
 	// Used to query the wavetable; non-wavetable samples have an entry count of 1
 	uint32 get_entry_count() const;
 	const s_sample_data *get_entry(uint32 index) const;
 
+	// Returns the number of samples in the first entry, including samples which are streamed
+	uint32 get_sample_count() const;
+
+	// Streamed samples only hold samples [0, get_stream_start()) in their entry. The remaining samples are computed
+	// from the file on demand.
+	bool is_streamed() const;
+	uint32 get_stream_start() const;
+
+	// Opens the file that this sample streams from and verifies that it has not changed since the sample was loaded
+	bool open_stream(c_sample_file_reader &reader) const;
+
+	// Reads samples starting at first_sample_index from an opened stream and computes their interpolation
+	// coefficients. The scratch buffer holds raw samples read from the file and is resized as needed.
+	bool read_streamed_samples(
+		c_sample_file_reader &reader,
+		uint32 first_sample_index,
+		c_wrapped_array<s_sample_interpolation_coefficients> samples_out,
+		std::vector<real32> &scratch) const;
+
 private:
+	static bool load_streamed_file(
+		const char *filename,
+		c_sample_file_reader &reader,
+		std::vector<c_sample *> &channel_samples_out);
+
 	enum class e_type {
 		k_none,				// The sample has no type yet
 		k_single_sample,	// A single sample, or an initialized sample in a wavetable
@@ -82,6 +142,18 @@ private:
 	uint32 m_loop_end = 0;				// End loop point, in samples
 	bool m_phase_shift_enabled = false;	// Whether phase shifting is allowed (implemented by doubling the loop)
 
+	// How frames are stored in m_samples, m_real32_frames, or m_int16_frames
+	e_sample_storage_format m_storage_format = e_sample_storage_format::k_interpolation_coefficients;
+
+	bool m_streamed = false;			// Whether samples past m_stream_start are read from disk
+	uint32 m_stream_start = 0;			// Index of the first streamed sample
+	uint32 m_sample_count = 0;			// Number of samples including streamed samples, unused for wavetables
+	std::string m_stream_filename;		// File that streamed samples are read from
+	uint32 m_stream_frame_count = 0;	// Frame count of the file when it was loaded, used to detect changes
+	uint32 m_stream_channel = 0;		// Channel within the file that this sample reads
+
 	std::vector<s_sample_interpolation_coefficients> m_samples;
+	std::vector<real32> m_real32_frames;
+	std::vector<int16> m_int16_frames;
 	std::vector<s_sample_data> m_entries;
 };
@@ -3,7 +3,9 @@
 #include "engine/task_functions/sampler/sample.h"
 #include "engine/task_functions/sampler/sample_library.h"
 
-c_sample_library::c_sample_library() {}
+c_sample_library::c_sample_library() {
+	m_streaming_enabled = false;
+}
 
 c_sample_library::~c_sample_library() {
 	// This will clear out all samples
@@ -13,9 +15,10 @@ c_sample_library::~c_sample_library() {
 	wl_assert(m_previous_requested_samples.empty());
 }
 
-void c_sample_library::initialize(const char *root_path) {
+void c_sample_library::initialize(const char *root_path, bool streaming_enabled) {
 	wl_assert(m_root_path.empty());
 	m_root_path = root_path;
+	m_streaming_enabled = streaming_enabled;
 }
 
 void c_sample_library::clear_requested_samples() {
@@ -26,6 +29,7 @@ void c_sample_library::clear_requested_samples() {
 h_sample c_sample_library::request_sample(const s_file_sample_parameters &parameters) {
 	wl_assert(parameters.filename);
 	wl_assert(valid_enum_index(parameters.loop_mode));
+	wl_assert(valid_enum_index(parameters.storage_format));
 
 	s_requested_sample requested_sample;
 	requested_sample.sample_type = e_sample_type::k_file;
@@ -33,6 +37,7 @@ h_sample c_sample_library::request_sample(const s_file_sample_parameters &parame
 		? requested_sample.file_path = m_root_path + parameters.filename
 		: requested_sample.file_path = parameters.filename;
 	requested_sample.loop_mode = parameters.loop_mode;
+	requested_sample.storage_format = parameters.storage_format;
 	requested_sample.timestamp = 0;
 	// Phase doesn't exist without looping
 	requested_sample.phase_shift_enabled =
@@ -45,6 +50,7 @@ h_sample c_sample_library::request_sample(const s_wavetable_sample_parameters &p
 	s_requested_sample requested_sample;
 	requested_sample.sample_type = e_sample_type::k_wavetable;
 	requested_sample.loop_mode = e_sample_loop_mode::k_loop;
+	requested_sample.storage_format = e_sample_storage_format::k_interpolation_coefficients;
 	requested_sample.timestamp = 0;
 	requested_sample.harmonic_weights.assign(parameters.harmonic_weights.begin(), parameters.harmonic_weights.end());
 	requested_sample.phase_shift_enabled = parameters.phase_shift_enabled;
@@ -53,6 +59,9 @@ h_sample c_sample_library::request_sample(const s_wavetable_sample_parameters &p
 }
 
 void c_sample_library::update_loaded_samples() {
+	// Streams may be reading from samples which are about to be unloaded or reloaded
+	m_sample_streamer.stop_all_streams();
+
 	// Unload all previously loaded samples which were not re-referenced
 	for (size_t index = 0; index < m_previous_requested_samples.size(); index++) {
 		for (c_sample *sample : m_previous_requested_samples[index].channel_samples) {
@@ -87,8 +96,17 @@ void c_sample_library::update_loaded_samples() {
 					request.file_path.c_str(),
 					request.loop_mode,
 					request.phase_shift_enabled,
+					request.storage_format,
+					m_streaming_enabled,
 					request.channel_samples);
 			}
+
+			// Stream buffers are only allocated once a streamed sample is actually used
+			if (!m_sample_streamer.is_initialized()
+				&& !request.channel_samples.empty()
+				&& request.channel_samples[0]->is_streamed()) {
+				m_sample_streamer.initialize(k_max_sample_streams);
+			}
 		} else if (request.sample_type == e_sample_type::k_wavetable) {
 			if (request.channel_samples.empty()) {
 				c_wrapped_array<const real32> harmonic_weights(request.harmonic_weights);
@@ -112,6 +130,10 @@ const c_sample *c_sample_library::get_sample(h_sample handle, uint32 channel_ind
 	return nullptr;
 }
 
+c_sample_streamer *c_sample_library::get_sample_streamer() {
+	return &m_sample_streamer;
+}
+
 bool c_sample_library::are_requested_samples_equal(
 	const s_requested_sample &requested_sample_a,
 	const s_requested_sample &requested_sample_b) {
@@ -122,6 +144,7 @@ bool c_sample_library::are_requested_samples_equal(
 	if (requested_sample_a.sample_type == e_sample_type::k_file) {
 		return are_file_paths_equivalent(requested_sample_a.file_path.c_str(), requested_sample_b.file_path.c_str())
 			&& requested_sample_a.loop_mode == requested_sample_b.loop_mode
+			&& requested_sample_a.storage_format == requested_sample_b.storage_format
 			&& requested_sample_a.timestamp == requested_sample_b.timestamp
 			&&requested_sample_a.phase_shift_enabled == requested_sample_b.phase_shift_enabled;
 	} else if (requested_sample_a.sample_type == e_sample_type::k_wavetable) {
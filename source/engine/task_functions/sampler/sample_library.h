@@ -4,6 +4,7 @@
 #include "common/utility/handle.h"
 
 #include "engine/task_functions/sampler/sample.h"
+#include "engine/task_functions/sampler/sample_streamer.h"
 
 #include <string>
 #include <vector>
@@ -12,6 +13,7 @@ struct s_file_sample_parameters {
 	const char *filename;
 	e_sample_loop_mode loop_mode;
 	bool phase_shift_enabled;
+	e_sample_storage_format storage_format;
 };
 
 struct s_wavetable_sample_parameters {
@@ -27,7 +29,8 @@ public:
 	c_sample_library();
 	~c_sample_library();
 
-	void initialize(const char *root_path);
+	// If streaming is enabled, long samples are streamed from disk rather than fully loaded into memory
+	void initialize(const char *root_path, bool streaming_enabled);
 
 	// Clears the list of samples that have been requested
 	void clear_requested_samples();
@@ -44,6 +47,9 @@ public:
 	// Returns the sample with the given handle, or null if it failed to load
 	const c_sample *get_sample(h_sample handle, uint32 channel_index) const;
 
+	// Returns the streamer used to play streamed samples
+	c_sample_streamer *get_sample_streamer();
+
 private:
 	enum class e_sample_type {
 		k_file,
@@ -58,6 +64,7 @@ private:
 		// File parameters:
 		std::string file_path;
 		e_sample_loop_mode loop_mode;
+		e_sample_storage_format storage_format;
 		// Modification timestamp of the loaded sample
 		uint64 timestamp;
 
@@ -76,7 +83,12 @@ private:
 		const s_requested_sample &requested_sample_b);
 	h_sample request_sample(const s_requested_sample &requested_sample);
 
+	// Maximum number of voices which can play streamed samples at once
+	static constexpr uint32 k_max_sample_streams = 64;
+
 	std::string m_root_path;
+	bool m_streaming_enabled;
+	c_sample_streamer m_sample_streamer;
 	std::vector<s_requested_sample> m_requested_samples;
 	std::vector<s_requested_sample> m_previous_requested_samples;
 };
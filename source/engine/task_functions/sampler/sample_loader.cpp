@@ -2,6 +2,8 @@
 
 #include "engine/task_functions/sampler/sample_loader.h"
 
+#include <algorithm>
+
 struct s_wave_riff_header {
 	uint32 chunk_id;
 	uint32 chunk_size;
@@ -26,13 +28,8 @@ struct s_wave_data_subchunk {
 
 // $TODO add cue-points to wav files: http://bleepsandpops.com/post/37792760450/adding-cue-points-to-wav-files-in-c
 
-static bool load_wav(const char *filename, s_loaded_sample &loaded_sample_out) {
-	std::ifstream file(filename, std::ios::binary);
-	if (file.fail()) {
-		return false;
-	}
-
-	c_binary_file_reader reader(file);
+bool c_sample_file_reader::read_wav_header() {
+	c_binary_file_reader reader(m_file);
 
 	s_wave_riff_header riff_header;
 	if (!reader.read_raw(&riff_header, sizeof(riff_header))) {
@@ -132,54 +129,135 @@ static bool load_wav(const char *filename, s_loaded_sample &loaded_sample_out) {
 		return false;
 	}
 
-	std::vector<uint8> raw_data(data_subchunk.subchunk_2_size);
-	file.read(reinterpret_cast<char *>(raw_data.data()), raw_data.size());
-	if (file.fail()) {
+	// $TODO support more formats, namely float and int24
+	if (fmt_subchunk.bits_per_sample != 8 && fmt_subchunk.bits_per_sample != 16) {
+		return false;
+	}
+
+	m_little_endian = little_endian;
+	m_sample_rate = fmt_subchunk.sample_rate;
+	m_frame_count = frames;
+	m_channel_count = fmt_subchunk.num_channels;
+	m_bytes_per_sample = fmt_subchunk.bits_per_sample / 8;
+	m_data_offset = static_cast<uint64>(m_file.tellg());
+	return true;
+}
+
+bool load_sample(const char *filename, s_loaded_sample &loaded_sample_out) {
+	// $TODO detect format to determine which reader to use
+	c_sample_file_reader reader;
+	if (!reader.open(filename)) {
 		return false;
 	}
 
-	loaded_sample_out.sample_rate = fmt_subchunk.sample_rate;
-	loaded_sample_out.frame_count = frames;
-	loaded_sample_out.channel_count = fmt_subchunk.num_channels;
+	loaded_sample_out.sample_rate = reader.get_sample_rate();
+	loaded_sample_out.frame_count = reader.get_frame_count();
+	loaded_sample_out.channel_count = reader.get_channel_count();
 	// $TODO add loop point data if it exists (make sure to verify that it's valid first)
 	loaded_sample_out.loop_start_sample_index = 0;
-	loaded_sample_out.loop_end_sample_index = frames;
+	loaded_sample_out.loop_end_sample_index = reader.get_frame_count();
+
+	loaded_sample_out.samples.resize(reader.get_frame_count() * reader.get_channel_count());
+	return reader.read_frames(
+		0,
+		reader.get_frame_count(),
+		c_wrapped_array<real32>(loaded_sample_out.samples.data(), loaded_sample_out.samples.size()));
+}
+
+bool c_sample_file_reader::open(const char *filename) {
+	wl_assert(!is_open());
+	m_file.open(filename, std::ios::binary);
+	if (m_file.fail()) {
+		return false;
+	}
+
+	if (!read_wav_header()) {
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void c_sample_file_reader::close() {
+	m_file.close();
+	m_file.clear();
+	m_sample_rate = 0;
+	m_frame_count = 0;
+	m_channel_count = 0;
+	m_bytes_per_sample = 0;
+	m_data_offset = 0;
+}
+
+bool c_sample_file_reader::is_open() const {
+	return m_file.is_open();
+}
+
+uint32 c_sample_file_reader::get_sample_rate() const {
+	return m_sample_rate;
+}
+
+uint32 c_sample_file_reader::get_frame_count() const {
+	return m_frame_count;
+}
+
+uint32 c_sample_file_reader::get_channel_count() const {
+	return m_channel_count;
+}
+
+bool c_sample_file_reader::read_frames(int64 first_frame, uint32 frame_count, c_wrapped_array<real32> samples_out) {
+	wl_assert(is_open());
+	wl_assert(samples_out.get_count() == static_cast<size_t>(frame_count) * m_channel_count);
+
+	// Only frames within the file are read; the rest are zero
+	int64 end_frame = first_frame + frame_count;
+	int64 read_start_frame = std::clamp<int64>(first_frame, 0, m_frame_count);
+	int64 read_end_frame = std::clamp<int64>(end_frame, 0, m_frame_count);
+	uint32 leading_frame_count = static_cast<uint32>(read_start_frame - first_frame);
+	uint32 read_frame_count = static_cast<uint32>(std::max<int64>(read_end_frame - read_start_frame, 0));
+
+	zero_type(samples_out.get_pointer(), samples_out.get_count());
+	if (read_frame_count == 0) {
+		return true;
+	}
+
+	size_t frame_size = m_bytes_per_sample * m_channel_count;
+	m_raw_data.resize(read_frame_count * frame_size);
+	m_file.seekg(static_cast<std::streamoff>(m_data_offset + read_start_frame * frame_size));
+	m_file.read(reinterpret_cast<char *>(m_raw_data.data()), m_raw_data.size());
+	if (m_file.fail()) {
+		m_file.clear();
+		return false;
+	}
 
 	// Convert to real format
-	// $TODO support more formats, namely float and int24
-	loaded_sample_out.samples.resize(frames * fmt_subchunk.num_channels);
-	switch (fmt_subchunk.bits_per_sample) {
-	case 8:
-		for (size_t frame = 0; frame < frames; frame++) {
-			for (uint32 channel = 0; channel < fmt_subchunk.num_channels; channel++) {
-				size_t index = frame * fmt_subchunk.num_channels + channel;
+	for (uint32 channel = 0; channel < m_channel_count; channel++) {
+		real32 *channel_samples = &samples_out[channel * frame_count + leading_frame_count];
+		switch (m_bytes_per_sample) {
+		case 1:
+			for (size_t frame = 0; frame < read_frame_count; frame++) {
+				size_t index = frame * m_channel_count + channel;
 				// map [0,255] to [-1,1]
-				real32 value = (static_cast<real32>(raw_data[index]) - 127.5f) * (1.0f / 127.5f);
-				loaded_sample_out.samples[channel * frames + frame] = value;
+				channel_samples[frame] = (static_cast<real32>(m_raw_data[index]) - 127.5f) * (1.0f / 127.5f);
 			}
-		}
-		break;
+			break;
 
-	case 16:
-		for (size_t frame = 0; frame < frames; frame++) {
-			for (uint32 channel = 0; channel < fmt_subchunk.num_channels; channel++) {
-				size_t index = frame * fmt_subchunk.num_channels + channel;
+		case 2:
+			for (size_t frame = 0; frame < read_frame_count; frame++) {
+				size_t index = frame * m_channel_count + channel;
 				// map [-32768,32767] to [-1,1]
-				int16 integer_value = reinterpret_cast<const int16 *>(raw_data.data())[index];
-				real32 value = (static_cast<real32>(integer_value) + 0.5f) * (1.0f / 32767.5f);
-				loaded_sample_out.samples[channel * frames + frame] = value;
+				uint16 raw_value = reinterpret_cast<const uint16 *>(m_raw_data.data())[index];
+				raw_value = m_little_endian ? little_to_native_endian(raw_value) : big_to_native_endian(raw_value);
+				int16 integer_value = static_cast<int16>(raw_value);
+				channel_samples[frame] = (static_cast<real32>(integer_value) + 0.5f) * (1.0f / 32767.5f);
 			}
-		}
-		break;
+			break;
 
-	default:
-		return false;
+		default:
+			wl_unreachable();
+		}
 	}
 
 	return true;
 }
 
-bool load_sample(const char *filename, s_loaded_sample &loaded_sample_out) {
-	// $TODO detect format to determine which loading function to call
-	return load_wav(filename, loaded_sample_out);
-}
@@ -18,3 +18,36 @@ struct s_loaded_sample {
 };
 
 bool load_sample(const char *filename, s_loaded_sample &loaded_sample_out);
+
+// Reads sample data from a file on demand rather than all at once. This is used to stream samples which are too large
+// to be fully loaded into memory.
+class c_sample_file_reader {
+public:
+	c_sample_file_reader() = default;
+	UNCOPYABLE(c_sample_file_reader);
+
+	// Opens the file and reads its format. The sample data itself is not read.
+	bool open(const char *filename);
+	void close();
+	bool is_open() const;
+
+	uint32 get_sample_rate() const;
+	uint32 get_frame_count() const;
+	uint32 get_channel_count() const;
+
+	// Reads frames [first_frame, first_frame + frame_count) in the same non-interleaved layout as s_loaded_sample.
+	// Frames outside of the file's range are read as 0.
+	bool read_frames(int64 first_frame, uint32 frame_count, c_wrapped_array<real32> samples_out);
+
+private:
+	bool read_wav_header();
+
+	std::ifstream m_file;
+	bool m_little_endian = true;
+	uint32 m_sample_rate = 0;
+	uint32 m_frame_count = 0;
+	uint32 m_channel_count = 0;
+	uint32 m_bytes_per_sample = 0;
+	uint64 m_data_offset = 0;
+	std::vector<uint8> m_raw_data;
+};
@@ -0,0 +1,352 @@
+#include "engine/task_functions/sampler/sample_streamer.h"
+
+#include <algorithm>
+
+// Stream handles hold the stream index in the low bits and the stream's generation in the high bits so that handles to
+// reclaimed streams can be detected
+static constexpr uint32 k_stream_index_bits = 8;
+static constexpr uint32 k_stream_index_mask = (1u << k_stream_index_bits) - 1;
+static constexpr uint32 k_stream_generation_mask = (1u << (32 - k_stream_index_bits)) - 1;
+
+// How often the streaming thread polls for new streams and playback progress. Real-time threads never signal the
+// streaming thread, so the idle period must be well below the preload duration of streamed samples.
+static constexpr uint32 k_active_poll_period_ms = 2;
+static constexpr uint32 k_idle_poll_period_ms = 20;
+
+// Streams which are not updated for this long are assumed to belong to deactivated voices and are reclaimed
+static constexpr int64 k_stream_timeout_ms = 500;
+
+// Buffer positions are computed by masking sample indices, and blocks must never wrap around the end of the buffer
+STATIC_ASSERT(
+	(c_sample_streamer::k_stream_buffer_sample_count & (c_sample_streamer::k_stream_buffer_sample_count - 1)) == 0);
+STATIC_ASSERT(c_sample_streamer::k_stream_buffer_sample_count % c_sample_streamer::k_stream_block_sample_count == 0);
+
+c_sample_streamer::c_sample_streamer() {
+	m_stop_all_streams_flag = false;
+	m_streaming_thread_terminate_flag = false;
+}
+
+c_sample_streamer::~c_sample_streamer() {
+	if (is_initialized()) {
+		shutdown();
+	}
+}
+
+void c_sample_streamer::initialize(uint32 max_stream_count) {
+	wl_assert(!is_initialized());
+	// The all-ones index is reserved so that no valid handle matches the invalid handle
+	wl_assert(max_stream_count > 0 && max_stream_count < k_stream_index_mask);
+
+	m_streams.resize(max_stream_count);
+	for (std::unique_ptr<s_stream> &stream : m_streams) {
+		stream = std::make_unique<s_stream>();
+		stream->state = e_stream_state::k_free;
+		stream->generation = 0;
+		stream->sample = nullptr;
+		stream->read_sample_index = 0;
+		stream->update_count = 0;
+		stream->start_sample_index = 0;
+		stream->write_sample_index = 0;
+		stream->buffer.allocate(k_stream_buffer_sample_count);
+		stream->started = false;
+		stream->failed = false;
+		stream->last_update_count = 0;
+		stream->last_update_time_ms = 0;
+	}
+
+	m_stop_all_streams_flag = false;
+	m_streaming_thread_terminate_flag = false;
+	m_stopwatch.initialize();
+	m_stopwatch.reset();
+
+	s_thread_definition thread_definition;
+	thread_definition.thread_name = "sample_streamer";
+	thread_definition.stack_size = 0;
+	thread_definition.thread_priority = e_thread_priority::k_high;
+	thread_definition.processor = -1;
+	thread_definition.thread_entry_point = streaming_thread_function_entry_point;
+	zero_type(&thread_definition.parameter_block);
+	// Set a single parameter to point to 'this'
+	*thread_definition.parameter_block.get_memory_typed<c_sample_streamer *>() = this;
+	m_streaming_thread.start(thread_definition);
+}
+
+void c_sample_streamer::shutdown() {
+	wl_assert(is_initialized());
+
+	{
+		// Signal the thread to terminate
+		c_scoped_lock lock(m_lock);
+		m_streaming_thread_terminate_flag = true;
+		m_streaming_thread_signal.notify_one();
+	}
+
+	m_streaming_thread.join();
+	m_streams.clear();
+	m_scratch.clear();
+}
+
+bool c_sample_streamer::is_initialized() const {
+	return m_streaming_thread.is_running();
+}
+
+void c_sample_streamer::stop_all_streams() {
+	if (!is_initialized()) {
+		return;
+	}
+
+	c_scoped_lock lock(m_lock);
+	m_stop_all_streams_flag = true;
+	m_streaming_thread_signal.notify_one();
+
+	while (m_stop_all_streams_flag) {
+		m_streams_stopped_signal.wait(lock);
+	}
+}
+
+h_sample_stream c_sample_streamer::start_stream(const c_sample *sample, uint32 first_sample_index) {
+	wl_assert(sample->is_streamed());
+	first_sample_index = std::max(first_sample_index, sample->get_stream_start());
+
+	for (uint32 stream_index = 0; stream_index < m_streams.size(); stream_index++) {
+		s_stream &stream = *m_streams[stream_index];
+		e_stream_state expected_state = e_stream_state::k_free;
+		if (stream.state.compare_exchange_strong(
+			expected_state,
+			e_stream_state::k_claimed,
+			std::memory_order_acquire)) {
+			// Only the claiming thread can access the stream until it is published as active
+			uint32 generation = (stream.generation.load(std::memory_order_relaxed) + 1) & k_stream_generation_mask;
+			stream.generation.store(generation, std::memory_order_relaxed);
+			stream.sample = sample;
+			stream.read_sample_index.store(first_sample_index, std::memory_order_relaxed);
+			stream.update_count.store(0, std::memory_order_relaxed);
+			stream.start_sample_index.store(first_sample_index, std::memory_order_relaxed);
+			stream.write_sample_index.store(first_sample_index, std::memory_order_relaxed);
+			stream.state.store(e_stream_state::k_active, std::memory_order_release);
+			return make_stream_handle(stream_index, generation);
+		}
+	}
+
+	return h_sample_stream::invalid();
+}
+
+void c_sample_streamer::stop_stream(h_sample_stream stream_handle) {
+	s_stream *stream = get_stream(stream_handle);
+	if (stream) {
+		// The streaming thread frees the stream once it is no longer reading into it
+		e_stream_state expected_state = e_stream_state::k_active;
+		stream->state.compare_exchange_strong(expected_state, e_stream_state::k_stopped, std::memory_order_release);
+	}
+}
+
+bool c_sample_streamer::is_stream_valid(h_sample_stream stream_handle) const {
+	return get_stream(stream_handle) != nullptr;
+}
+
+void c_sample_streamer::update_stream(h_sample_stream stream_handle, uint32 sample_index) {
+	s_stream *stream = get_stream(stream_handle);
+	if (stream) {
+		stream->read_sample_index.store(sample_index, std::memory_order_release);
+
+		// Only the owner of the stream writes the update count, so this doesn't need to be an atomic increment
+		uint32 update_count = stream->update_count.load(std::memory_order_relaxed);
+		stream->update_count.store(update_count + 1, std::memory_order_relaxed);
+	}
+}
+
+const s_sample_interpolation_coefficients *c_sample_streamer::get_stream_sample(
+	h_sample_stream stream_handle,
+	uint32 sample_index) const {
+	const s_stream *stream = get_stream(stream_handle);
+	if (!stream) {
+		return nullptr;
+	}
+
+	// The streaming thread may currently be writing the block following write_sample_index, which overwrites the
+	// oldest block in the buffer, so that block is not considered to be available
+	uint32 write_sample_index = stream->write_sample_index.load(std::memory_order_acquire);
+	uint32 start_sample_index = stream->start_sample_index.load(std::memory_order_acquire);
+	if (sample_index < start_sample_index
+		|| sample_index >= write_sample_index
+		|| write_sample_index - sample_index > k_stream_buffer_sample_count - k_stream_block_sample_count) {
+		return nullptr;
+	}
+
+	return &stream->buffer.get_array()[sample_index & (k_stream_buffer_sample_count - 1)];
+}
+
+h_sample_stream c_sample_streamer::make_stream_handle(uint32 stream_index, uint32 generation) {
+	wl_assert(stream_index < k_stream_index_mask);
+	wl_assert(generation <= k_stream_generation_mask);
+	return h_sample_stream::construct((generation << k_stream_index_bits) | stream_index);
+}
+
+c_sample_streamer::s_stream *c_sample_streamer::get_stream(h_sample_stream stream_handle) {
+	const c_sample_streamer *const_this = this;
+	return const_cast<s_stream *>(const_this->get_stream(stream_handle));
+}
+
+const c_sample_streamer::s_stream *c_sample_streamer::get_stream(h_sample_stream stream_handle) const {
+	if (!stream_handle.is_valid()) {
+		return nullptr;
+	}
+
+	uint32 stream_index = stream_handle.get_data() & k_stream_index_mask;
+	uint32 generation = stream_handle.get_data() >> k_stream_index_bits;
+	if (stream_index >= m_streams.size()) {
+		return nullptr;
+	}
+
+	const s_stream *stream = m_streams[stream_index].get();
+	if (stream->state.load(std::memory_order_acquire) != e_stream_state::k_active
+		|| stream->generation.load(std::memory_order_relaxed) != generation) {
+		return nullptr;
+	}
+
+	return stream;
+}
+
+void c_sample_streamer::streaming_thread_function_entry_point(const s_thread_parameter_block *params) {
+	c_sample_streamer *this_ptr = *params->get_memory_typed<c_sample_streamer *>();
+	this_ptr->streaming_thread_function();
+}
+
+void c_sample_streamer::streaming_thread_function() {
+	c_scoped_lock lock(m_lock);
+
+	while (!m_streaming_thread_terminate_flag) {
+		if (m_stop_all_streams_flag) {
+			// No real-time threads are running at this point, so nothing else is accessing the streams
+			for (std::unique_ptr<s_stream> &stream : m_streams) {
+				if (stream->state.load(std::memory_order_acquire) != e_stream_state::k_free) {
+					free_stream(*stream);
+				}
+			}
+
+			m_stop_all_streams_flag = false;
+			m_streams_stopped_signal.notify_all();
+		}
+
+		lock.unlock();
+
+		free_inactive_streams(m_stopwatch.query_ms());
+
+		// Read one block into each stream in turn so that all streams make progress. Limit the number of passes so
+		// that we still respond to requests if playback consumes samples as quickly as we can read them.
+		static constexpr uint32 k_max_fill_pass_count = k_stream_buffer_sample_count / k_stream_block_sample_count;
+		bool any_streams_active = false;
+		bool any_streams_filled = true;
+		for (uint32 pass = 0; any_streams_filled && pass < k_max_fill_pass_count; pass++) {
+			any_streams_filled = false;
+			for (std::unique_ptr<s_stream> &stream : m_streams) {
+				if (stream->state.load(std::memory_order_acquire) == e_stream_state::k_active) {
+					any_streams_active = true;
+					any_streams_filled |= fill_stream(*stream);
+				}
+			}
+		}
+
+		lock.lock();
+
+		if (!m_streaming_thread_terminate_flag && !m_stop_all_streams_flag) {
+			m_streaming_thread_signal.wait(lock, any_streams_active ? k_active_poll_period_ms : k_idle_poll_period_ms);
+		}
+	}
+
+	for (std::unique_ptr<s_stream> &stream : m_streams) {
+		if (stream->state.load(std::memory_order_acquire) != e_stream_state::k_free) {
+			free_stream(*stream);
+		}
+	}
+}
+
+bool c_sample_streamer::fill_stream(s_stream &stream) {
+	const c_sample *sample = stream.sample;
+	if (!stream.started) {
+		stream.started = true;
+		stream.failed = !sample->open_stream(stream.reader);
+		stream.last_update_count = stream.update_count.load(std::memory_order_relaxed);
+		stream.last_update_time_ms = m_stopwatch.query_ms();
+	}
+
+	if (stream.failed) {
+		return false;
+	}
+
+	uint32 read_sample_index = stream.read_sample_index.load(std::memory_order_acquire);
+	uint32 write_sample_index = stream.write_sample_index.load(std::memory_order_relaxed);
+	if (read_sample_index > write_sample_index) {
+		// Playback has moved past the samples we've read, so skip ahead rather than reading samples that will never be
+		// played. Raise the start index first so that real-time threads never see skipped samples as available.
+		write_sample_index = read_sample_index;
+		stream.start_sample_index.store(write_sample_index, std::memory_order_release);
+		stream.write_sample_index.store(write_sample_index, std::memory_order_release);
+	}
+
+	uint32 sample_count = sample->get_sample_count();
+	if (write_sample_index >= sample_count) {
+		return false;
+	}
+
+	// Blocks never wrap around the end of the buffer
+	uint32 buffer_offset = write_sample_index & (k_stream_buffer_sample_count - 1);
+	uint32 block_sample_count = std::min(
+		{
+			k_stream_block_sample_count,
+			sample_count - write_sample_index,
+			k_stream_buffer_sample_count - buffer_offset
+		});
+	// Leave a block of space behind the read position so that the block being written never overwrites a sample which
+	// may still be read. See get_stream_sample().
+	if (write_sample_index + block_sample_count
+		> read_sample_index + k_stream_buffer_sample_count - k_stream_block_sample_count) {
+		// The buffer is full
+		return false;
+	}
+
+	c_wrapped_array<s_sample_interpolation_coefficients> block(
+		&stream.buffer.get_array()[buffer_offset],
+		block_sample_count);
+	if (!sample->read_streamed_samples(stream.reader, write_sample_index, block, m_scratch)) {
+		// Playback continues silently past the samples which have been read
+		stream.failed = true;
+		return false;
+	}
+
+	stream.write_sample_index.store(write_sample_index + block_sample_count, std::memory_order_release);
+	return true;
+}
+
+void c_sample_streamer::free_inactive_streams(int64 time_ms) {
+	for (std::unique_ptr<s_stream> &stream : m_streams) {
+		e_stream_state state = stream->state.load(std::memory_order_acquire);
+		if (state == e_stream_state::k_active && stream->started) {
+			uint32 update_count = stream->update_count.load(std::memory_order_relaxed);
+			if (update_count != stream->last_update_count) {
+				stream->last_update_count = update_count;
+				stream->last_update_time_ms = time_ms;
+			} else if (time_ms - stream->last_update_time_ms >= k_stream_timeout_ms) {
+				// If this fails, the owner stopped the stream in the meantime, so it needs to be freed either way
+				e_stream_state expected_state = e_stream_state::k_active;
+				stream->state.compare_exchange_strong(expected_state, e_stream_state::k_stopped);
+				state = e_stream_state::k_stopped;
+			}
+		}
+
+		if (state == e_stream_state::k_stopped) {
+			free_stream(*stream);
+		}
+	}
+}
+
+void c_sample_streamer::free_stream(s_stream &stream) {
+	if (stream.reader.is_open()) {
+		stream.reader.close();
+	}
+
+	stream.sample = nullptr;
+	stream.started = false;
+	stream.failed = false;
+	stream.state.store(e_stream_state::k_free, std::memory_order_release);
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/threading/condition_variable.h"
+#include "common/threading/lock_free.h"
+#include "common/threading/mutex.h"
+#include "common/threading/thread.h"
+#include "common/utility/aligned_allocator.h"
+#include "common/utility/handle.h"
+#include "common/utility/stopwatch.h"
+
+#include "engine/task_functions/sampler/sample.h"
+#include "engine/task_functions/sampler/sample_loader.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct s_sample_stream_handle_identifier {};
+using h_sample_stream = c_handle<s_sample_stream_handle_identifier, uint32>;
+
+// Reads the streamed portion of samples from disk ahead of each playing voice. Each voice playing a streamed sample
+// claims a stream, which is a fixed-size ring buffer of interpolation coefficients, and reports its playback position
+// every buffer. A background thread reads and computes coefficients ahead of that position.
+//
+// All functions other than initialize(), shutdown(), and stop_all_streams() may be called from real-time threads. They
+// never allocate, lock, or wait. Streams which stop being updated (e.g. because their voice was deactivated) are
+// reclaimed automatically after a timeout.
+class c_sample_streamer {
+public:
+	// Number of samples held in each stream's ring buffer
+	static constexpr uint32 k_stream_buffer_sample_count = 16384;
+
+	// Samples are read and computed in blocks of this size
+	static constexpr uint32 k_stream_block_sample_count = 1024;
+
+	c_sample_streamer();
+	UNCOPYABLE(c_sample_streamer);
+	~c_sample_streamer();
+
+	// Allocates stream buffers and starts the streaming thread
+	void initialize(uint32 max_stream_count);
+	void shutdown();
+	bool is_initialized() const;
+
+	// Releases all streams and waits until the streaming thread is no longer reading any samples. This must be called
+	// before unloading streamed samples.
+	void stop_all_streams();
+
+	// Claims a stream which starts reading the sample at first_sample_index. Returns an invalid handle if all streams
+	// are in use, in which case playback past the sample's preloaded region will be silent.
+	h_sample_stream start_stream(const c_sample *sample, uint32 first_sample_index);
+
+	// Releases a stream. The handle may be invalid or may refer to a stream which has already been reclaimed.
+	void stop_stream(h_sample_stream stream_handle);
+
+	// Returns whether the stream is still owned by the caller
+	bool is_stream_valid(h_sample_stream stream_handle) const;
+
+	// Reports the index of the earliest sample which will be read from the stream from now on. The streaming thread
+	// keeps the ring buffer filled ahead of this index.
+	void update_stream(h_sample_stream stream_handle, uint32 sample_index);
+
+	// Returns the coefficients for the given sample, or null if the stream has not been filled up to that point yet
+	const s_sample_interpolation_coefficients *get_stream_sample(
+		h_sample_stream stream_handle,
+		uint32 sample_index) const;
+
+private:
+	enum class e_stream_state : uint32 {
+		k_free,		// The stream is not in use
+		k_claimed,	// The stream is being set up by the thread that claimed it
+		k_active,	// The stream is being filled by the streaming thread
+		k_stopped,	// The stream was released and is waiting for the streaming thread to free it
+
+		k_count
+	};
+
+	struct ALIGNAS_LOCK_FREE s_stream {
+		// Fields shared with real-time threads:
+
+		std::atomic<e_stream_state> state;
+		std::atomic<uint32> generation;
+
+		// The sample being streamed, which is written before the stream becomes active
+		const c_sample *sample;
+
+		// Only written by real-time threads
+		ALIGNAS_LOCK_FREE std::atomic<uint32> read_sample_index;
+		std::atomic<uint32> update_count;
+
+		// Only written by the streaming thread once the stream is active. Samples [start_sample_index,
+		// write_sample_index) have been written, although the earliest ones may have since been overwritten.
+		ALIGNAS_LOCK_FREE std::atomic<uint32> start_sample_index;
+		std::atomic<uint32> write_sample_index;
+
+		c_aligned_allocator<s_sample_interpolation_coefficients, k_simd_alignment> buffer;
+
+		// Streaming thread state:
+
+		c_sample_file_reader reader;
+		bool started;
+		bool failed;
+		uint32 last_update_count;
+		int64 last_update_time_ms;
+	};
+
+	static h_sample_stream make_stream_handle(uint32 stream_index, uint32 generation);
+	s_stream *get_stream(h_sample_stream stream_handle);
+	const s_stream *get_stream(h_sample_stream stream_handle) const;
+
+	// Streaming thread function (the static one is a wrapper)
+	static void streaming_thread_function_entry_point(const s_thread_parameter_block *params);
+	void streaming_thread_function();
+
+	// Called on the streaming thread to read one block of samples into the stream if there is space. Returns true if
+	// a block was read.
+	bool fill_stream(s_stream &stream);
+
+	// Called on the streaming thread to free streams which were stopped or which have not been updated recently
+	void free_inactive_streams(int64 time_ms);
+	void free_stream(s_stream &stream);
+
+	std::vector<std::unique_ptr<s_stream>> m_streams;
+
+	// Scratch memory used by the streaming thread to read raw samples
+	std::vector<real32> m_scratch;
+
+	c_thread m_streaming_thread;
+
+	// Used to detect streams which are no longer being updated
+	c_stopwatch m_stopwatch;
+
+	// Used in combination with the condition variables below
+	c_mutex m_lock;
+
+	// Signals the streaming thread to wake up
+	c_condition_variable m_streaming_thread_signal;
+
+	// Signals that the streaming thread has released all streams
+	c_condition_variable m_streams_stopped_signal;
+
+	// Flags indicating that the streaming thread should stop all streams or terminate, protected by m_lock
+	bool m_stop_all_streams_flag;
+	bool m_streaming_thread_terminate_flag;
+};
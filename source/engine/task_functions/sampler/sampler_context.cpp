@@ -2,6 +2,7 @@
 #include "engine/events/event_interface.h"
 #include "engine/task_functions/sampler/sampler_context.h"
 
+#include <algorithm>
 #include <cmath>
 
 void s_sampler_shared_context::initialize_file(
@@ -10,13 +11,16 @@ void s_sampler_shared_context::initialize_file(
 	const char *sample,
 	e_sample_loop_mode loop_mode,
 	bool phase_shift_enabled,
+	e_sample_storage_format storage_format,
 	real32 channel_real) {
 	wl_assert(valid_enum_index(loop_mode));
+	wl_assert(valid_enum_index(storage_format));
 
 	s_file_sample_parameters parameters;
 	parameters.filename = sample;
 	parameters.loop_mode = loop_mode;
 	parameters.phase_shift_enabled = phase_shift_enabled;
+	parameters.storage_format = storage_format;
 	sample_handle = sample_library->request_sample(parameters);
 	if (channel_real < 0.0f
 		|| std::floor(channel_real) != channel_real) {
@@ -52,11 +56,23 @@ void s_sampler_shared_context::initialize_wavetable(
 
 void s_sampler_voice_context::initialize(s_sampler_shared_context *sampler_shared_context) {
 	shared_context = sampler_shared_context;
+	stream_handle = h_sample_stream::invalid();
 }
 
-void s_sampler_voice_context::activate() {
+void s_sampler_voice_context::activate(c_sample_library *sample_library) {
 	sample_index = 0.0;
 	reached_end = false;
+
+	// Voices aren't notified when they're deactivated, so the stream from the previous activation may still be held
+	c_sample_streamer *sample_streamer = sample_library->get_sample_streamer();
+	sample_streamer->stop_stream(stream_handle);
+	stream_handle = h_sample_stream::invalid();
+
+	// Start streaming right away so that the stream is filled by the time the preloaded samples run out
+	const c_sample *sample = sample_library->get_sample(shared_context->sample_handle, shared_context->channel);
+	if (sample && sample->is_streamed()) {
+		stream_handle = sample_streamer->start_stream(sample, sample->get_stream_start());
+	}
 }
 
 const c_sample *s_sampler_voice_context::get_sample_or_fail_gracefully(
@@ -90,6 +106,28 @@ const c_sample *s_sampler_voice_context::get_sample_or_fail_gracefully(
 	return sample;
 }
 
+void s_sampler_voice_context::update_stream(c_sample_library *sample_library, const c_sample *sample) {
+	if (!sample->is_streamed()) {
+		return;
+	}
+
+	c_sample_streamer *sample_streamer = sample_library->get_sample_streamer();
+	uint32 sample_index_int = static_cast<uint32>(std::max(sample_index, 0.0));
+	if (reached_end || sample_index_int >= sample->get_sample_count()) {
+		sample_streamer->stop_stream(stream_handle);
+		stream_handle = h_sample_stream::invalid();
+		return;
+	}
+
+	if (!sample_streamer->is_stream_valid(stream_handle)) {
+		// Either no stream was free when the voice was activated or the stream timed out, e.g. because processing was
+		// paused. Resume streaming from the current position; playback is silent until the stream catches up.
+		stream_handle = sample_streamer->start_stream(sample, sample_index_int);
+	}
+
+	sample_streamer->update_stream(stream_handle, sample_index_int);
+}
+
 bool s_sampler_voice_context::handle_reached_end(c_real_buffer *result) {
 	if (reached_end) {
 		result->assign_constant(0.0f);
@@ -17,6 +17,7 @@ struct s_sampler_shared_context {
 		const char *sample,
 		e_sample_loop_mode loop_mode,
 		bool phase_shift_enabled,
+		e_sample_storage_format storage_format,
 		real32 channel_real);
 	void initialize_wavetable(
 		c_event_interface *event_interface,
@@ -31,7 +32,7 @@ struct s_sampler_shared_context {
 
 struct s_sampler_voice_context {
 	void initialize(s_sampler_shared_context *sampler_shared_context);
-	void activate();
+	void activate(c_sample_library *sample_library);
 
 	// Common utility functions used in all versions of the sampler:
 
@@ -42,6 +43,10 @@ struct s_sampler_voice_context {
 		c_event_interface *event_interface,
 		const char *sample_name);
 
+	// Reports the playback position to the voice's stream if the sample is streamed, reclaiming a stream if necessary,
+	// and releases the stream once it is no longer needed. Call this before fetching samples each buffer.
+	void update_stream(c_sample_library *sample_library, const c_sample *sample);
+
 	// Fills the output buffer with 0s if the end has been reached
 	bool handle_reached_end(c_real_buffer *result);
 
@@ -56,4 +61,7 @@ struct s_sampler_voice_context {
 	// Store the sample index in real64 for improved precision so we can accurately handle both short and long samples
 	real64 sample_index;
 	bool reached_end;
+
+	// The stream which reads ahead of the playback position if the sample is streamed
+	h_sample_stream stream_handle;
 };
@@ -197,6 +197,94 @@ namespace filter_task_functions {
 		}
 	}
 
+	static void iir_sos_multiple_voices(c_task_function_context_array contexts) {
+		static constexpr size_t k_max_voices = c_reentrant_iir_sos::k_max_voices;
+		size_t voice_count = contexts.get_count();
+		wl_assert(voice_count <= k_max_voices);
+
+		// Arguments are read in the same order as iir_sos(): coefficients, signal, result
+		s_static_array<s_iir_sos_context *, k_max_voices> iir_sos_contexts;
+		s_static_array<c_real_buffer_array_in, k_max_voices> coefficients;
+		s_static_array<const c_real_buffer *, k_max_voices> signals;
+		s_static_array<c_real_buffer *, k_max_voices> results;
+		s_static_array<real32 *, k_max_voices> result_data;
+		for (size_t voice = 0; voice < voice_count; voice++) {
+			const s_task_function_context &context = contexts[voice];
+			wl_assert(context.buffer_size == contexts[0].buffer_size);
+			iir_sos_contexts[voice] = reinterpret_cast<s_iir_sos_context *>(context.voice_memory.get_pointer());
+			coefficients[voice] = context.arguments[0].get_real_buffer_array_in();
+			signals[voice] = context.arguments[1].get_real_buffer_in();
+			results[voice] = context.arguments[2].get_real_buffer_out();
+			result_data[voice] = results[voice]->get_data();
+		}
+
+		// Every voice runs the same task graph so the SOS count and which SOSs are first-order always match
+		size_t sos_count = iir_sos_contexts[0]->states.get_count();
+		for (size_t sos_index = 0; sos_index < sos_count; sos_index++) {
+			bool is_first_order = iir_sos_contexts[0]->is_first_order[sos_index];
+			size_t coefficients_start_index = sos_index * 5;
+
+			s_static_array<c_reentrant_iir_sos, k_max_voices> filters;
+			s_static_array<s_iir_sos_state *, k_max_voices> states;
+			for (size_t voice = 0; voice < voice_count; voice++) {
+				wl_assert(iir_sos_contexts[voice]->states.get_count() == sos_count);
+				wl_assert(iir_sos_contexts[voice]->is_first_order[sos_index] == is_first_order);
+				c_real_buffer_array_in voice_coefficients = coefficients[voice];
+				if (is_first_order) {
+					filters[voice].initialize_first_order(
+						voice_coefficients[coefficients_start_index],
+						voice_coefficients[coefficients_start_index + 1],
+						voice_coefficients[coefficients_start_index + 3]);
+				} else {
+					filters[voice].initialize(
+						voice_coefficients[coefficients_start_index],
+						voice_coefficients[coefficients_start_index + 1],
+						voice_coefficients[coefficients_start_index + 2],
+						voice_coefficients[coefficients_start_index + 3],
+						voice_coefficients[coefficients_start_index + 4]);
+				}
+
+				states[voice] = &iir_sos_contexts[voice]->states[sos_index];
+			}
+
+			c_reentrant_iir_sos::process_voices(
+				c_wrapped_array<c_reentrant_iir_sos>(filters.get_elements(), voice_count),
+				c_wrapped_array<s_iir_sos_state *const>(states.get_elements(), voice_count),
+				c_wrapped_array<const c_real_buffer *const>(signals.get_elements(), voice_count),
+				c_wrapped_array<real32 *const>(result_data.get_elements(), voice_count),
+				contexts[0].buffer_size);
+
+			for (size_t voice = 0; voice < voice_count; voice++) {
+				results[voice]->set_is_constant(false);
+			}
+		}
+	}
+
+	void iir_sos_batched(c_task_function_context_array contexts) {
+		// The recursion of a single voice can't be vectorized, so instead we step several voices together. Only
+		// neighboring voices with the same buffer size are grouped. A voice which started partway through the chunk
+		// has a shorter buffer and is processed on its own.
+		size_t context_index = 0;
+		while (context_index < contexts.get_count()) {
+			uint32 buffer_size = contexts[context_index].buffer_size;
+			size_t voice_count = 1;
+			while (voice_count < c_reentrant_iir_sos::k_max_voices
+				&& context_index + voice_count < contexts.get_count()
+				&& contexts[context_index + voice_count].buffer_size == buffer_size) {
+				voice_count++;
+			}
+
+			if (voice_count == 1) {
+				task_function_binding::task_function_call_wrapper<iir_sos, void>(contexts[context_index]);
+			} else {
+				iir_sos_multiple_voices(
+					c_task_function_context_array(contexts.get_pointer() + context_index, voice_count));
+			}
+
+			context_index += voice_count;
+		}
+	}
+
 	s_task_memory_query_result allpass_memory_query(
 		wl_task_argument(c_real_constant_array, delays)) {
 		s_task_memory_query_result result;
@@ -707,7 +795,8 @@ namespace filter_task_functions {
 			.set_function<iir_sos>()
 			.set_memory_query<iir_sos_memory_query>()
 			.set_voice_initializer<iir_sos_voice_initializer>()
-			.set_voice_activator<iir_sos_voice_activator>();
+			.set_voice_activator<iir_sos_voice_activator>()
+			.set_batched_function<iir_sos_batched>();
 
 		wl_task_function(0x24a5a6e8, "allpass")
 			.set_function<allpass>()
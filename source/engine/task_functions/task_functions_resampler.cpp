@@ -6,6 +6,8 @@
 
 #include "instrument/native_modules/resampler/resampler.h"
 
+#include <algorithm>
+
 static constexpr real32 k_quality_low = 0.0f;
 static constexpr real32 k_quality_high = 1.0f;
 
@@ -24,291 +26,332 @@ struct s_resampler_library_context {
 	uint8 downsample2x_bool_mapping[256 * 2];
 	uint8 downsample3x_bool_mapping[256 * 3];
 	uint8 downsample4x_bool_mapping[256 * 4];
+
+	// Real resampling kernels for each resampler stage, indexed by filter and stage resample factor. Downsample filters
+	// are specific to a single resample factor so only one of their entries is initialized.
+	static constexpr uint32 k_min_resample_factor = 2;
+	static constexpr uint32 k_max_resample_factor = k_max_single_stage_resample_factor;
+	c_resampler_block_kernel real_kernels
+		[enum_count<e_resampler_filter>()][k_max_resample_factor - k_min_resample_factor + 1];
+
+	c_resampler_block_kernel &get_real_kernel(e_resampler_filter resampler_filter, uint32 resample_factor) {
+		wl_assert(resample_factor >= k_min_resample_factor && resample_factor <= k_max_resample_factor);
+		return real_kernels[enum_index(resampler_filter)][resample_factor - k_min_resample_factor];
+	}
+
+	const c_resampler_block_kernel &get_real_kernel(e_resampler_filter resampler_filter, uint32 resample_factor) const {
+		wl_assert(resample_factor >= k_min_resample_factor && resample_factor <= k_max_resample_factor);
+		return real_kernels[enum_index(resampler_filter)][resample_factor - k_min_resample_factor];
+	}
 };
 
-class c_resample_real {
+// A single polyphase filtering stage with its own history. Counts are in terms of kernel outputs: input samples when
+// upsampling and output samples when downsampling.
+class c_resample_real_stage {
 public:
-	c_resample_real() = default;
+	c_resample_real_stage() = default;
 
 	static void calculate_memory(
+		const s_resampler_stage &stage,
 		bool is_upsampling,
-		uint32 resample_factor,
-		e_resampler_filter resampler_filter,
+		size_t delay,
 		c_stack_allocator::c_memory_calculator &memory_calculator) {
-		const s_resampler_parameters &resampler_parameters = get_resampler_parameters(resampler_filter);
-		size_t delay = calculate_delay(is_upsampling, resample_factor, resampler_parameters);
-
-		size_t history_extension = c_resampler::get_required_history_samples(resampler_parameters);
-		size_t history_length = delay + resampler_parameters.taps_per_phase;
-		size_t extended_history_buffer_size = history_extension + history_length;
-		memory_calculator.add_array<real32>(extended_history_buffer_size);
+		const s_resampler_parameters &resampler_parameters = get_resampler_parameters(stage.resampler_filter);
+		uint32 sample_stride = is_upsampling ? 1 : stage.resample_factor;
+		size_t history_sample_count = calculate_history_sample_count(resampler_parameters, sample_stride, delay);
+		memory_calculator.add_array<real32>(calculate_history_buffer_size(history_sample_count, sample_stride));
 	}
 
 	void initialize(
+		const s_resampler_stage &stage,
 		bool is_upsampling,
-		uint32 resample_factor,
-		e_resampler_filter resampler_filter,
+		size_t delay,
+		const c_resampler_block_kernel *kernel,
 		c_stack_allocator &allocator) {
-		m_is_upsampling = is_upsampling;
-		m_resample_factor = resample_factor;
-		m_resampler_filter = resampler_filter;
-
-		const s_resampler_parameters &resampler_parameters = get_resampler_parameters(resampler_filter);
-		m_delay = calculate_delay(is_upsampling, resample_factor, resampler_parameters);
+		m_resample_factor = stage.resample_factor;
+		m_kernel = kernel;
+		wl_assert(kernel->get_phase_count() == (is_upsampling ? stage.resample_factor : 1));
+		wl_assert(kernel->get_sample_stride() == (is_upsampling ? 1 : stage.resample_factor));
 
-		m_history_extension = c_resampler::get_required_history_samples(resampler_parameters);
-		m_history_length = m_delay + resampler_parameters.taps_per_phase;
-		size_t extended_history_buffer_size = m_history_extension + m_history_length;
-		allocator.allocate_array(m_history_buffer, extended_history_buffer_size);
-
-		if (is_upsampling) {
-			wl_assert(resample_factor <= k_max_upsample_factor);
-			for (uint32 i = 0; i < resample_factor; i++) {
-				m_upsample_fractions[i] = static_cast<real32>(i) / static_cast<real32>(resample_factor);
-			}
-		}
+		const s_resampler_parameters &resampler_parameters = get_resampler_parameters(stage.resampler_filter);
+		m_history_sample_count =
+			calculate_history_sample_count(resampler_parameters, kernel->get_sample_stride(), delay);
+		allocator.allocate_array(
+			m_history_buffer,
+			calculate_history_buffer_size(m_history_sample_count, kernel->get_sample_stride()));
 	}
 
 	void reset() {
-		m_write_index = m_delay;
-		m_read_index = 0;
+		// The history is treated as settled to zero rather than being cleared. It only gets written once the stage
+		// becomes unsettled so voice activation cost doesn't depend on the history length.
 		m_constant_value = 0.0f;
-		m_constant_count = m_history_buffer.get_count();
+		m_constant_count = m_history_sample_count;
+	}
 
-		// $PERF unfortunately I can't think of a way to amortize this cost, which we must pay on every voice activation
-		zero_type(m_history_buffer.get_pointer(), m_history_buffer.get_count());
+	uint32 get_resample_factor() const {
+		return m_resample_factor;
 	}
 
-	void process_upsample(const c_real_buffer *input, c_real_buffer *output, size_t input_sample_count) {
-		wl_assert(m_is_upsampling);
+	// Returns true if the entire history holds the given constant, in which case the output is that constant
+	bool is_settled(real32 value) const {
+		return value == m_constant_value && m_constant_count >= m_history_sample_count;
+	}
 
-		if (input->is_constant()) {
-			real32 input_value = input->get_constant();
-			if (input_value == m_constant_value && m_constant_count >= m_history_length) {
-				output->assign_constant(input_value);
-				return;
-			}
+	void process(const real32 *input_data, size_t count, real32 *output_data) {
+		fill_settled_history();
 
-			c_resampler resampler(
-				get_resampler_parameters(m_resampler_filter),
-				get_resampler_phases(m_resampler_filter));
-			real32 *output_data = output->get_data();
-			size_t output_sample_index = 0;
-			for (size_t sample_index = 0; sample_index < input_sample_count; sample_index++) {
-				size_t offset_write_index = m_history_extension + m_write_index;
-				m_history_buffer[offset_write_index] = input_value;
-
-				// Duplicate the sample if necessary
-				if (m_write_index + m_history_extension >= m_history_length) {
-					m_history_buffer[offset_write_index - m_history_length] = input_value;
-				}
+		uint32 phase_count = m_kernel->get_phase_count();
+		uint32 sample_stride = m_kernel->get_sample_stride();
+		real32 *block_samples = &m_history_buffer[m_history_sample_count];
+		for (size_t block_start = 0; block_start < count; block_start += k_block_size) {
+			size_t block_count = std::min(k_block_size, count - block_start);
+			size_t block_sample_count = block_count * sample_stride;
+			copy_type(block_samples, input_data + block_start * sample_stride, block_sample_count);
 
-				for (uint32 i = 0; i < m_resample_factor; i++) {
-					output_data[output_sample_index++] = resampler.resample(
-						m_history_buffer,
-						m_read_index + m_history_extension,
-						m_upsample_fractions[i]);
-				}
+			wl_assert(m_kernel->get_required_sample_count(block_count) <= m_history_buffer.get_count());
+			m_kernel->process(m_history_buffer.get_pointer(), block_count, output_data + block_start * phase_count);
+			advance_history(block_sample_count);
+		}
 
-				m_write_index++;
-				if (m_write_index == m_history_length) {
-					m_write_index = 0;
-				}
+		m_constant_count = 0;
+	}
 
-				m_read_index++;
-				if (m_read_index == m_history_length) {
-					m_read_index = 0;
-				}
-			}
+	// Returns true without writing any output if the stage has settled to the constant. Otherwise, fills the output.
+	bool process_constant(real32 input_value, size_t count, real32 *output_data) {
+		if (input_value != m_constant_value) {
+			fill_settled_history();
+			m_constant_value = input_value;
+			m_constant_count = 0;
+		}
 
-			output->set_is_constant(false);
+		if (m_constant_count >= m_history_sample_count) {
+			return true;
+		}
 
-			if (input_value != m_constant_value) {
-				m_constant_value = input_value;
-				m_constant_count = 0;
+		uint32 phase_count = m_kernel->get_phase_count();
+		uint32 sample_stride = m_kernel->get_sample_stride();
+		real32 *block_samples = &m_history_buffer[m_history_sample_count];
+		for (size_t block_start = 0; block_start < count; block_start += k_block_size) {
+			size_t block_count = std::min(k_block_size, count - block_start);
+			size_t block_sample_count = block_count * sample_stride;
+			std::fill(block_samples, block_samples + block_sample_count, input_value);
+
+			// Only the outputs whose taps reach back into the non-constant history need to run the filter. The
+			// rest are simply the constant scaled by each phase's gain.
+			size_t unsettled_sample_count =
+				m_history_sample_count - std::min(m_constant_count, m_history_sample_count);
+			size_t unsettled_count =
+				std::min(block_count, (unsettled_sample_count + sample_stride - 1) / sample_stride);
+			real32 *block_output_data = output_data + block_start * phase_count;
+			if (unsettled_count > 0) {
+				m_kernel->process(m_history_buffer.get_pointer(), unsettled_count, block_output_data);
 			}
 
-			m_constant_count += input_sample_count;
-		} else {
-			c_resampler resampler(
-				get_resampler_parameters(m_resampler_filter),
-				get_resampler_phases(m_resampler_filter));
-			const real32 *input_data = input->get_data();
-			real32 *output_data = output->get_data();
-			size_t output_sample_index = 0;
-			for (size_t sample_index = 0; sample_index < input_sample_count; sample_index++) {
-				real32 input_sample = input_data[sample_index];
-
-				size_t offset_write_index = m_history_extension + m_write_index;
-				m_history_buffer[offset_write_index] = input_sample;
-
-				// Duplicate the sample if necessary
-				if (m_write_index + m_history_extension >= m_history_length) {
-					m_history_buffer[offset_write_index - m_history_length] = input_sample;
-				}
-
-				for (uint32 i = 0; i < m_resample_factor; i++) {
-					output_data[output_sample_index++] = resampler.resample(
-						m_history_buffer,
-						m_read_index + m_history_extension,
-						m_upsample_fractions[i]);
+			for (size_t index = unsettled_count; index < block_count; index++) {
+				for (uint32 phase_index = 0; phase_index < phase_count; phase_index++) {
+					block_output_data[index * phase_count + phase_index] =
+						input_value * m_kernel->get_phase_gain(phase_index);
 				}
+			}
 
-				m_write_index++;
-				if (m_write_index == m_history_length) {
-					m_write_index = 0;
-				}
+			advance_history(block_sample_count);
+			m_constant_count += block_sample_count;
+		}
 
-				m_read_index++;
-				if (m_read_index == m_history_length) {
-					m_read_index = 0;
-				}
-			}
+		return false;
+	}
 
-			output->set_is_constant(false);
-			m_constant_count = 0;
+private:
+	// Inputs are processed in blocks which are appended to the history buffer
+	static constexpr size_t k_block_size = c_resampler_block_kernel::k_max_strided_output_count;
+
+	static size_t calculate_history_sample_count(
+		const s_resampler_parameters &resampler_parameters,
+		uint32 sample_stride,
+		size_t delay) {
+		// The delay is applied by keeping extra history so that each output's last tap lands delay samples earlier
+		return c_resampler_block_kernel::get_padded_taps_per_phase(resampler_parameters, sample_stride) - 1 + delay;
+	}
+
+	static size_t calculate_history_buffer_size(size_t history_sample_count, uint32 sample_stride) {
+		// The kernel computes outputs in SIMD-sized groups, so it may read a partial group past the end of the block
+		return history_sample_count + (k_block_size + k_simd_32_lanes) * sample_stride;
+	}
+
+	void fill_settled_history() {
+		// A settled history may not have been written since reset so its contents are stale. Before anything other
+		// than the settled constant is pushed, write out the constant that it represents.
+		if (m_constant_count >= m_history_sample_count) {
+			std::fill(
+				m_history_buffer.get_pointer(),
+				m_history_buffer.get_pointer() + m_history_sample_count,
+				m_constant_value);
 		}
 	}
 
-	void process_downsample(const c_real_buffer *input, c_real_buffer *output, size_t output_sample_count) {
-		wl_assert(!m_is_upsampling);
+	void advance_history(size_t sample_count) {
+		// Keep only the samples which later outputs will still read
+		copy_type_with_overlap(
+			m_history_buffer.get_pointer(),
+			&m_history_buffer[sample_count],
+			m_history_sample_count);
+	}
 
-		if (input->is_constant()) {
-			real32 input_value = input->get_constant();
-			if (input_value == m_constant_value && m_constant_count >= m_history_length) {
-				output->assign_constant(input_value);
-				return;
-			}
+	uint32 m_resample_factor = 0;						// Factor this stage resamples by
+	const c_resampler_block_kernel *m_kernel = nullptr;	// Shared kernel for this filter and resample factor
 
-			c_resampler resampler(
-				get_resampler_parameters(m_resampler_filter),
-				get_resampler_phases(m_resampler_filter));
-			real32 *output_data = output->get_data();
-			for (size_t sample_index = 0; sample_index < output_sample_count; sample_index++) {
-				for (size_t i = 0; i < m_resample_factor; i++) {
-					size_t offset_write_index = m_history_extension + m_write_index;
-					m_history_buffer[offset_write_index] = input_value;
-
-					// Duplicate the sample if necessary
-					if (m_write_index + m_history_extension >= m_history_length) {
-						m_history_buffer[offset_write_index - m_history_length] = input_value;
-					}
+	c_wrapped_array<real32> m_history_buffer;			// History samples followed by space for a block of input
+	size_t m_history_sample_count = 0;					// Number of history samples kept between blocks
 
-					if (i == 0) {
-						output_data[sample_index] = resampler.resample(
-							m_history_buffer,
-							m_read_index + m_history_extension,
-							0.0f);
-					}
+	real32 m_constant_value = 0.0f;						// The last constant pushed
+	size_t m_constant_count = 0;						// The number of sequential constant values in the history
+};
 
-					m_write_index++;
-					if (m_write_index == m_history_length) {
-						m_write_index = 0;
-					}
+// Resamples using one stage, or a cascade of 2x stages for resample factors above 4. Cascaded stages are run over
+// chunks of the buffer so that intermediate signals fit in a small amount of scratch memory.
+class c_resample_real {
+public:
+	c_resample_real() = default;
 
-					m_read_index++;
-					if (m_read_index == m_history_length) {
-						m_read_index = 0;
-					}
-				}
-			}
+	static void calculate_memory(
+		bool is_upsampling,
+		uint32 resample_factor,
+		real32 quality,
+		c_stack_allocator::c_memory_calculator &memory_calculator) {
+		s_resampler_latency latency = get_resampler_latency(is_upsampling, resample_factor, quality);
+		for (uint32 stage_index = 0; stage_index < get_resampler_stage_count(resample_factor); stage_index++) {
+			c_resample_real_stage::calculate_memory(
+				get_resampler_stage(is_upsampling, resample_factor, quality, stage_index),
+				is_upsampling,
+				stage_index == 0 ? latency.delay : 0,
+				memory_calculator);
+		}
+	}
+
+	static void calculate_scratch_memory(
+		uint32 resample_factor,
+		c_stack_allocator::c_memory_calculator &memory_calculator) {
+		if (get_resampler_stage_count(resample_factor) > 1) {
+			memory_calculator.add_array<real32>(k_max_intermediate_sample_count * 2);
+		}
+	}
 
-			output->set_is_constant(false);
+	void initialize(
+		const s_resampler_library_context *library_context,
+		bool is_upsampling,
+		uint32 resample_factor,
+		real32 quality,
+		c_stack_allocator &allocator) {
+		m_is_upsampling = is_upsampling;
+		m_resample_factor = resample_factor;
+		m_stage_count = get_resampler_stage_count(resample_factor);
+
+		// Any additional delay is applied to the first stage, which only happens when downsampling
+		s_resampler_latency latency = get_resampler_latency(is_upsampling, resample_factor, quality);
+		for (uint32 stage_index = 0; stage_index < m_stage_count; stage_index++) {
+			s_resampler_stage stage = get_resampler_stage(is_upsampling, resample_factor, quality, stage_index);
+			m_stages[stage_index].initialize(
+				stage,
+				is_upsampling,
+				stage_index == 0 ? latency.delay : 0,
+				&library_context->get_real_kernel(stage.resampler_filter, stage.resample_factor),
+				allocator);
+		}
+	}
 
-			if (input_value != m_constant_value) {
-				m_constant_value = input_value;
-				m_constant_count = 0;
-			}
+	void reset() {
+		for (uint32 stage_index = 0; stage_index < m_stage_count; stage_index++) {
+			m_stages[stage_index].reset();
+		}
+	}
 
-			m_constant_count += output_sample_count * m_resample_factor;
-		} else {
-			c_resampler resampler(
-				get_resampler_parameters(m_resampler_filter),
-				get_resampler_phases(m_resampler_filter));
-			const real32 *input_data = input->get_data();
-			real32 *output_data = output->get_data();
-			for (size_t sample_index = 0; sample_index < output_sample_count; sample_index++) {
-				for (size_t i = 0; i < m_resample_factor; i++) {
-					real32 input_sample = input_data[sample_index * m_resample_factor + i];
-
-					size_t offset_write_index = m_history_extension + m_write_index;
-					m_history_buffer[offset_write_index] = input_sample;
-
-					// Duplicate the sample if necessary
-					if (m_write_index + m_history_extension >= m_history_length) {
-						m_history_buffer[offset_write_index - m_history_length] = input_sample;
-					}
+	// The count is in terms of the downsampled sample rate: input samples when upsampling and output samples when
+	// downsampling
+	void process(
+		const c_real_buffer *input,
+		c_real_buffer *output,
+		size_t count,
+		c_wrapped_array<uint8> scratch_memory) {
+		if (input->is_constant()) {
+			real32 input_value = input->get_constant();
+			bool settled = true;
+			for (uint32 stage_index = 0; stage_index < m_stage_count && settled; stage_index++) {
+				settled = m_stages[stage_index].is_settled(input_value);
+			}
 
-					if (i == 0) {
-						output_data[sample_index] = resampler.resample(
-							m_history_buffer,
-							m_read_index + m_history_extension,
-							0.0f);
-					}
+			if (settled) {
+				output->assign_constant(input_value);
+				return;
+			}
+		}
 
-					m_write_index++;
-					if (m_write_index == m_history_length) {
-						m_write_index = 0;
-					}
+		real32 *intermediate_buffers[2] = { nullptr, nullptr };
+		size_t chunk_size = count;
+		if (m_stage_count > 1) {
+			c_stack_allocator scratch_allocator(scratch_memory);
+			c_wrapped_array<real32> intermediate_samples;
+			scratch_allocator.allocate_array(intermediate_samples, k_max_intermediate_sample_count * 2);
+			scratch_allocator.release_no_destructors();
+			intermediate_buffers[0] = &intermediate_samples[0];
+			intermediate_buffers[1] = &intermediate_samples[k_max_intermediate_sample_count];
+
+			// Intermediate signals are at most half of the upsampled sample rate
+			chunk_size = k_max_intermediate_sample_count / (m_resample_factor / 2);
+		}
 
-					m_read_index++;
-					if (m_read_index == m_history_length) {
-						m_read_index = 0;
+		const real32 *input_data = input->is_constant() ? nullptr : input->get_data();
+		real32 *output_data = output->get_data();
+		size_t input_stride = m_is_upsampling ? 1 : m_resample_factor;
+		size_t output_stride = m_is_upsampling ? m_resample_factor : 1;
+		for (size_t chunk_start = 0; chunk_start < count; chunk_start += chunk_size) {
+			size_t chunk_count = std::min(chunk_size, count - chunk_start);
+
+			// Run the chunk through each stage, keeping track of whether the signal is still constant
+			bool is_constant = input->is_constant();
+			real32 constant_value = is_constant ? input->get_constant() : 0.0f;
+			const real32 *stage_input_data = is_constant ? nullptr : input_data + chunk_start * input_stride;
+			size_t stage_input_rate = m_is_upsampling ? 1 : m_resample_factor;
+			for (uint32 stage_index = 0; stage_index < m_stage_count; stage_index++) {
+				c_resample_real_stage &stage = m_stages[stage_index];
+				bool is_last_stage = stage_index + 1 == m_stage_count;
+				real32 *stage_output_data = is_last_stage
+					? output_data + chunk_start * output_stride
+					: intermediate_buffers[stage_index % 2];
+
+				// Stage counts are in terms of the lower of the stage's two sample rates
+				size_t stage_output_rate = m_is_upsampling
+					? stage_input_rate * stage.get_resample_factor()
+					: stage_input_rate / stage.get_resample_factor();
+				size_t stage_count = chunk_count * std::min(stage_input_rate, stage_output_rate);
+
+				if (is_constant) {
+					if (!stage.process_constant(constant_value, stage_count, stage_output_data)) {
+						is_constant = false;
+						stage_input_data = stage_output_data;
+					} else if (is_last_stage) {
+						size_t output_count = chunk_count * output_stride;
+						std::fill(stage_output_data, stage_output_data + output_count, constant_value);
 					}
+				} else {
+					stage.process(stage_input_data, stage_count, stage_output_data);
+					stage_input_data = stage_output_data;
 				}
-			}
 
-			output->set_is_constant(false);
-			m_constant_count = 0;
+				stage_input_rate = stage_output_rate;
+			}
 		}
-	}
 
-private:
-	static size_t calculate_delay(
-		bool is_upsampling,
-		uint32 resample_factor,
-		const s_resampler_parameters &resampler_parameters) {
-		if (is_upsampling) {
-			// The latency is in terms of the downsampled sample rate so we don't need to add any additional delay
-			// to keep the downsampled and upsampled signals in sync
-			return 0;
-		} else {
-			// The latency is in terms of the downsampled sample rate. Since we're sampling from the upsampled signal,
-			// the reported resampler latency is in terms of the upsampled sample rate. To convert, we divide (rounding
-			// up) by the downsample factor. By rounding up, we may add up to downsample_factor - 1 additional samples
-			// of delay to the upsampled signal.
-			uint32 latency_rounded_up =
-				((resampler_parameters.latency + resample_factor - 1) / resample_factor) * resample_factor;
-			return latency_rounded_up - resampler_parameters.latency;
-		}
+		output->set_is_constant(false);
 	}
 
-	static size_t calculate_extended_history_buffer_size(
-		size_t delay,
-		const s_resampler_parameters &resampler_parameters) {
-		size_t required_history_samples = c_resampler::get_required_history_samples(resampler_parameters);
-
-		// We're using a circular buffer and duplicating samples so that the history buffer can read contiguous blocks.
-		// In order for this to work, we need to extend the buffer by required_history_samples - 1.
-		return delay + required_history_samples * 2 - 1;
-	}
+private:
+	// The maximum number of samples in an intermediate signal between two stages for each chunk
+	static constexpr size_t k_max_intermediate_sample_count = 512;
 
 	bool m_is_upsampling = false;				// True if we're upsampling, false if we're downsampling
-	uint32 m_resample_factor = 0;				// Factor to resample by
-	e_resampler_filter m_resampler_filter;		// The resampler filter being used
-	size_t m_delay = 0;							// Additional delay to add so that latency is stays aligned
-
-	static constexpr uint32 k_max_upsample_factor = 4;
-	real32 m_upsample_fractions[k_max_upsample_factor];
-
-	c_wrapped_array<real32> m_history_buffer;	// History buffer
-	size_t m_history_length = 0;				// "Logical" length of the history buffer (without duplication)
-	size_t m_history_extension = 0;				// Number of (duplicated) extended samples at the beginning
-	size_t m_write_index = 0;					// Index we're writing to (before offsetting by extension)
-	size_t m_read_index = 0;					// Index we're reading to (before offsetting by extension)
-
-	real32 m_constant_value = 0.0f;				// The last constant pushed
-	size_t m_constant_count = 0;				// The number of sequential constant values in the buffer
+	uint32 m_resample_factor = 0;				// Total factor to resample by
+	uint32 m_stage_count = 0;					// Number of cascaded stages
+	c_resample_real_stage m_stages[k_max_resampler_stage_count];
 };
 
 static s_task_memory_query_result resample_real_memory_query(
@@ -319,15 +362,16 @@ static s_task_memory_query_result resample_real_memory_query(
 
 	c_stack_allocator::c_memory_calculator memory_calculator;
 	memory_calculator.add<c_resample_real>();
-	c_resample_real::calculate_memory(
-		is_upsampling,
-		resample_factor,
-		get_resampler_filter_from_quality(is_upsampling, resample_factor, quality),
-		memory_calculator);
+	c_resample_real::calculate_memory(is_upsampling, resample_factor, quality, memory_calculator);
 
 	wl_assert(memory_calculator.get_destructor_count() == 0);
 	result.voice_size_alignment = memory_calculator.get_size_alignment();
 
+	c_stack_allocator::c_memory_calculator scratch_calculator;
+	c_resample_real::calculate_scratch_memory(resample_factor, scratch_calculator);
+	wl_assert(scratch_calculator.get_destructor_count() == 0);
+	result.scratch_size_alignment = scratch_calculator.get_size_alignment();
+
 	return result;
 }
 
@@ -341,14 +385,27 @@ static void resample_real_voice_initializer(
 	c_resample_real *resample_real;
 	allocator.allocate(resample_real);
 	resample_real->initialize(
+		static_cast<const s_resampler_library_context *>(context.library_context),
 		is_upsampling,
 		resample_factor,
-		get_resampler_filter_from_quality(is_upsampling, resample_factor, quality),
+		quality,
 		allocator);
 
 	allocator.release_no_destructors();
 }
 
+static void resample_real(
+	const s_task_function_context &context,
+	const c_real_buffer *input,
+	c_real_buffer *output) {
+	c_resample_real *resample_real = reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer());
+	resample_real->process(input, output, context.buffer_size, context.scratch_memory);
+}
+
+static void resample_real_voice_activator(const s_task_function_context &context) {
+	reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer())->reset();
+}
+
 static void compute_upsample_bool_mapping(uint32 upsample_factor, c_wrapped_array<uint32> mapping) {
 	wl_assert(upsample_factor >= 2 && upsample_factor <= 4);
 	wl_assert(mapping.get_count() == 256);
@@ -454,6 +511,33 @@ void downsample_bool(
 	}
 }
 
+static void initialize_real_kernel(
+	c_resampler_block_kernel &kernel,
+	bool is_upsampling,
+	const s_resampler_stage &stage) {
+	if (is_upsampling) {
+		// Each input sample produces one output at each fraction
+		real32 upsample_fractions[c_resampler_block_kernel::k_max_phase_count];
+		for (uint32 i = 0; i < stage.resample_factor; i++) {
+			upsample_fractions[i] = static_cast<real32>(i) / static_cast<real32>(stage.resample_factor);
+		}
+
+		kernel.initialize(
+			get_resampler_parameters(stage.resampler_filter),
+			get_resampler_phases(stage.resampler_filter),
+			c_wrapped_array<const real32>(upsample_fractions, stage.resample_factor),
+			1);
+	} else {
+		// Each output sample is aligned with every Nth input sample
+		static constexpr real32 k_downsample_fractions[] = { 0.0f };
+		kernel.initialize(
+			get_resampler_parameters(stage.resampler_filter),
+			get_resampler_phases(stage.resampler_filter),
+			c_wrapped_array<const real32>::construct(k_downsample_fractions),
+			stage.resample_factor);
+	}
+}
+
 namespace resampler_task_functions {
 
 	void *engine_initializer() {
@@ -467,6 +551,32 @@ namespace resampler_task_functions {
 		compute_downsample_bool_mapping(3, c_wrapped_array<uint8>::construct(context->downsample3x_bool_mapping));
 		compute_downsample_bool_mapping(4, c_wrapped_array<uint8>::construct(context->downsample4x_bool_mapping));
 
+		// Build a kernel for each stage of each real resampler task function and quality. Stages are shared between
+		// resample factors, e.g. the base stage of 8x upsampling uses the same kernel as 2x upsampling.
+		static constexpr real32 k_qualities[] = { k_quality_low, k_quality_high };
+		static constexpr bool k_is_upsampling_values[] = { true, false };
+		for (uint32 resample_factor = 2; resample_factor <= 16; resample_factor++) {
+			if (!is_valid_resample_factor(resample_factor)) {
+				continue;
+			}
+
+			uint32 stage_count = get_resampler_stage_count(resample_factor);
+			for (bool is_upsampling : k_is_upsampling_values) {
+				for (real32 quality : k_qualities) {
+					for (uint32 stage_index = 0; stage_index < stage_count; stage_index++) {
+						s_resampler_stage stage =
+							get_resampler_stage(is_upsampling, resample_factor, quality, stage_index);
+						c_resampler_block_kernel &kernel = context->get_real_kernel(
+							stage.resampler_filter,
+							stage.resample_factor);
+						if (kernel.get_phase_count() == 0) {
+							initialize_real_kernel(kernel, is_upsampling, stage);
+						}
+					}
+				}
+			}
+		}
+
 		return context;
 	}
 
@@ -479,8 +589,7 @@ namespace resampler_task_functions {
 		wl_task_argument(const c_real_buffer *, signal),
 		wl_task_argument(real32, quality),
 		wl_task_argument_upsampled(c_real_buffer *, 2, upsampled_signal)) {
-		c_resample_real *resample_real = reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer());
-		resample_real->process_upsample(signal, upsampled_signal, context.buffer_size);
+		resample_real(context, signal, upsampled_signal);
 	}
 
 	s_task_memory_query_result upsample2x_real_memory_query(
@@ -495,7 +604,7 @@ namespace resampler_task_functions {
 	}
 
 	void upsample2x_real_voice_activator(const s_task_function_context &context) {
-		reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer())->reset();
+		resample_real_voice_activator(context);
 	}
 
 	void upsample3x_real(
@@ -503,8 +612,7 @@ namespace resampler_task_functions {
 		wl_task_argument(const c_real_buffer *, signal),
 		wl_task_argument(real32, quality),
 		wl_task_argument_upsampled(c_real_buffer *, 3, upsampled_signal)) {
-		c_resample_real *resample_real = reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer());
-		resample_real->process_upsample(signal, upsampled_signal, context.buffer_size);
+		resample_real(context, signal, upsampled_signal);
 	}
 
 	s_task_memory_query_result upsample3x_real_memory_query(
@@ -519,7 +627,7 @@ namespace resampler_task_functions {
 	}
 
 	void upsample3x_real_voice_activator(const s_task_function_context &context) {
-		reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer())->reset();
+		resample_real_voice_activator(context);
 	}
 
 	void upsample4x_real(
@@ -527,8 +635,7 @@ namespace resampler_task_functions {
 		wl_task_argument(const c_real_buffer *, signal),
 		wl_task_argument(real32, quality),
 		wl_task_argument_upsampled(c_real_buffer *, 4, upsampled_signal)) {
-		c_resample_real *resample_real = reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer());
-		resample_real->process_upsample(signal, upsampled_signal, context.buffer_size);
+		resample_real(context, signal, upsampled_signal);
 	}
 
 	s_task_memory_query_result upsample4x_real_memory_query(
@@ -543,7 +650,53 @@ namespace resampler_task_functions {
 	}
 
 	void upsample4x_real_voice_activator(const s_task_function_context &context) {
-		reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer())->reset();
+		resample_real_voice_activator(context);
+	}
+
+	void upsample8x_real(
+		const s_task_function_context &context,
+		wl_task_argument(const c_real_buffer *, signal),
+		wl_task_argument(real32, quality),
+		wl_task_argument_upsampled(c_real_buffer *, 8, upsampled_signal)) {
+		resample_real(context, signal, upsampled_signal);
+	}
+
+	s_task_memory_query_result upsample8x_real_memory_query(
+		wl_task_argument(real32, quality)) {
+		return resample_real_memory_query(true, 8, *quality);
+	}
+
+	void upsample8x_real_voice_initializer(
+		const s_task_function_context &context,
+		wl_task_argument(real32, quality)) {
+		resample_real_voice_initializer(context, true, 8, *quality);
+	}
+
+	void upsample8x_real_voice_activator(const s_task_function_context &context) {
+		resample_real_voice_activator(context);
+	}
+
+	void upsample16x_real(
+		const s_task_function_context &context,
+		wl_task_argument(const c_real_buffer *, signal),
+		wl_task_argument(real32, quality),
+		wl_task_argument_upsampled(c_real_buffer *, 16, upsampled_signal)) {
+		resample_real(context, signal, upsampled_signal);
+	}
+
+	s_task_memory_query_result upsample16x_real_memory_query(
+		wl_task_argument(real32, quality)) {
+		return resample_real_memory_query(true, 16, *quality);
+	}
+
+	void upsample16x_real_voice_initializer(
+		const s_task_function_context &context,
+		wl_task_argument(real32, quality)) {
+		resample_real_voice_initializer(context, true, 16, *quality);
+	}
+
+	void upsample16x_real_voice_activator(const s_task_function_context &context) {
+		resample_real_voice_activator(context);
 	}
 
 	void downsample2x_real(
@@ -551,8 +704,7 @@ namespace resampler_task_functions {
 		wl_task_argument_upsampled(const c_real_buffer *, 2, signal),
 		wl_task_argument(real32, quality),
 		wl_task_argument(c_real_buffer *, downsampled_signal)) {
-		c_resample_real *resample_real = reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer());
-		resample_real->process_downsample(signal, downsampled_signal, context.buffer_size);
+		resample_real(context, signal, downsampled_signal);
 	}
 
 	s_task_memory_query_result downsample2x_real_memory_query(
@@ -567,7 +719,7 @@ namespace resampler_task_functions {
 	}
 
 	void downsample2x_real_voice_activator(const s_task_function_context &context) {
-		reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer())->reset();
+		resample_real_voice_activator(context);
 	}
 
 	void downsample3x_real(
@@ -575,8 +727,7 @@ namespace resampler_task_functions {
 		wl_task_argument_upsampled(const c_real_buffer *, 3, signal),
 		wl_task_argument(real32, quality),
 		wl_task_argument(c_real_buffer *, downsampled_signal)) {
-		c_resample_real *resample_real = reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer());
-		resample_real->process_downsample(signal, downsampled_signal, context.buffer_size);
+		resample_real(context, signal, downsampled_signal);
 	}
 
 	s_task_memory_query_result downsample3x_real_memory_query(
@@ -591,7 +742,7 @@ namespace resampler_task_functions {
 	}
 
 	void downsample3x_real_voice_activator(const s_task_function_context &context) {
-		reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer())->reset();
+		resample_real_voice_activator(context);
 	}
 
 	void downsample4x_real(
@@ -599,8 +750,7 @@ namespace resampler_task_functions {
 		wl_task_argument_upsampled(const c_real_buffer *, 4, signal),
 		wl_task_argument(real32, quality),
 		wl_task_argument(c_real_buffer *, downsampled_signal)) {
-		c_resample_real *resample_real = reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer());
-		resample_real->process_downsample(signal, downsampled_signal, context.buffer_size);
+		resample_real(context, signal, downsampled_signal);
 	}
 
 	s_task_memory_query_result downsample4x_real_memory_query(
@@ -615,7 +765,53 @@ namespace resampler_task_functions {
 	}
 
 	void downsample4x_real_voice_activator(const s_task_function_context &context) {
-		reinterpret_cast<c_resample_real *>(context.voice_memory.get_pointer())->reset();
+		resample_real_voice_activator(context);
+	}
+
+	void downsample8x_real(
+		const s_task_function_context &context,
+		wl_task_argument_upsampled(const c_real_buffer *, 8, signal),
+		wl_task_argument(real32, quality),
+		wl_task_argument(c_real_buffer *, downsampled_signal)) {
+		resample_real(context, signal, downsampled_signal);
+	}
+
+	s_task_memory_query_result downsample8x_real_memory_query(
+		wl_task_argument(real32, quality)) {
+		return resample_real_memory_query(false, 8, *quality);
+	}
+
+	void downsample8x_real_voice_initializer(
+		const s_task_function_context &context,
+		wl_task_argument(real32, quality)) {
+		resample_real_voice_initializer(context, false, 8, *quality);
+	}
+
+	void downsample8x_real_voice_activator(const s_task_function_context &context) {
+		resample_real_voice_activator(context);
+	}
+
+	void downsample16x_real(
+		const s_task_function_context &context,
+		wl_task_argument_upsampled(const c_real_buffer *, 16, signal),
+		wl_task_argument(real32, quality),
+		wl_task_argument(c_real_buffer *, downsampled_signal)) {
+		resample_real(context, signal, downsampled_signal);
+	}
+
+	s_task_memory_query_result downsample16x_real_memory_query(
+		wl_task_argument(real32, quality)) {
+		return resample_real_memory_query(false, 16, *quality);
+	}
+
+	void downsample16x_real_voice_initializer(
+		const s_task_function_context &context,
+		wl_task_argument(real32, quality)) {
+		resample_real_voice_initializer(context, false, 16, *quality);
+	}
+
+	void downsample16x_real_voice_activator(const s_task_function_context &context) {
+		resample_real_voice_activator(context);
 	}
 
 	void upsample2x_bool(
@@ -744,6 +940,18 @@ namespace resampler_task_functions {
 			.set_voice_initializer<upsample4x_real_voice_initializer>()
 			.set_voice_activator<upsample4x_real_voice_activator>();
 
+		wl_task_function(0x96a5b60a, "upsample8x$real")
+			.set_function<upsample8x_real>()
+			.set_memory_query<upsample8x_real_memory_query>()
+			.set_voice_initializer<upsample8x_real_voice_initializer>()
+			.set_voice_activator<upsample8x_real_voice_activator>();
+
+		wl_task_function(0x2df9072d, "upsample16x$real")
+			.set_function<upsample16x_real>()
+			.set_memory_query<upsample16x_real_memory_query>()
+			.set_voice_initializer<upsample16x_real_voice_initializer>()
+			.set_voice_activator<upsample16x_real_voice_activator>();
+
 		wl_task_function(0x1cc763e8, "downsample2x$real")
 			.set_function<downsample2x_real>()
 			.set_memory_query<downsample2x_real_memory_query>()
@@ -762,6 +970,18 @@ namespace resampler_task_functions {
 			.set_voice_initializer<downsample4x_real_voice_initializer>()
 			.set_voice_activator<downsample4x_real_voice_activator>();
 
+		wl_task_function(0x417efecd, "downsample8x$real")
+			.set_function<downsample8x_real>()
+			.set_memory_query<downsample8x_real_memory_query>()
+			.set_voice_initializer<downsample8x_real_voice_initializer>()
+			.set_voice_activator<downsample8x_real_voice_activator>();
+
+		wl_task_function(0xf3ca45e9, "downsample16x$real")
+			.set_function<downsample16x_real>()
+			.set_memory_query<downsample16x_real_memory_query>()
+			.set_voice_initializer<downsample16x_real_voice_initializer>()
+			.set_voice_activator<downsample16x_real_voice_activator>();
+
 		wl_task_function(0x6751d67f, "upsample2x$bool")
 			.set_function<upsample2x_bool>();
 
@@ -1,11 +1,12 @@
 #include "engine/buffer.h"
-#include "engine/buffer_operations/buffer_iterator.h"
 #include "engine/task_function_registration.h"
 #include "engine/task_functions/sampler/fetch_sample.h"
 #include "engine/task_functions/sampler/sample.h"
 #include "engine/task_functions/sampler/sample_library.h"
 #include "engine/task_functions/sampler/sampler_context.h"
 
+#include <algorithm>
+
 class c_event_interface;
 
 // $TODO add initial_delay parameter
@@ -17,8 +18,11 @@ static void get_sample_time_data(
 	real64 &loop_start_sample_out,
 	real64 &loop_end_sample_out);
 
+// Compact samples store raw frames instead of interpolation coefficients
+static e_sample_storage_format get_compact_storage_format(bool int16_frames);
+
 static void run_sampler(
-	const c_sample_library *sample_library,
+	c_sample_library *sample_library,
 	const s_task_function_context &context,
 	const char *name,
 	const c_real_buffer *speed,
@@ -27,13 +31,21 @@ static void run_sampler(
 		reinterpret_cast<s_sampler_voice_context *>(context.voice_memory.get_pointer());
 	const c_sample *sample =
 		sampler_context->get_sample_or_fail_gracefully(sample_library, result, context.event_interface, name);
-	if (!sample || sampler_context->handle_reached_end(result)) {
+	if (!sample) {
+		return;
+	}
+
+	sampler_context->update_stream(sample_library, sample);
+	if (sampler_context->handle_reached_end(result)) {
 		return;
 	}
 
 	wl_assert(!sample->is_looping());
 	wl_assert(!sample->is_wavetable());
 
+	bool is_streamed = sample->is_streamed();
+	const c_sample_streamer *sample_streamer = sample_library->get_sample_streamer();
+
 	real64 length_samples, loop_start_sample, loop_end_sample;
 	get_sample_time_data(sample, length_samples, loop_start_sample, loop_end_sample);
 
@@ -41,46 +53,58 @@ static void run_sampler(
 	real32 base_sample_rate = static_cast<real32>(sample->get_sample_rate());
 	real32 advance_multiplier = base_sample_rate / stream_sample_rate;
 
-	bool is_result_constant = speed->is_constant() && speed->get_constant() == 0.0f;
-	size_t samples_written = 0;
+	if (speed->is_constant() && speed->get_constant() == 0.0f) {
+		// The sample doesn't advance so the result is constant
+		real64 sample_index = sampler_context->increment_time(loop_end_sample, 0.0f);
+		result->assign_constant(
+			is_streamed
+				? fetch_streamed_sample(sample, sample_streamer, sampler_context->stream_handle, sample_index)
+				: fetch_sample(sample, sample_index));
+		return;
+	}
 
-	// Could SIMD-optimize, but the buffer advance logic is a bit tricky
-	iterate_buffers<1, false>(context.buffer_size, speed, result,
-		[&](size_t i, real32 speed_value, real32 &result_value) {
+	real32 *result_data = result->get_data();
+	size_t samples_written = 0;
+	while (samples_written < context.buffer_size && !sampler_context->reached_end) {
+		size_t block_size = std::min(context.buffer_size - samples_written, k_fetch_sample_block_size);
+
+		// Advancing time is serial, so compute the block's sample indices up front and then fetch them all at once
+		real64 sample_indices[k_fetch_sample_block_size];
+		size_t block_sample_count = 0;
+		while (block_sample_count < block_size && !sampler_context->reached_end) {
+			real32 speed_value = speed->is_constant()
+				? speed->get_constant()
+				: speed->get_data()[samples_written + block_sample_count];
 			speed_value = sanitize_inf_nan(speed_value);
 			real32 advance = speed_value * advance_multiplier;
-			real64 sample_index = sampler_context->increment_time(loop_end_sample, advance);
-			result_value = fetch_sample(sample, sample_index);
-
-			samples_written++;
-			return !is_result_constant && !sampler_context->reached_end;
-		});
-
-	if (is_result_constant) {
-		if (samples_written == 0) {
-			// We reached the end without writing any samples
-			result->assign_constant(0.0f);
-		} else {
-			result->extend_constant();
+			sample_indices[block_sample_count] = sampler_context->increment_time(loop_end_sample, advance);
+			block_sample_count++;
 		}
-	} else {
-		size_t samples_remaining = context.buffer_size - samples_written;
-
-		// If the sample ended before the end of the buffer, fill the rest with 0
-		zero_type(result->get_data(), samples_remaining);
 
-		// If samples_written is 0, the buffer is filled with 0
-		if (samples_written == 0) {
-			result->assign_constant(0.0f); // Make sure we set a full SIMD block of samples to 0
+		real32 *block_result_data = result_data + samples_written;
+		if (is_streamed) {
+			for (size_t index = 0; index < block_sample_count; index++) {
+				block_result_data[index] = fetch_streamed_sample(
+					sample,
+					sample_streamer,
+					sampler_context->stream_handle,
+					sample_indices[index]);
+			}
 		} else {
-			result->set_is_constant(false);
+			fetch_samples(sample, sample_indices, block_sample_count, block_result_data);
 		}
+
+		samples_written += block_sample_count;
 	}
+
+	// If the sample ended before the end of the buffer, fill the rest with 0
+	zero_type(result_data + samples_written, context.buffer_size - samples_written);
+	result->set_is_constant(false);
 }
 
 template<bool k_is_wavetable>
 static void run_sampler_loop(
-	const c_sample_library *sample_library,
+	c_sample_library *sample_library,
 	const s_task_function_context &context,
 	const char *name,
 	const c_real_buffer *speed,
@@ -98,6 +122,9 @@ static void run_sampler_loop(
 	wl_assert(!sampler_context->reached_end);
 	wl_assert(k_is_wavetable == sample->is_wavetable());
 
+	// Looping samples are never streamed
+	wl_assert(!sample->is_streamed());
+
 	real64 length_samples, loop_start_sample, loop_end_sample;
 	get_sample_time_data(sample, length_samples, loop_start_sample, loop_end_sample);
 	real64 phase_to_sample_offset_multiplier = loop_end_sample - loop_start_sample;
@@ -106,14 +133,31 @@ static void run_sampler_loop(
 	real32 base_sample_rate = static_cast<real32>(sample->get_sample_rate());
 	real32 advance_multiplier = base_sample_rate / stream_sample_rate;
 
-	bool is_result_constant = speed->is_constant() && speed->get_constant() == 0.0f && phase->is_constant();
+	if (speed->is_constant() && speed->get_constant() == 0.0f && phase->is_constant()) {
+		// The sample doesn't advance and the phase doesn't change so the result is constant
+		real64 sample_index = sampler_context->increment_time_looping(loop_start_sample, loop_end_sample, 0.0f);
+		real32 phase_value = sanitize_inf_nan(phase->get_constant());
+		sample_index += clamp(phase_value, 0.0f, 1.0f) * phase_to_sample_offset_multiplier;
+		if constexpr (k_is_wavetable) {
+			result->assign_constant(
+				fetch_wavetable_sample(sample, stream_sample_rate, base_sample_rate, 0.0f, sample_index));
+		} else {
+			result->assign_constant(fetch_sample(sample, sample_index));
+		}
 
-	size_t samples_written = 0;
-	size_t buffer_samples_remaining = context.buffer_size;
+		return;
+	}
 
-	// Could SIMD-optimize, but the buffer advance logic is a bit tricky
-	iterate_buffers<1, false>(context.buffer_size, speed, phase, result,
-		[&](size_t i, real32 speed_value, real32 phase_value, real32 &result_value) {
+	real32 *result_data = result->get_data();
+	for (size_t block_start = 0; block_start < context.buffer_size; block_start += k_fetch_sample_block_size) {
+		size_t block_size = std::min(context.buffer_size - block_start, k_fetch_sample_block_size);
+
+		// Advancing time is serial, so compute the block's sample indices up front and then fetch them all at once.
+		// Loop wraps are handled here so fetching doesn't need to know about them.
+		real64 sample_indices[k_fetch_sample_block_size];
+		for (size_t index = 0; index < block_size; index++) {
+			real32 speed_value = speed->is_constant() ? speed->get_constant() : speed->get_data()[block_start + index];
+			real32 phase_value = phase->is_constant() ? phase->get_constant() : phase->get_data()[block_start + index];
 			speed_value = sanitize_inf_nan(speed_value);
 			phase_value = sanitize_inf_nan(phase_value);
 			real32 advance = speed_value * advance_multiplier;
@@ -121,30 +165,38 @@ static void run_sampler_loop(
 
 			real32 clamped_phase = clamp(phase_value, 0.0f, 1.0f);
 			real64 sample_offset = clamped_phase * phase_to_sample_offset_multiplier;
-			sample_index += sample_offset;
+			sample_indices[index] = sample_index + sample_offset;
+		}
 
-			if constexpr (k_is_wavetable) {
-				result_value = fetch_wavetable_sample(
+		real32 *block_result_data = result_data + block_start;
+		if constexpr (k_is_wavetable) {
+			if (speed->is_constant()) {
+				fetch_wavetable_samples(
 					sample,
 					stream_sample_rate,
 					base_sample_rate,
-					speed_value,
-					sample_index);
+					sanitize_inf_nan(speed->get_constant()),
+					sample_indices,
+					block_size,
+					block_result_data);
 			} else {
-				result_value = fetch_sample(sample, sample_index);
+				// The wavetable levels depend on the speed so each sample must be fetched individually
+				const real32 *speed_data = speed->get_data() + block_start;
+				for (size_t index = 0; index < block_size; index++) {
+					block_result_data[index] = fetch_wavetable_sample(
+						sample,
+						stream_sample_rate,
+						base_sample_rate,
+						sanitize_inf_nan(speed_data[index]),
+						sample_indices[index]);
+				}
 			}
-
-			samples_written++;
-			return !is_result_constant;
-		});
-
-	wl_assert(samples_written > 0);
-	if (is_result_constant) {
-		result->extend_constant();
-	} else {
-		wl_assert(samples_written == context.buffer_size);
-		result->set_is_constant(false);
+		} else {
+			fetch_samples(sample, sample_indices, block_size, block_result_data);
+		}
 	}
+
+	result->set_is_constant(false);
 }
 
 static void get_sample_time_data(
@@ -152,16 +204,20 @@ static void get_sample_time_data(
 	real64 &length_samples_out,
 	real64 &loop_start_sample_out,
 	real64 &loop_end_sample_out) {
-	length_samples_out = static_cast<real64>(sample->get_entry(0)->samples.get_count());
+	length_samples_out = static_cast<real64>(sample->get_sample_count());
 	loop_start_sample_out = static_cast<real64>(sample->get_loop_start());
 	loop_end_sample_out = static_cast<real64>(sample->get_loop_end());
 }
 
+static e_sample_storage_format get_compact_storage_format(bool int16_frames) {
+	return int16_frames ? e_sample_storage_format::k_int16 : e_sample_storage_format::k_real32;
+}
+
 namespace sampler_task_functions {
 
 	void *sampler_library_engine_initializer() {
 		c_sample_library *sample_library = new c_sample_library();
-		sample_library->initialize("./");
+		sample_library->initialize("./", true);
 		return sample_library;
 	}
 
@@ -200,6 +256,7 @@ namespace sampler_task_functions {
 			name,
 			e_sample_loop_mode::k_none,
 			false,
+			e_sample_storage_format::k_interpolation_coefficients,
 			channel);
 	}
 
@@ -212,9 +269,10 @@ namespace sampler_task_functions {
 	}
 
 	void sampler_voice_activator(const s_task_function_context &context) {
+		c_sample_library *sample_library = static_cast<c_sample_library *>(context.library_context);
 		s_sampler_voice_context *sampler_voice_context =
 			reinterpret_cast<s_sampler_voice_context *>(context.voice_memory.get_pointer());
-		sampler_voice_context->activate();
+		sampler_voice_context->activate(sample_library);
 	}
 
 	void sampler(
@@ -244,6 +302,7 @@ namespace sampler_task_functions {
 			name,
 			loop_mode,
 			phase_shift_enabled,
+			e_sample_storage_format::k_interpolation_coefficients,
 			channel);
 	}
 
@@ -259,6 +318,70 @@ namespace sampler_task_functions {
 		run_sampler_loop<false>(sample_library, context, name, speed, phase, result);
 	}
 
+	void sampler_compact_initializer(
+		const s_task_function_context &context,
+		wl_task_argument(const char *, name),
+		wl_task_argument(real32, channel),
+		wl_task_argument(bool, int16_frames)) {
+		c_sample_library *sample_library = static_cast<c_sample_library *>(context.library_context);
+		s_sampler_shared_context *sampler_context =
+			reinterpret_cast<s_sampler_shared_context *>(context.shared_memory.get_pointer());
+		sampler_context->initialize_file(
+			context.event_interface,
+			sample_library,
+			name,
+			e_sample_loop_mode::k_none,
+			false,
+			get_compact_storage_format(int16_frames),
+			channel);
+	}
+
+	void sampler_compact(
+		const s_task_function_context &context,
+		wl_task_argument(const char *, name),
+		wl_task_argument(real32, channel),
+		wl_task_argument(bool, int16_frames),
+		wl_task_argument(const c_real_buffer *, speed),
+		wl_task_argument(c_real_buffer *, result)) {
+		c_sample_library *sample_library = static_cast<c_sample_library *>(context.library_context);
+		run_sampler(sample_library, context, name, speed, result);
+	}
+
+	void sampler_loop_compact_initializer(
+		const s_task_function_context &context,
+		wl_task_argument(const char *, name),
+		wl_task_argument(real32, channel),
+		wl_task_argument(bool, bidi),
+		wl_task_argument(bool, int16_frames),
+		wl_task_argument(const c_real_buffer *, phase)) {
+		c_sample_library *sample_library = static_cast<c_sample_library *>(context.library_context);
+		s_sampler_shared_context *sampler_context =
+			reinterpret_cast<s_sampler_shared_context *>(context.shared_memory.get_pointer());
+		bool phase_shift_enabled = !phase->is_constant() || (clamp(phase->get_constant(), 0.0f, 1.0f) != 0.0f);
+		e_sample_loop_mode loop_mode = bidi ? e_sample_loop_mode::k_bidi_loop : e_sample_loop_mode::k_loop;
+		sampler_context->initialize_file(
+			context.event_interface,
+			sample_library,
+			name,
+			loop_mode,
+			phase_shift_enabled,
+			get_compact_storage_format(int16_frames),
+			channel);
+	}
+
+	void sampler_loop_compact(
+		const s_task_function_context &context,
+		wl_task_argument(const char *, name),
+		wl_task_argument(real32, channel),
+		wl_task_argument(bool, bidi),
+		wl_task_argument(bool, int16_frames),
+		wl_task_argument(const c_real_buffer *, speed),
+		wl_task_argument(const c_real_buffer *, phase),
+		wl_task_argument(c_real_buffer *, result)) {
+		c_sample_library *sample_library = static_cast<c_sample_library *>(context.library_context);
+		run_sampler_loop<false>(sample_library, context, name, speed, phase, result);
+	}
+
 	void sampler_wavetable_initializer(
 		const s_task_function_context &context,
 		wl_task_argument(c_real_constant_array, harmonic_weights),
@@ -313,6 +436,20 @@ namespace sampler_task_functions {
 			.set_voice_initializer<sampler_voice_initializer>()
 			.set_voice_activator<sampler_voice_activator>();
 
+		wl_task_function(0x757e44bf, "sampler_compact")
+			.set_function<sampler_compact>()
+			.set_memory_query<sampler_memory_query>()
+			.set_initializer<sampler_compact_initializer>()
+			.set_voice_initializer<sampler_voice_initializer>()
+			.set_voice_activator<sampler_voice_activator>();
+
+		wl_task_function(0xc95b79ea, "sampler_loop_compact")
+			.set_function<sampler_loop_compact>()
+			.set_memory_query<sampler_memory_query>()
+			.set_initializer<sampler_loop_compact_initializer>()
+			.set_voice_initializer<sampler_voice_initializer>()
+			.set_voice_activator<sampler_voice_activator>();
+
 		wl_end_active_library_task_function_registration();
 	}
 
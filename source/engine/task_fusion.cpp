@@ -0,0 +1,184 @@
+#include "engine/buffer.h"
+#include "engine/buffer_operations/buffer_iterator.h"
+#include "engine/task_fusion.h"
+
+#include "instrument/native_module_registry.h"
+
+struct s_fused_task_dynamic_input {
+	uint32 register_index;
+	const real32 *data;
+};
+
+static real32xN evaluate_fused_task_instruction(
+	const s_fused_task_instruction &instruction,
+	const s_static_array<real32xN, k_max_fused_task_registers> &registers);
+
+e_fused_task_operation get_task_function_fused_operation(const s_task_function &task_function) {
+	e_fused_task_operation operation;
+	switch (c_native_module_registry::get_native_module_operator(task_function.native_module_uid)) {
+	case e_native_operator::k_negation:
+		operation = e_fused_task_operation::k_negation;
+		break;
+
+	case e_native_operator::k_addition:
+		operation = e_fused_task_operation::k_addition;
+		break;
+
+	case e_native_operator::k_subtraction:
+		operation = e_fused_task_operation::k_subtraction;
+		break;
+
+	case e_native_operator::k_multiplication:
+		operation = e_fused_task_operation::k_multiplication;
+		break;
+
+	case e_native_operator::k_division:
+		operation = e_fused_task_operation::k_division;
+		break;
+
+	case e_native_operator::k_modulo:
+		operation = e_fused_task_operation::k_modulo;
+		break;
+
+	default:
+		return e_fused_task_operation::k_invalid;
+	}
+
+	// Operators can be overloaded, so make sure this is the version which takes real buffer operands and produces a
+	// single real buffer result
+	uint32 operand_count = get_fused_task_operation_operand_count(operation);
+	if (task_function.argument_count != operand_count + 1) {
+		return e_fused_task_operation::k_invalid;
+	}
+
+	for (uint32 argument_index = 0; argument_index < task_function.argument_count; argument_index++) {
+		const s_task_function_argument &argument = task_function.arguments[argument_index];
+		e_task_argument_direction expected_direction = argument_index < operand_count
+			? e_task_argument_direction::k_in
+			: e_task_argument_direction::k_out;
+		if (argument.argument_direction != expected_direction
+			|| argument.type.get_primitive_type() != e_task_primitive_type::k_real
+			|| argument.type.is_array()
+			|| argument.type.get_data_mutability() != e_task_data_mutability::k_variable) {
+			return e_fused_task_operation::k_invalid;
+		}
+	}
+
+	return operation;
+}
+
+uint32 get_fused_task_operation_operand_count(e_fused_task_operation operation) {
+	wl_assert(valid_enum_index(operation));
+	return operation == e_fused_task_operation::k_negation ? 1 : 2;
+}
+
+void execute_fused_task(const s_task_function_context &context, c_fused_task_instruction_array instructions) {
+	wl_assert(context.arguments.get_count() >= 2);
+	wl_assert(instructions.get_count() > 0 && instructions.get_count() <= k_max_fused_task_instructions);
+
+	uint32 input_count = cast_integer_verify<uint32>(context.arguments.get_count() - 1);
+	wl_assert(input_count <= k_max_fused_task_inputs);
+	uint32 result_register_index = input_count + cast_integer_verify<uint32>(instructions.get_count()) - 1;
+	c_real_buffer *result = context.arguments[input_count].get_real_buffer_out();
+
+	s_static_array<real32xN, k_max_fused_task_registers> registers;
+	s_static_array<bool, k_max_fused_task_registers> registers_constant;
+
+	// Constant inputs are broadcast into their registers once. Only dynamic inputs are loaded on each iteration.
+	s_static_array<s_fused_task_dynamic_input, k_max_fused_task_inputs> dynamic_inputs;
+	size_t dynamic_input_count = 0;
+	for (uint32 input_index = 0; input_index < input_count; input_index++) {
+		const c_real_buffer *input = context.arguments[input_index].get_real_buffer_in();
+		registers_constant[input_index] = input->is_constant();
+		if (input->is_constant()) {
+			registers[input_index] = real32xN(input->get_constant());
+		} else {
+			dynamic_inputs[dynamic_input_count++] = { input_index, input->get_data() };
+		}
+	}
+
+	// Evaluate instructions with constant operands up front. This matches the constant-in, constant-out behavior of the
+	// unfused tasks, including the multiply-by-zero shortcut, so the fused output is constant in exactly the same
+	// cases.
+	s_static_array<uint32, k_max_fused_task_instructions> dynamic_instruction_indices;
+	size_t dynamic_instruction_count = 0;
+	for (uint32 instruction_index = 0; instruction_index < instructions.get_count(); instruction_index++) {
+		const s_fused_task_instruction &instruction = instructions[instruction_index];
+		uint32 register_index = input_count + instruction_index;
+		uint32 operand_count = get_fused_task_operation_operand_count(instruction.operation);
+
+		bool all_operands_constant = true;
+		bool multiply_by_zero = false;
+		for (uint32 operand_index = 0; operand_index < operand_count; operand_index++) {
+			uint32 operand_register_index = instruction.operands[operand_index];
+			wl_assert(operand_register_index < register_index);
+			all_operands_constant &= registers_constant[operand_register_index];
+			multiply_by_zero |= instruction.operation == e_fused_task_operation::k_multiplication
+				&& registers_constant[operand_register_index]
+				&& registers[operand_register_index].first_element() == 0.0f;
+		}
+
+		if (multiply_by_zero) {
+			registers[register_index] = real32xN(0.0f);
+			registers_constant[register_index] = true;
+		} else if (all_operands_constant) {
+			registers[register_index] = evaluate_fused_task_instruction(instruction, registers);
+			registers_constant[register_index] = true;
+		} else {
+			registers_constant[register_index] = false;
+			dynamic_instruction_indices[dynamic_instruction_count++] = instruction_index;
+		}
+	}
+
+	if (registers_constant[result_register_index]) {
+		result->assign_constant(registers[result_register_index].first_element());
+		return;
+	}
+
+	// The result is written back to its buffer only after all inputs for the block have been read, so it is safe for
+	// the output buffer to be shared with one of the inputs
+	iterate_buffers<k_simd_32_lanes, false>(context.buffer_size, result,
+		[&](size_t i, real32xN &result) {
+			for (size_t index = 0; index < dynamic_input_count; index++) {
+				const s_fused_task_dynamic_input &dynamic_input = dynamic_inputs[index];
+				registers[dynamic_input.register_index] = real32xN(dynamic_input.data + i);
+			}
+
+			for (size_t index = 0; index < dynamic_instruction_count; index++) {
+				uint32 instruction_index = dynamic_instruction_indices[index];
+				registers[input_count + instruction_index] =
+					evaluate_fused_task_instruction(instructions[instruction_index], registers);
+			}
+
+			result = registers[result_register_index];
+		});
+}
+
+static real32xN evaluate_fused_task_instruction(
+	const s_fused_task_instruction &instruction,
+	const s_static_array<real32xN, k_max_fused_task_registers> &registers) {
+	const real32xN &a = registers[instruction.operands[0]];
+	switch (instruction.operation) {
+	case e_fused_task_operation::k_negation:
+		return -a;
+
+	case e_fused_task_operation::k_addition:
+		return a + registers[instruction.operands[1]];
+
+	case e_fused_task_operation::k_subtraction:
+		return a - registers[instruction.operands[1]];
+
+	case e_fused_task_operation::k_multiplication:
+		return a * registers[instruction.operands[1]];
+
+	case e_fused_task_operation::k_division:
+		return a / registers[instruction.operands[1]];
+
+	case e_fused_task_operation::k_modulo:
+		return a % registers[instruction.operands[1]];
+
+	default:
+		wl_unreachable();
+		return real32xN(0.0f);
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "common/common.h"
+
+#include "task_function/task_function.h"
+
+// Max number of elementwise tasks which can be fused together into a single task
+static constexpr size_t k_max_fused_task_instructions = 16;
+
+// Each instruction is unary or binary, so a tree of N instructions has at most N + 1 leaf inputs
+static constexpr size_t k_max_fused_task_inputs = k_max_fused_task_instructions + 1;
+static constexpr size_t k_max_fused_task_registers = k_max_fused_task_inputs + k_max_fused_task_instructions;
+static constexpr size_t k_max_fused_task_operands = 2;
+
+// Elementwise real operations which can be fused together
+enum class e_fused_task_operation {
+	k_invalid = -1,
+
+	k_negation,
+	k_addition,
+	k_subtraction,
+	k_multiplication,
+	k_division,
+	k_modulo,
+
+	k_count
+};
+
+struct s_fused_task_instruction {
+	e_fused_task_operation operation;
+
+	// Register index of each operand. The first registers hold the fused task's inputs in argument order and each
+	// following register holds the result of the instruction at that position. The result of the final instruction is
+	// written to the fused task's output.
+	s_static_array<uint32, k_max_fused_task_operands> operands;
+};
+
+using c_fused_task_instruction_array = c_wrapped_array<const s_fused_task_instruction>;
+
+// Returns the operation performed by the given task function if it can be fused, or k_invalid otherwise
+e_fused_task_operation get_task_function_fused_operation(const s_task_function &task_function);
+
+// Returns the number of operands read by the operation
+uint32 get_fused_task_operation_operand_count(e_fused_task_operation operation);
+
+// Executes a fused task. The arguments consist of the real input buffers followed by a single real output buffer. The
+// entire expression is evaluated one SIMD block at a time so intermediate results never touch buffer memory.
+void execute_fused_task(const s_task_function_context &context, c_fused_task_instruction_array instructions);
@@ -7,6 +7,8 @@
 
 #include "native_module/native_module.h"
 
+#include <algorithm>
+
 #define OUTPUT_TASK_GRAPH_BUILD_RESULT 0
 
 #if IS_TRUE(OUTPUT_TASK_GRAPH_BUILD_RESULT)
@@ -17,6 +19,22 @@
 
 static constexpr uint32 k_invalid_task = static_cast<uint32>(-1);
 
+// While a fused task is being built, operands referring to inputs are tagged with this bit because the final input
+// count, and therefore the register index of each instruction result, isn't known yet
+static constexpr uint32 k_fused_task_input_operand_flag = 0x80000000;
+
+struct c_task_graph::s_task_fusion_state {
+	const std::unordered_map<h_graph_node, uint32> *nodes_to_tasks;
+	const std::vector<e_fused_task_operation> *task_operations;
+	std::vector<uint32> *fused_task_roots;
+	std::unordered_set<h_graph_node> *fused_node_handles;
+
+	uint32 root_task_index;
+	std::vector<s_fused_task_instruction> instructions;
+	std::vector<c_buffer *> input_buffers;
+	uint32 node_count;
+};
+
 // Rebasing helpers
 template<typename t_pointer> static t_pointer *store_index_in_pointer(size_t index);
 template<typename t_pointer> static size_t extract_index_from_pointer(t_pointer *pointer);
@@ -146,10 +164,16 @@ uint32 c_task_graph::get_task_upsample_factor(uint32 task_index) const {
 
 c_task_function_runtime_arguments c_task_graph::get_task_arguments(uint32 task_index) const {
 	const s_task &task = m_tasks[task_index];
-	const s_task_function &task_function = c_task_function_registry::get_task_function(task.task_function_handle);
 	return c_task_function_runtime_arguments(
-		task_function.argument_count == 0 ? nullptr : &m_task_function_arguments[task.arguments_start],
-		task_function.argument_count);
+		task.argument_count == 0 ? nullptr : &m_task_function_arguments[task.arguments_start],
+		task.argument_count);
+}
+
+c_fused_task_instruction_array c_task_graph::get_task_fused_instructions(uint32 task_index) const {
+	const s_task &task = m_tasks[task_index];
+	return c_fused_task_instruction_array(
+		task.fused_instructions_count == 0 ? nullptr : &m_fused_task_instructions[task.fused_instructions_start],
+		task.fused_instructions_count);
 }
 
 size_t c_task_graph::get_task_predecessor_count(uint32 task_index) const {
@@ -169,6 +193,22 @@ c_task_graph_task_array c_task_graph::get_initial_tasks() const {
 		m_initial_tasks_count);
 }
 
+uint32 c_task_graph::get_task_priority(uint32 task_index) const {
+	return m_tasks[task_index].priority;
+}
+
+real64 c_task_graph::calculate_critical_path_cost(c_wrapped_array<const real64> task_costs) const {
+	std::vector<real64> bottom_level_costs;
+	calculate_bottom_level_costs(task_costs, bottom_level_costs);
+
+	real64 critical_path_cost = 0.0;
+	for (real64 bottom_level_cost : bottom_level_costs) {
+		critical_path_cost = std::max(critical_path_cost, bottom_level_cost);
+	}
+
+	return critical_path_cost;
+}
+
 c_buffer_array c_task_graph::get_inputs() const {
 	return c_buffer_array(m_input_buffers);
 }
@@ -194,8 +234,20 @@ size_t c_task_graph::get_buffer_index(const c_buffer *buffer) const {
 	return buffer - &m_buffers.front();
 }
 
-c_wrapped_array<const c_task_graph::s_buffer_usage_info> c_task_graph::get_buffer_usage_info() const {
-	return c_wrapped_array<const c_task_graph::s_buffer_usage_info>(m_buffer_usage_info);
+c_task_graph_task_array c_task_graph::get_sequential_task_order() const {
+	return c_task_graph_task_array(m_sequential_task_order);
+}
+
+uint32 c_task_graph::get_buffer_slot_count(e_task_graph_schedule schedule) const {
+	return cast_integer_verify<uint32>(m_buffer_slot_assignments[enum_index(schedule)].slot_types.size());
+}
+
+c_task_data_type c_task_graph::get_buffer_slot_type(e_task_graph_schedule schedule, uint32 slot_index) const {
+	return m_buffer_slot_assignments[enum_index(schedule)].slot_types[slot_index];
+}
+
+uint32 c_task_graph::get_buffer_slot(e_task_graph_schedule schedule, size_t buffer_index) const {
+	return m_buffer_slot_assignments[enum_index(schedule)].buffer_slots[buffer_index];
 }
 
 uint32 c_task_graph::get_output_latency() const {
@@ -279,7 +331,11 @@ bool c_task_graph::build(const c_native_module_graph &native_module_graph) {
 		}
 	}
 
+	std::unordered_set<h_graph_node> fused_node_handles;
 	if (success) {
+		// Fusion happens before rebasing because it looks up buffers in m_nodes_to_buffers, which aren't rebased
+		fuse_elementwise_tasks(native_module_graph, nodes_to_tasks, fused_node_handles);
+
 		rebase_arrays();
 		rebase_strings();
 		rebase_buffers();
@@ -297,7 +353,10 @@ bool c_task_graph::build(const c_native_module_graph &native_module_graph) {
 		wl_assert(m_remain_active_output_buffer);
 #endif // IS_TRUE(ASSERTS_ENABLED)
 
-		build_task_successor_lists(native_module_graph, nodes_to_tasks);
+		build_task_successor_lists(native_module_graph, nodes_to_tasks, fused_node_handles);
+		build_sequential_task_order();
+		assign_task_priorities();
+		assign_sequential_buffer_slots();
 		calculate_max_concurrency();
 
 #if IS_TRUE(OUTPUT_TASK_GRAPH_BUILD_RESULT)
@@ -351,6 +410,7 @@ static bool does_native_module_call_input_branch(
 void c_task_graph::clear() {
 	m_tasks.clear();
 	m_task_function_arguments.clear();
+	m_fused_task_instructions.clear();
 	m_buffers.clear();
 	m_nodes_to_buffers.clear();
 	m_output_nodes_to_shared_input_nodes.clear();
@@ -364,7 +424,11 @@ void c_task_graph::clear() {
 	m_string_table.clear();
 	m_task_lists.clear();
 	m_max_task_concurrency = 0;
-	m_buffer_usage_info.clear();
+	m_sequential_task_order.clear();
+	for (s_buffer_slot_assignment &buffer_slot_assignment : m_buffer_slot_assignments) {
+		buffer_slot_assignment.slot_types.clear();
+		buffer_slot_assignment.buffer_slots.clear();
+	}
 	m_initial_tasks_start = k_invalid_list_index;
 	m_initial_tasks_count = 0;
 	m_output_latency = 0;
@@ -450,6 +514,9 @@ bool c_task_graph::setup_task(
 
 	// Set up the task arguments
 	task.arguments_start = m_task_function_arguments.size();
+	task.argument_count = task_function.argument_count;
+	task.fused_instructions_start = 0;
+	task.fused_instructions_count = 0;
 
 	size_t old_task_function_arguments_size = m_task_function_arguments.size();
 	m_task_function_arguments.resize(old_task_function_arguments_size + task_function.argument_count);
@@ -614,6 +681,245 @@ bool c_task_graph::setup_task(
 	return true;
 }
 
+void c_task_graph::fuse_elementwise_tasks(
+	const c_native_module_graph &native_module_graph,
+	std::unordered_map<h_graph_node, uint32> &nodes_to_tasks,
+	std::unordered_set<h_graph_node> &fused_node_handles) {
+	// Each elementwise task reads its inputs and writes its output in full, so a chain like "a * b + c" costs a buffer
+	// round trip per operation. Here we merge each tree of elementwise tasks, connected through intermediate results
+	// which have no other consumers, into a single task which keeps the intermediate results in registers.
+	std::vector<h_graph_node> task_node_handles(m_tasks.size());
+	for (auto it = nodes_to_tasks.begin(); it != nodes_to_tasks.end(); it++) {
+		task_node_handles[it->second] = it->first;
+	}
+
+	std::vector<e_fused_task_operation> task_operations(m_tasks.size());
+	for (uint32 task_index = 0; task_index < m_tasks.size(); task_index++) {
+		task_operations[task_index] = get_task_function_fused_operation(
+			c_task_function_registry::get_task_function(m_tasks[task_index].task_function_handle));
+	}
+
+	// The root task each task was fused into, or k_invalid_task if the task was not absorbed by another task
+	std::vector<uint32> fused_task_roots(m_tasks.size(), k_invalid_task);
+
+	// Tasks were created in dependency order. By visiting them in reverse, a task's consumer is always visited first,
+	// so any fusable task which hasn't been absorbed by the time it is visited becomes the root of a new fused task.
+	for (uint32 task_index = cast_integer_verify<uint32>(m_tasks.size()); task_index-- > 0;) {
+		if (task_operations[task_index] == e_fused_task_operation::k_invalid
+			|| fused_task_roots[task_index] != k_invalid_task) {
+			continue;
+		}
+
+		s_task_fusion_state state;
+		state.nodes_to_tasks = &nodes_to_tasks;
+		state.task_operations = &task_operations;
+		state.fused_task_roots = &fused_task_roots;
+		state.fused_node_handles = &fused_node_handles;
+		state.root_task_index = task_index;
+		state.node_count = 1;
+
+		h_graph_node node_handle = task_node_handles[task_index];
+		add_fused_task_instruction(native_module_graph, node_handle, state);
+		if (state.instructions.size() == 1) {
+			// Nothing was fused so leave the original task alone
+			continue;
+		}
+
+		// Now that the input count is known, resolve operand register indices
+		uint32 input_count = cast_integer_verify<uint32>(state.input_buffers.size());
+		for (s_fused_task_instruction &instruction : state.instructions) {
+			uint32 operand_count = get_fused_task_operation_operand_count(instruction.operation);
+			for (uint32 operand_index = 0; operand_index < operand_count; operand_index++) {
+				uint32 &operand = instruction.operands[operand_index];
+				operand = (operand & k_fused_task_input_operand_flag)
+					? (operand & ~k_fused_task_input_operand_flag)
+					: input_count + operand;
+			}
+		}
+
+		// Replace the root task's arguments with the fused inputs followed by the root's output
+		s_task &task = m_tasks[task_index];
+		task.arguments_start = m_task_function_arguments.size();
+		task.argument_count = input_count + 1;
+
+		c_task_qualified_data_type buffer_type(
+			c_task_data_type(e_task_primitive_type::k_real, false, 1),
+			e_task_data_mutability::k_variable);
+		for (c_buffer *input_buffer : state.input_buffers) {
+			s_task_function_runtime_argument &argument = m_task_function_arguments.emplace_back();
+			argument.argument_direction = e_task_argument_direction::k_in;
+			argument.type = buffer_type;
+			argument.value.emplace<c_buffer *>(input_buffer);
+		}
+
+		h_graph_node output_node_handle = native_module_graph.get_node_outgoing_edge_handle(node_handle, 0);
+		s_task_function_runtime_argument &output_argument = m_task_function_arguments.emplace_back();
+		output_argument.argument_direction = e_task_argument_direction::k_out;
+		output_argument.type = buffer_type;
+		output_argument.value.emplace<c_buffer *>(m_nodes_to_buffers.at(output_node_handle));
+
+		task.fused_instructions_start = m_fused_task_instructions.size();
+		task.fused_instructions_count = state.instructions.size();
+		m_fused_task_instructions.insert(
+			m_fused_task_instructions.end(),
+			state.instructions.begin(),
+			state.instructions.end());
+	}
+
+	if (fused_node_handles.empty()) {
+		return;
+	}
+
+	// Remove the absorbed tasks and point their nodes at the fused tasks which replaced them
+	std::vector<uint32> new_task_indices(m_tasks.size(), k_invalid_task);
+	uint32 new_task_count = 0;
+	for (uint32 task_index = 0; task_index < m_tasks.size(); task_index++) {
+		if (fused_task_roots[task_index] == k_invalid_task) {
+			new_task_indices[task_index] = new_task_count;
+			m_tasks[new_task_count] = m_tasks[task_index];
+			new_task_count++;
+		}
+	}
+
+	m_tasks.resize(new_task_count);
+
+	for (auto it = nodes_to_tasks.begin(); it != nodes_to_tasks.end(); it++) {
+		uint32 root_task_index = fused_task_roots[it->second];
+		it->second = new_task_indices[root_task_index == k_invalid_task ? it->second : root_task_index];
+		wl_assert(it->second != k_invalid_task);
+	}
+
+	remove_unreferenced_arguments_and_buffers();
+}
+
+uint32 c_task_graph::add_fused_task_instruction(
+	const c_native_module_graph &native_module_graph,
+	h_graph_node node_handle,
+	s_task_fusion_state &state) {
+	uint32 task_index = state.nodes_to_tasks->at(node_handle);
+
+	s_fused_task_instruction instruction;
+	instruction.operation = (*state.task_operations)[task_index];
+	zero_type(&instruction.operands);
+
+	uint32 operand_count = get_fused_task_operation_operand_count(instruction.operation);
+	for (uint32 operand_index = 0; operand_index < operand_count; operand_index++) {
+		h_graph_node source_node_handle =
+			native_module_graph.get_node_indexed_input_incoming_edge_handle(node_handle, operand_index, 0);
+
+		// The source can be absorbed if it's an elementwise task at the same upsample factor whose result is only used
+		// by this operand
+		uint32 source_task_index = k_invalid_task;
+		if (native_module_graph.get_node_type(source_node_handle) == e_native_module_graph_node_type::k_indexed_output
+			&& native_module_graph.get_node_outgoing_edge_count(source_node_handle) == 1
+			&& state.node_count < k_max_fused_task_instructions) {
+			h_graph_node source_task_node_handle =
+				native_module_graph.get_node_incoming_edge_handle(source_node_handle, 0);
+			uint32 candidate_task_index = state.nodes_to_tasks->at(source_task_node_handle);
+			if ((*state.task_operations)[candidate_task_index] != e_fused_task_operation::k_invalid
+				&& m_tasks[candidate_task_index].upsample_factor == m_tasks[task_index].upsample_factor) {
+				source_task_index = candidate_task_index;
+				(*state.fused_task_roots)[source_task_index] = state.root_task_index;
+				state.fused_node_handles->insert(source_task_node_handle);
+				state.node_count++;
+				instruction.operands[operand_index] =
+					add_fused_task_instruction(native_module_graph, source_task_node_handle, state);
+			}
+		}
+
+		if (source_task_index == k_invalid_task) {
+			// Read this operand from its buffer. Buffers are only shared between values whose lifetimes don't overlap,
+			// so two inputs using the same buffer must hold the same value and can share a register.
+			c_buffer *buffer = m_nodes_to_buffers.at(source_node_handle);
+			auto it = std::find(state.input_buffers.begin(), state.input_buffers.end(), buffer);
+			uint32 input_index = cast_integer_verify<uint32>(it - state.input_buffers.begin());
+			if (it == state.input_buffers.end()) {
+				state.input_buffers.push_back(buffer);
+			}
+
+			instruction.operands[operand_index] = input_index | k_fused_task_input_operand_flag;
+		}
+	}
+
+	uint32 instruction_index = cast_integer_verify<uint32>(state.instructions.size());
+	state.instructions.push_back(instruction);
+	return instruction_index;
+}
+
+void c_task_graph::remove_unreferenced_arguments_and_buffers() {
+	// Rebuild the argument list so that it only contains arguments belonging to remaining tasks
+	std::vector<s_task_function_runtime_argument> task_function_arguments;
+	for (s_task &task : m_tasks) {
+		size_t arguments_start = task_function_arguments.size();
+		task_function_arguments.insert(
+			task_function_arguments.end(),
+			m_task_function_arguments.begin() + task.arguments_start,
+			m_task_function_arguments.begin() + task.arguments_start + task.argument_count);
+		task.arguments_start = arguments_start;
+	}
+
+	m_task_function_arguments.swap(task_function_arguments);
+
+	// Buffers which only held intermediate results of fused tasks are no longer referenced. Buffers haven't been
+	// rebased yet, so each buffer pointer still holds its buffer index.
+	static constexpr size_t k_unreferenced = static_cast<size_t>(-1);
+	std::vector<size_t> new_buffer_indices(m_buffers.size(), k_unreferenced);
+	auto for_each_buffer_reference = [&](auto &&function) {
+		for (s_task_function_runtime_argument &argument : m_task_function_arguments) {
+			if (!argument.type.is_array()
+				&& argument.type.get_data_mutability() != e_task_data_mutability::k_constant) {
+				function(std::get<c_buffer *>(argument.value));
+			}
+		}
+
+		for (c_buffer *&buffer : m_buffer_arrays) {
+			function(buffer);
+		}
+
+		for (c_buffer *&buffer : m_input_buffers) {
+			function(buffer);
+		}
+
+		for (c_buffer *&buffer : m_output_buffers) {
+			function(buffer);
+		}
+
+		function(m_remain_active_output_buffer);
+	};
+
+	for_each_buffer_reference([&](c_buffer *&buffer) { new_buffer_indices[extract_index_from_pointer(buffer)] = 0; });
+
+	size_t new_buffer_count = 0;
+	for (size_t buffer_index = 0; buffer_index < m_buffers.size(); buffer_index++) {
+		if (new_buffer_indices[buffer_index] != k_unreferenced) {
+			new_buffer_indices[buffer_index] = new_buffer_count;
+			if (new_buffer_count != buffer_index) {
+				m_buffers[new_buffer_count] = std::move(m_buffers[buffer_index]);
+			}
+
+			new_buffer_count++;
+		}
+	}
+
+	while (m_buffers.size() > new_buffer_count) {
+		m_buffers.pop_back();
+	}
+
+	for_each_buffer_reference([&](c_buffer *&buffer) {
+		buffer = store_index_in_pointer<c_buffer>(new_buffer_indices[extract_index_from_pointer(buffer)]);
+	});
+
+	for (auto it = m_nodes_to_buffers.begin(); it != m_nodes_to_buffers.end();) {
+		size_t new_buffer_index = new_buffer_indices[extract_index_from_pointer(it->second)];
+		if (new_buffer_index == k_unreferenced) {
+			it = m_nodes_to_buffers.erase(it);
+		} else {
+			it->second = store_index_in_pointer<c_buffer>(new_buffer_index);
+			it++;
+		}
+	}
+}
+
 c_buffer *c_task_graph::add_or_get_buffer(
 	const c_native_module_graph &native_module_graph,
 	h_graph_node node_handle,
@@ -996,7 +1302,8 @@ void c_task_graph::rebase_strings() {
 
 void c_task_graph::build_task_successor_lists(
 	const c_native_module_graph &native_module_graph,
-	const std::unordered_map<h_graph_node, uint32> &nodes_to_tasks) {
+	const std::unordered_map<h_graph_node, uint32> &nodes_to_tasks,
+	const std::unordered_set<h_graph_node> &fused_node_handles) {
 	// Clear predecessor counts first since those are set in a random order
 	for (uint32 task_index = 0; task_index < m_tasks.size(); task_index++) {
 		m_tasks[task_index].predecessor_count = 0;
@@ -1013,6 +1320,11 @@ void c_task_graph::build_task_successor_lists(
 
 		wl_assert(
 			native_module_graph.get_node_type(node_handle) == e_native_module_graph_node_type::k_native_module_call);
+		if (fused_node_handles.find(node_handle) != fused_node_handles.end()) {
+			// This node was fused into a successor's task, so its only outgoing edges are internal to that task
+			continue;
+		}
+
 		uint32 task_index = nodes_to_tasks.at(node_handle);
 		s_task &task = m_tasks[task_index];
 
@@ -1107,25 +1419,8 @@ void c_task_graph::add_task_successor(uint32 predecessor_task_index, uint32 succ
 }
 
 void c_task_graph::calculate_max_concurrency() {
-	// In this function we calculate the worst case for the number of buffers which must be in memory concurrently. This
-	// number may be much less than the number of buffers because in many cases, buffer B can only ever be created once
-	// buffer A is no longer needed.
-
-	// The optimal solution is the following: create an NxN matrix, where N is the total number of tasks. Each cell
-	// (a,b) contains a boolean value determining whether it is possible for tasks a and b to execute in parallel (this
-	// can be determined by analyzing task successors/predecessors). All cells (a,a) are set to true. Next, create a new
-	// graph containing a node for each buffer used for each task (so if a task uses B buffers, B nodes would be
-	// created). For two nodes xb1 and xb2 (where x is the original task index and b is the original buffer index), add
-	// an edge if the cell (x1,x2) in the matrix is set. The maximum buffer concurrency is equal to the size of the
-	// maximum clique in this graph.
-
-	// Unfortunately, calculating the maximum clique in a graph is NP-hard, so we will take a different approach. We
-	// start by assuming all buffers are independent. We then attempt to merge buffers which cannot ever exist in
-	// parallel. This is a greedy (and suboptimal) algorithm because we don't know if merging buffers a and b will
-	// prevent future merges that could be better.
-
-	// In the future, we may want to use a heuristic to try to guess the best buffers to merge next, but for now we will
-	// just pick the first valid pair we come across, for simplicity.
+	// In this function we calculate the worst case for the number of tasks which can be executing concurrently and
+	// assign buffer slots which are valid no matter how the tasks are scheduled.
 
 	// 1) Find task successors/predecessors. We use a pretty inefficient but simple algorithm, but make it better by
 	// ORing uint32s to combine successor lists.
@@ -1144,7 +1439,9 @@ void c_task_graph::calculate_max_concurrency() {
 	predecessor_resolver.resolve();
 
 	{
-		// At this point it is convenient to calculate task concurrency
+		// 2) Two tasks (a,b) can be parallel if (a !precedes b) and (b !precedes a). Finding the largest set of
+		// mutually concurrent tasks is NP-hard so we greedily merge tasks which can't be parallel instead, which
+		// overestimates the concurrency.
 		std::vector<bool> task_concurrency(m_tasks.size() * m_tasks.size());
 		for (uint32 task_b = 0; task_b < m_tasks.size(); task_b++) {
 			for (uint32 task_a = 0; task_a < m_tasks.size(); task_a++) {
@@ -1157,276 +1454,335 @@ void c_task_graph::calculate_max_concurrency() {
 			estimate_max_concurrency(cast_integer_verify<uint32>(m_tasks.size()), task_concurrency);
 	}
 
-	// 2) Determine which buffers are concurrent. This means that it is possible or necessary for the buffers to exist
-	// at the same time.
+	// 3) Assign buffers to slots using the same precedence information
+	assign_concurrent_buffer_slots(predecessor_resolver);
+}
 
-	// Each buffer type can only be concurrent with other buffers of its same type, so first we identify all the
-	// different buffer types that exist
+uint32 c_task_graph::estimate_max_concurrency(uint32 node_count, const std::vector<bool> &concurrency_matrix) const {
+	wl_assert(node_count * node_count == concurrency_matrix.size());
 
-	for (const c_buffer &buffer : m_buffers) {
-		add_usage_info_for_buffer_type(predecessor_resolver, buffer.get_data_type());
-	}
+	static constexpr size_t k_none = static_cast<size_t>(-1);
+	struct s_merged_node_group {
+		uint32 node_index;
+		size_t next;
+
+	};
+
+	std::vector<s_merged_node_group> merge_group_lists;
+	std::vector<size_t> merge_group_heads;
+
+	// Attempt to merge each node with the first possible merge group we encounter. If no merge is successful, make a
+	// new merge group.
+	for (uint32 node_index_a = 0; node_index_a < node_count; node_index_a++) {
+		bool merged = false;
+		for (size_t merge_group_index = 0;
+			!merged && merge_group_index < merge_group_heads.size();
+			merge_group_index++) {
+			bool can_merge = true;
+			size_t node_index_b = merge_group_heads[merge_group_index];
+			while (node_index_b != k_none && can_merge) {
+				s_merged_node_group merged_node_group = merge_group_lists[node_index_b];
+				if (concurrency_matrix[node_index_a * node_count + merged_node_group.node_index]) {
+					// These two nodes are concurrent, so we can't merge them
+					can_merge = false;
+				}
+
+				node_index_b = merged_node_group.next;
+			}
+
+			if (can_merge) {
+				size_t new_index = merge_group_lists.size();
+
+				s_merged_node_group merged_node_group;
+				merged_node_group.node_index = node_index_a;
+				merged_node_group.next = merge_group_heads[merge_group_index];
+				merge_group_lists.push_back(merged_node_group);
+				merge_group_heads[merge_group_index] = new_index;
 
-	// Remove any buffer usage info entries with 0 max concurrency - this can happen if all buffers of that type are
-	// compile-time constants
-	for (size_t index = 0; index < m_buffer_usage_info.size();) {
-		if (m_buffer_usage_info[index].max_concurrency == 0) {
-			m_buffer_usage_info.erase(m_buffer_usage_info.begin() + index);
+				merged = true;
+			}
 		}
 
-		index++;
+		if (!merged) {
+			// No valid merges, add a new merge group
+			merge_group_heads.push_back(merge_group_lists.size());
+
+			s_merged_node_group merged_node_group;
+			merged_node_group.node_index = node_index_a;
+			merged_node_group.next = k_none;
+			merge_group_lists.push_back(merged_node_group);
+		}
 	}
+
+	// The number of merge groups we end up with is the max concurrency. It is an overestimate, meaning we will reserve
+	// more memory than necessary.
+	return cast_integer_verify<uint32>(merge_group_heads.size());
 }
 
-void c_task_graph::add_usage_info_for_buffer_type(
-	const c_predecessor_resolver &predecessor_resolver,
-	c_task_data_type data_type) {
-	// Skip if we've already calculated for this type
-	size_t found = false;
-	for (size_t info_index = 0; info_index < m_buffer_usage_info.size(); info_index++) {
-		if (m_buffer_usage_info[info_index].type == data_type) {
-			found = true;
-			break;
-		}
+void c_task_graph::build_sequential_task_order() {
+	// Traverse the graph depth-first so that each task tends to run immediately after the task producing its inputs.
+	// This keeps buffers hot in the cache and shortens buffer lifetimes, which reduces the number of buffer slots.
+	std::vector<size_t> predecessors_remaining(m_tasks.size());
+	for (uint32 task_index = 0; task_index < m_tasks.size(); task_index++) {
+		predecessors_remaining[task_index] = m_tasks[task_index].predecessor_count;
 	}
 
-	if (!found) {
-		m_buffer_usage_info.push_back(s_buffer_usage_info());
-		s_buffer_usage_info &info = m_buffer_usage_info.back();
-		info.type = data_type;
-		info.max_concurrency = calculate_max_buffer_concurrency(predecessor_resolver, data_type);
+	// Tasks are pushed in reverse so that they're popped in their original order
+	std::vector<uint32> task_stack;
+	task_stack.reserve(m_tasks.size());
+	c_task_graph_task_array initial_tasks = get_initial_tasks();
+	for (size_t index = initial_tasks.get_count(); index > 0; index--) {
+		task_stack.push_back(initial_tasks[index - 1]);
 	}
-}
 
-uint32 c_task_graph::calculate_max_buffer_concurrency(
-	const c_predecessor_resolver &task_predecessor_resolver,
-	c_task_data_type data_type) const {
-	// To determine whether two tasks (a,b) can be parallel, we just ask whether (a !precedes b) and (b !precedes a).
-	// The predecessor resolver provides this data.
+	m_sequential_task_order.reserve(m_tasks.size());
+	while (!task_stack.empty()) {
+		uint32 task_index = task_stack.back();
+		task_stack.pop_back();
+		m_sequential_task_order.push_back(task_index);
+
+		c_task_graph_task_array successors = get_task_successors(task_index);
+		for (size_t index = successors.get_count(); index > 0; index--) {
+			uint32 successor_task_index = successors[index - 1];
+			wl_assert(predecessors_remaining[successor_task_index] > 0);
+			if (--predecessors_remaining[successor_task_index] == 0) {
+				task_stack.push_back(successor_task_index);
+			}
+		}
+	}
 
-	// We're looking at individual buffers, so the array data type flag shouldn't make a difference
-	wl_assert(!data_type.is_array());
+	wl_assert(m_sequential_task_order.size() == m_tasks.size());
+}
 
-	// The information we actually want to know is whether we can merge buffers, so we actually need to know which
-	// buffers can exist in parallel. We can convert task concurrency data to buffer concurrency data.
-	size_t buffer_count = m_buffers.size();
-	std::vector<bool> buffer_concurrency(buffer_count * buffer_count, false);
+void c_task_graph::calculate_bottom_level_costs(
+	c_wrapped_array<const real64> task_costs,
+	std::vector<real64> &bottom_level_costs_out) const {
+	wl_assert(task_costs.get_count() == m_tasks.size());
+	bottom_level_costs_out.resize(m_tasks.size());
+
+	// Walk backwards through the sequential order so that each task's successors have already been visited
+	for (size_t index = m_sequential_task_order.size(); index > 0; index--) {
+		uint32 task_index = m_sequential_task_order[index - 1];
+		real64 max_successor_cost = 0.0;
+		for (uint32 successor_task_index : get_task_successors(task_index)) {
+			max_successor_cost = std::max(max_successor_cost, bottom_level_costs_out[successor_task_index]);
+		}
 
-	// Not all buffers are of the correct type - this bitvector masks out invalid buffers
-	std::vector<bool> buffer_type_mask(buffer_count, false);
-	uint32 valid_buffer_count = 0;
+		bottom_level_costs_out[task_index] = task_costs[task_index] + max_successor_cost;
+	}
+}
 
-	// For any task, all buffer pairs of the same type are concurrent
+void c_task_graph::assign_task_priorities() {
+	// Without profiling data, a task's cost is estimated by how many samples it processes relative to other tasks
+	std::vector<real64> task_costs(m_tasks.size());
 	for (uint32 task_index = 0; task_index < m_tasks.size(); task_index++) {
-		for (c_task_buffer_iterator it_a(get_task_arguments(task_index)); it_a.is_valid(); it_a.next()) {
-			if (it_a.get_buffer()->get_data_type() != data_type) {
-				continue;
-			}
+		task_costs[task_index] = static_cast<real64>(m_tasks[task_index].upsample_factor);
+	}
 
-			size_t buffer_a_index = get_buffer_index(it_a.get_buffer());
+	std::vector<real64> bottom_level_costs;
+	calculate_bottom_level_costs(c_wrapped_array<const real64>(task_costs), bottom_level_costs);
+	for (uint32 task_index = 0; task_index < m_tasks.size(); task_index++) {
+		m_tasks[task_index].priority = static_cast<uint32>(bottom_level_costs[task_index]);
+	}
 
-			if (!buffer_type_mask[buffer_a_index]) {
-				buffer_type_mask[buffer_a_index] = true;
-				valid_buffer_count++;
-			}
+	// The executor runs the first successor which becomes ready on the same thread, so higher priorities go first. The
+	// sort is stable to keep the original order between equal priorities.
+	auto sort_task_list = [this](size_t start, size_t count) {
+		if (count == 0) {
+			return;
+		}
 
-			for (c_task_buffer_iterator it_b(get_task_arguments(task_index)); it_b.is_valid(); it_b.next()) {
-				if (it_b.get_buffer()->get_data_type() != data_type) {
-					continue;
-				}
+		std::stable_sort(
+			m_task_lists.begin() + start,
+			m_task_lists.begin() + start + count,
+			[this](uint32 task_index_a, uint32 task_index_b) {
+				return m_tasks[task_index_a].priority > m_tasks[task_index_b].priority;
+			});
+	};
 
-				size_t buffer_b_index = get_buffer_index(it_b.get_buffer());
-				buffer_concurrency[buffer_a_index * buffer_count + buffer_b_index] = true;
-				buffer_concurrency[buffer_b_index * buffer_count + buffer_a_index] = true;
-			}
-		}
+	for (const s_task &task : m_tasks) {
+		sort_task_list(task.successors_start, task.successors_count);
 	}
 
-	// For any pair of concurrent tasks, all buffer pairs between the two tasks are concurrent
-	for (uint32 task_a_index = 0; task_a_index < m_tasks.size(); task_a_index++) {
-		for (uint32 task_b_index = task_a_index + 1; task_b_index < m_tasks.size(); task_b_index++) {
-			if (!task_predecessor_resolver.are_a_b_concurrent(task_a_index, task_b_index)) {
-				continue;
-			}
+	sort_task_list(m_initial_tasks_start, m_initial_tasks_count);
+}
 
-			for (c_task_buffer_iterator it_a(get_task_arguments(task_a_index)); it_a.is_valid(); it_a.next()) {
-				if (it_a.get_buffer()->get_data_type() != data_type) {
-					continue;
-				}
+void c_task_graph::assign_sequential_buffer_slots() {
+	// Time 0 is before any task executes and time N+1 is after the last task has executed. The task at position i in
+	// the sequential order executes at time i+1.
+	static constexpr uint32 k_unused = static_cast<uint32>(-1);
+	uint32 end_time = cast_integer_verify<uint32>(m_sequential_task_order.size() + 1);
+
+	std::vector<uint32> first_use_times(m_buffers.size(), k_unused);
+	std::vector<uint32> last_use_times(m_buffers.size(), 0);
+	auto add_use = [&](const c_buffer *buffer, uint32 time) {
+		size_t buffer_index = get_buffer_index(buffer);
+		first_use_times[buffer_index] = std::min(first_use_times[buffer_index], time);
+		last_use_times[buffer_index] = std::max(last_use_times[buffer_index], time);
+	};
 
-				size_t buffer_a_index = get_buffer_index(it_a.get_buffer());
-				for (c_task_buffer_iterator it_b(get_task_arguments(task_b_index)); it_b.is_valid(); it_b.next()) {
-					if (it_b.get_buffer()->get_data_type() != data_type) {
-						continue;
-					}
+	// Inputs are written before processing begins and outputs are read after processing ends
+	for (const c_buffer *input_buffer : m_input_buffers) {
+		add_use(input_buffer, 0);
+	}
 
-					size_t buffer_b_index = get_buffer_index(it_b.get_buffer());
-					buffer_concurrency[buffer_a_index * buffer_count + buffer_b_index] = true;
-					buffer_concurrency[buffer_b_index * buffer_count + buffer_a_index] = true;
-				}
-			}
+	for (uint32 order_index = 0; order_index < m_sequential_task_order.size(); order_index++) {
+		uint32 task_index = m_sequential_task_order[order_index];
+		for (c_task_buffer_iterator it(get_task_arguments(task_index)); it.is_valid(); it.next()) {
+			add_use(it.get_buffer(), order_index + 1);
 		}
 	}
 
-	// All input buffers are concurrent
-	for (size_t input_a = 0; input_a < m_input_buffers.size(); input_a++) {
-		c_buffer *input_a_buffer = m_input_buffers[input_a];
-		wl_assert(!input_a_buffer->is_compile_time_constant());
-		size_t input_a_buffer_index = get_buffer_index(input_a_buffer);
-		c_task_data_type input_a_buffer_type = m_buffers[input_a_buffer_index].get_data_type();
-		if (input_a_buffer_type != data_type) {
-			continue;
+	for (const c_buffer *output_buffer : m_output_buffers) {
+		if (!output_buffer->is_compile_time_constant()) {
+			add_use(output_buffer, end_time);
 		}
+	}
 
-		if (!buffer_type_mask[input_a_buffer_index]) {
-			buffer_type_mask[input_a_buffer_index] = true;
-			valid_buffer_count++;
+	if (!m_remain_active_output_buffer->is_compile_time_constant()) {
+		add_use(m_remain_active_output_buffer, end_time);
+	}
+
+	// Visit buffers in the order they become live. Greedily assigning the first free slot of a matching type produces
+	// the minimum number of slots because buffer lifetimes are intervals on a single timeline.
+	std::vector<size_t> buffer_indices;
+	for (size_t buffer_index = 0; buffer_index < m_buffers.size(); buffer_index++) {
+		if (first_use_times[buffer_index] != k_unused) {
+			wl_assert(!m_buffers[buffer_index].is_compile_time_constant());
+			buffer_indices.push_back(buffer_index);
 		}
+	}
 
-		for (size_t input_b = input_a + 1; input_b < m_input_buffers.size(); input_b++) {
-			c_buffer *input_b_buffer = m_input_buffers[input_b];
-			wl_assert(!input_b_buffer->is_compile_time_constant());
-			size_t input_b_buffer_index = get_buffer_index(input_b_buffer);
-			c_task_data_type input_b_buffer_type = m_buffers[input_b_buffer_index].get_data_type();
-			if (input_b_buffer_type != data_type) {
-				continue;
+	std::stable_sort(buffer_indices.begin(), buffer_indices.end(),
+		[&](size_t buffer_index_a, size_t buffer_index_b) {
+			return first_use_times[buffer_index_a] < first_use_times[buffer_index_b];
+		});
+
+	s_buffer_slot_assignment &assignment = m_buffer_slot_assignments[enum_index(e_task_graph_schedule::k_sequential)];
+	assignment.buffer_slots.resize(m_buffers.size(), k_invalid_buffer_slot);
+
+	// The time at which each slot's current buffer is last used
+	std::vector<uint32> slot_last_use_times;
+	for (size_t buffer_index : buffer_indices) {
+		c_task_data_type data_type = m_buffers[buffer_index].get_data_type();
+		uint32 assigned_slot = k_invalid_buffer_slot;
+		for (uint32 slot = 0; slot < assignment.slot_types.size(); slot++) {
+			if (assignment.slot_types[slot] == data_type
+				&& slot_last_use_times[slot] < first_use_times[buffer_index]) {
+				assigned_slot = slot;
+				break;
 			}
+		}
 
-			size_t index_ab = input_a_buffer_index * buffer_count + input_b_buffer_index;
-			size_t index_ba = input_b_buffer_index * buffer_count + input_a_buffer_index;
-			buffer_concurrency[index_ab] = true;
-			buffer_concurrency[index_ba] = true;
+		if (assigned_slot == k_invalid_buffer_slot) {
+			assigned_slot = cast_integer_verify<uint32>(assignment.slot_types.size());
+			assignment.slot_types.push_back(data_type);
+			slot_last_use_times.push_back(0);
 		}
+
+		assignment.buffer_slots[buffer_index] = assigned_slot;
+		slot_last_use_times[assigned_slot] = last_use_times[buffer_index];
 	}
+}
 
-	// All output buffers are concurrent
-	for (size_t output_a = 0; output_a < m_output_buffers.size(); output_a++) {
-		c_buffer *output_a_buffer = m_output_buffers[output_a];
-		if (output_a_buffer->is_compile_time_constant()) {
-			continue;
+void c_task_graph::assign_concurrent_buffer_slots(const c_predecessor_resolver &task_predecessor_resolver) {
+	// When tasks can execute in any valid order, two buffers can only share a slot if every task using one buffer
+	// precedes every task using the other. Inputs are written before any task executes and outputs are read after all
+	// tasks have executed.
+	std::vector<std::vector<uint32>> buffer_tasks(m_buffers.size());
+	std::vector<bool> buffers_used_before_tasks(m_buffers.size(), false);
+	std::vector<bool> buffers_used_after_tasks(m_buffers.size(), false);
+
+	// Buffers are visited in the order they become live in the sequential order, which tends to pack slots tightly
+	std::vector<size_t> buffer_indices;
+	std::vector<bool> buffers_visited(m_buffers.size(), false);
+	auto visit_buffer = [&](const c_buffer *buffer) {
+		size_t buffer_index = get_buffer_index(buffer);
+		if (!buffers_visited[buffer_index]) {
+			buffers_visited[buffer_index] = true;
+			buffer_indices.push_back(buffer_index);
 		}
 
-		size_t output_a_buffer_index = get_buffer_index(output_a_buffer);
-		c_task_data_type output_a_buffer_type = m_buffers[output_a_buffer_index].get_data_type();
-		if (output_a_buffer_type != data_type) {
-			continue;
-		}
+		return buffer_index;
+	};
 
-		for (size_t output_b = output_a + 1; output_b < m_output_buffers.size(); output_b++) {
-			c_buffer *output_b_buffer = m_output_buffers[output_b];
-			if (output_b_buffer->is_compile_time_constant()) {
-				continue;
-			}
+	for (const c_buffer *input_buffer : m_input_buffers) {
+		buffers_used_before_tasks[visit_buffer(input_buffer)] = true;
+	}
 
-			size_t output_b_buffer_index = get_buffer_index(output_b_buffer);
-			c_task_data_type output_b_buffer_type = m_buffers[output_b_buffer_index].get_data_type();
-			if (output_b_buffer_type != data_type) {
-				continue;
+	for (uint32 task_index : m_sequential_task_order) {
+		for (c_task_buffer_iterator it(get_task_arguments(task_index)); it.is_valid(); it.next()) {
+			std::vector<uint32> &tasks = buffer_tasks[visit_buffer(it.get_buffer())];
+			if (tasks.empty() || tasks.back() != task_index) {
+				tasks.push_back(task_index);
 			}
-
-			size_t index_ab = output_a_buffer_index * buffer_count + output_b_buffer_index;
-			size_t index_ba = output_b_buffer_index * buffer_count + output_a_buffer_index;
-			buffer_concurrency[index_ab] = true;
-			buffer_concurrency[index_ba] = true;
 		}
 	}
 
-	// The output buffers are also concurrent with the remain-active output buffer, but they are different types (real
-	// and bool) so we don't need to bother marking them as concurrent since they will never be combined anyway. Assert
-	// this here to be sure.
-#if IS_TRUE(ASSERTS_ENABLED)
-	size_t remain_active_output_buffer_index = get_buffer_index(m_remain_active_output_buffer);
-	for (c_buffer *output_buffer : m_output_buffers) {
-		size_t output_buffer_index = get_buffer_index(output_buffer);
-		wl_assert(m_buffers[remain_active_output_buffer_index].get_data_type()
-			!= m_buffers[output_buffer_index].get_data_type());
+	for (const c_buffer *output_buffer : m_output_buffers) {
+		if (!output_buffer->is_compile_time_constant()) {
+			buffers_used_after_tasks[visit_buffer(output_buffer)] = true;
+		}
 	}
-#endif // IS_TRUE(ASSERTS_ENABLED)
 
-	// Reduce the matrix down to only valid buffers. The actual indices no longer matter at this point.
-	std::vector<bool> reduced_buffer_concurrency;
-	reduced_buffer_concurrency.reserve(valid_buffer_count * valid_buffer_count);
+	if (!m_remain_active_output_buffer->is_compile_time_constant()) {
+		buffers_used_after_tasks[visit_buffer(m_remain_active_output_buffer)] = true;
+	}
 
-	for (uint32 buffer_a_index = 0; buffer_a_index < buffer_count; buffer_a_index++) {
-		if (!buffer_type_mask[buffer_a_index]) {
-			continue;
+	auto does_buffer_a_precede_buffer_b = [&](size_t buffer_a_index, size_t buffer_b_index) {
+		if (buffers_used_after_tasks[buffer_a_index] || buffers_used_before_tasks[buffer_b_index]) {
+			return false;
 		}
 
-		for (uint32 buffer_b_index = 0; buffer_b_index < buffer_count; buffer_b_index++) {
-			if (!buffer_type_mask[buffer_b_index]) {
-				continue;
+		for (uint32 task_a_index : buffer_tasks[buffer_a_index]) {
+			for (uint32 task_b_index : buffer_tasks[buffer_b_index]) {
+				if (!task_predecessor_resolver.does_a_precede_b(task_a_index, task_b_index)) {
+					return false;
+				}
 			}
-
-			reduced_buffer_concurrency.push_back(buffer_concurrency[buffer_a_index * buffer_count + buffer_b_index]);
 		}
-	}
-
-	wl_assert(reduced_buffer_concurrency.size() == valid_buffer_count * valid_buffer_count);
-
-	// Merge buffers which are not concurrent. To merge buffer x with buffers S=(a,b,c,...), buffer x must not be
-	// concurrent with any buffers in S.
-	return estimate_max_concurrency(valid_buffer_count, reduced_buffer_concurrency);
-}
-
-uint32 c_task_graph::estimate_max_concurrency(uint32 node_count, const std::vector<bool> &concurrency_matrix) const {
-	wl_assert(node_count * node_count == concurrency_matrix.size());
-
-	static constexpr size_t k_none = static_cast<size_t>(-1);
-	struct s_merged_node_group {
-		uint32 node_index;
-		size_t next;
 
+		return true;
 	};
 
-	std::vector<s_merged_node_group> merge_group_lists;
-	std::vector<size_t> merge_group_heads;
+	s_buffer_slot_assignment &assignment = m_buffer_slot_assignments[enum_index(e_task_graph_schedule::k_concurrent)];
+	assignment.buffer_slots.resize(m_buffers.size(), k_invalid_buffer_slot);
+
+	// Greedily place each buffer into the first slot of a matching type whose buffers are all ordered with respect to
+	// it. Like the task concurrency estimate, this can use more slots than necessary.
+	std::vector<std::vector<size_t>> slot_buffer_indices;
+	for (size_t buffer_index : buffer_indices) {
+		wl_assert(!m_buffers[buffer_index].is_compile_time_constant());
+		c_task_data_type data_type = m_buffers[buffer_index].get_data_type();
+		uint32 assigned_slot = k_invalid_buffer_slot;
+		for (uint32 slot = 0; assigned_slot == k_invalid_buffer_slot && slot < assignment.slot_types.size(); slot++) {
+			if (assignment.slot_types[slot] != data_type) {
+				continue;
+			}
 
-	// Attempt to merge each node with the first possible merge group we encounter. If no merge is successful, make a
-	// new merge group.
-	for (uint32 node_index_a = 0; node_index_a < node_count; node_index_a++) {
-		bool merged = false;
-		for (size_t merge_group_index = 0;
-			!merged && merge_group_index < merge_group_heads.size();
-			merge_group_index++) {
-			bool can_merge = true;
-			size_t node_index_b = merge_group_heads[merge_group_index];
-			while (node_index_b != k_none && can_merge) {
-				s_merged_node_group merged_node_group = merge_group_lists[node_index_b];
-				if (concurrency_matrix[node_index_a * node_count + merged_node_group.node_index]) {
-					// These two nodes are concurrent, so we can't merge them
-					can_merge = false;
+			bool can_share = true;
+			for (size_t slot_buffer_index : slot_buffer_indices[slot]) {
+				if (!does_buffer_a_precede_buffer_b(slot_buffer_index, buffer_index)
+					&& !does_buffer_a_precede_buffer_b(buffer_index, slot_buffer_index)) {
+					can_share = false;
+					break;
 				}
-
-				node_index_b = merged_node_group.next;
 			}
 
-			if (can_merge) {
-				size_t new_index = merge_group_lists.size();
-
-				s_merged_node_group merged_node_group;
-				merged_node_group.node_index = node_index_a;
-				merged_node_group.next = merge_group_heads[merge_group_index];
-				merge_group_lists.push_back(merged_node_group);
-				merge_group_heads[merge_group_index] = new_index;
-
-				merged = true;
+			if (can_share) {
+				assigned_slot = slot;
 			}
 		}
 
-		if (!merged) {
-			// No valid merges, add a new merge group
-			merge_group_heads.push_back(merge_group_lists.size());
-
-			s_merged_node_group merged_node_group;
-			merged_node_group.node_index = node_index_a;
-			merged_node_group.next = k_none;
-			merge_group_lists.push_back(merged_node_group);
+		if (assigned_slot == k_invalid_buffer_slot) {
+			assigned_slot = cast_integer_verify<uint32>(assignment.slot_types.size());
+			assignment.slot_types.push_back(data_type);
+			slot_buffer_indices.emplace_back();
 		}
-	}
 
-	// The number of merge groups we end up with is the max concurrency. It is an overestimate, meaning we will reserve
-	// more memory than necessary.
-	return cast_integer_verify<uint32>(merge_group_heads.size());
+		assignment.buffer_slots[buffer_index] = assigned_slot;
+		slot_buffer_indices[assigned_slot].push_back(buffer_index);
+	}
 }
 
 #if IS_TRUE(OUTPUT_TASK_GRAPH_BUILD_RESULT)
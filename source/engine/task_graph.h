@@ -4,6 +4,7 @@
 #include "common/utility/string_table.h"
 
 #include "engine/task_function_registry.h"
+#include "engine/task_fusion.h"
 
 #include "instrument/graph_node_handle.h"
 #include "instrument/instrument_stage.h"
@@ -11,6 +12,7 @@
 #include "task_function/task_function.h"
 
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class c_native_module_graph;
@@ -18,6 +20,18 @@ class c_predecessor_resolver;
 
 using c_task_graph_task_array = c_wrapped_array<const uint32>;
 
+// Describes how the tasks of a single task graph instance are scheduled. Each schedule has its own buffer slot
+// assignment because buffer lifetimes depend on the order in which tasks can execute.
+enum class e_task_graph_schedule {
+	// Tasks are executed one at a time in the sequential task order
+	k_sequential,
+
+	// Tasks are executed in any order which satisfies every predecessor constraint, possibly in parallel
+	k_concurrent,
+
+	k_count
+};
+
 // Iterates through all non-constant buffers associated with a task
 class c_task_buffer_iterator {
 public:
@@ -45,6 +59,8 @@ public:
 		uint32 max_concurrency;
 	};
 
+	static constexpr uint32 k_invalid_buffer_slot = static_cast<uint32>(-1);
+
 	c_task_graph() = default;
 
 	bool build(const c_native_module_graph &native_module_graph);
@@ -56,10 +72,24 @@ public:
 	uint32 get_task_upsample_factor(uint32 task_index) const;
 	c_task_function_runtime_arguments get_task_arguments(uint32 task_index) const;
 
+	// Chains of elementwise tasks are fused into a single task which evaluates the whole expression in one pass. For
+	// these tasks, the instruction list is non-empty and should be executed using execute_fused_task() in place of the
+	// task function. The task function of the final task in the chain is retained for identification.
+	c_fused_task_instruction_array get_task_fused_instructions(uint32 task_index) const;
+
 	size_t get_task_predecessor_count(uint32 task_index) const;
 	c_task_graph_task_array get_task_successors(uint32 task_index) const;
 
 	c_task_graph_task_array get_initial_tasks() const;
+
+	// Each task's priority is the estimated cost of the longest chain of tasks starting with that task, where a task's
+	// cost is estimated from the number of samples it processes. Ready tasks on the critical path should be executed
+	// first, so successor lists and the initial task list are sorted by decreasing priority.
+	uint32 get_task_priority(uint32 task_index) const;
+
+	// Returns the cost of the longest chain of tasks in the graph using the provided cost for each task
+	real64 calculate_critical_path_cost(c_wrapped_array<const real64> task_costs) const;
+
 	c_buffer_array get_inputs() const;
 	c_buffer_array get_outputs() const;
 	c_buffer *get_remain_active_output() const;
@@ -68,7 +98,15 @@ public:
 	c_buffer *get_buffer_by_index(size_t index) const;
 	size_t get_buffer_index(const c_buffer *buffer) const;
 
-	c_wrapped_array<const s_buffer_usage_info> get_buffer_usage_info() const;
+	// Returns all tasks in an order which satisfies every predecessor constraint. When only a single thread is
+	// processing the graph, the tasks can simply be executed in this order without any scheduling.
+	c_task_graph_task_array get_sequential_task_order() const;
+
+	// Each dynamic buffer is statically assigned to a slot for each schedule. Buffers of the same type share a slot if
+	// their lifetimes can never overlap under that schedule. Compile-time constants are assigned k_invalid_buffer_slot.
+	uint32 get_buffer_slot_count(e_task_graph_schedule schedule) const;
+	c_task_data_type get_buffer_slot_type(e_task_graph_schedule schedule, uint32 slot_index) const;
+	uint32 get_buffer_slot(e_task_graph_schedule schedule, size_t buffer_index) const;
 
 	uint32 get_output_latency() const;
 
@@ -82,8 +120,14 @@ private:
 		// The upsample factor of this task
 		uint32 upsample_factor;
 
-		// Start index in m_task_function_arguments
+		// Start index in m_task_function_arguments and number of arguments. The argument count only differs from the
+		// task function's argument count for fused tasks.
 		size_t arguments_start;
+		size_t argument_count;
+
+		// Start index in m_fused_task_instructions and number of instructions. The count is 0 for unfused tasks.
+		size_t fused_instructions_start;
+		size_t fused_instructions_count;
 
 		// Number of tasks which must complete before this task is executed
 		size_t predecessor_count;
@@ -91,6 +135,19 @@ private:
 		// List of tasks which can execute only after this task has been completed
 		size_t successors_start;
 		size_t successors_count;
+
+		// Estimated cost of the longest chain of tasks starting with this task
+		uint32 priority;
+	};
+
+	struct s_task_fusion_state;
+
+	struct s_buffer_slot_assignment {
+		// Type of each buffer slot
+		std::vector<c_task_data_type> slot_types;
+
+		// The slot assigned to each buffer
+		std::vector<uint32> buffer_slots;
 	};
 
 	void clear();
@@ -105,6 +162,16 @@ private:
 		h_graph_node node_handle,
 		uint32 task_index);
 
+	void fuse_elementwise_tasks(
+		const c_native_module_graph &native_module_graph,
+		std::unordered_map<h_graph_node, uint32> &nodes_to_tasks,
+		std::unordered_set<h_graph_node> &fused_node_handles);
+	uint32 add_fused_task_instruction(
+		const c_native_module_graph &native_module_graph,
+		h_graph_node node_handle,
+		s_task_fusion_state &state);
+	void remove_unreferenced_arguments_and_buffers();
+
 	c_buffer *add_or_get_buffer(
 		const c_native_module_graph &native_module_graph,
 		h_graph_node node_handle,
@@ -143,20 +210,25 @@ private:
 
 	void build_task_successor_lists(
 		const c_native_module_graph &native_module_graph,
-		const std::unordered_map<h_graph_node, uint32> &nodes_to_tasks);
+		const std::unordered_map<h_graph_node, uint32> &nodes_to_tasks,
+		const std::unordered_set<h_graph_node> &fused_node_handles);
 	void add_task_successor(uint32 predecessor_task_index, uint32 successor_task_index);
 	void calculate_max_concurrency();
-	void add_usage_info_for_buffer_type(
-		const c_predecessor_resolver &predecessor_resolver,
-		c_task_data_type data_type);
-	uint32 calculate_max_buffer_concurrency(
-		const c_predecessor_resolver &task_predecessor_resolver,
-		c_task_data_type data_type) const;
 	uint32 estimate_max_concurrency(uint32 node_count, const std::vector<bool> &concurrency_matrix) const;
+	void build_sequential_task_order();
+	void calculate_bottom_level_costs(
+		c_wrapped_array<const real64> task_costs,
+		std::vector<real64> &bottom_level_costs_out) const;
+	void assign_task_priorities();
+	void assign_sequential_buffer_slots();
+	void assign_concurrent_buffer_slots(const c_predecessor_resolver &task_predecessor_resolver);
 
 	std::vector<s_task> m_tasks;
 	std::vector<s_task_function_runtime_argument> m_task_function_arguments;
 
+	// Instructions evaluated by fused tasks
+	std::vector<s_fused_task_instruction> m_fused_task_instructions;
+
 	// List of all buffers
 	std::vector<c_buffer> m_buffers;
 
@@ -193,8 +265,11 @@ private:
 	// Max amount of concurrency that can exist at any given time during execution
 	uint32 m_max_task_concurrency = 0;
 
-	// Information about the usage of buffers, including type and max concurrency
-	std::vector<s_buffer_usage_info> m_buffer_usage_info;
+	// Order in which to execute tasks when processing on a single thread
+	std::vector<uint32> m_sequential_task_order;
+
+	// Buffer slot assignment for each schedule
+	s_static_array<s_buffer_slot_assignment, enum_count<e_task_graph_schedule>()> m_buffer_slot_assignments;
 
 	// List of initial tasks
 	size_t m_initial_tasks_start = k_invalid_list_index;
@@ -23,8 +23,27 @@ void c_thread_pool::start(const s_thread_pool_settings &settings) {
 		m_pending_tasks_queue_memory.get_array(),
 		m_pending_tasks_free_list_memory.get_array());
 
+	// Any single thread may end up holding every task, so each deque must be able to hold max_tasks elements. The
+	// external thread gets the last deque.
+	size_t deque_size = 1;
+	while (deque_size < settings.max_tasks) {
+		deque_size *= 2;
+	}
+
+	size_t thread_queue_count = settings.thread_count + 1;
+	m_thread_queues.allocate(thread_queue_count);
+	m_thread_queue_element_memory.allocate(thread_queue_count * deque_size);
+	for (size_t thread_index = 0; thread_index < thread_queue_count; thread_index++) {
+		s_thread_queue &thread_queue = m_thread_queues.get_array()[thread_index];
+		thread_queue.deque.initialize(
+			m_thread_queue_element_memory.get_array().get_range(thread_index * deque_size, deque_size));
+		thread_queue.random_state = cast_integer_verify<uint32>(thread_index + 1);
+	}
+
 	m_check_paused = settings.start_paused;
 	m_paused = settings.start_paused;
+	m_idle_spin_count = settings.idle_spin_count;
+	m_wakeup_count = 0;
 
 #if IS_TRUE(ASSERTS_ENABLED)
 	m_memory_allocations_allowed = settings.memory_allocations_allowed;
@@ -83,9 +102,16 @@ uint32 c_thread_pool::stop() {
 		unexecuted_tasks++;
 	}
 
+	// All threads have been joined so it's safe to access each deque
+	for (s_thread_queue &thread_queue : m_thread_queues.get_array()) {
+		unexecuted_tasks += cast_integer_verify<uint32>(thread_queue.deque.get_count_unsafe());
+	}
+
 	m_pending_tasks_element_memory.free_memory();
 	m_pending_tasks_queue_memory.free_memory();
 	m_pending_tasks_free_list_memory.free_memory();
+	m_thread_queues.free_memory();
+	m_thread_queue_element_memory.free_memory();
 
 #if IS_TRUE(ASSERTS_ENABLED)
 	m_running = false;
@@ -129,6 +155,14 @@ void c_thread_pool::resume() {
 	}
 }
 
+uint32 c_thread_pool::get_thread_count() const {
+	return cast_integer_verify<uint32>(m_threads.size());
+}
+
+uint32 c_thread_pool::get_wakeup_count() const {
+	return m_wakeup_count;
+}
+
 bool c_thread_pool::add_task(const s_thread_pool_task &task) {
 	wl_assert(m_running);
 
@@ -139,11 +173,38 @@ bool c_thread_pool::add_task(const s_thread_pool_task &task) {
 	return m_pending_tasks.push(pending_task);
 }
 
+bool c_thread_pool::add_task(uint32 thread_index, const s_thread_pool_task &task) {
+	wl_assert(m_running);
+
+	s_task pending_task;
+	pending_task.task_function = task.task_entry_point;
+	copy_type(&pending_task.params, &task.parameter_block);
+
+	return m_thread_queues.get_array()[thread_index].deque.push(pending_task);
+}
+
+bool c_thread_pool::execute_task(uint32 thread_index) {
+	wl_assert(m_running);
+
+	s_task task;
+	if (!get_next_task(thread_index, task)) {
+		return false;
+	}
+
+	// Termination tasks are only pushed by stop(), which can't run at the same time as this function
+	wl_assert(task.task_function);
+	task.task_function(thread_index, &task.params);
+	return true;
+}
+
 void c_thread_pool::worker_thread_entry_point(const s_thread_parameter_block *param_block) {
 	const s_worker_thread_context &context = *param_block->get_memory_typed<s_worker_thread_context>();
 
 	SET_MEMORY_ALLOCATIONS_ALLOWED_FOR_SCOPE(context.this_ptr->m_memory_allocations_allowed);
 
+	// Number of consecutive times we've failed to find a task
+	uint32 idle_iterations = 0;
+
 	// Keep looping until we find a termination task
 	while (true) {
 		// Check if we should pause
@@ -153,18 +214,29 @@ void c_thread_pool::worker_thread_entry_point(const s_thread_parameter_block *pa
 			if (context.this_ptr->m_paused) {
 				// Wait on the condition variable. If we spuriously wake up, we will loop and pause again.
 				context.this_ptr->m_pause_condition_variable.wait(lock);
+				context.this_ptr->m_wakeup_count++;
 			}
+
+			idle_iterations = 0;
 		}
 
-		// Attempt to pop a task from the queue
+		// Attempt to find a task
 		s_task task;
-		if (context.this_ptr->m_pending_tasks.pop(task)) {
+		if (context.this_ptr->get_next_task(context.worker_thread_index, task)) {
 			// If this task has no task function, it is an indication that we should terminate
 			if (!task.task_function) {
 				break;
 			}
 
 			task.task_function(context.worker_thread_index, &task.params);
+			idle_iterations = 0;
+		} else if (idle_iterations < context.this_ptr->m_idle_spin_count) {
+			// Spin for a bounded number of iterations since more tasks are likely to show up very soon
+			c_thread::spin_wait_hint();
+			idle_iterations++;
+		} else {
+			// We've been idle for a while, back off so we don't starve other threads (e.g. the audio thread)
+			c_thread::yield();
 		}
 	}
 }
@@ -172,14 +244,43 @@ void c_thread_pool::worker_thread_entry_point(const s_thread_parameter_block *pa
 void c_thread_pool::execute_all_tasks_synchronous() {
 	SET_MEMORY_ALLOCATIONS_ALLOWED_FOR_SCOPE(m_memory_allocations_allowed);
 
-	// Attempt to pop a task from the queue
-	s_task task;
-	while (m_pending_tasks.pop(task)) {
-		// If this task has no task function, it is an indication that we should terminate
-		if (!task.task_function) {
-			return;
-		}
+	// With no worker threads, the only deque is the external thread's deque. Termination tasks are never pushed in this
+	// case because there are no threads to terminate.
+	while (execute_task(0)) {}
+}
 
-		task.task_function(0, &task.params);
+bool c_thread_pool::get_next_task(uint32 thread_index, s_task &task_out) {
+	c_wrapped_array<s_thread_queue> thread_queues = m_thread_queues.get_array();
+	s_thread_queue &thread_queue = thread_queues[thread_index];
+
+	if (thread_queue.deque.pop(task_out)) {
+		return true;
+	}
+
+	if (m_pending_tasks.pop(task_out)) {
+		return true;
+	}
+
+	// Pick a random victim to start with so that idle threads don't all converge on the same deque
+	uint32 thread_queue_count = cast_integer_verify<uint32>(thread_queues.get_count());
+	if (thread_queue_count <= 1) {
+		return false;
 	}
+
+	// xorshift32
+	uint32 random_state = thread_queue.random_state;
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	thread_queue.random_state = random_state;
+
+	uint32 first_victim_index = random_state % thread_queue_count;
+	for (uint32 offset = 0; offset < thread_queue_count; offset++) {
+		uint32 victim_index = (first_victim_index + offset) % thread_queue_count;
+		if (victim_index != thread_index && thread_queues[victim_index].deque.steal(task_out)) {
+			return true;
+		}
+	}
+
+	return false;
 }
@@ -5,6 +5,7 @@
 #include "common/threading/lock_free_queue.h"
 #include "common/threading/mutex.h"
 #include "common/threading/thread.h"
+#include "common/threading/work_stealing_deque.h"
 
 #include <atomic>
 #include <vector>
@@ -17,6 +18,9 @@ struct s_thread_pool_settings {
 
 	// Whether memory allocations are allowed on worker threads (used in assert-enabled builds only)
 	bool memory_allocations_allowed = true;
+
+	// Number of times an idle worker thread spins before it starts yielding its time slice while waiting for tasks
+	uint32 idle_spin_count = 1024;
 };
 
 // Entry point worker thread function
@@ -29,6 +33,10 @@ struct s_thread_pool_task {
 };
 
 // Simple thread pool class. Spawns N threads which consume work tasks. Task dependencies should be externally managed.
+// Each worker thread has its own work-stealing deque. Tasks added from within a task are pushed onto the executing
+// thread's deque and are popped in LIFO order, which keeps the data they operate on warm in the cache. Idle threads
+// steal from the other deques. One additional thread index, equal to the thread count, is reserved for a single
+// external thread which helps execute tasks via execute_task().
 class c_thread_pool {
 public:
 	c_thread_pool() = default;
@@ -48,10 +56,25 @@ public:
 	// Resumes paused worker threads
 	void resume();
 
+	uint32 get_thread_count() const;
+
+	// Returns the number of times a worker thread has been woken up after being paused
+	uint32 get_wakeup_count() const;
+
 	// Thread-safe functions: these can be called from any thread, including worker threads:
 
+	// Adds a task to the shared queue
 	bool add_task(const s_thread_pool_task &task);
 
+	// Adds a task to the deque owned by the given thread. This must only be called from the thread which owns that
+	// thread index, i.e. from a task running on that thread or from the external thread.
+	bool add_task(uint32 thread_index, const s_thread_pool_task &task);
+
+	// Pops a single task and executes it on the calling thread using the provided thread index. This allows a thread
+	// which would otherwise block waiting for tasks to complete to help out instead. Returns false if no task was
+	// available.
+	bool execute_task(uint32 thread_index);
+
 private:
 	// Internal representation of a task
 	struct ALIGNAS_LOCK_FREE s_task {
@@ -65,9 +88,21 @@ private:
 		uint32 worker_thread_index;
 	};
 
+	// Per-thread task deque, including one for the external thread
+	struct alignas(CACHE_LINE_SIZE) s_thread_queue {
+		c_work_stealing_deque<s_task> deque;
+
+		// State used to pick random steal victims
+		uint32 random_state;
+	};
+
 	static void worker_thread_entry_point(const s_thread_parameter_block *param_block);
 	void execute_all_tasks_synchronous();
 
+	// Finds the next task for the given thread. The thread's own deque is checked first, followed by the shared queue,
+	// and finally the other threads' deques in random order.
+	bool get_next_task(uint32 thread_index, s_task &task_out);
+
 	std::vector<c_thread> m_threads;
 
 #if IS_TRUE(ASSERTS_ENABLED)
@@ -78,13 +113,23 @@ private:
 	bool m_running = false;
 #endif // IS_TRUE(ASSERTS_ENABLED)
 
+	// Number of spin iterations before an idle worker thread starts yielding
+	uint32 m_idle_spin_count = 0;
+
+	// Number of times worker threads have woken up after being paused
+	std::atomic<uint32> m_wakeup_count = 0;
+
 	// Used to allow threads to pause in a blocking way when we don't want to hog CPU
 	std::atomic<bool> m_check_paused = false;			// Lock-free guard against unnecessarily acquiring the mutex
 	bool m_paused = false;								// Whether threads should be paused
 	c_mutex m_pause_mutex;								// Mutex to protect the paused bool
 	c_condition_variable m_pause_condition_variable;	// Used with the pause mutex
 
-	// Queue of tasks to complete
+	// Work-stealing deque for each thread
+	c_aligned_allocator<s_thread_queue, CACHE_LINE_SIZE> m_thread_queues;
+	c_lock_free_aligned_allocator<s_task> m_thread_queue_element_memory;
+
+	// Queue of tasks added from outside of the thread pool, including termination tasks
 	c_lock_free_queue<s_task> m_pending_tasks;
 	c_lock_free_aligned_allocator<s_task> m_pending_tasks_element_memory;
 	c_lock_free_aligned_allocator<s_aligned_lock_free_handle> m_pending_tasks_queue_memory;
@@ -22,6 +22,8 @@ e_instrument_result c_instrument_variant::save(std::ofstream &out) const {
 	writer.write(m_instrument_globals.sample_rate);
 	writer.write(m_instrument_globals.chunk_size);
 	writer.write(m_instrument_globals.activate_fx_immediately);
+	writer.write(m_instrument_globals.inaudible_voice_timeout);
+	writer.write(m_instrument_globals.inaudible_voice_threshold);
 
 	// Write each graph
 	writer.write(m_voice_native_module_graph != nullptr);
@@ -54,7 +56,9 @@ e_instrument_result c_instrument_variant::load(std::ifstream &in) {
 	if (!reader.read(m_instrument_globals.max_voices)
 		|| !reader.read(m_instrument_globals.sample_rate)
 		|| !reader.read(m_instrument_globals.chunk_size)
-		|| !reader.read(m_instrument_globals.activate_fx_immediately)) {
+		|| !reader.read(m_instrument_globals.activate_fx_immediately)
+		|| !reader.read(m_instrument_globals.inaudible_voice_timeout)
+		|| !reader.read(m_instrument_globals.inaudible_voice_threshold)) {
 		return in.eof() ? e_instrument_result::k_invalid_globals : e_instrument_result::k_failed_to_read;
 	}
 
@@ -17,5 +17,13 @@ struct s_instrument_globals {
 
 	// Whether to start FX processing immediately. If false, FX processing starts when any voice is activated.
 	bool activate_fx_immediately = false;
+
+	// If non-zero, a released voice is deactivated once all of its outputs have been constant and inaudible for at
+	// least this many consecutive samples, even if its remain-active output is still true. If 0, voices are only
+	// deactivated through the remain-active output.
+	uint32 inaudible_voice_timeout = 0;
+
+	// Constant voice outputs with a magnitude at or below this value are considered inaudible
+	real32 inaudible_voice_threshold = 0.0f;
 };
 
@@ -3,6 +3,7 @@
 #include "instrument/native_modules/json/json_file_manager.h"
 
 s_json_result c_json_file_manager::load_json_file(const char *filename, const c_json_file **json_file_out) {
+	c_scoped_lock lock(m_mutex);
 	for (const s_load_request &load_request : m_load_requests) {
 		if (are_file_paths_equivalent(filename, load_request.filename.c_str())) {
 			// Will be null if the request previously failed
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "common/common.h"
+#include "common/threading/mutex.h"
 
 #include "instrument/native_modules/json/json_file.h"
 
 #include <memory>
 #include <vector>
 
+// Caches loaded JSON files. This is shared between instrument variants, which may be built on multiple threads at once.
 class c_json_file_manager {
 public:
 	c_json_file_manager() = default;
@@ -20,5 +22,6 @@ private:
 		std::unique_ptr<c_json_file> json_file; // Null if the file failed to load
 	};
 
+	c_mutex m_mutex;
 	std::vector<s_load_request> m_load_requests;
 };
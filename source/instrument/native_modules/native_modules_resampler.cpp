@@ -10,25 +10,17 @@ void resample_real_validate_arguments(
 	bool is_upsampling,
 	uint32 resample_factor,
 	real32 quality) {
-	if (get_resampler_filter_from_quality(is_upsampling, resample_factor, quality) == e_resampler_filter::k_invalid) {
+	if (get_resampler_stage(is_upsampling, resample_factor, quality, 0).resampler_filter
+		== e_resampler_filter::k_invalid) {
 		context.diagnostic_interface->error("Invalid quality '%f'", quality);
 	}
 }
 
 int32 resample_real_get_latency(bool is_upsampling, uint32 resample_factor, real32 quality) {
-	e_resampler_filter resampler_filter = get_resampler_filter_from_quality(is_upsampling, resample_factor, quality);
-	if (is_upsampling) {
-		// The latency is in terms of the downsampled sample rate
-		const s_resampler_parameters &parameters = get_resampler_parameters(resampler_filter);
-		return parameters.latency;
-	} else {
-		// The latency is in terms of the downsampled sample rate. Since we're sampling from the upsampled signal, the
-		// reported resampler latency is in terms of the upsampled sample rate. To convert, we divide (rounding up) by
-		// the downsample factor. By rounding up, we may add up to resample_factor - 1 additional samples of delay to
-		// the upsampled signal.
-		const s_resampler_parameters &parameters = get_resampler_parameters(resampler_filter);
-		return (parameters.latency + resample_factor - 1) / resample_factor;
-	}
+	// When upsampling, the latency is in terms of the downsampled sample rate. When downsampling, the reported
+	// resampler latency is in terms of the upsampled sample rate, so it gets divided (rounding up) by the downsample
+	// factor. By rounding up, we may add up to resample_factor - 1 additional samples of delay to the upsampled signal.
+	return get_resampler_latency(is_upsampling, resample_factor, quality).latency;
 }
 
 namespace resampler_native_modules {
@@ -81,6 +73,38 @@ namespace resampler_native_modules {
 		wl_argument(in const real, quality),
 		wl_argument(return out real@4x, upsampled_signal));
 
+	void upsample8x_real_validate_arguments(
+		const s_native_module_context &context,
+		wl_argument(in const real, quality)) {
+		resample_real_validate_arguments(context, true, 8, *quality);
+	}
+
+	int32 upsample8x_real_get_latency(
+		wl_argument(in const real, quality)) {
+		return resample_real_get_latency(true, 8, *quality);
+	}
+
+	void upsample8x_real(
+		wl_argument(in real, signal),
+		wl_argument(in const real, quality),
+		wl_argument(return out real@8x, upsampled_signal));
+
+	void upsample16x_real_validate_arguments(
+		const s_native_module_context &context,
+		wl_argument(in const real, quality)) {
+		resample_real_validate_arguments(context, true, 16, *quality);
+	}
+
+	int32 upsample16x_real_get_latency(
+		wl_argument(in const real, quality)) {
+		return resample_real_get_latency(true, 16, *quality);
+	}
+
+	void upsample16x_real(
+		wl_argument(in real, signal),
+		wl_argument(in const real, quality),
+		wl_argument(return out real@16x, upsampled_signal));
+
 	void downsample2x_real_validate_arguments(
 		const s_native_module_context &context,
 		wl_argument(in const real, quality)) {
@@ -129,6 +153,38 @@ namespace resampler_native_modules {
 		wl_argument(in const real, quality),
 		wl_argument(return out real, downsampled_signal));
 
+	void downsample8x_real_validate_arguments(
+		const s_native_module_context &context,
+		wl_argument(in const real, quality)) {
+		resample_real_validate_arguments(context, false, 8, *quality);
+	}
+
+	int32 downsample8x_real_get_latency(
+		wl_argument(in const real, quality)) {
+		return resample_real_get_latency(false, 8, *quality);
+	}
+
+	void downsample8x_real(
+		wl_argument(in real@8x, signal),
+		wl_argument(in const real, quality),
+		wl_argument(return out real, downsampled_signal));
+
+	void downsample16x_real_validate_arguments(
+		const s_native_module_context &context,
+		wl_argument(in const real, quality)) {
+		resample_real_validate_arguments(context, false, 16, *quality);
+	}
+
+	int32 downsample16x_real_get_latency(
+		wl_argument(in const real, quality)) {
+		return resample_real_get_latency(false, 16, *quality);
+	}
+
+	void downsample16x_real(
+		wl_argument(in real@16x, signal),
+		wl_argument(in const real, quality),
+		wl_argument(return out real, downsampled_signal));
+
 	void upsample2x_bool(
 		wl_argument(in bool, signal),
 		wl_argument(return out bool@2x, upsampled_signal));
@@ -172,6 +228,16 @@ namespace resampler_native_modules {
 			.set_validate_arguments<upsample4x_real_validate_arguments>()
 			.set_get_latency<upsample4x_real_get_latency>();
 
+		wl_native_module(0x9447f532, "upsample8x$real")
+			.set_call_signature<decltype(upsample8x_real)>()
+			.set_validate_arguments<upsample8x_real_validate_arguments>()
+			.set_get_latency<upsample8x_real_get_latency>();
+
+		wl_native_module(0xef2c52b5, "upsample16x$real")
+			.set_call_signature<decltype(upsample16x_real)>()
+			.set_validate_arguments<upsample16x_real_validate_arguments>()
+			.set_get_latency<upsample16x_real_get_latency>();
+
 		wl_native_module(0xb2503502, "downsample2x$real")
 			.set_call_signature<decltype(downsample2x_real)>()
 			.set_validate_arguments<downsample2x_real_validate_arguments>()
@@ -187,6 +253,16 @@ namespace resampler_native_modules {
 			.set_validate_arguments<downsample4x_real_validate_arguments>()
 			.set_get_latency<downsample4x_real_get_latency>();
 
+		wl_native_module(0xda2d85aa, "downsample8x$real")
+			.set_call_signature<decltype(downsample8x_real)>()
+			.set_validate_arguments<downsample8x_real_validate_arguments>()
+			.set_get_latency<downsample8x_real_get_latency>();
+
+		wl_native_module(0x2c103e4b, "downsample16x$real")
+			.set_call_signature<decltype(downsample16x_real)>()
+			.set_validate_arguments<downsample16x_real_validate_arguments>()
+			.set_get_latency<downsample16x_real_get_latency>();
+
 		wl_native_module(0xa09fc17f, "upsample2x$bool")
 			.set_call_signature<decltype(upsample2x_bool)>();
 
@@ -212,9 +288,13 @@ namespace resampler_native_modules {
 		wl_optimization_rule(upsample2x$real(0, const q) -> 0);
 		wl_optimization_rule(upsample3x$real(0, const q) -> 0);
 		wl_optimization_rule(upsample4x$real(0, const q) -> 0);
+		wl_optimization_rule(upsample8x$real(0, const q) -> 0);
+		wl_optimization_rule(upsample16x$real(0, const q) -> 0);
 		wl_optimization_rule(downsample2x$real(0, const q) -> 0);
 		wl_optimization_rule(downsample3x$real(0, const q) -> 0);
 		wl_optimization_rule(downsample4x$real(0, const q) -> 0);
+		wl_optimization_rule(downsample8x$real(0, const q) -> 0);
+		wl_optimization_rule(downsample16x$real(0, const q) -> 0);
 		wl_optimization_rule(upsample2x$bool(const x) -> x);
 		wl_optimization_rule(upsample3x$bool(const x) -> x);
 		wl_optimization_rule(upsample4x$bool(const x) -> x);
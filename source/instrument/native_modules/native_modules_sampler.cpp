@@ -22,6 +22,24 @@ namespace sampler_native_modules {
 		wl_argument(in real, phase),
 		wl_argument(return out real, result));
 
+	// Compact versions of the samplers store raw frames rather than precomputed interpolation coefficients, using 4x
+	// less memory (or 8x less if int16_frames is true) at the cost of lower quality interpolation
+	void sampler_compact(
+		wl_argument(in const string, name),
+		wl_argument(in const real, channel),
+		wl_argument(in const bool, int16_frames),
+		wl_argument(in real, speed),
+		wl_argument(return out real, result));
+
+	void sampler_loop_compact(
+		wl_argument(in const string, name),
+		wl_argument(in const real, channel),
+		wl_argument(in const bool, bidi),
+		wl_argument(in const bool, int16_frames),
+		wl_argument(in real, speed),
+		wl_argument(in real, phase),
+		wl_argument(return out real, result));
+
 	void scrape_native_modules() {
 		static constexpr uint32 k_sampler_library_id = 3;
 		wl_native_module_library(k_sampler_library_id, "sampler", 0);
@@ -35,6 +53,12 @@ namespace sampler_native_modules {
 		wl_native_module(0x5616fda5, "sampler_wavetable")
 			.set_call_signature<decltype(sampler_wavetable)>();
 
+		wl_native_module(0x0baf607b, "sampler_compact")
+			.set_call_signature<decltype(sampler_compact)>();
+
+		wl_native_module(0xdd9f203b, "sampler_loop_compact")
+			.set_call_signature<decltype(sampler_loop_compact)>();
+
 		wl_end_active_library_native_module_registration();
 	}
 
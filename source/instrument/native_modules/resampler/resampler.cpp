@@ -43,3 +43,85 @@ e_resampler_filter get_resampler_filter_from_quality(bool is_upsampling, uint32
 
 	return e_resampler_filter::k_invalid;
 }
+
+static e_resampler_filter get_half_band_resampler_filter_from_quality(bool is_upsampling, real32 quality) {
+	if (quality == k_resampler_quality_low) {
+		return is_upsampling
+			? e_resampler_filter::k_upsample_half_band_low_quality
+			: e_resampler_filter::k_downsample_half_band_low_quality;
+	} else if (quality == k_resampler_quality_high) {
+		return is_upsampling
+			? e_resampler_filter::k_upsample_half_band_high_quality
+			: e_resampler_filter::k_downsample_half_band_high_quality;
+	}
+
+	return e_resampler_filter::k_invalid;
+}
+
+bool is_valid_resample_factor(uint32 resample_factor) {
+	return (resample_factor >= 2 && resample_factor <= k_max_single_stage_resample_factor)
+		|| resample_factor == 8
+		|| resample_factor == 16;
+}
+
+uint32 get_resampler_stage_count(uint32 resample_factor) {
+	wl_assert(is_valid_resample_factor(resample_factor));
+	if (resample_factor <= k_max_single_stage_resample_factor) {
+		return 1;
+	}
+
+	uint32 stage_count = 0;
+	while (resample_factor > 1) {
+		resample_factor >>= 1;
+		stage_count++;
+	}
+
+	wl_assert(stage_count <= k_max_resampler_stage_count);
+	return stage_count;
+}
+
+s_resampler_stage get_resampler_stage(bool is_upsampling, uint32 resample_factor, real32 quality, uint32 stage_index) {
+	uint32 stage_count = get_resampler_stage_count(resample_factor);
+	wl_assert(stage_index < stage_count);
+
+	s_resampler_stage result;
+	if (stage_count == 1) {
+		result.resampler_filter = get_resampler_filter_from_quality(is_upsampling, resample_factor, quality);
+		result.resample_factor = resample_factor;
+	} else {
+		// The base sample rate stage is first when upsampling and last when downsampling
+		uint32 base_stage_index = is_upsampling ? 0 : stage_count - 1;
+		result.resampler_filter = (stage_index == base_stage_index)
+			? get_resampler_filter_from_quality(is_upsampling, 2, quality)
+			: get_half_band_resampler_filter_from_quality(is_upsampling, quality);
+		result.resample_factor = 2;
+	}
+
+	return result;
+}
+
+s_resampler_latency get_resampler_latency(bool is_upsampling, uint32 resample_factor, real32 quality) {
+	// Accumulate the latency of each stage in terms of the upsampled sample rate. Filter latency is in terms of each
+	// stage's input sample rate.
+	uint32 stage_count = get_resampler_stage_count(resample_factor);
+	uint32 upsampled_latency = 0;
+	uint32 stage_sample_period = is_upsampling ? resample_factor : 1;
+	for (uint32 stage_index = 0; stage_index < stage_count; stage_index++) {
+		s_resampler_stage stage = get_resampler_stage(is_upsampling, resample_factor, quality, stage_index);
+		const s_resampler_parameters &parameters = get_resampler_parameters(stage.resampler_filter);
+		upsampled_latency += parameters.latency * stage_sample_period;
+		stage_sample_period = is_upsampling
+			? stage_sample_period / stage.resample_factor
+			: stage_sample_period * stage.resample_factor;
+	}
+
+	s_resampler_latency result;
+	uint32 latency = (upsampled_latency + resample_factor - 1) / resample_factor;
+	result.latency = cast_integer_verify<int32>(latency);
+	result.delay = latency * resample_factor - upsampled_latency;
+
+	// Upsampling stages can't add delay in between input samples, so the half-band filter latencies are chosen such
+	// that the total is always a whole number of input samples
+	wl_assert(!is_upsampling || result.delay == 0);
+	return result;
+}
@@ -5,3 +5,29 @@
 #include "instrument/resampler/resampler.h"
 
 e_resampler_filter get_resampler_filter_from_quality(bool is_upsampling, uint32 resample_factor, real32 quality);
+
+// Resample factors above k_max_single_stage_resample_factor are performed as a cascade of 2x stages within a single
+// task. The stage running at the base sample rate uses the full quality filter and the stages running above it use
+// short half-band filters, since the signal there is already bandlimited well below their nyquist frequencies.
+static constexpr uint32 k_max_single_stage_resample_factor = 4;
+static constexpr uint32 k_max_resampler_stage_count = 4;
+
+struct s_resampler_stage {
+	e_resampler_filter resampler_filter;
+	uint32 resample_factor;
+};
+
+struct s_resampler_latency {
+	int32 latency;	// Latency in terms of the downsampled sample rate
+	uint32 delay;	// Additional delay in terms of the upsampled sample rate, only used when downsampling
+};
+
+bool is_valid_resample_factor(uint32 resample_factor);
+uint32 get_resampler_stage_count(uint32 resample_factor);
+
+// Stages are returned in processing order, so upsampling starts at the base sample rate and downsampling ends at it
+s_resampler_stage get_resampler_stage(bool is_upsampling, uint32 resample_factor, real32 quality, uint32 stage_index);
+
+// Returns the total latency of all stages. When downsampling, the latency is rounded up to a whole number of
+// downsampled samples and the difference is added as delay to the first stage.
+s_resampler_latency get_resampler_latency(bool is_upsampling, uint32 resample_factor, real32 quality);
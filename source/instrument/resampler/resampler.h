@@ -15,6 +15,12 @@ enum class e_resampler_filter {
 	k_downsample_3x_high_quality,
 	k_downsample_4x_high_quality,
 
+	// Used for the stages of 8x and 16x resampling which run above the base sample rate
+	k_upsample_half_band_low_quality,
+	k_downsample_half_band_low_quality,
+	k_upsample_half_band_high_quality,
+	k_downsample_half_band_high_quality,
+
 	k_count
 };
 
@@ -1,6 +1,6 @@
 // This file was auto-generated by generate_resampler_filters.py. Do not edit.
 
-STATIC_ASSERT_MSG(enum_count<e_resampler_filter>() == 8, "Resampler filter enum length mismatch");
+STATIC_ASSERT_MSG(enum_count<e_resampler_filter>() == 12, "Resampler filter enum length mismatch");
 STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_upsample_low_quality) == 0, "Resampler filter enum mismatch");
 STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_downsample_2x_low_quality) == 1, "Resampler filter enum mismatch");
 STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_downsample_3x_low_quality) == 2, "Resampler filter enum mismatch");
@@ -9,6 +9,10 @@ STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_upsample_high_quality) == 4,
 STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_downsample_2x_high_quality) == 5, "Resampler filter enum mismatch");
 STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_downsample_3x_high_quality) == 6, "Resampler filter enum mismatch");
 STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_downsample_4x_high_quality) == 7, "Resampler filter enum mismatch");
+STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_upsample_half_band_low_quality) == 8, "Resampler filter enum mismatch");
+STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_downsample_half_band_low_quality) == 9, "Resampler filter enum mismatch");
+STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_upsample_half_band_high_quality) == 10, "Resampler filter enum mismatch");
+STATIC_ASSERT_MSG(enum_index(e_resampler_filter::k_downsample_half_band_high_quality) == 11, "Resampler filter enum mismatch");
 
 static const s_resampler_parameters k_resampler_parameters[] = {
 	{
@@ -51,6 +55,26 @@ static const s_resampler_parameters k_resampler_parameters[] = {
 		256,
 		128
 	},
+	{
+		2,
+		16,
+		8
+	},
+	{
+		2,
+		16,
+		8
+	},
+	{
+		2,
+		32,
+		16
+	},
+	{
+		2,
+		48,
+		24
+	},
 };
 
 const s_resampler_parameters &get_resampler_parameters(e_resampler_filter resampler_filter) {
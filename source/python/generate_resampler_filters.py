@@ -77,6 +77,46 @@ params.window_type = polyphase_fir_generator.WindowType.KAISER
 params.kaiser_beta = 15.0
 all_filter_params.append(("downsample_4x_high_quality", params))
 
+# Half-band filters are used for the 2x stages of 8x and 16x resampling which run above the base sample rate. The
+# signal at these stages is bandlimited to at most half of the stage's nyquist frequency, so the transition band can
+# be very wide and far fewer taps are needed. Latency (taps_per_phase / 2) must be a multiple of 8 so that the total
+# latency of a 16x resampler is a whole number of base sample rate samples.
+params = polyphase_fir_generator.FilterParams()
+params.upsample_factor = 2
+params.taps_per_phase = 16
+params.cutoff_frequency = 0.5
+params.window_type = polyphase_fir_generator.WindowType.KAISER
+params.kaiser_beta = 4.5
+params.half_band = True
+all_filter_params.append(("upsample_half_band_low_quality", params))
+
+params = polyphase_fir_generator.FilterParams()
+params.upsample_factor = 2
+params.taps_per_phase = 16
+params.cutoff_frequency = 0.25
+params.window_type = polyphase_fir_generator.WindowType.KAISER
+params.kaiser_beta = 4.5
+params.half_band = True
+all_filter_params.append(("downsample_half_band_low_quality", params))
+
+params = polyphase_fir_generator.FilterParams()
+params.upsample_factor = 2
+params.taps_per_phase = 32
+params.cutoff_frequency = 0.5
+params.window_type = polyphase_fir_generator.WindowType.KAISER
+params.kaiser_beta = 15.0
+params.half_band = True
+all_filter_params.append(("upsample_half_band_high_quality", params))
+
+params = polyphase_fir_generator.FilterParams()
+params.upsample_factor = 2
+params.taps_per_phase = 48
+params.cutoff_frequency = 0.25
+params.window_type = polyphase_fir_generator.WindowType.KAISER
+params.kaiser_beta = 15.0
+params.half_band = True
+all_filter_params.append(("downsample_half_band_high_quality", params))
+
 # Generate filters and write them to a file
 coefficients_per_line = 16
 
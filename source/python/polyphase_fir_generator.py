@@ -28,6 +28,7 @@ class FilterParams:
 		self.window_type = WindowType.RECTANGULAR
 		self.kaiser_beta = 0.0
 		self.notch_frequencies = [] # Two notches at 0.5 is an experiment that isn't working so well
+		self.half_band = False # If true, the transition band is centered on the cutoff rather than ending at it
 
 class PolyphaseFir:
 	def __init__(self):
@@ -93,8 +94,14 @@ def build_polyphase_fir(params, plot = False, plot_sample_rate = 1.0):
 	main_lobe_width, side_lobe_magnitude = analyze_window(window)
 	transition_bandwidth = main_lobe_width * params.upsample_factor / (2.0 * np.pi)
 
-	# Adjust the cutoff based on window analysis results
-	windowed_cutoff = params.cutoff_frequency - transition_bandwidth * 0.5
+	# Adjust the cutoff based on window analysis results. Half-band filters keep the transition band centered on the
+	# cutoff so that it is symmetric around a quarter of the upsampled sample rate.
+	if params.half_band:
+		windowed_cutoff = params.cutoff_frequency
+		stopband_frequency = params.cutoff_frequency + transition_bandwidth * 0.5
+	else:
+		windowed_cutoff = params.cutoff_frequency - transition_bandwidth * 0.5
+		stopband_frequency = params.cutoff_frequency
 	upsampled_windowed_cutoff = windowed_cutoff / params.upsample_factor
 
 	# Construct the FFT of an ideal lowpass filter, compensating for the notch filter shape
@@ -158,7 +165,7 @@ def build_polyphase_fir(params, plot = False, plot_sample_rate = 1.0):
 				previous_mag = abs(mag)
 
 			# If we're in the stopband, measure attenuation
-			if freq > params.cutoff_frequency:
+			if freq > stopband_frequency:
 				stopband_attenuation = max(stopband_attenuation, abs(mag))
 
 		print("Max ripple: {}dB".format(max(-db(ripple_min), db(ripple_max))))
@@ -167,8 +174,8 @@ def build_polyphase_fir(params, plot = False, plot_sample_rate = 1.0):
 			int(transition_band_frequency * plot_sample_rate),
 			plot_sample_rate))
 		print("Transition bandwidth: {} ({}hz @ {}hz)".format(
-			params.cutoff_frequency - transition_band_frequency,
-			int((params.cutoff_frequency - transition_band_frequency) * plot_sample_rate),
+			stopband_frequency - transition_band_frequency,
+			int((stopband_frequency - transition_band_frequency) * plot_sample_rate),
 			plot_sample_rate))
 		print("Stopband attenuation: {}dB".format(db(stopband_attenuation)))
 
@@ -187,8 +194,8 @@ def build_polyphase_fir(params, plot = False, plot_sample_rate = 1.0):
 				(transition_band_frequency, ripple_min),
 				(0.0, ripple_min),
 				(0.0, ripple_max),
-				(params.cutoff_frequency, ripple_max),
-				(params.cutoff_frequency, stopband_attenuation)
+				(stopband_frequency, ripple_max),
+				(stopband_frequency, stopband_attenuation)
 			],
 			[
 				(params.upsample_factor * 0.5, stopband_attenuation),
@@ -1,5 +1,6 @@
 #include "common/common.h"
 #include "common/math/floating_point.h"
+#include "common/math/simd.h"
 #include "common/threading/mutex.h"
 #include "common/threading/semaphore.h"
 #include "common/threading/thread.h"
@@ -16,10 +17,12 @@
 #include "instrument/native_module_registry.h"
 #include "instrument/native_modules/scrape_native_modules.h"
 
+#include "runtime/offline_renderer.h"
 #include "runtime/runtime_config.h"
 #include "runtime/runtime_context.h"
 
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <queue>
 #include <string>
@@ -50,7 +53,10 @@ private:
 
 	void list_devices();
 	void initialize_from_runtime_config();
+	bool load_runtime_instrument(const char *fname, uint32 sample_rate, c_runtime_instrument &runtime_instrument);
+	void get_executor_settings(const c_runtime_instrument *runtime_instrument, s_executor_settings &settings_out) const;
 	void process_command_load_synth(const s_command &command);
+	bool render_offline();
 
 	static bool controller_hook_wrapper(void *context, const s_controller_event &controller_event);
 	bool controller_hook(const s_controller_event &controller_event);
@@ -72,6 +78,11 @@ private:
 	// Command-line options:
 	bool m_list_enabled;			// Whether to list all native modules and immediately exit
 	std::string m_startup_synth;	// If non-empty, immediately loads a synth
+
+	// If a render synth is provided, the synth is rendered offline using the event script and then the runtime exits
+	std::string m_render_synth;
+	std::string m_render_event_script;
+	std::string m_render_output;
 };
 
 int main(int argc, char **argv) {
@@ -96,6 +107,11 @@ c_command_line_interface::c_command_line_interface(int argc, char **argv) {
 		} else {
 			m_startup_synth = argv[1];
 		}
+	} else if (argc == 5 && strcmp(argv[1], "--render") == 0) {
+		// --render <synth> <event script> <output wav>
+		m_render_synth = argv[2];
+		m_render_event_script = argv[3];
+		m_render_output = argv[4];
 	}
 }
 
@@ -104,6 +120,14 @@ c_command_line_interface::~c_command_line_interface() {
 }
 
 int c_command_line_interface::main_function() {
+	int result = 0;
+
+	if ((get_simd_requirements() & ~get_simd_availability()) != 0) {
+		std::cout << "This CPU doesn't support the instruction sets this build was compiled for, "
+			"rebuild with a lower simd_support option\n";
+		return 1;
+	}
+
 	scrape_native_modules();
 	scrape_task_functions();
 
@@ -160,45 +184,54 @@ int c_command_line_interface::main_function() {
 		}
 
 		initialize_event_data_types();
-		initialize_from_runtime_config();
 
-		// None active initially
-		m_runtime_context.active_instrument = -1;
+		if (!m_render_synth.empty()) {
+			// No streams are started when rendering offline so no audio or controller devices are required
+			result = render_offline() ? 0 : 1;
+		} else {
+			initialize_from_runtime_config();
 
-		if (!m_startup_synth.empty()) {
-			s_command command;
-			command.command = "load_synth";
-			command.arguments.push_back(m_startup_synth);
-			process_command_load_synth(command);
-		}
+			// None active initially
+			m_runtime_context.active_instrument = -1;
 
-		s_thread_definition controller_command_thread_definition;
-		zero_type(&controller_command_thread_definition);
-		controller_command_thread_definition.thread_name = "controller command thread";
-		controller_command_thread_definition.thread_priority = e_thread_priority::k_normal;
-		controller_command_thread_definition.processor = -1;
-		controller_command_thread_definition.thread_entry_point = controller_command_thread_entry_point;
-		*controller_command_thread_definition.parameter_block.get_memory_typed<c_command_line_interface *>() = this;
-		m_controller_command_thread.start(controller_command_thread_definition);
-
-		bool done = false;
-		while (!done) {
-			s_command command = read_command();
-			done = run_command(command);
-		}
+			if (!m_startup_synth.empty()) {
+				s_command command;
+				command.command = "load_synth";
+				command.arguments.push_back(m_startup_synth);
+				process_command_load_synth(command);
+			}
 
-		{
-			c_scoped_lock lock(m_controller_command_lock);
-			s_command exit_command;
-			exit_command.command = "exit";
-			m_controller_commands.push(exit_command);
+			s_thread_definition controller_command_thread_definition;
+			zero_type(&controller_command_thread_definition);
+			controller_command_thread_definition.thread_name = "controller command thread";
+			controller_command_thread_definition.thread_priority = e_thread_priority::k_normal;
+			controller_command_thread_definition.processor = -1;
+			controller_command_thread_definition.thread_entry_point = controller_command_thread_entry_point;
+			*controller_command_thread_definition.parameter_block.get_memory_typed<c_command_line_interface *>() = this;
+			m_controller_command_thread.start(controller_command_thread_definition);
+
+			bool done = false;
+			while (!done) {
+				s_command command = read_command();
+				done = run_command(command);
+			}
+
+			{
+				c_scoped_lock lock(m_controller_command_lock);
+				s_command exit_command;
+				exit_command.command = "exit";
+				m_controller_commands.push(exit_command);
+			}
+
+			m_controller_command_semaphore.notify();
+			m_controller_command_thread.join();
 		}
+	}
 
-		m_controller_command_semaphore.notify();
-		m_controller_command_thread.join();
+	for (c_executor &executor : m_runtime_context.executors) {
+		executor.shutdown();
 	}
 
-	m_runtime_context.executor.shutdown();
 	m_runtime_context.controller_driver_interface.stop_stream();
 	m_runtime_context.controller_driver_interface.shutdown();
 	m_runtime_context.audio_driver_interface.stop_stream();
@@ -214,7 +247,7 @@ int c_command_line_interface::main_function() {
 	c_task_function_registry::shutdown();
 	c_native_module_registry::shutdown();
 
-	return 0;
+	return result;
 }
 
 c_command_line_interface::s_command c_command_line_interface::read_command() {
@@ -366,6 +399,12 @@ void c_command_line_interface::initialize_from_runtime_config() {
 		settings.stream_callback = m_runtime_context.stream_callback;
 		settings.stream_callback_user_data = &m_runtime_context;
 
+		m_runtime_context.crossfade_enabled = config_settings.executor_crossfade_enabled;
+		m_runtime_context.crossfade_buffer.resize(
+			config_settings.audio_frames_per_buffer
+			* config_settings.audio_output_channel_count
+			* get_sample_format_size(config_settings.audio_sample_format));
+
 		s_audio_driver_result result = m_runtime_context.audio_driver_interface.start_stream(settings);
 		if (result.result != e_audio_driver_result::k_success) {
 			std::cout << "Failed to start audio stream: " << result.message << "\n";
@@ -396,6 +435,76 @@ void c_command_line_interface::initialize_from_runtime_config() {
 	}
 }
 
+bool c_command_line_interface::load_runtime_instrument(
+	const char *fname,
+	uint32 sample_rate,
+	c_runtime_instrument &runtime_instrument) {
+	// Try to load the instrument
+	c_instrument instrument;
+
+	e_instrument_result load_result = instrument.load(fname);
+	if (load_result != e_instrument_result::k_success) {
+		std::cout << "Failed to load '" << fname << "' (result code " << enum_index(load_result) << ")\n";
+		return false;
+	}
+
+	// Select the native module graph from the instrument
+	uint32 instrument_variant_index;
+	{
+		s_instrument_variant_requirements requirements;
+		requirements.sample_rate = sample_rate;
+
+		e_instrument_variant_for_requirements_result instrument_variant_result =
+			instrument.get_instrument_variant_for_requirements(requirements, instrument_variant_index);
+
+		if (instrument_variant_result == e_instrument_variant_for_requirements_result::k_no_match) {
+			std::cout << "Failed to find instrument variant matching the runtime requirements\n";
+			return false;
+		} else if (instrument_variant_result == e_instrument_variant_for_requirements_result::k_ambiguous_matches) {
+			std::cout << "Found multiple instrument variants matching the runtime requirements - "
+				"refine stream parameters or instrument globals\n";
+			return false;
+		} else {
+			wl_assert(instrument_variant_result == e_instrument_variant_for_requirements_result::k_success);
+		}
+	}
+
+	if (!runtime_instrument.build(instrument.get_instrument_variant(instrument_variant_index))) {
+		std::cout << "Failed to build runtime instrument\n";
+		return false;
+	}
+
+	return true;
+}
+
+void c_command_line_interface::get_executor_settings(
+	const c_runtime_instrument *runtime_instrument,
+	s_executor_settings &settings_out) const {
+	// The controller event callback is left for the caller to provide
+	const c_runtime_config::s_settings &runtime_config_settings = m_runtime_config.get_settings();
+	settings_out.runtime_instrument = runtime_instrument;
+	settings_out.thread_count = runtime_config_settings.executor_thread_count;
+	settings_out.process_voices_concurrently = runtime_config_settings.executor_process_voices_concurrently;
+	settings_out.voice_batch_size = runtime_config_settings.executor_voice_batch_size;
+	settings_out.deadline_policy = runtime_config_settings.executor_deadline_policy;
+	settings_out.deadline_threshold = runtime_config_settings.executor_deadline_threshold;
+	settings_out.sample_rate = runtime_config_settings.audio_sample_rate;
+	settings_out.sample_format = runtime_config_settings.audio_sample_format;
+	settings_out.max_buffer_size = runtime_config_settings.audio_frames_per_buffer;
+	settings_out.fixed_buffer_size = true; // The audio stream and the offline renderer both use fixed-size buffers
+	settings_out.input_channel_count = runtime_config_settings.audio_input_channel_count;
+	settings_out.output_channel_count = runtime_config_settings.audio_output_channel_count;
+	settings_out.processing_chunk_size = runtime_config_settings.executor_processing_chunk_size;
+	settings_out.controller_event_queue_size = runtime_config_settings.controller_event_queue_size;
+	settings_out.max_controller_parameters = runtime_config_settings.executor_max_controller_parameters;
+	settings_out.process_controller_events = nullptr;
+	settings_out.process_controller_events_context = nullptr;
+	settings_out.event_console_enabled = runtime_config_settings.executor_console_enabled;
+	settings_out.profiling_enabled = runtime_config_settings.executor_profiling_enabled;
+	settings_out.profiling_threshold = runtime_config_settings.executor_profiling_threshold;
+	settings_out.profiling_trace_chunk_count = runtime_config_settings.executor_profiling_trace_chunk_count;
+}
+
 void c_command_line_interface::process_command_load_synth(const s_command &command) {
 	c_scoped_lock lock(m_command_lock);
 
@@ -405,39 +514,6 @@ void c_command_line_interface::process_command_load_synth(const s_command &comma
 			return;
 		}
 
-		// Try to load the instrument
-		c_instrument instrument;
-
-		// First argument is the path to load
-		e_instrument_result load_result = instrument.load(command.arguments[0].c_str());
-		if (load_result != e_instrument_result::k_success) {
-			std::cout << "Failed to load '" << command.arguments[0] <<
-				"' (result code " << enum_index(load_result) << ")\n";
-			return;
-		}
-
-		// Select the native module graph from the instrument
-		uint32 instrument_variant_index;
-		{
-			s_instrument_variant_requirements requirements;
-			requirements.sample_rate = static_cast<uint32>(
-				m_runtime_context.audio_driver_interface.get_settings().sample_rate);
-
-			e_instrument_variant_for_requirements_result instrument_variant_result =
-				instrument.get_instrument_variant_for_requirements(requirements, instrument_variant_index);
-
-			if (instrument_variant_result == e_instrument_variant_for_requirements_result::k_no_match) {
-				std::cout << "Failed to find instrument variant matching the runtime requirements\n";
-				return;
-			} else if (instrument_variant_result == e_instrument_variant_for_requirements_result::k_ambiguous_matches) {
-				std::cout << "Found multiple instrument variants matching the runtime requirements - "
-					"refine stream parameters or instrument globals\n";
-				return;
-			} else {
-				wl_assert(instrument_variant_result == e_instrument_variant_for_requirements_result::k_success);
-			}
-		}
-
 		// Load into the inactive instrument
 		int32 loading_instrument;
 		if (m_runtime_context.active_instrument == -1) {
@@ -446,34 +522,32 @@ void c_command_line_interface::process_command_load_synth(const s_command &comma
 			loading_instrument = (m_runtime_context.active_instrument == 0) ? 1 : 0;
 		}
 
+		// First argument is the path to load
 		c_runtime_instrument &runtime_instrument = m_runtime_context.runtime_instruments[loading_instrument];
-		if (!runtime_instrument.build(instrument.get_instrument_variant(instrument_variant_index))) {
-			std::cout << "Failed to build runtime instrument\n";
+		if (!load_runtime_instrument(
+			command.arguments[0].c_str(),
+			static_cast<uint32>(m_runtime_context.audio_driver_interface.get_settings().sample_rate),
+			runtime_instrument)) {
 			return;
 		}
 
 		if (m_runtime_context.audio_driver_interface.is_stream_running()) {
-			// Set up the executor with the new graph
-			m_runtime_context.executor.shutdown();
+			// Set up the loading instrument's executor with the new graph while the active one keeps running
+			c_executor &executor = m_runtime_context.executors[loading_instrument];
 
-			const c_runtime_config::s_settings &runtime_config_settings = m_runtime_config.get_settings();
 			s_executor_settings settings;
-			settings.runtime_instrument = &runtime_instrument;
-			settings.thread_count = runtime_config_settings.executor_thread_count;
-			settings.sample_rate = runtime_config_settings.audio_sample_rate;
-			settings.max_buffer_size = runtime_config_settings.audio_frames_per_buffer;
-			settings.input_channel_count = runtime_config_settings.audio_input_channel_count;
-			settings.output_channel_count = runtime_config_settings.audio_output_channel_count;
-			settings.controller_event_queue_size = runtime_config_settings.controller_event_queue_size;
-			settings.max_controller_parameters = runtime_config_settings.executor_max_controller_parameters;
+			get_executor_settings(&runtime_instrument, settings);
 			settings.process_controller_events = s_runtime_context::process_controller_events_callback;
 			settings.process_controller_events_context = &m_runtime_context;
-			settings.event_console_enabled = runtime_config_settings.executor_console_enabled;
-			settings.profiling_enabled = runtime_config_settings.executor_profiling_enabled;
-			settings.profiling_threshold = runtime_config_settings.executor_profiling_threshold;
-			m_runtime_context.executor.initialize(
-				settings,
-				c_wrapped_array<void *>(m_task_function_library_contexts));
+			executor.initialize(settings, c_wrapped_array<void *>(m_task_function_library_contexts));
+
+			if (m_runtime_context.active_instrument != -1) {
+				// Hand the stream over to the new executor at the next chunk boundary. Once the stream has switched,
+				// the old executor is no longer called so it can be shut down without waiting on the stream.
+				m_runtime_context.requested_executor.store(loading_instrument, std::memory_order_release);
+				m_runtime_context.executor_swap_signal.wait();
+				m_runtime_context.executors[m_runtime_context.active_instrument].shutdown_detached();
+			}
 		}
 
 		m_runtime_context.active_instrument = loading_instrument;
@@ -483,6 +557,66 @@ void c_command_line_interface::process_command_load_synth(const s_command &comma
 	std::cout << "Invalid command\n";
 }
 
+bool c_command_line_interface::render_offline() {
+	const c_runtime_config::s_settings &runtime_config_settings = m_runtime_config.get_settings();
+
+	c_offline_renderer renderer;
+	if (!renderer.load_event_script(m_render_event_script.c_str())) {
+		std::cout << "Failed to load event script '" << m_render_event_script << "'\n";
+		return false;
+	}
+
+	c_runtime_instrument &runtime_instrument = m_runtime_context.runtime_instruments[0];
+	if (!load_runtime_instrument(
+		m_render_synth.c_str(),
+		runtime_config_settings.audio_sample_rate,
+		runtime_instrument)) {
+		return false;
+	}
+
+	// Every scripted event may land in a single buffer, and without a controller device the configured queue size is
+	// tiny, so make room for all of them
+	c_executor &executor = m_runtime_context.executors[0];
+	s_executor_settings settings;
+	get_executor_settings(&runtime_instrument, settings);
+	settings.controller_event_queue_size = std::max(settings.controller_event_queue_size, renderer.get_event_count());
+	settings.process_controller_events = c_offline_renderer::process_controller_events_callback;
+	settings.process_controller_events_context = &renderer;
+	executor.initialize(settings, c_wrapped_array<void *>(m_task_function_library_contexts));
+
+	c_offline_renderer::s_render_settings render_settings;
+	render_settings.sample_rate = runtime_config_settings.audio_sample_rate;
+	render_settings.sample_format = runtime_config_settings.audio_sample_format;
+	render_settings.frames_per_buffer = runtime_config_settings.audio_frames_per_buffer;
+	render_settings.input_channel_count = runtime_config_settings.audio_input_channel_count;
+	render_settings.output_channel_count = runtime_config_settings.audio_output_channel_count;
+
+	c_offline_renderer::s_render_statistics statistics;
+	bool success = renderer.render(executor, render_settings, m_render_output.c_str(), statistics);
+
+	// The executor calls back into the renderer so it must be shut down before the renderer goes away
+	executor.shutdown();
+
+	if (!success) {
+		std::cout << "Failed to render '" << m_render_output << "'\n";
+		return false;
+	}
+
+	real64 chunk_duration_sec = static_cast<real64>(render_settings.frames_per_buffer)
+		/ static_cast<real64>(render_settings.sample_rate);
+	std::cout << std::fixed << std::setprecision(3)
+		<< "Rendered " << statistics.audio_duration_sec << " sec of audio to '" << m_render_output << "' in "
+		<< statistics.render_duration_sec << " sec (" << statistics.realtime_factor << "x realtime, "
+		<< runtime_config_settings.executor_thread_count << " threads)\n"
+		<< "Chunks: " << statistics.chunk_count << " of " << render_settings.frames_per_buffer << " frames, "
+		<< "min/avg/max " << statistics.min_chunk_time_sec * 1000.0 << "/"
+		<< statistics.average_chunk_time_sec * 1000.0 << "/"
+		<< statistics.max_chunk_time_sec * 1000.0 << " ms, budget " << chunk_duration_sec * 1000.0 << " ms, "
+		<< statistics.late_chunk_count << " over budget\n";
+
+	return true;
+}
+
 bool c_command_line_interface::controller_hook_wrapper(void *context, const s_controller_event &controller_event) {
 	return static_cast<c_command_line_interface *>(context)->controller_hook(controller_event);
 }
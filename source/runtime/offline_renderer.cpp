@@ -0,0 +1,301 @@
+#include "common/utility/reporting.h"
+#include "common/utility/stopwatch.h"
+
+#include "runtime/offline_renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+// WAVE_FORMAT_IEEE_FLOAT
+static constexpr uint16 k_wave_format_ieee_float = 3;
+
+// Size of the RIFF, fmt, and data chunk headers which precede the sample data
+static constexpr uint32 k_wave_header_size = 44;
+
+static void write_fourcc(std::ofstream &file, uint32 fourcc) {
+	uint32 raw_value = native_to_big_endian(fourcc);
+	file.write(reinterpret_cast<const char *>(&raw_value), sizeof(raw_value));
+}
+
+template<typename t_value>
+static void write_little_endian(std::ofstream &file, t_value value) {
+	t_value raw_value = native_to_little_endian(value);
+	file.write(reinterpret_cast<const char *>(&raw_value), sizeof(raw_value));
+}
+
+static void write_wave_header(
+	std::ofstream &file,
+	uint32 sample_rate,
+	uint32 channel_count,
+	uint32 bytes_per_sample,
+	uint32 data_size) {
+	uint32 block_align = channel_count * bytes_per_sample;
+
+	write_fourcc(file, 'RIFF');
+	write_little_endian(file, k_wave_header_size - 8 + data_size);
+	write_fourcc(file, 'WAVE');
+
+	write_fourcc(file, 'fmt ');
+	write_little_endian(file, 16u);
+	write_little_endian(file, k_wave_format_ieee_float);
+	write_little_endian(file, static_cast<uint16>(channel_count));
+	write_little_endian(file, sample_rate);
+	write_little_endian(file, sample_rate * block_align);
+	write_little_endian(file, static_cast<uint16>(block_align));
+	write_little_endian(file, static_cast<uint16>(bytes_per_sample * 8));
+
+	write_fourcc(file, 'data');
+	write_little_endian(file, data_size);
+}
+
+size_t c_offline_renderer::process_controller_events_callback(
+	void *context,
+	c_wrapped_array<s_timestamped_controller_event> controller_events,
+	real64 buffer_time_sec,
+	real64 buffer_duration_sec) {
+	return static_cast<c_offline_renderer *>(context)->process_controller_events(
+		controller_events,
+		buffer_time_sec,
+		buffer_duration_sec);
+}
+
+bool c_offline_renderer::load_event_script(const char *fname) {
+	m_events.clear();
+	m_duration_sec = 0.0;
+	m_next_event_index = 0;
+
+	std::ifstream file(fname);
+	if (file.fail()) {
+		report_error("Failed to open '%s'", fname);
+		return false;
+	}
+
+	bool end_found = false;
+	real64 last_event_time_sec = 0.0;
+	uint32 line_number = 0;
+	std::string line;
+	while (std::getline(file, line)) {
+		line_number++;
+
+		size_t comment_start = line.find('#');
+		if (comment_start != std::string::npos) {
+			line.resize(comment_start);
+		}
+
+		if (line.find_first_not_of(" \t\r") == std::string::npos) {
+			continue;
+		}
+
+		std::istringstream line_stream(line);
+		real64 time_sec;
+		std::string event_name;
+		if (!(line_stream >> time_sec >> event_name) || time_sec < 0.0) {
+			report_error("%s(%u): invalid event", fname, line_number);
+			return false;
+		}
+
+		s_timestamped_controller_event event;
+		zero_type(&event);
+		event.timestamp_sec = time_sec;
+
+		bool valid = true;
+		if (event_name == "note_on") {
+			event.controller_event.event_type = e_controller_event_type::k_note_on;
+			s_controller_event_data_note_on *event_data =
+				event.controller_event.get_data<s_controller_event_data_note_on>();
+			valid = static_cast<bool>(line_stream >> event_data->note_id >> event_data->velocity);
+		} else if (event_name == "note_off") {
+			event.controller_event.event_type = e_controller_event_type::k_note_off;
+			s_controller_event_data_note_off *event_data =
+				event.controller_event.get_data<s_controller_event_data_note_off>();
+			valid = static_cast<bool>(line_stream >> event_data->note_id >> event_data->velocity);
+		} else if (event_name == "parameter") {
+			event.controller_event.event_type = e_controller_event_type::k_parameter_change;
+			s_controller_event_data_parameter_change *event_data =
+				event.controller_event.get_data<s_controller_event_data_parameter_change>();
+			valid = static_cast<bool>(line_stream >> event_data->parameter_id >> event_data->value);
+		} else if (event_name == "end") {
+			if (end_found) {
+				report_error("%s(%u): duplicate end", fname, line_number);
+				return false;
+			}
+
+			end_found = true;
+			m_duration_sec = time_sec;
+			continue;
+		} else {
+			report_error("%s(%u): unknown event '%s'", fname, line_number, event_name.c_str());
+			return false;
+		}
+
+		std::string trailing;
+		if (!valid || (line_stream >> trailing)) {
+			report_error("%s(%u): invalid arguments for '%s'", fname, line_number, event_name.c_str());
+			return false;
+		}
+
+		m_events.push_back(event);
+		last_event_time_sec = std::max(last_event_time_sec, time_sec);
+	}
+
+	if (!end_found) {
+		m_duration_sec = last_event_time_sec + k_default_tail_sec;
+	}
+
+	// Events at the same time keep their order from the script so that e.g. a note off followed by a note on works
+	std::stable_sort(
+		m_events.begin(),
+		m_events.end(),
+		[](const s_timestamped_controller_event &a, const s_timestamped_controller_event &b) {
+			return a.timestamp_sec < b.timestamp_sec;
+		});
+
+	return true;
+}
+
+size_t c_offline_renderer::get_event_count() const {
+	return m_events.size();
+}
+
+real64 c_offline_renderer::get_duration_sec() const {
+	return m_duration_sec;
+}
+
+bool c_offline_renderer::render(
+	c_executor &executor,
+	const s_render_settings &settings,
+	const char *output_fname,
+	s_render_statistics &statistics_out) {
+	wl_assert(settings.sample_rate > 0);
+	wl_assert(settings.frames_per_buffer > 0);
+	wl_assert(settings.output_channel_count > 0);
+
+	// Only float output is written to the WAV file
+	wl_assert(settings.sample_format == e_sample_format::k_float32);
+	uint32 bytes_per_sample = cast_integer_verify<uint32>(get_sample_format_size(settings.sample_format));
+
+	std::ofstream file(output_fname, std::ios::binary);
+	if (file.fail()) {
+		report_error("Failed to open '%s'", output_fname);
+		return false;
+	}
+
+	// Round up to a whole number of buffers since the executor is always called with full buffers
+	uint64 target_frame_count =
+		static_cast<uint64>(std::ceil(m_duration_sec * static_cast<real64>(settings.sample_rate)));
+	uint32 chunk_count = cast_integer_verify<uint32>(
+		(target_frame_count + settings.frames_per_buffer - 1) / settings.frames_per_buffer);
+	uint64 frame_count = static_cast<uint64>(chunk_count) * settings.frames_per_buffer;
+
+	size_t output_frame_size = settings.output_channel_count * bytes_per_sample;
+	uint64 data_size = frame_count * output_frame_size;
+	if (k_wave_header_size + data_size > std::numeric_limits<uint32>::max()) {
+		report_error("Render of %.3f seconds is too long for a WAV file", m_duration_sec);
+		return false;
+	}
+
+	write_wave_header(
+		file,
+		settings.sample_rate,
+		settings.output_channel_count,
+		bytes_per_sample,
+		static_cast<uint32>(data_size));
+
+	std::vector<uint8> input_buffer(settings.frames_per_buffer * settings.input_channel_count * bytes_per_sample, 0);
+	std::vector<uint8> output_buffer(settings.frames_per_buffer * output_frame_size);
+
+	s_executor_chunk_context chunk_context;
+	chunk_context.sample_rate = settings.sample_rate;
+	chunk_context.frames = settings.frames_per_buffer;
+	chunk_context.input_channel_count = settings.input_channel_count;
+	chunk_context.input_sample_format = settings.sample_format;
+	chunk_context.input_buffer = c_wrapped_array<const uint8>(input_buffer.data(), input_buffer.size());
+	chunk_context.output_channel_count = settings.output_channel_count;
+	chunk_context.output_sample_format = settings.sample_format;
+	chunk_context.output_buffer = c_wrapped_array<uint8>(output_buffer.data(), output_buffer.size());
+
+	real64 chunk_duration_sec =
+		static_cast<real64>(settings.frames_per_buffer) / static_cast<real64>(settings.sample_rate);
+	int64 chunk_duration_ns = static_cast<int64>(chunk_duration_sec * static_cast<real64>(k_nanoseconds_per_second));
+
+	int64 total_time_ns = 0;
+	int64 min_chunk_time_ns = std::numeric_limits<int64>::max();
+	int64 max_chunk_time_ns = 0;
+	uint32 late_chunk_count = 0;
+
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+
+	m_next_event_index = 0;
+	for (uint32 chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+		uint64 chunk_start_frame = static_cast<uint64>(chunk_index) * settings.frames_per_buffer;
+		chunk_context.buffer_time_sec =
+			static_cast<real64>(chunk_start_frame) / static_cast<real64>(settings.sample_rate);
+
+		stopwatch.reset();
+		executor.execute(chunk_context);
+		int64 chunk_time_ns = stopwatch.query();
+
+		total_time_ns += chunk_time_ns;
+		min_chunk_time_ns = std::min(min_chunk_time_ns, chunk_time_ns);
+		max_chunk_time_ns = std::max(max_chunk_time_ns, chunk_time_ns);
+		if (chunk_time_ns > chunk_duration_ns) {
+			late_chunk_count++;
+		}
+
+		// The executor's output is already interleaved so it is written out directly
+		file.write(reinterpret_cast<const char *>(output_buffer.data()), output_buffer.size());
+	}
+
+	if (file.fail()) {
+		report_error("Failed to write '%s'", output_fname);
+		return false;
+	}
+
+	real64 nanoseconds_to_seconds = 1.0 / static_cast<real64>(k_nanoseconds_per_second);
+	statistics_out.chunk_count = chunk_count;
+	statistics_out.frame_count = frame_count;
+	statistics_out.audio_duration_sec = static_cast<real64>(frame_count) / static_cast<real64>(settings.sample_rate);
+	statistics_out.render_duration_sec = static_cast<real64>(total_time_ns) * nanoseconds_to_seconds;
+	statistics_out.realtime_factor = (total_time_ns == 0)
+		? 0.0
+		: statistics_out.audio_duration_sec / statistics_out.render_duration_sec;
+	statistics_out.min_chunk_time_sec = (chunk_count == 0)
+		? 0.0
+		: static_cast<real64>(min_chunk_time_ns) * nanoseconds_to_seconds;
+	statistics_out.average_chunk_time_sec = (chunk_count == 0)
+		? 0.0
+		: statistics_out.render_duration_sec / static_cast<real64>(chunk_count);
+	statistics_out.max_chunk_time_sec = static_cast<real64>(max_chunk_time_ns) * nanoseconds_to_seconds;
+	statistics_out.late_chunk_count = late_chunk_count;
+
+	return true;
+}
+
+size_t c_offline_renderer::process_controller_events(
+	c_wrapped_array<s_timestamped_controller_event> controller_events,
+	real64 buffer_time_sec,
+	real64 buffer_duration_sec) {
+	// Unlike a live controller stream, scripted events are known ahead of time so no latency compensation is needed
+	real64 buffer_end_time_sec = buffer_time_sec + buffer_duration_sec;
+	size_t controller_event_count = 0;
+	while (m_next_event_index < m_events.size()
+		&& m_events[m_next_event_index].timestamp_sec < buffer_end_time_sec) {
+		const s_timestamped_controller_event &event = m_events[m_next_event_index];
+		m_next_event_index++;
+
+		// Events which don't fit are dropped, just like when a controller's event queue overflows
+		if (controller_event_count < controller_events.get_count()) {
+			s_timestamped_controller_event &buffer_event = controller_events[controller_event_count];
+			buffer_event.timestamp_sec = std::max(0.0, event.timestamp_sec - buffer_time_sec);
+			buffer_event.controller_event = event.controller_event;
+			controller_event_count++;
+		}
+	}
+
+	return controller_event_count;
+}
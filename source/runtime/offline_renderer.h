@@ -0,0 +1,76 @@
+#pragma once
+
+#include "common/common.h"
+
+#include "engine/controller.h"
+#include "engine/executor/executor.h"
+
+#include <vector>
+
+// Renders a synth to a WAV file by calling the executor as fast as possible rather than from an audio stream.
+// Controller events are read from a text script containing one event per line:
+//   <time_sec> note_on <note_id> <velocity>
+//   <time_sec> note_off <note_id> <velocity>
+//   <time_sec> parameter <parameter_id> <value>
+//   <time_sec> end
+// Anything following '#' is a comment. The optional end line sets the duration of the render, otherwise rendering stops
+// k_default_tail_sec after the last event.
+class c_offline_renderer {
+public:
+	static constexpr real64 k_default_tail_sec = 2.0;
+
+	struct s_render_settings {
+		uint32 sample_rate;
+		e_sample_format sample_format;
+		uint32 frames_per_buffer;
+		uint32 input_channel_count;
+		uint32 output_channel_count;
+	};
+
+	struct s_render_statistics {
+		uint32 chunk_count;
+		uint64 frame_count;
+		real64 audio_duration_sec;
+		real64 render_duration_sec;
+		real64 realtime_factor; // Seconds of audio rendered per second of wall time
+
+		// Time spent in each call to the executor
+		real64 min_chunk_time_sec;
+		real64 average_chunk_time_sec;
+		real64 max_chunk_time_sec;
+
+		// Number of chunks which took longer than their own duration and would have glitched on a live stream
+		uint32 late_chunk_count;
+	};
+
+	static size_t process_controller_events_callback(
+		void *context,
+		c_wrapped_array<s_timestamped_controller_event> controller_events,
+		real64 buffer_time_sec,
+		real64 buffer_duration_sec);
+
+	bool load_event_script(const char *fname);
+
+	size_t get_event_count() const;
+	real64 get_duration_sec() const;
+
+	// The executor must already be initialized with process_controller_events_callback and this renderer as context
+	bool render(
+		c_executor &executor,
+		const s_render_settings &settings,
+		const char *output_fname,
+		s_render_statistics &statistics_out);
+
+private:
+	size_t process_controller_events(
+		c_wrapped_array<s_timestamped_controller_event> controller_events,
+		real64 buffer_time_sec,
+		real64 buffer_duration_sec);
+
+	// Events sorted by absolute timestamp
+	std::vector<s_timestamped_controller_event> m_events;
+	real64 m_duration_sec = 0.0;
+
+	// Index of the next event to hand to the executor
+	size_t m_next_event_index = 0;
+};
@@ -16,6 +16,15 @@ static constexpr const char *k_sample_format_xml_strings[] = {
 
 STATIC_ASSERT(is_enum_fully_mapped<e_sample_format>(k_sample_format_xml_strings));
 
+static constexpr const char *k_deadline_policy_xml_strings[] = {
+	"none",
+	"skip_released_voices",
+	"steal_released_voices",
+	"steal_voices"
+};
+
+STATIC_ASSERT(is_enum_fully_mapped<e_deadline_policy>(k_deadline_policy_xml_strings));
+
 static constexpr const char *k_bool_xml_strings[] = {
 	"false",
 	"true"
@@ -26,6 +35,7 @@ static constexpr const char *k_none_xml_string = "none";
 
 static constexpr uint32 k_default_audio_input_channel_count = 0;
 static constexpr uint32 k_default_audio_output_channel_count = 2;
+static constexpr uint32 k_default_audio_sample_rate = 44100;
 static constexpr e_sample_format k_default_audio_sample_format = e_sample_format::k_float32;
 static constexpr uint32 k_default_audio_frames_per_buffer = 512;
 
@@ -34,10 +44,17 @@ static constexpr uint32 k_default_controller_event_queue_size = 1024;
 static constexpr uint32 k_default_controller_unknown_latency = 15;
 
 static constexpr uint32 k_default_executor_thread_count = 0;
+static constexpr bool k_default_executor_process_voices_concurrently = false;
+static constexpr uint32 k_default_executor_voice_batch_size = 1;
+static constexpr e_deadline_policy k_default_executor_deadline_policy = e_deadline_policy::k_none;
+static constexpr real32 k_default_executor_deadline_threshold = 0.9f;
+static constexpr uint32 k_default_executor_processing_chunk_size = 0;
+static constexpr bool k_default_executor_crossfade_enabled = true;
 static constexpr uint32 k_default_executor_max_controller_parameters = 1024;
 static constexpr bool k_default_executor_console_enabled = true;
 static constexpr bool k_default_executor_profiling_enabled = false;
 static constexpr real32 k_default_executor_profiling_threshold = 0.0f;
+static constexpr uint32 k_default_executor_profiling_trace_chunk_count = 0;
 
 static bool try_to_get_value_from_child_node(
 	const rapidxml::xml_node<> *parent_node,
@@ -379,6 +396,61 @@ bool c_runtime_config::write_default_settings(const char *fname) {
 			k_default_executor_thread_count),
 		k_default_xml_string);
 
+	append_setting(
+		executor_node,
+		"process_voices_concurrently",
+		str_format(
+			"Whether independent voices are processed concurrently across worker threads rather than one at a time "
+			"- default is %s, has no effect if thread_count is 0",
+			k_bool_xml_strings[k_default_executor_process_voices_concurrently]),
+		k_default_xml_string);
+
+	append_setting(
+		executor_node,
+		"voice_batch_size",
+		str_format(
+			"Max number of voices which are processed in lockstep so that tasks which support it can process several "
+			"voices at once - default is %u, which disables batching",
+			k_default_executor_voice_batch_size),
+		k_default_xml_string);
+
+	append_setting(
+		executor_node,
+		"deadline_policy",
+		str_format(
+			"What to do with the oldest voices which have not been processed yet once a chunk is expected to run "
+			"past deadline_threshold (none, skip_released_voices, steal_released_voices, or steal_voices) - "
+			"default is %s",
+			k_deadline_policy_xml_strings[enum_index(k_default_executor_deadline_policy)]),
+		k_default_xml_string);
+
+	append_setting(
+		executor_node,
+		"deadline_threshold",
+		str_format(
+			"Time after which the deadline policy is applied as a ratio of chunk time - default is %f",
+			k_default_executor_deadline_threshold),
+		k_default_xml_string);
+
+	append_setting(
+		executor_node,
+		"processing_chunk_size",
+		str_format(
+			"Fixed number of frames the instrument is processed in, independent of frames_per_buffer - default is %u, "
+			"which processes each audio buffer directly. If frames_per_buffer is not a multiple of this value, one "
+			"processing chunk of latency is added. Instruments which specify a chunk size override this value.",
+			k_default_executor_processing_chunk_size),
+		k_default_xml_string);
+
+	append_setting(
+		executor_node,
+		"crossfade_enabled",
+		str_format(
+			"Whether the previous instrument is faded out over one audio buffer when a new instrument is loaded - "
+			"default is %s",
+			k_bool_xml_strings[k_default_executor_crossfade_enabled]),
+		k_default_xml_string);
+
 	append_setting(
 		executor_node,
 		"max_controller_parameters",
@@ -411,6 +483,15 @@ bool c_runtime_config::write_default_settings(const char *fname) {
 			k_default_executor_profiling_threshold),
 		k_default_xml_string);
 
+	append_setting(
+		executor_node,
+		"profiling_trace_chunk_count",
+		str_format(
+			"Number of most recent profiled chunks written to a Chrome trace event file when profiling - default is "
+			"%u, which disables tracing. Only chunks exceeding profiling_threshold are traced.",
+			k_default_executor_profiling_trace_chunk_count),
+		k_default_xml_string);
+
 	std::ofstream file(fname);
 	file << document;
 	return !file.fail();
@@ -422,11 +503,7 @@ void c_runtime_config::initialize(
 	set_default_audio_device(audio_driver_interface);
 	set_default_controller_device(controller_driver_interface);
 
-	s_audio_device_info audio_input_device_info =
-		audio_driver_interface->get_device_info(m_settings.audio_input_device_index);
-	s_audio_device_info audio_output_device_info =
-		audio_driver_interface->get_device_info(m_settings.audio_output_device_index);
-	set_default_audio(&audio_input_device_info, &audio_output_device_info);
+	set_default_audio(audio_driver_interface);
 
 	if (m_settings.controller_device_count > 0) {
 		s_controller_device_info controller_device_info =
@@ -550,11 +627,7 @@ e_runtime_config_result c_runtime_config::read_settings(
 		}
 
 		// Based on device index, apply default settings
-		s_audio_device_info audio_input_device_info =
-			audio_driver_interface->get_device_info(m_settings.audio_input_device_index);
-		s_audio_device_info audio_output_device_info =
-			audio_driver_interface->get_device_info(m_settings.audio_output_device_index);
-		set_default_audio(&audio_input_device_info, &audio_output_device_info);
+		set_default_audio(audio_driver_interface);
 
 		if (m_settings.controller_device_count > 0) {
 			s_controller_device_info controller_device_info =
@@ -660,6 +733,42 @@ e_runtime_config_result c_runtime_config::read_settings(
 				16u,
 				m_settings.executor_thread_count,
 				m_settings.executor_thread_count);
+			try_to_get_value_from_child_node(
+				executor_node,
+				"process_voices_concurrently",
+				m_settings.executor_process_voices_concurrently,
+				m_settings.executor_process_voices_concurrently);
+			try_to_get_value_from_child_node(
+				executor_node,
+				"voice_batch_size",
+				1u,
+				64u,
+				m_settings.executor_voice_batch_size,
+				m_settings.executor_voice_batch_size);
+			try_to_get_value_from_child_node(
+				executor_node,
+				"deadline_policy",
+				c_wrapped_array<const char *const>::construct(k_deadline_policy_xml_strings),
+				m_settings.executor_deadline_policy,
+				m_settings.executor_deadline_policy);
+			try_to_get_value_from_child_node(
+				executor_node,
+				"deadline_threshold",
+				0.0f, 1.0f,
+				m_settings.executor_deadline_threshold,
+				m_settings.executor_deadline_threshold);
+			try_to_get_value_from_child_node(
+				executor_node,
+				"processing_chunk_size",
+				0u,
+				16384u,
+				m_settings.executor_processing_chunk_size,
+				m_settings.executor_processing_chunk_size);
+			try_to_get_value_from_child_node(
+				executor_node,
+				"crossfade_enabled",
+				m_settings.executor_crossfade_enabled,
+				m_settings.executor_crossfade_enabled);
 			try_to_get_value_from_child_node(
 				executor_node,
 				"max_controller_parameters",
@@ -683,6 +792,13 @@ e_runtime_config_result c_runtime_config::read_settings(
 				0.0f, 1.0f,
 				m_settings.executor_profiling_threshold,
 				m_settings.executor_profiling_threshold);
+			try_to_get_value_from_child_node(
+				executor_node,
+				"profiling_trace_chunk_count",
+				0u,
+				4096u,
+				m_settings.executor_profiling_trace_chunk_count,
+				m_settings.executor_profiling_trace_chunk_count);
 		}
 	} catch (const rapidxml::parse_error &) {
 		report_error("'%s' is not valid XML", fname);
@@ -702,23 +818,42 @@ void c_runtime_config::set_default_audio_device(const c_audio_driver_interface *
 	m_settings.audio_output_device_index = audio_driver_interface->get_default_output_device_index();
 }
 
+void c_runtime_config::set_default_audio(const c_audio_driver_interface *audio_driver_interface) {
+	// Machines without a sound card (e.g. when rendering offline) have no devices to query
+	uint32 device_count = audio_driver_interface->get_device_count();
+	if (valid_index(m_settings.audio_input_device_index, device_count)
+		&& valid_index(m_settings.audio_output_device_index, device_count)) {
+		s_audio_device_info audio_input_device_info =
+			audio_driver_interface->get_device_info(m_settings.audio_input_device_index);
+		s_audio_device_info audio_output_device_info =
+			audio_driver_interface->get_device_info(m_settings.audio_output_device_index);
+		set_default_audio(&audio_input_device_info, &audio_output_device_info);
+	} else {
+		set_default_audio(nullptr, nullptr);
+	}
+}
+
 void c_runtime_config::set_default_audio(
 	const s_audio_device_info *audio_input_device_info,
 	const s_audio_device_info *audio_output_device_info) {
-	m_settings.audio_input_channel_count =
-		std::min(k_default_audio_input_channel_count, audio_input_device_info->max_input_channels);
+	m_settings.audio_input_channel_count = audio_input_device_info
+		? std::min(k_default_audio_input_channel_count, audio_input_device_info->max_input_channels)
+		: k_default_audio_input_channel_count;
 	for (uint32 index = 0; index < m_settings.audio_input_channel_indices.get_count(); index++) {
 		m_settings.audio_input_channel_indices[index] = index;
 	}
 
-	m_settings.audio_output_channel_count =
-		std::min(k_default_audio_output_channel_count, audio_output_device_info->max_output_channels);
+	m_settings.audio_output_channel_count = audio_output_device_info
+		? std::min(k_default_audio_output_channel_count, audio_output_device_info->max_output_channels)
+		: k_default_audio_output_channel_count;
 	for (uint32 index = 0; index < m_settings.audio_output_channel_indices.get_count(); index++) {
 		m_settings.audio_output_channel_indices[index] = index;
 	}
 
 	// Grab sample rate default from the output device
-	m_settings.audio_sample_rate = static_cast<uint32>(audio_output_device_info->default_sample_rate);
+	m_settings.audio_sample_rate = audio_output_device_info
+		? static_cast<uint32>(audio_output_device_info->default_sample_rate)
+		: k_default_audio_sample_rate;
 	m_settings.audio_sample_format = k_default_audio_sample_format;
 	m_settings.audio_frames_per_buffer = k_default_audio_frames_per_buffer;
 }
@@ -739,8 +874,15 @@ void c_runtime_config::set_default_controller(const s_controller_device_info *co
 
 void c_runtime_config::set_default_executor() {
 	m_settings.executor_thread_count = k_default_executor_thread_count;
+	m_settings.executor_process_voices_concurrently = k_default_executor_process_voices_concurrently;
+	m_settings.executor_voice_batch_size = k_default_executor_voice_batch_size;
+	m_settings.executor_deadline_policy = k_default_executor_deadline_policy;
+	m_settings.executor_deadline_threshold = k_default_executor_deadline_threshold;
+	m_settings.executor_processing_chunk_size = k_default_executor_processing_chunk_size;
+	m_settings.executor_crossfade_enabled = k_default_executor_crossfade_enabled;
 	m_settings.executor_max_controller_parameters = k_default_executor_max_controller_parameters;
 	m_settings.executor_console_enabled = k_default_executor_console_enabled;
 	m_settings.executor_profiling_enabled = k_default_executor_profiling_enabled;
 	m_settings.executor_profiling_threshold = k_default_executor_profiling_threshold;
+	m_settings.executor_profiling_trace_chunk_count = k_default_executor_profiling_trace_chunk_count;
 }
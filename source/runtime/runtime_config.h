@@ -2,6 +2,7 @@
 
 #include "common/common.h"
 
+#include "engine/executor/deadline_policy.h"
 #include "engine/sample_format.h"
 
 #include "runtime/driver/audio_driver_interface.h"
@@ -40,10 +41,17 @@ public:
 		uint32 controller_unknown_latency;
 
 		uint32 executor_thread_count;
+		bool executor_process_voices_concurrently;
+		uint32 executor_voice_batch_size;
+		e_deadline_policy executor_deadline_policy;
+		real32 executor_deadline_threshold;
+		uint32 executor_processing_chunk_size;
+		bool executor_crossfade_enabled;
 		uint32 executor_max_controller_parameters;
 		bool executor_console_enabled;
 		bool executor_profiling_enabled;
 		real32 executor_profiling_threshold;
+		uint32 executor_profiling_trace_chunk_count;
 	};
 
 	// Produces a self-documenting settings file
@@ -61,6 +69,7 @@ public:
 
 private:
 	void set_default_audio_device(const c_audio_driver_interface *audio_driver_interface);
+	void set_default_audio(const c_audio_driver_interface *audio_driver_interface);
 	void set_default_audio(
 		const s_audio_device_info *audio_input_device_info,
 		const s_audio_device_info *audio_output_device_info);
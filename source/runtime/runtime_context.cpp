@@ -2,6 +2,38 @@
 
 #include "runtime/runtime_context.h"
 
+static void crossfade_output_buffers(
+	uint32 frames,
+	uint32 output_channel_count,
+	e_sample_format output_format,
+	c_wrapped_array<const uint8> fade_out_buffer,
+	c_wrapped_array<uint8> fade_in_buffer) {
+	switch (output_format) {
+	case e_sample_format::k_float32:
+	{
+		wl_assert(fade_out_buffer.get_count() == (frames * output_channel_count * sizeof(real32)));
+		wl_assert(fade_in_buffer.get_count() == fade_out_buffer.get_count());
+		const real32 *typed_fade_out_buffer = reinterpret_cast<const real32 *>(fade_out_buffer.get_pointer());
+		real32 *typed_fade_in_buffer = reinterpret_cast<real32 *>(fade_in_buffer.get_pointer());
+
+		real32 frame_count_inverse = 1.0f / static_cast<real32>(frames);
+		for (uint32 frame = 0; frame < frames; frame++) {
+			real32 fade_in_gain = static_cast<real32>(frame + 1) * frame_count_inverse;
+			real32 fade_out_gain = 1.0f - fade_in_gain;
+			for (uint32 channel = 0; channel < output_channel_count; channel++) {
+				size_t index = frame * output_channel_count + channel;
+				typed_fade_in_buffer[index] =
+					typed_fade_in_buffer[index] * fade_in_gain + typed_fade_out_buffer[index] * fade_out_gain;
+			}
+		}
+		break;
+	}
+
+	default:
+		wl_haltf("Unsupported format");
+	}
+}
+
 void s_runtime_context::stream_callback(const s_audio_driver_stream_callback_context &context) {
 	// Pipe into the executor
 	s_runtime_context *this_ptr = static_cast<s_runtime_context *>(context.user_data);
@@ -20,7 +52,37 @@ void s_runtime_context::stream_callback(const s_audio_driver_stream_callback_con
 	chunk_context.output_sample_format = context.driver_settings->sample_format;
 	chunk_context.output_buffer = context.output_buffer;
 
-	this_ptr->executor.execute(chunk_context);
+	int32 requested_executor = this_ptr->requested_executor.load(std::memory_order_acquire);
+	if (requested_executor == this_ptr->active_executor) {
+		this_ptr->executors[this_ptr->active_executor].execute(chunk_context);
+		return;
+	}
+
+	// Switch to the requested executor. The incoming executor runs first so that it receives this chunk's controller
+	// events.
+	this_ptr->executors[requested_executor].execute(chunk_context);
+
+	if (this_ptr->crossfade_enabled) {
+		wl_assert(this_ptr->crossfade_buffer.size() >= chunk_context.output_buffer.get_count());
+		c_wrapped_array<uint8> crossfade_buffer(
+			this_ptr->crossfade_buffer.data(),
+			chunk_context.output_buffer.get_count());
+
+		s_executor_chunk_context fade_out_chunk_context = chunk_context;
+		fade_out_chunk_context.output_buffer = crossfade_buffer;
+		this_ptr->executors[this_ptr->active_executor].execute(fade_out_chunk_context);
+
+		crossfade_output_buffers(
+			chunk_context.frames,
+			chunk_context.output_channel_count,
+			chunk_context.output_sample_format,
+			crossfade_buffer,
+			chunk_context.output_buffer);
+	}
+
+	// The outgoing executor is never called again so the loading thread can shut it down
+	this_ptr->active_executor = requested_executor;
+	this_ptr->executor_swap_signal.notify();
 }
 
 size_t s_runtime_context::process_controller_events_callback(
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/common.h"
+#include "common/threading/semaphore.h"
 
 #include "engine/executor/executor.h"
 #include "engine/runtime_instrument.h"
@@ -8,6 +9,9 @@
 #include "runtime/driver/audio_driver_interface.h"
 #include "runtime/driver/controller_driver_interface.h"
 
+#include <atomic>
+#include <vector>
+
 struct s_runtime_context {
 	static void stream_callback(const s_audio_driver_stream_callback_context &context);
 	static size_t process_controller_events_callback(
@@ -22,8 +26,23 @@ struct s_runtime_context {
 	// Interface for controller driver
 	c_controller_driver_interface controller_driver_interface;
 
-	// Executes the synth logic
-	c_executor executor;
+	// Executes the synth logic. Each executor runs the runtime instrument with the same index. The loading synth's
+	// executor is fully initialized off of the audio thread and then swapped in at the start of a stream callback.
+	s_static_array<c_executor, 2> executors;
+
+	// The executor called by the stream. Only written by the stream callback.
+	int32 active_executor = 0;
+
+	// The executor the stream should switch to, written by the loading thread
+	std::atomic<int32> requested_executor{ 0 };
+
+	// Signaled by the stream callback once it has switched to the requested executor
+	c_semaphore executor_swap_signal;
+
+	// Whether the outgoing executor is faded out over one buffer when switching executors. The crossfade buffer holds
+	// the outgoing executor's output and is allocated when the stream starts.
+	bool crossfade_enabled = false;
+	std::vector<uint8> crossfade_buffer;
 
 	// We store two runtime instruments, one for the active audio stream, and one for the loading synth. We load into
 	// the non-active one and then swap at a deterministic time.
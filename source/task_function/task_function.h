@@ -272,6 +272,13 @@ using f_task_voice_activator = void (*)(const s_task_function_context &context);
 // Function executed for the task
 using f_task_function = void (*)(const s_task_function_context &context);
 
+using c_task_function_context_array = c_wrapped_array<const s_task_function_context>;
+
+// Optional function which executes the same task for several voices at once. Each context is set up exactly as it would
+// be for a single call to f_task_function, so contexts differ in voice memory, voice interface, arguments, and buffer
+// size. The results must be identical to calling f_task_function once per context.
+using f_task_batched_function = void (*)(c_task_function_context_array contexts);
+
 struct s_task_function_argument {
 	e_task_argument_direction argument_direction;
 	c_task_qualified_data_type type;
@@ -285,6 +292,9 @@ struct s_task_function {
 	// Function to execute
 	f_task_function function;
 
+	// Function to execute for a batch of voices, or null
+	f_task_batched_function batched_function;
+
 	// Memory query function, or null
 	f_task_memory_query memory_query;
 
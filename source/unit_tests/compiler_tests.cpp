@@ -2,6 +2,7 @@
 
 #include "compiler/compiler.h"
 #include "compiler/compiler_context.h"
+#include "compiler/source_file_cache.h"
 
 #include "instrument/instrument.h"
 #include "instrument/native_module_graph.h"
@@ -74,6 +75,7 @@ STATIC_ASSERT(is_enum_fully_mapped<e_compiler_error>(k_compiler_error_strings));
 
 static constexpr const char *k_compiler_tests_directory = "generated_compiler_tests";
 static constexpr const char *k_test_extension = ".wl";
+static constexpr uint32 k_multithreaded_compiler_thread_count = 4;
 
 static std::string_view get_next_token(std::string_view &line) {
 	size_t start_offset = 0;
@@ -273,6 +275,13 @@ protected:
 			output_file.close();
 		}
 
+		// Each test is also compiled using multiple threads with a source file cache shared between all tests. Imports
+		// shared between tests get reused from the cache.
+		c_compiler_source_file_cache source_file_cache;
+		s_compiler_settings multithreaded_settings;
+		multithreaded_settings.thread_count = k_multithreaded_compiler_thread_count;
+		multithreaded_settings.source_file_cache = &source_file_cache;
+
 		// Run each test
 		for (const std::tuple<std::string, e_compiler_error> &test : tests) {
 			const std::string &test_name = std::get<0>(test);
@@ -319,6 +328,19 @@ protected:
 				{
 					additional_tests(test_name, result.get());
 				}
+
+				// Multithreaded compilation should produce identical results and diagnostics in the same order
+				c_compiler_context multithreaded_context = c_compiler_context(m_library_contexts);
+				std::unique_ptr<c_instrument> multithreaded_result(
+					c_compiler::compile(multithreaded_context, test_path.string().c_str(), multithreaded_settings));
+				if (test_passed && !are_compilation_results_identical(
+					context,
+					result.get(),
+					multithreaded_context,
+					multithreaded_result.get())) {
+					test_passed = false;
+					error_message = "multithreaded compilation did not match single-threaded compilation";
+				}
 			}
 
 			// This outputs test name and error message only if we failed
@@ -333,6 +355,65 @@ protected:
 	}
 
 private:
+	static bool are_compilation_results_identical(
+		const c_compiler_context &context_a,
+		const c_instrument *instrument_a,
+		const c_compiler_context &context_b,
+		const c_instrument *instrument_b) {
+		if ((instrument_a == nullptr) != (instrument_b == nullptr)
+			|| context_a.get_error_count() != context_b.get_error_count()
+			|| context_a.get_warning_count() != context_b.get_warning_count()) {
+			return false;
+		}
+
+		for (size_t index = 0; index < context_a.get_error_count(); index++) {
+			if (context_a.get_error(index).error != context_b.get_error(index).error
+				|| context_a.get_error(index).message != context_b.get_error(index).message) {
+				return false;
+			}
+		}
+
+		for (size_t index = 0; index < context_a.get_warning_count(); index++) {
+			if (context_a.get_warning(index).warning != context_b.get_warning(index).warning
+				|| context_a.get_warning(index).message != context_b.get_warning(index).message) {
+				return false;
+			}
+		}
+
+		if (instrument_a) {
+			if (instrument_a->get_instrument_variant_count() != instrument_b->get_instrument_variant_count()) {
+				return false;
+			}
+
+			for (uint32 index = 0; index < instrument_a->get_instrument_variant_count(); index++) {
+				const c_instrument_variant *variant_a = instrument_a->get_instrument_variant(index);
+				const c_instrument_variant *variant_b = instrument_b->get_instrument_variant(index);
+				if (variant_a->get_instrument_globals().sample_rate != variant_b->get_instrument_globals().sample_rate
+					|| variant_a->get_output_latency() != variant_b->get_output_latency()
+					|| !are_native_module_graphs_similar(
+						variant_a->get_voice_native_module_graph(),
+						variant_b->get_voice_native_module_graph())
+					|| !are_native_module_graphs_similar(
+						variant_a->get_fx_native_module_graph(),
+						variant_b->get_fx_native_module_graph())) {
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	static bool are_native_module_graphs_similar(
+		const c_native_module_graph *native_module_graph_a,
+		const c_native_module_graph *native_module_graph_b) {
+		if (!native_module_graph_a || !native_module_graph_b) {
+			return native_module_graph_a == native_module_graph_b;
+		}
+
+		return native_module_graph_a->get_node_count() == native_module_graph_b->get_node_count();
+	}
+
 	std::vector<void *> m_library_contexts;
 };
 
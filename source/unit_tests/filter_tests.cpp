@@ -0,0 +1,165 @@
+#include "common/common.h"
+#include "common/math/math.h"
+#include "common/utility/aligned_allocator.h"
+#include "common/utility/stack_allocator.h"
+
+#include "engine/task_functions/filter/comb_feedback.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+static constexpr real32 k_test_feedback = 0.5f;
+static constexpr size_t k_test_sample_count = 1000;
+
+// Memory is filled with this byte before use so that reading history which was never cleared produces huge values
+static constexpr uint8 k_garbage_memory_value = 0x7f;
+
+enum class e_comb_feedback_delay_mode {
+	k_fixed,
+	k_variable_constant,
+	k_variable,
+
+	k_count
+};
+
+struct s_test_comb_feedback {
+	c_aligned_allocator<uint8, k_simd_alignment> memory;
+	c_comb_feedback comb_feedback;
+
+	void initialize(e_comb_feedback_delay_mode delay_mode, real32 min_delay, real32 max_delay, uint8 memory_value) {
+		c_stack_allocator::c_memory_calculator memory_calculator;
+		if (delay_mode == e_comb_feedback_delay_mode::k_fixed) {
+			c_comb_feedback::calculate_memory(static_cast<uint32>(max_delay), memory_calculator);
+		} else {
+			c_comb_feedback::calculate_memory_variable(max_delay, memory_calculator);
+		}
+
+		memory.allocate(memory_calculator.get_size_alignment().size);
+		c_stack_allocator allocator(memory.get_array());
+		if (delay_mode == e_comb_feedback_delay_mode::k_fixed) {
+			comb_feedback.initialize(static_cast<uint32>(max_delay), allocator);
+		} else {
+			comb_feedback.initialize_variable(min_delay, max_delay, allocator);
+		}
+
+		allocator.release_no_destructors();
+
+		// Allocation zeroes the history so fill it afterwards
+		std::fill(memory.get_array().begin(), memory.get_array().end(), memory_value);
+	}
+};
+
+// Runs the comb filter over a test signal and returns the history read for each sample. Variable delays sweep back and
+// forth between the min and max delays so that both ends of the history get read.
+static std::vector<real32> run_comb_feedback(
+	c_comb_feedback &comb_feedback,
+	e_comb_feedback_delay_mode delay_mode,
+	real32 min_delay,
+	real32 max_delay,
+	size_t block_size) {
+	std::vector<real32> result(k_test_sample_count);
+	std::vector<real32> input(block_size);
+	std::vector<real32> delay(block_size);
+	std::vector<real32> filtered_history(block_size);
+	std::vector<real32> output(block_size);
+	for (size_t block_start = 0; block_start < k_test_sample_count; block_start += block_size) {
+		size_t block_sample_count = std::min(block_size, k_test_sample_count - block_start);
+		for (size_t index = 0; index < block_sample_count; index++) {
+			real32 sample_index = static_cast<real32>(block_start + index);
+			input[index] = std::sin(sample_index * 0.1f);
+			delay[index] = min_delay + (max_delay - min_delay) * (0.5f + 0.5f * std::cos(sample_index * 0.01f));
+		}
+
+		real32 *history = &result[block_start];
+		switch (delay_mode) {
+		case e_comb_feedback_delay_mode::k_fixed:
+			comb_feedback.read_history(static_cast<uint32>(max_delay), history, block_sample_count);
+			break;
+
+		case e_comb_feedback_delay_mode::k_variable_constant:
+			comb_feedback.read_history_variable_constant(max_delay, history, block_sample_count);
+			break;
+
+		case e_comb_feedback_delay_mode::k_variable:
+			comb_feedback.read_history_variable(delay.data(), history, block_sample_count);
+			break;
+
+		default:
+			wl_unreachable();
+		}
+
+		for (size_t index = 0; index < block_sample_count; index++) {
+			filtered_history[index] = history[index] * k_test_feedback;
+		}
+
+		comb_feedback.write_history(input.data(), filtered_history.data(), output.data(), block_sample_count);
+	}
+
+	return result;
+}
+
+TEST(CombFeedback, ResetDoesNotTouchHistory) {
+	// Voice activation cost shouldn't scale with the history size, so reset shouldn't write to the history at all
+	static constexpr real32 k_delays[] = { 100.0f, 10000.0f, 1000000.0f };
+	for (real32 delay : k_delays) {
+		for (e_comb_feedback_delay_mode delay_mode : iterate_enum<e_comb_feedback_delay_mode>()) {
+			if (delay_mode == e_comb_feedback_delay_mode::k_variable_constant) {
+				continue;
+			}
+
+			s_test_comb_feedback test_comb_feedback;
+			test_comb_feedback.initialize(delay_mode, 40.0f, delay, k_garbage_memory_value);
+			test_comb_feedback.comb_feedback.reset();
+
+			c_wrapped_array<uint8> memory = test_comb_feedback.memory.get_array();
+			EXPECT_TRUE(std::all_of(
+				memory.begin(),
+				memory.end(),
+				[](uint8 value) { return value == k_garbage_memory_value; }));
+		}
+	}
+}
+
+TEST(CombFeedback, ResetHistoryReadsAsZero) {
+	static constexpr real32 k_min_delay = 40.0f;
+	static constexpr real32 k_max_delays[] = { 40.0f, 63.25f, 100.0f };
+	static constexpr size_t k_block_sizes[] = { 16, 40 };
+
+	for (e_comb_feedback_delay_mode delay_mode : iterate_enum<e_comb_feedback_delay_mode>()) {
+		for (real32 max_delay : k_max_delays) {
+			if (delay_mode == e_comb_feedback_delay_mode::k_fixed && max_delay != std::floor(max_delay)) {
+				continue;
+			}
+
+			for (size_t block_size : k_block_sizes) {
+				// The reference history starts out zeroed in memory
+				s_test_comb_feedback reference_comb_feedback;
+				reference_comb_feedback.initialize(delay_mode, k_min_delay, max_delay, 0);
+				reference_comb_feedback.comb_feedback.reset();
+				std::vector<real32> expected_result = run_comb_feedback(
+					reference_comb_feedback.comb_feedback,
+					delay_mode,
+					k_min_delay,
+					max_delay,
+					block_size);
+
+				// After being reset, a history filled with garbage and previously used history should behave the same
+				s_test_comb_feedback test_comb_feedback;
+				test_comb_feedback.initialize(delay_mode, k_min_delay, max_delay, k_garbage_memory_value);
+				for (uint32 iteration = 0; iteration < 2; iteration++) {
+					test_comb_feedback.comb_feedback.reset();
+					std::vector<real32> result = run_comb_feedback(
+						test_comb_feedback.comb_feedback,
+						delay_mode,
+						k_min_delay,
+						max_delay,
+						block_size);
+					EXPECT_EQ(result, expected_result);
+				}
+			}
+		}
+	}
+}
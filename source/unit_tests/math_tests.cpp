@@ -1,5 +1,11 @@
 #include "common/common.h"
+#include "common/math/fft.h"
 #include "common/math/math.h"
+#include "common/utility/aligned_allocator.h"
+
+#include "engine/task_functions/filter/fir_kernels.h"
+
+#include <cmath>
 
 #include <gtest/gtest.h>
 
@@ -288,3 +294,111 @@ TEST(Math, SanitizeInfNan) {
 	EXPECT_EQ(sanitize_inf_nan(-std::numeric_limits<real32>::infinity()), 0.0f);
 	EXPECT_EQ(sanitize_inf_nan(std::numeric_limits<real32>::quiet_NaN()), 0.0f);
 }
+
+TEST(Math, RealFft) {
+	static constexpr size_t k_fft_size = 256;
+	static constexpr size_t k_bin_count = k_fft_size / 2;
+
+	c_stack_allocator::c_memory_calculator memory_calculator;
+	c_real_fft::calculate_memory(k_fft_size, memory_calculator);
+	c_aligned_allocator<uint8, k_simd_alignment> fft_memory;
+	fft_memory.allocate(memory_calculator.get_size_alignment().size);
+
+	c_stack_allocator allocator(fft_memory.get_array());
+	c_real_fft fft;
+	fft.initialize(k_fft_size, allocator);
+
+	c_aligned_allocator<real32, k_simd_alignment> input;
+	c_aligned_allocator<real32, k_simd_alignment> real;
+	c_aligned_allocator<real32, k_simd_alignment> imaginary;
+	c_aligned_allocator<real32, k_simd_alignment> output;
+	c_aligned_allocator<real32, k_simd_alignment> scratch;
+	input.allocate(k_fft_size);
+	real.allocate(k_bin_count);
+	imaginary.allocate(k_bin_count);
+	output.allocate(k_fft_size);
+	scratch.allocate(k_fft_size);
+
+	for (size_t index = 0; index < k_fft_size; index++) {
+		input.get_array()[index] = std::sin(static_cast<real32>(index * index) * 0.01f);
+	}
+
+	fft.forward(input.get_array().get_pointer(), real.get_array().get_pointer(), imaginary.get_array().get_pointer(),
+		scratch.get_array().get_pointer());
+
+	// Compare against a naive DFT. The Nyquist bin is packed into imaginary[0].
+	for (size_t bin = 0; bin <= k_bin_count; bin++) {
+		real64 expected_real = 0.0;
+		real64 expected_imaginary = 0.0;
+		for (size_t index = 0; index < k_fft_size; index++) {
+			real64 angle = -2.0 * k_pi<real64> * static_cast<real64>(bin * index) / static_cast<real64>(k_fft_size);
+			expected_real += input.get_array()[index] * std::cos(angle);
+			expected_imaginary += input.get_array()[index] * std::sin(angle);
+		}
+
+		if (bin == 0) {
+			EXPECT_NEAR(real.get_array()[0], expected_real, 1e-3);
+		} else if (bin == k_bin_count) {
+			EXPECT_NEAR(imaginary.get_array()[0], expected_real, 1e-3);
+		} else {
+			EXPECT_NEAR(real.get_array()[bin], expected_real, 1e-3);
+			EXPECT_NEAR(imaginary.get_array()[bin], expected_imaginary, 1e-3);
+		}
+	}
+
+	fft.inverse(real.get_array().get_pointer(), imaginary.get_array().get_pointer(), output.get_array().get_pointer(),
+		scratch.get_array().get_pointer());
+	for (size_t index = 0; index < k_fft_size; index++) {
+		EXPECT_NEAR(output.get_array()[index] / static_cast<real32>(k_fft_size), input.get_array()[index], 1e-5f);
+	}
+
+	allocator.release_no_destructors();
+}
+
+TEST(Math, FirKernelSimdTiers) {
+	// Not a multiple of any tier's lane count so that remainders are exercised
+	static constexpr size_t k_count = 45;
+
+	c_aligned_allocator<real32, k_simd_alignment> a;
+	c_aligned_allocator<real32, k_simd_alignment> b;
+	a.allocate(k_count);
+	b.allocate(k_count);
+
+	real32 expected_dot_product = 0.0f;
+	for (size_t index = 0; index < k_count; index++) {
+		a.get_array()[index] = static_cast<real32>(index % 7) - 3.0f;
+		b.get_array()[index] = static_cast<real32>(index % 5) * 0.5f;
+		expected_dot_product += a.get_array()[index] * b.get_array()[index];
+	}
+
+	// Only tiers which are compiled in and supported by this CPU can be run
+	for (e_simd_tier simd_tier : iterate_enum<e_simd_tier>()) {
+		const s_fir_kernels *fir_kernels = get_fir_kernels(simd_tier);
+		if (!fir_kernels || enum_index(simd_tier) > enum_index(get_simd_tier())) {
+			continue;
+		}
+
+		EXPECT_NEAR(fir_kernels->convolve(a.get_array().get_pointer(), b.get_array().get_pointer(), k_count),
+			expected_dot_product,
+			1e-4f);
+
+		real32 output_real[k_count] = {};
+		real32 output_imaginary[k_count] = {};
+		fir_kernels->multiply_accumulate_spectrum(
+			a.get_array().get_pointer(),
+			b.get_array().get_pointer(),
+			b.get_array().get_pointer(),
+			a.get_array().get_pointer(),
+			output_real,
+			output_imaginary,
+			k_count);
+
+		for (size_t index = 0; index < k_count; index++) {
+			// (a + bi)(b + ai) = ab - ab + (a^2 + b^2)i
+			real32 a_value = a.get_array()[index];
+			real32 b_value = b.get_array()[index];
+			EXPECT_NEAR(output_real[index], 0.0f, 1e-5f);
+			EXPECT_NEAR(output_imaginary[index], a_value * a_value + b_value * b_value, 1e-5f);
+		}
+	}
+}
@@ -0,0 +1,109 @@
+#include "common/common.h"
+
+#include "engine/resampler/resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+static constexpr size_t k_test_output_count = 100;
+
+static std::vector<real32> generate_test_samples(size_t count) {
+	std::vector<real32> samples(count);
+	for (size_t index = 0; index < count; index++) {
+		samples[index] = std::sin(static_cast<real32>(index) * 0.37f) * 0.5f + static_cast<real32>(index % 5) * 0.1f;
+	}
+
+	return samples;
+}
+
+// Compares each block kernel output against the corresponding c_resampler::resample() call. The kernel blends
+// coefficients rather than results and sums in a different order, so results only match up to rounding.
+static void test_block_kernel(
+	e_resampler_filter resampler_filter,
+	c_wrapped_array<const real32> fractional_sample_indices,
+	uint32 sample_stride) {
+	const s_resampler_parameters &parameters = get_resampler_parameters(resampler_filter);
+	c_wrapped_array<const real32> phases = get_resampler_phases(resampler_filter);
+
+	c_resampler_block_kernel kernel;
+	kernel.initialize(parameters, phases, fractional_sample_indices, sample_stride);
+	ASSERT_EQ(kernel.get_phase_count(), fractional_sample_indices.get_count());
+	ASSERT_EQ(kernel.get_sample_stride(), sample_stride);
+	ASSERT_EQ(kernel.get_history_sample_count() % sample_stride, sample_stride - 1);
+	ASSERT_GE(kernel.get_history_sample_count(), c_resampler::get_required_history_samples(parameters));
+
+	std::vector<real32> samples = generate_test_samples(kernel.get_required_sample_count(k_test_output_count));
+	std::vector<real32> outputs(k_test_output_count * kernel.get_phase_count());
+	kernel.process(samples.data(), k_test_output_count, outputs.data());
+
+	c_resampler resampler(parameters, phases);
+	c_wrapped_array<const real32> sample_array(samples.data(), samples.size());
+	for (size_t output_index = 0; output_index < k_test_output_count; output_index++) {
+		// The kernel pads the beginning of the filter with zeros, so the last tap lands on the last padded tap
+		size_t sample_index = output_index * sample_stride + kernel.get_history_sample_count();
+		for (uint32 phase_index = 0; phase_index < kernel.get_phase_count(); phase_index++) {
+			real32 expected_output = resampler.resample(
+				sample_array,
+				sample_index,
+				fractional_sample_indices[phase_index]);
+			real32 output = outputs[output_index * kernel.get_phase_count() + phase_index];
+			EXPECT_NEAR(output, expected_output, 1e-5f);
+		}
+	}
+
+	// A constant input should produce each phase's gain
+	std::fill(samples.begin(), samples.end(), 1.0f);
+	kernel.process(samples.data(), k_test_output_count, outputs.data());
+	for (size_t output_index = 0; output_index < k_test_output_count; output_index++) {
+		for (uint32 phase_index = 0; phase_index < kernel.get_phase_count(); phase_index++) {
+			real32 output = outputs[output_index * kernel.get_phase_count() + phase_index];
+			EXPECT_NEAR(output, kernel.get_phase_gain(phase_index), 1e-5f);
+		}
+	}
+}
+
+TEST(Resampler, UpsampleBlockKernel) {
+	static constexpr e_resampler_filter k_resampler_filters[] = {
+		e_resampler_filter::k_upsample_low_quality,
+		e_resampler_filter::k_upsample_high_quality
+	};
+
+	for (e_resampler_filter resampler_filter : k_resampler_filters) {
+		for (uint32 upsample_factor = 2; upsample_factor <= 4; upsample_factor++) {
+			real32 fractional_sample_indices[c_resampler_block_kernel::k_max_phase_count];
+			for (uint32 i = 0; i < upsample_factor; i++) {
+				fractional_sample_indices[i] = static_cast<real32>(i) / static_cast<real32>(upsample_factor);
+			}
+
+			test_block_kernel(
+				resampler_filter,
+				c_wrapped_array<const real32>(fractional_sample_indices, upsample_factor),
+				1);
+		}
+	}
+}
+
+TEST(Resampler, DownsampleBlockKernel) {
+	static constexpr e_resampler_filter k_resampler_filters[] = {
+		e_resampler_filter::k_downsample_2x_low_quality,
+		e_resampler_filter::k_downsample_3x_low_quality,
+		e_resampler_filter::k_downsample_4x_low_quality,
+		e_resampler_filter::k_downsample_2x_high_quality,
+		e_resampler_filter::k_downsample_3x_high_quality,
+		e_resampler_filter::k_downsample_4x_high_quality
+	};
+
+	static constexpr uint32 k_downsample_factors[] = { 2, 3, 4, 2, 3, 4 };
+	STATIC_ASSERT(array_count(k_resampler_filters) == array_count(k_downsample_factors));
+
+	static constexpr real32 k_fractional_sample_indices[] = { 0.0f };
+	for (size_t index = 0; index < array_count(k_resampler_filters); index++) {
+		test_block_kernel(
+			k_resampler_filters[index],
+			c_wrapped_array<const real32>::construct(k_fractional_sample_indices),
+			k_downsample_factors[index]);
+	}
+}
@@ -0,0 +1,345 @@
+#include "common/common.h"
+#include "common/math/math.h"
+#include "common/threading/thread.h"
+#include "common/utility/stopwatch.h"
+
+#include "engine/task_functions/sampler/fetch_sample.h"
+#include "engine/task_functions/sampler/sample.h"
+#include "engine/task_functions/sampler/sample_loader.h"
+#include "engine/task_functions/sampler/sample_streamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+static constexpr const char *k_test_sample_filename = "sampler_test_sample.wav";
+static constexpr uint32 k_test_sample_rate = 44100;
+
+// Long enough to be streamed
+static constexpr uint32 k_test_sample_frame_count = k_test_sample_rate * 3;
+
+// Returns the unquantized chirp in the range [-0.5, 0.5]
+static real64 get_test_sample_value(real64 frame) {
+	real64 time = frame / k_test_sample_rate;
+	real64 phase = 2.0 * k_pi<real64> * (100.0 + 500.0 * time) * time;
+	return std::sin(phase) * 0.5;
+}
+
+static int16 get_test_sample_frame(uint32 frame) {
+	return static_cast<int16>(get_test_sample_value(static_cast<real64>(frame)) * 32768.0);
+}
+
+// Writes a mono 16-bit PCM chirp
+static bool write_test_sample(const char *filename) {
+	std::ofstream file(filename, std::ios::binary);
+	if (file.fail()) {
+		return false;
+	}
+
+	auto write_uint32 = [&file](uint32 value) {
+		uint32 raw_value = native_to_little_endian(value);
+		file.write(reinterpret_cast<const char *>(&raw_value), sizeof(raw_value));
+	};
+
+	auto write_uint16 = [&file](uint16 value) {
+		uint16 raw_value = native_to_little_endian(value);
+		file.write(reinterpret_cast<const char *>(&raw_value), sizeof(raw_value));
+	};
+
+	uint32 data_size = k_test_sample_frame_count * sizeof(int16);
+	file.write("RIFF", 4);
+	write_uint32(20 + 16 + data_size);
+	file.write("WAVE", 4);
+	file.write("fmt ", 4);
+	write_uint32(16);
+	write_uint16(1);
+	write_uint16(1);
+	write_uint32(k_test_sample_rate);
+	write_uint32(k_test_sample_rate * sizeof(int16));
+	write_uint16(sizeof(int16));
+	write_uint16(16);
+	file.write("data", 4);
+	write_uint32(data_size);
+
+	for (uint32 frame = 0; frame < k_test_sample_frame_count; frame++) {
+		write_uint16(static_cast<uint16>(get_test_sample_frame(frame)));
+	}
+
+	return !file.fail();
+}
+
+// Returns deterministic, irregularly spaced sample indices in the range [0, max_sample_index)
+static std::vector<real64> generate_test_sample_indices(size_t count, real64 max_sample_index) {
+	std::vector<real64> sample_indices(count);
+	for (size_t index = 0; index < count; index++) {
+		real64 t = std::fmod(static_cast<real64>(index) * 0.618034, 1.0);
+		sample_indices[index] = t * max_sample_index;
+	}
+
+	return sample_indices;
+}
+
+static void expect_coefficients_equal(
+	const s_sample_interpolation_coefficients &coefficients_a,
+	const s_sample_interpolation_coefficients &coefficients_b) {
+	for (size_t index = 0; index < coefficients_a.coefficients.get_count(); index++) {
+		EXPECT_EQ(coefficients_a.coefficients[index], coefficients_b.coefficients[index]);
+	}
+}
+
+class SamplerTest : public testing::Test {
+protected:
+	void SetUp() override {
+		ASSERT_TRUE(write_test_sample(k_test_sample_filename));
+
+		std::vector<c_sample *> loaded_samples;
+		ASSERT_TRUE(c_sample::load_file(
+			k_test_sample_filename,
+			e_sample_loop_mode::k_none,
+			false,
+			e_sample_storage_format::k_interpolation_coefficients,
+			false,
+			loaded_samples));
+		ASSERT_EQ(loaded_samples.size(), 1);
+		m_loaded_sample.reset(loaded_samples[0]);
+
+		std::vector<c_sample *> streamed_samples;
+		ASSERT_TRUE(c_sample::load_file(
+			k_test_sample_filename,
+			e_sample_loop_mode::k_none,
+			false,
+			e_sample_storage_format::k_interpolation_coefficients,
+			true,
+			streamed_samples));
+		ASSERT_EQ(streamed_samples.size(), 1);
+		m_streamed_sample.reset(streamed_samples[0]);
+	}
+
+	void TearDown() override {
+		m_loaded_sample.reset();
+		m_streamed_sample.reset();
+		std::remove(k_test_sample_filename);
+	}
+
+	std::unique_ptr<c_sample> m_loaded_sample;
+	std::unique_ptr<c_sample> m_streamed_sample;
+};
+
+TEST_F(SamplerTest, StreamedSampleMatchesLoadedSample) {
+	ASSERT_FALSE(m_loaded_sample->is_streamed());
+	ASSERT_TRUE(m_streamed_sample->is_streamed());
+	EXPECT_EQ(m_streamed_sample->get_sample_count(), m_loaded_sample->get_sample_count());
+	EXPECT_GT(m_streamed_sample->get_stream_start(), 0);
+	EXPECT_LT(m_streamed_sample->get_stream_start(), m_streamed_sample->get_sample_count());
+
+	c_wrapped_array<const s_sample_interpolation_coefficients> loaded_coefficients =
+		m_loaded_sample->get_entry(0)->samples;
+	c_wrapped_array<const s_sample_interpolation_coefficients> preloaded_coefficients =
+		m_streamed_sample->get_entry(0)->samples;
+	ASSERT_EQ(preloaded_coefficients.get_count(), m_streamed_sample->get_stream_start());
+	for (size_t index = 0; index < preloaded_coefficients.get_count(); index++) {
+		expect_coefficients_equal(preloaded_coefficients[index], loaded_coefficients[index]);
+	}
+
+	// Read the rest of the sample in blocks, including the zero-padded end of the file
+	c_sample_file_reader reader;
+	ASSERT_TRUE(m_streamed_sample->open_stream(reader));
+
+	static constexpr uint32 k_block_sample_count = 1000;
+	std::vector<s_sample_interpolation_coefficients> block(k_block_sample_count);
+	std::vector<real32> scratch;
+	for (uint32 block_start = m_streamed_sample->get_stream_start();
+		block_start < m_streamed_sample->get_sample_count();
+		block_start += k_block_sample_count) {
+		uint32 block_sample_count =
+			std::min(k_block_sample_count, m_streamed_sample->get_sample_count() - block_start);
+		ASSERT_TRUE(m_streamed_sample->read_streamed_samples(
+			reader,
+			block_start,
+			c_wrapped_array<s_sample_interpolation_coefficients>(block.data(), block_sample_count),
+			scratch));
+
+		for (uint32 index = 0; index < block_sample_count; index++) {
+			expect_coefficients_equal(block[index], loaded_coefficients[block_start + index]);
+		}
+	}
+}
+
+TEST_F(SamplerTest, SampleStreamer) {
+	c_sample_streamer sample_streamer;
+	sample_streamer.initialize(1);
+
+	uint32 first_sample_index = m_streamed_sample->get_stream_start();
+	h_sample_stream stream_handle = sample_streamer.start_stream(m_streamed_sample.get(), first_sample_index);
+	ASSERT_TRUE(stream_handle.is_valid());
+
+	// Only one stream was allocated
+	EXPECT_FALSE(sample_streamer.start_stream(m_streamed_sample.get(), first_sample_index).is_valid());
+
+	c_wrapped_array<const s_sample_interpolation_coefficients> loaded_coefficients =
+		m_loaded_sample->get_entry(0)->samples;
+
+	// Play through the entire sample, waiting for the streamer wherever it has not caught up yet
+	static constexpr uint32 k_buffer_sample_count = 4096;
+	static constexpr int64 k_timeout_ms = 5000;
+	c_stopwatch stopwatch;
+	stopwatch.initialize();
+	for (uint32 buffer_start = first_sample_index;
+		buffer_start < m_streamed_sample->get_sample_count();
+		buffer_start += k_buffer_sample_count) {
+		sample_streamer.update_stream(stream_handle, buffer_start);
+
+		uint32 buffer_end = std::min(buffer_start + k_buffer_sample_count, m_streamed_sample->get_sample_count());
+		for (uint32 sample_index = buffer_start; sample_index < buffer_end; sample_index++) {
+			stopwatch.reset();
+			const s_sample_interpolation_coefficients *coefficients;
+			while (!(coefficients = sample_streamer.get_stream_sample(stream_handle, sample_index))) {
+				ASSERT_LT(stopwatch.query_ms(), k_timeout_ms);
+				c_thread::yield();
+			}
+
+			expect_coefficients_equal(*coefficients, loaded_coefficients[sample_index]);
+		}
+	}
+
+	sample_streamer.stop_stream(stream_handle);
+	EXPECT_FALSE(sample_streamer.is_stream_valid(stream_handle));
+
+	// Once the streaming thread frees the stream, it can be claimed again
+	stopwatch.reset();
+	h_sample_stream new_stream_handle = sample_streamer.start_stream(m_streamed_sample.get(), first_sample_index);
+	while (!new_stream_handle.is_valid()) {
+		ASSERT_LT(stopwatch.query_ms(), k_timeout_ms);
+		c_thread::yield();
+		new_stream_handle = sample_streamer.start_stream(m_streamed_sample.get(), first_sample_index);
+	}
+
+	EXPECT_NE(new_stream_handle, stream_handle);
+	EXPECT_FALSE(sample_streamer.is_stream_valid(stream_handle));
+	EXPECT_TRUE(sample_streamer.is_stream_valid(new_stream_handle));
+
+	sample_streamer.stop_all_streams();
+	EXPECT_FALSE(sample_streamer.is_stream_valid(new_stream_handle));
+	sample_streamer.shutdown();
+}
+
+TEST_F(SamplerTest, CompactSampleStorageFormats) {
+	static constexpr e_sample_storage_format k_compact_storage_formats[] = {
+		e_sample_storage_format::k_real32,
+		e_sample_storage_format::k_int16
+	};
+
+	for (e_sample_storage_format storage_format : k_compact_storage_formats) {
+		std::vector<c_sample *> compact_samples;
+		ASSERT_TRUE(c_sample::load_file(
+			k_test_sample_filename,
+			e_sample_loop_mode::k_none,
+			false,
+			storage_format,
+			true,
+			compact_samples));
+		ASSERT_EQ(compact_samples.size(), 1);
+		std::unique_ptr<c_sample> compact_sample(compact_samples[0]);
+
+		// Compact samples are never streamed
+		EXPECT_FALSE(compact_sample->is_streamed());
+		EXPECT_EQ(compact_sample->get_storage_format(), storage_format);
+		EXPECT_EQ(compact_sample->get_sample_count(), m_loaded_sample->get_sample_count());
+
+		real32 max_error = 0.0f;
+		for (uint32 sample_index = 0; sample_index < compact_sample->get_sample_count(); sample_index++) {
+			// Frames are reproduced exactly, including when stored as int16
+			int16 frame = get_test_sample_frame(sample_index);
+			real32 expected_sample = (static_cast<real32>(frame) + 0.5f) * (1.0f / 32767.5f);
+			EXPECT_EQ(fetch_sample(compact_sample.get(), sample_index), expected_sample);
+
+			// Between frames, the cubic should stay close to the original signal. The chirp stays well below the
+			// nyquist frequency, so the error is dominated by quantization and by the cubic's high frequency rolloff.
+			if (sample_index > 0 && sample_index + 2 < compact_sample->get_sample_count()) {
+				real64 fractional_sample_index = sample_index + 0.5;
+				real32 error = static_cast<real32>(std::abs(
+					fetch_sample(compact_sample.get(), fractional_sample_index)
+						- get_test_sample_value(fractional_sample_index)));
+				max_error = std::max(max_error, error);
+			}
+		}
+
+		EXPECT_LT(max_error, 0.002f);
+	}
+}
+
+TEST_F(SamplerTest, FetchSampleBlocks) {
+	// Not a multiple of any SIMD width so that the scalar fallback is also tested
+	static constexpr size_t k_fetch_count = 61;
+
+	static constexpr e_sample_storage_format k_storage_formats[] = {
+		e_sample_storage_format::k_interpolation_coefficients,
+		e_sample_storage_format::k_real32,
+		e_sample_storage_format::k_int16
+	};
+
+	for (e_sample_storage_format storage_format : k_storage_formats) {
+		std::vector<c_sample *> samples;
+		ASSERT_TRUE(c_sample::load_file(
+			k_test_sample_filename,
+			e_sample_loop_mode::k_none,
+			false,
+			storage_format,
+			false,
+			samples));
+		ASSERT_EQ(samples.size(), 1);
+		std::unique_ptr<c_sample> sample(samples[0]);
+
+		std::vector<real64> sample_indices =
+			generate_test_sample_indices(k_fetch_count, static_cast<real64>(sample->get_sample_count()));
+
+		std::vector<real32> result(k_fetch_count);
+		fetch_samples(sample.get(), sample_indices.data(), k_fetch_count, result.data());
+		for (size_t index = 0; index < k_fetch_count; index++) {
+			EXPECT_NEAR(result[index], fetch_sample(sample.get(), sample_indices[index]), 1e-6f);
+		}
+	}
+}
+
+TEST(Sampler, FetchWavetableSampleBlocks) {
+	static constexpr size_t k_fetch_count = 61;
+	static constexpr real32 k_stream_sample_rate = 44100.0f;
+	static constexpr real32 k_harmonic_weights[] = { 1.0f, 0.5f, 0.0f, 0.25f };
+
+	// Cover speeds which use a single wavetable level as well as speeds which blend between two levels
+	static constexpr real32 k_speeds[] = { 0.1f, 1.0f, 3.7f, 100.0f };
+
+	std::unique_ptr<c_sample> sample(
+		c_sample::generate_wavetable(c_wrapped_array<const real32>::construct(k_harmonic_weights), false));
+	ASSERT_TRUE(sample);
+	real32 base_sample_rate = static_cast<real32>(sample->get_sample_rate());
+
+	std::vector<real64> sample_indices =
+		generate_test_sample_indices(k_fetch_count, static_cast<real64>(sample->get_loop_end()));
+
+	for (real32 speed : k_speeds) {
+		std::vector<real32> result(k_fetch_count);
+		fetch_wavetable_samples(
+			sample.get(),
+			k_stream_sample_rate,
+			base_sample_rate,
+			speed,
+			sample_indices.data(),
+			k_fetch_count,
+			result.data());
+		for (size_t index = 0; index < k_fetch_count; index++) {
+			real32 expected_result = fetch_wavetable_sample(
+				sample.get(),
+				k_stream_sample_rate,
+				base_sample_rate,
+				speed,
+				sample_indices[index]);
+			EXPECT_NEAR(result[index], expected_result, 1e-6f);
+		}
+	}
+}